@@ -9,14 +9,24 @@
 #import "GPUImageMovie.h"
 #import "GPUImagePicture.h"
 #import "GPUImageRawDataInput.h"
+#import "GPUImageYUVConverter.h"
 #import "GPUImageRawDataOutput.h"
 #import "GPUImageMovieWriter.h"
+#import "GPUImageYUVRenderer.h"
+#import "GPUImageRawVideoInput.h"
+#import "GPUImageRawVideoOutput.h"
+#import "GPUImageY4MReader.h"
+#import "GPUImageY4MWriter.h"
 #import "GPUImageFilterPipeline.h"
+#import "GPUImageBatchProcessor.h"
+#import "GPUImageSegmentedMovieProcessor.h"
+#import "GPUImageTiledImageProcessor.h"
 #import "GPUImageTextureOutput.h"
 #import "GPUImageFilterGroup.h"
 #import "GPUImageTextureInput.h"
 #import "GPUImageUIElement.h"
 #import "GPUImageBuffer.h"
+#import "GPUImageFence.h"
 
 // Filters
 #import "GPUImageFilter.h"
@@ -149,4 +159,17 @@
 #import "GPUImageTwoInputCrossTextureSamplingFilter.h"
 #import "GPUImagePoissonBlendFilter.h"
 #import "GPUImageMotionBlurFilter.h"
-#import "GPUImageZoomBlurFilter.h"
\ No newline at end of file
+#import "GPUImageZoomBlurFilter.h"
+#import "GPUImageLuminancePackingFilter.h"
+#import "GPUImageLuminanceUnpackingFilter.h"
+#import "GPUImagePackedSobelEdgeDetectionFilter.h"
+#import "GPUImagePackedNonMaximumSuppressionFilter.h"
+#import "GPUImagePackedLuminanceThresholdFilter.h"
+#import "GPUImagePackedLocalBinaryPatternFilter.h"
+#import "GPUImageHalfSizeDownsamplingFilter.h"
+#import "GPUImageDownscalePyramid.h"
+#import "GPUImageResamplingFilter.h"
+#import "GPUImageLayerCompositingFilter.h"
+#import "GPUImageMultiInputFilter.h"
+#import "GPUImagePipelinePlan.h"
+#import "GPUImageParameterAnimation.h"
\ No newline at end of file
@@ -99,6 +99,30 @@ NSString *const kGPUImageNearbyTexelSamplingVertexShaderString = SHADER_STRING
     }
 }
 
+- (NSUInteger)pixelFootprintRadius;
+{
+    if (!hasOverriddenImageSizeFactor)
+    {
+        return 1;
+    }
+    
+    CGSize currentFBOSize = [self sizeOfFBO];
+    return (NSUInteger)ceil(MAX(_texelWidth * currentFBOSize.width, _texelHeight * currentFBOSize.height));
+}
+
+#pragma mark -
+#pragma mark Changed regions
+
+- (CGRect)outputRegionAffectedByInputRegion:(CGRect)inputRegion atIndex:(NSInteger)textureIndex;
+{
+    return [self region:inputRegion expandedByPixels:[self pixelFootprintRadius]];
+}
+
+- (CGRect)inputRegionNeededForOutputRegion:(CGRect)outputRegion atIndex:(NSInteger)textureIndex;
+{
+    return [self region:outputRegion expandedByPixels:[self pixelFootprintRadius]];
+}
+
 #pragma mark -
 #pragma mark Accessors
 
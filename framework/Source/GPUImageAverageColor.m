@@ -181,7 +181,9 @@ NSString *const kGPUImageColorAveragingFragmentShaderString = SHADER_STRING
             CGSize currentFramebufferSize = [[stageSizes objectAtIndex:currentStage] CGSizeValue];
             
 //            NSLog(@"FBO stage size: %f, %f", currentFramebufferSize.width, currentFramebufferSize.height);
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, (int)currentFramebufferSize.width, (int)currentFramebufferSize.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+            // The final stage is read back with glReadPixels, so only the stages before it are kept at higher precision
+            GLenum stageTextureType = (currentStage < (numberOfStageFramebuffers - 1)) ? [self outputTextureType] : GL_UNSIGNED_BYTE;
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, (int)currentFramebufferSize.width, (int)currentFramebufferSize.height, 0, GL_RGBA, stageTextureType, 0);
             glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, currentTexture, 0);
             GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
             
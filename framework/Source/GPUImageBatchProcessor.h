@@ -0,0 +1,56 @@
+#import <UIKit/UIKit.h>
+#import "GPUImageOutput.h"
+
+/** Runs a sequence of still images through a filter graph with decoding, rendering, and result handling overlapped
+
+ Each image goes through three stages:
+
+ - Decoding into BGRA bytes, on a concurrent background queue
+ - Upload, rendering, and readback, on the video processing queue
+ - The imageProcessedBlock, on a concurrent background queue, which is the place to encode or save the result
+
+ Images move through the stages independently, so decoding of later images and encoding of earlier ones proceed while the GPU works on the current one. The upload texture and the filter framebuffers are reused for consecutive images of the same size.
+
+ The output filter should not have been prepared for image capture, because the texture cache capture path blocks rendering until the captured image is released.
+ */
+@interface GPUImageBatchProcessor : NSObject
+
+@property(readonly, nonatomic) id<GPUImageInput> inputFilter;
+@property(readonly, nonatomic) GPUImageOutput *outputFilter;
+
+/** The maximum number of images that can be decoded, rendered, or waiting on the imageProcessedBlock at one time. This bounds memory use. Defaults to 3.
+ */
+@property(readwrite, nonatomic) NSUInteger maximumImagesInFlight;
+
+/** Whether the batch currently being processed is still running
+ */
+@property(readonly, nonatomic, getter=isProcessing) BOOL processing;
+
+/// @name Initialization and teardown
+
+/** Process through a single filter or filter group
+ */
+- (id)initWithFilter:(GPUImageOutput<GPUImageInput> *)newFilter;
+
+/** Process through a graph of filters
+
+ @param newInputFilter The filter that each decoded image is sent to
+ @param newOutputFilter The filter whose output is read back for each image
+ */
+- (id)initWithInputFilter:(id<GPUImageInput>)newInputFilter outputFilter:(GPUImageOutput *)newOutputFilter;
+
+/// @name Batch processing
+
+/** Starts processing a batch of images asynchronously
+
+ @param imageSources The images to process. Each element can be a UIImage, a CGImageRef, or a file NSURL.
+ @param imageProcessedBlock Called once per image, on a background queue, with the index of the image in imageSources and the filtered result. The result is released after the block returns, so retain it to keep it around. A NULL result means that the source couldn't be decoded. Calls for different images may run concurrently and in any order.
+ @param completionBlock Called on the main queue after every image has passed through imageProcessedBlock
+ */
+- (void)processImageSources:(NSArray *)imageSources imageProcessedBlock:(void (^)(NSUInteger imageIndex, CGImageRef processedImage))imageProcessedBlock completion:(void (^)(void))completionBlock;
+
+/** Stops starting new images in the current batch. Images already in flight still complete.
+ */
+- (void)cancelProcessing;
+
+@end
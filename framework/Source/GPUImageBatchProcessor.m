@@ -0,0 +1,221 @@
+#import "GPUImageBatchProcessor.h"
+#import "GPUImageRawDataInput.h"
+
+@interface GPUImageBatchProcessor()
+{
+    GPUImageRawDataInput *imageInput;
+    dispatch_queue_t schedulingQueue;
+    BOOL cancelRequested;
+}
+
+- (GLubyte *)newDecodedBytesForImageSource:(id)imageSource size:(CGSize *)decodedSize;
+- (CGImageRef)newCGImageByRenderingBytes:(GLubyte *)imageBytes size:(CGSize)imageSize;
+
+@end
+
+@implementation GPUImageBatchProcessor
+
+@synthesize inputFilter = _inputFilter;
+@synthesize outputFilter = _outputFilter;
+@synthesize maximumImagesInFlight = _maximumImagesInFlight;
+@synthesize processing = _processing;
+
+#pragma mark -
+#pragma mark Initialization and teardown
+
+- (id)initWithFilter:(GPUImageOutput<GPUImageInput> *)newFilter;
+{
+    if (!(self = [self initWithInputFilter:newFilter outputFilter:newFilter]))
+    {
+		return nil;
+    }
+
+    return self;
+}
+
+- (id)initWithInputFilter:(id<GPUImageInput>)newInputFilter outputFilter:(GPUImageOutput *)newOutputFilter;
+{
+    if (!(self = [super init]))
+    {
+		return nil;
+    }
+
+    _inputFilter = newInputFilter;
+    _outputFilter = newOutputFilter;
+    _maximumImagesInFlight = 3;
+    _processing = NO;
+    schedulingQueue = dispatch_queue_create("com.sunsetlakesoftware.GPUImage.batchSchedulingQueue", NULL);
+
+    return self;
+}
+
+- (void)dealloc;
+{
+    runSynchronouslyOnVideoProcessingQueue(^{
+        [imageInput removeAllTargets];
+    });
+
+    // ARC forbids explicit message send of 'release'; since iOS 6 even for dispatch_release() calls: stripping it out in that case is required.
+#if ( (__IPHONE_OS_VERSION_MIN_REQUIRED < __IPHONE_6_0) || (!defined(__IPHONE_6_0)) )
+    if (schedulingQueue != NULL)
+    {
+        dispatch_release(schedulingQueue);
+    }
+#endif
+}
+
+#pragma mark -
+#pragma mark Batch processing
+
+- (void)processImageSources:(NSArray *)imageSources imageProcessedBlock:(void (^)(NSUInteger imageIndex, CGImageRef processedImage))imageProcessedBlock completion:(void (^)(void))completionBlock;
+{
+    NSAssert(!_processing, @"Only one batch can be processed at a time by a GPUImageBatchProcessor");
+
+    _processing = YES;
+    cancelRequested = NO;
+
+    // The maximum texture size is cached after first being read from the image processing context, so make sure that happens on the right queue before decoding starts elsewhere
+    runSynchronouslyOnVideoProcessingQueue(^{
+        [GPUImageOpenGLESContext maximumTextureSizeForThisDevice];
+    });
+
+    NSArray *sourcesToProcess = [imageSources copy];
+    dispatch_semaphore_t imagesInFlightSemaphore = dispatch_semaphore_create(MAX(_maximumImagesInFlight, 1));
+    dispatch_group_t batchGroup = dispatch_group_create();
+    dispatch_queue_t workerQueue = dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0);
+
+    dispatch_async(schedulingQueue, ^{
+        [sourcesToProcess enumerateObjectsUsingBlock:^(id imageSource, NSUInteger imageIndex, BOOL *stop) {
+            dispatch_semaphore_wait(imagesInFlightSemaphore, DISPATCH_TIME_FOREVER);
+
+            if (cancelRequested)
+            {
+                dispatch_semaphore_signal(imagesInFlightSemaphore);
+                *stop = YES;
+                return;
+            }
+
+            dispatch_group_enter(batchGroup);
+
+            // Decode stage
+            dispatch_async(workerQueue, ^{
+                CGSize decodedSize = CGSizeZero;
+                GLubyte *decodedBytes = [self newDecodedBytesForImageSource:imageSource size:&decodedSize];
+
+                // Upload, render, and readback stage
+                runAsynchronouslyOnVideoProcessingQueue(^{
+                    CGImageRef processedImage = NULL;
+                    if (decodedBytes != NULL)
+                    {
+                        processedImage = [self newCGImageByRenderingBytes:decodedBytes size:decodedSize];
+                        free(decodedBytes);
+                    }
+
+                    // Result handling stage
+                    dispatch_async(workerQueue, ^{
+                        if (imageProcessedBlock != NULL)
+                        {
+                            imageProcessedBlock(imageIndex, processedImage);
+                        }
+
+                        CGImageRelease(processedImage);
+                        dispatch_semaphore_signal(imagesInFlightSemaphore);
+                        dispatch_group_leave(batchGroup);
+                    });
+                });
+            });
+        }];
+
+        dispatch_group_notify(batchGroup, dispatch_get_main_queue(), ^{
+            _processing = NO;
+
+            if (completionBlock != NULL)
+            {
+                completionBlock();
+            }
+
+#if ( (__IPHONE_OS_VERSION_MIN_REQUIRED < __IPHONE_6_0) || (!defined(__IPHONE_6_0)) )
+            dispatch_release(imagesInFlightSemaphore);
+            dispatch_release(batchGroup);
+#endif
+        });
+    });
+}
+
+- (void)cancelProcessing;
+{
+    cancelRequested = YES;
+}
+
+#pragma mark -
+#pragma mark Pipeline stages
+
+- (GLubyte *)newDecodedBytesForImageSource:(id)imageSource size:(CGSize *)decodedSize;
+{
+    CGImageRef imageToDecode = NULL;
+    UIImage *imageHolder = nil;
+
+    if ([imageSource isKindOfClass:[UIImage class]])
+    {
+        imageHolder = imageSource;
+    }
+    else if ([imageSource isKindOfClass:[NSURL class]])
+    {
+        imageHolder = [UIImage imageWithContentsOfFile:[(NSURL *)imageSource path]];
+    }
+    else if ((imageSource != nil) && (CFGetTypeID((__bridge CFTypeRef)imageSource) == CGImageGetTypeID()))
+    {
+        imageToDecode = (__bridge CGImageRef)imageSource;
+    }
+
+    if (imageHolder != nil)
+    {
+        imageToDecode = [imageHolder CGImage];
+    }
+
+    if (imageToDecode == NULL)
+    {
+        return NULL;
+    }
+
+    // Like GPUImagePicture, deal with images larger than the maximum texture size by resizing to be within that limit
+    CGSize pixelSizeOfImage = CGSizeMake(CGImageGetWidth(imageToDecode), CGImageGetHeight(imageToDecode));
+    pixelSizeOfImage = [GPUImageOpenGLESContext sizeThatFitsWithinATextureForSize:pixelSizeOfImage];
+    size_t widthOfImage = (size_t)pixelSizeOfImage.width;
+    size_t heightOfImage = (size_t)pixelSizeOfImage.height;
+
+    GLubyte *imageData = (GLubyte *) calloc(1, widthOfImage * heightOfImage * 4);
+    if (imageData == NULL)
+    {
+        return NULL;
+    }
+
+    CGColorSpaceRef genericRGBColorspace = CGColorSpaceCreateDeviceRGB();
+    CGContextRef imageContext = CGBitmapContextCreate(imageData, widthOfImage, heightOfImage, 8, widthOfImage * 4, genericRGBColorspace,  kCGBitmapByteOrder32Little | kCGImageAlphaPremultipliedFirst);
+    CGContextDrawImage(imageContext, CGRectMake(0.0, 0.0, widthOfImage, heightOfImage), imageToDecode);
+    CGContextRelease(imageContext);
+    CGColorSpaceRelease(genericRGBColorspace);
+
+    *decodedSize = CGSizeMake(widthOfImage, heightOfImage);
+    return imageData;
+}
+
+- (CGImageRef)newCGImageByRenderingBytes:(GLubyte *)imageBytes size:(CGSize)imageSize;
+{
+    // This runs on the video processing queue, so the input's processing and the readback below happen inline
+    if (imageInput == nil)
+    {
+        imageInput = [[GPUImageRawDataInput alloc] initWithBytes:imageBytes size:imageSize];
+        [imageInput addTarget:_inputFilter];
+    }
+    else
+    {
+        [imageInput updateDataFromBytes:imageBytes size:imageSize];
+    }
+
+    [imageInput processData];
+
+    return [_outputFilter newCGImageFromCurrentlyProcessedOutputWithOrientation:UIImageOrientationUp];
+}
+
+@end
@@ -77,6 +77,15 @@ NSString *const kGPUImageBoxBlurFragmentShaderString = SHADER_STRING
     return self;
 }
 
+#pragma mark -
+#pragma mark Tiled processing
+
+- (NSUInteger)pixelFootprintRadius;
+{
+    // The outermost linearly interpolated sample also picks up half of the next texel out
+    return (NSUInteger)ceil(3.5 * _blurSize + 0.5);
+}
+
 #pragma mark -
 #pragma mark Accessors
 
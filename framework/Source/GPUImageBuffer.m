@@ -43,7 +43,7 @@
 
 - (void)newFrameReadyAtTime:(CMTime)frameTime atIndex:(NSInteger)textureIndex;
 {
-    outputTextureRetainCount = [targets count];
+    outputTextureRetainCount = [self numberOfTargetsToSendFrameAtTime:frameTime];
 
     static const GLfloat imageVertices[] = {
         -1.0f, -1.0f,
@@ -57,18 +57,14 @@
     // Let the downstream video elements see the previous frame from the buffer before rendering a new one into place
     [self informTargetsAboutNewFrameAtTime:frameTime];
     
-    // Move the last frame to the back of the buffer, if needed
+    // Move the last frame to the back of the buffer, if needed.
+    // When simply delaying by one frame, the downstream reads of the previous frame were issued on this same context before the render below, so the GL command stream already orders them
     if (_bufferSize > 1)
     {
         NSNumber *lastTextureName = [bufferedTextures objectAtIndex:0];
         [bufferedTextures removeObjectAtIndex:0];
         [bufferedTextures addObject:lastTextureName];
     }
-    else
-    {
-        // Make sure the previous rendering has finished before enqueuing the current frame when simply delaying by one frame
-        glFinish();
-    }    
     
     // Render the new frame to the back of the buffer
     [self renderToTextureWithVertices:imageVertices textureCoordinates:[[self class] textureCoordinatesForRotation:inputRotation] sourceTexture:filterSourceTexture];
@@ -104,6 +100,7 @@
 - (void)prepareForImageCapture;
 {
     // Disable this for now, until I figure out how to integrate the texture caches with a buffer like this
+    // Until then captures from a buffer go through glReadPixels, which waits on the GPU by itself, so there's no capture fence to insert here
 }
 
 #pragma mark -
@@ -130,7 +127,7 @@
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 
     CGSize currentFBOSize = [self sizeOfFBO];
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, (int)currentFBOSize.width, (int)currentFBOSize.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, (int)currentFBOSize.width, (int)currentFBOSize.height, 0, GL_RGBA, [self outputTextureType], 0);
     glBindTexture(GL_TEXTURE_2D, 0);
 
     return newTextureName;
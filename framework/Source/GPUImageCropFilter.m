@@ -18,13 +18,6 @@ NSString *const kGPUImageCropFragmentShaderString =  SHADER_STRING
 
 @end
 
-@interface GPUImageCropFilter()
-{
-    CGSize originallySuppliedInputSize;
-}
-
-@end
-
 @implementation GPUImageCropFilter
 
 @synthesize cropRegion = _cropRegion;
@@ -212,7 +205,8 @@ NSString *const kGPUImageCropFragmentShaderString =  SHADER_STRING
 
 - (void)newFrameReadyAtTime:(CMTime)frameTime atIndex:(NSInteger)textureIndex;
 {
-    outputTextureRetainCount = [targets count];
+    outputTextureRetainCount = [self numberOfTargetsToSendFrameAtTime:frameTime];
+    [self applyParameterAnimationsAtTime:frameTime];
 
     static const GLfloat cropSquareVertices[] = {
         -1.0f, -1.0f,
@@ -221,11 +215,42 @@ NSString *const kGPUImageCropFragmentShaderString =  SHADER_STRING
         1.0f,  1.0f,
     };
     
+    [self calculateOutputChangedRegion];
     [self renderToTextureWithVertices:cropSquareVertices textureCoordinates:cropTextureCoordinates sourceTexture:filterSourceTexture];
 
     [self informTargetsAboutNewFrameAtTime:frameTime];
 }
 
+#pragma mark -
+#pragma mark Changed regions
+
+- (CGRect)outputRegionAffectedByInputRegion:(CGRect)inputRegion atIndex:(NSInteger)textureIndex;
+{
+    if (CGRectIsNull(inputRegion))
+    {
+        return inputRegion;
+    }
+    
+    if ( (_cropRegion.size.width <= 0.0) || (_cropRegion.size.height <= 0.0) )
+    {
+        return kGPUImageFullFrameRegion;
+    }
+    
+    // Changes outside of the crop region fall off the edges of the output, and so redraw nothing
+    return CGRectMake((inputRegion.origin.x - _cropRegion.origin.x) / _cropRegion.size.width, (inputRegion.origin.y - _cropRegion.origin.y) / _cropRegion.size.height, inputRegion.size.width / _cropRegion.size.width, inputRegion.size.height / _cropRegion.size.height);
+}
+
+- (CGRect)inputRegionNeededForOutputRegion:(CGRect)outputRegion atIndex:(NSInteger)textureIndex;
+{
+    if ( (_cropRegion.size.width <= 0.0) || (_cropRegion.size.height <= 0.0) )
+    {
+        return kGPUImageFullFrameRegion;
+    }
+    
+    // Nothing outside of the crop region is read, so filters upstream only need to draw that much
+    return CGRectMake(_cropRegion.origin.x + outputRegion.origin.x * _cropRegion.size.width, _cropRegion.origin.y + outputRegion.origin.y * _cropRegion.size.height, outputRegion.size.width * _cropRegion.size.width, outputRegion.size.height * _cropRegion.size.height);
+}
+
 #pragma mark -
 #pragma mark Accessors
 
@@ -237,6 +262,7 @@ NSString *const kGPUImageCropFragmentShaderString =  SHADER_STRING
                       newValue.size.height >= 0 && newValue.size.height <= 1);
 
     _cropRegion = newValue;
+    framebufferHoldsPreviousFrame = NO;
     [self calculateCropTextureCoordinates];
 }
 
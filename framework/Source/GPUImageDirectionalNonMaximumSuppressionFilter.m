@@ -74,6 +74,11 @@ NSString *const kGPUImageDirectionalNonmaximumSuppressionFragmentShaderString =
     }
 }
 
+- (BOOL)providesMonochromeOutput;
+{
+    return YES;
+}
+
 #pragma mark -
 #pragma mark Accessors
 
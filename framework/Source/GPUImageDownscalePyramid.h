@@ -0,0 +1,31 @@
+#import "GPUImageFilterGroup.h"
+
+/** Generates successively halved copies of its input once per frame, and lets targets subscribe to any level or to any smaller output size
+
+ Level 0 is the input itself, so full-size targets should be attached to the source rather than here. Level n is half the width and height of level n - 1, downsampled from it with a GPUImageHalfSizeDownsamplingFilter, so each level only costs a quarter of the one above it. An output at an arbitrary size is Lanczos resampled from the smallest level that is still at least that large, so no resample ever reduces by more than a factor of two. Producing a master, a preview and a thumbnail from one source costs little more than the largest of them.
+ 
+ Levels and sized outputs are only created when something asks for them. Adding a target without a level attaches it to level 1.
+ */
+@interface GPUImageDownscalePyramid : GPUImageFilterGroup
+{
+    NSMutableArray *pyramidLevels;
+    NSMutableArray *sizedOutputFilters, *sizedOutputSizes, *sizedOutputLevels;
+    CGSize pyramidInputSize;
+    GPUImageRotationMode pyramidInputRotation;
+    GLuint pyramidInputTexture;
+}
+
+/** The number of downsampled levels generated so far, not counting the input as level 0
+ */
+@property(readonly, nonatomic) NSUInteger numberOfLevels;
+
+// Level access
+- (GPUImageOutput *)outputAtLevel:(NSUInteger)level;
+- (void)addTarget:(id<GPUImageInput>)newTarget atLevel:(NSUInteger)level;
+- (CGSize)sizeOfLevel:(NSUInteger)level;
+
+// Sized outputs
+- (GPUImageOutput *)outputAtSize:(CGSize)outputSize;
+- (void)addTarget:(id<GPUImageInput>)newTarget atSize:(CGSize)outputSize;
+
+@end
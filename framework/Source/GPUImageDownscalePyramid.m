@@ -0,0 +1,304 @@
+#import "GPUImageDownscalePyramid.h"
+#import "GPUImageHalfSizeDownsamplingFilter.h"
+#import "GPUImageLanczosResamplingFilter.h"
+
+@interface GPUImageDownscalePyramid()
+
+- (NSUInteger)levelForOutputSize:(CGSize)outputSize;
+- (void)attachFilter:(GPUImageOutput<GPUImageInput> *)filter toLevel:(NSUInteger)level;
+- (void)detachFilter:(GPUImageOutput<GPUImageInput> *)filter fromLevel:(NSUInteger)level;
+- (void)reassignSizedOutputsToLevels;
+
+@end
+
+@implementation GPUImageDownscalePyramid
+
+#pragma mark -
+#pragma mark Initialization and teardown
+
+- (id)init;
+{
+    if (!(self = [super init]))
+    {
+		return nil;
+    }
+    
+    pyramidLevels = [[NSMutableArray alloc] init];
+    sizedOutputFilters = [[NSMutableArray alloc] init];
+    sizedOutputSizes = [[NSMutableArray alloc] init];
+    sizedOutputLevels = [[NSMutableArray alloc] init];
+    pyramidInputSize = CGSizeZero;
+    pyramidInputRotation = kGPUImageNoRotation;
+    pyramidInputTexture = 0;
+    
+    self.initialFilters = [NSArray array];
+    
+    return self;
+}
+
+#pragma mark -
+#pragma mark Level access
+
+- (NSUInteger)numberOfLevels;
+{
+    return [pyramidLevels count];
+}
+
+- (GPUImageOutput *)outputAtLevel:(NSUInteger)level;
+{
+    NSAssert(level > 0, @"Level 0 is the input of the pyramid. Attach full-size targets to the source itself.");
+    
+    runSynchronouslyOnVideoProcessingQueue(^{
+        while ([pyramidLevels count] < level)
+        {
+            GPUImageHalfSizeDownsamplingFilter *newLevel = [[GPUImageHalfSizeDownsamplingFilter alloc] init];
+            [self attachFilter:newLevel toLevel:[pyramidLevels count]];
+            [pyramidLevels addObject:newLevel];
+            [self addFilter:newLevel];
+            
+            if ([pyramidLevels count] == 1)
+            {
+                self.terminalFilter = newLevel;
+            }
+        }
+    });
+    
+    return [pyramidLevels objectAtIndex:(level - 1)];
+}
+
+- (void)addTarget:(id<GPUImageInput>)newTarget atLevel:(NSUInteger)level;
+{
+    [[self outputAtLevel:level] addTarget:newTarget];
+}
+
+- (CGSize)sizeOfLevel:(NSUInteger)level;
+{
+    CGSize levelSize = pyramidInputSize;
+    if (GPUImageRotationSwapsWidthAndHeight(pyramidInputRotation))
+    {
+        levelSize = CGSizeMake(levelSize.height, levelSize.width);
+    }
+    
+    for (NSUInteger currentLevel = 0; currentLevel < level; currentLevel++)
+    {
+        levelSize = CGSizeMake(ceil(levelSize.width / 2.0), ceil(levelSize.height / 2.0));
+    }
+    
+    return levelSize;
+}
+
+#pragma mark -
+#pragma mark Sized outputs
+
+- (GPUImageOutput *)outputAtSize:(CGSize)outputSize;
+{
+    __block GPUImageOutput *sizedOutput = nil;
+    
+    runSynchronouslyOnVideoProcessingQueue(^{
+        // Outputs of the same size share one resample
+        for (NSUInteger outputIndex = 0; outputIndex < [sizedOutputSizes count]; outputIndex++)
+        {
+            if (CGSizeEqualToSize([[sizedOutputSizes objectAtIndex:outputIndex] CGSizeValue], outputSize))
+            {
+                sizedOutput = [sizedOutputFilters objectAtIndex:outputIndex];
+                return;
+            }
+        }
+        
+        GPUImageLanczosResamplingFilter *resamplingFilter = [[GPUImageLanczosResamplingFilter alloc] init];
+        [resamplingFilter forceProcessingAtSize:outputSize];
+        [self addFilter:resamplingFilter];
+        
+        NSUInteger level = [self levelForOutputSize:outputSize];
+        [self attachFilter:resamplingFilter toLevel:level];
+        
+        [sizedOutputFilters addObject:resamplingFilter];
+        [sizedOutputSizes addObject:[NSValue valueWithCGSize:outputSize]];
+        [sizedOutputLevels addObject:[NSNumber numberWithUnsignedInteger:level]];
+        
+        sizedOutput = resamplingFilter;
+    });
+    
+    return sizedOutput;
+}
+
+- (void)addTarget:(id<GPUImageInput>)newTarget atSize:(CGSize)outputSize;
+{
+    [[self outputAtSize:outputSize] addTarget:newTarget];
+}
+
+#pragma mark -
+#pragma mark Managing the pyramid
+
+- (NSUInteger)levelForOutputSize:(CGSize)outputSize;
+{
+    // Until the input size is known everything resamples from the input, and is moved down once the first frame arrives
+    if (CGSizeEqualToSize(pyramidInputSize, CGSizeZero))
+    {
+        return 0;
+    }
+    
+    NSUInteger level = 0;
+    CGSize nextLevelSize = [self sizeOfLevel:1];
+    while ( (nextLevelSize.width >= outputSize.width) && (nextLevelSize.height >= outputSize.height) && (nextLevelSize.width > 1.0) && (nextLevelSize.height > 1.0) )
+    {
+        level++;
+        nextLevelSize = [self sizeOfLevel:(level + 1)];
+    }
+    
+    return level;
+}
+
+- (void)attachFilter:(GPUImageOutput<GPUImageInput> *)filter toLevel:(NSUInteger)level;
+{
+    if (level == 0)
+    {
+        self.initialFilters = [self.initialFilters arrayByAddingObject:filter];
+        
+        // Filters joining after the input was set up need to be brought up to date with it
+        if (firstTextureDelegate != nil)
+        {
+            [filter setTextureDelegate:self atIndex:0];
+        }
+        [filter setInputRotation:pyramidInputRotation atIndex:0];
+        if (!CGSizeEqualToSize(pyramidInputSize, CGSizeZero))
+        {
+            [filter setInputSize:pyramidInputSize atIndex:0];
+        }
+        if (pyramidInputTexture != 0)
+        {
+            [filter setInputTexture:pyramidInputTexture atIndex:0];
+        }
+    }
+    else
+    {
+        [[self outputAtLevel:level] addTarget:filter];
+    }
+}
+
+- (void)detachFilter:(GPUImageOutput<GPUImageInput> *)filter fromLevel:(NSUInteger)level;
+{
+    if (level == 0)
+    {
+        NSMutableArray *remainingInitialFilters = [NSMutableArray arrayWithArray:self.initialFilters];
+        [remainingInitialFilters removeObject:filter];
+        self.initialFilters = remainingInitialFilters;
+    }
+    else
+    {
+        [[pyramidLevels objectAtIndex:(level - 1)] removeTarget:filter];
+    }
+}
+
+- (void)reassignSizedOutputsToLevels;
+{
+    for (NSUInteger outputIndex = 0; outputIndex < [sizedOutputFilters count]; outputIndex++)
+    {
+        NSUInteger currentLevel = [[sizedOutputLevels objectAtIndex:outputIndex] unsignedIntegerValue];
+        NSUInteger newLevel = [self levelForOutputSize:[[sizedOutputSizes objectAtIndex:outputIndex] CGSizeValue]];
+        
+        if (newLevel != currentLevel)
+        {
+            GPUImageOutput<GPUImageInput> *resamplingFilter = [sizedOutputFilters objectAtIndex:outputIndex];
+            [self detachFilter:resamplingFilter fromLevel:currentLevel];
+            [self attachFilter:resamplingFilter toLevel:newLevel];
+            [sizedOutputLevels replaceObjectAtIndex:outputIndex withObject:[NSNumber numberWithUnsignedInteger:newLevel]];
+        }
+    }
+}
+
+#pragma mark -
+#pragma mark GPUImageOutput overrides
+
+- (void)addTarget:(id<GPUImageInput>)newTarget atTextureLocation:(NSInteger)textureLocation;
+{
+    [[self outputAtLevel:1] addTarget:newTarget atTextureLocation:textureLocation];
+}
+
+- (void)removeTarget:(id<GPUImageInput>)targetToRemove;
+{
+    for (GPUImageOutput *currentOutput in [pyramidLevels arrayByAddingObjectsFromArray:sizedOutputFilters])
+    {
+        if ([[currentOutput targets] containsObject:targetToRemove])
+        {
+            [currentOutput removeTarget:targetToRemove];
+        }
+    }
+}
+
+- (void)handOffTarget:(id<GPUImageInput>)targetToHandOff;
+{
+    for (GPUImageOutput *currentOutput in [pyramidLevels arrayByAddingObjectsFromArray:sizedOutputFilters])
+    {
+        if ([[currentOutput targets] containsObject:targetToHandOff])
+        {
+            [currentOutput handOffTarget:targetToHandOff];
+        }
+    }
+}
+
+- (void)removeAllTargets;
+{
+    // The levels themselves feed one another and the sized outputs, so only the outside targets come off
+    for (GPUImageOutput *currentOutput in [pyramidLevels arrayByAddingObjectsFromArray:sizedOutputFilters])
+    {
+        for (id<GPUImageInput> currentTarget in [currentOutput targets])
+        {
+            if (![pyramidLevels containsObject:currentTarget] && ![sizedOutputFilters containsObject:currentTarget])
+            {
+                [currentOutput removeTarget:currentTarget];
+            }
+        }
+    }
+}
+
+- (NSArray *)targets;
+{
+    NSMutableArray *outsideTargets = [[NSMutableArray alloc] init];
+    for (GPUImageOutput *currentOutput in [pyramidLevels arrayByAddingObjectsFromArray:sizedOutputFilters])
+    {
+        for (id<GPUImageInput> currentTarget in [currentOutput targets])
+        {
+            if (![pyramidLevels containsObject:currentTarget] && ![sizedOutputFilters containsObject:currentTarget])
+            {
+                [outsideTargets addObject:currentTarget];
+            }
+        }
+    }
+    
+    return outsideTargets;
+}
+
+#pragma mark -
+#pragma mark GPUImageInput protocol
+
+- (void)setInputTexture:(GLuint)newInputTexture atIndex:(NSInteger)textureIndex;
+{
+    pyramidInputTexture = newInputTexture;
+    [super setInputTexture:newInputTexture atIndex:textureIndex];
+}
+
+- (void)setInputRotation:(GPUImageRotationMode)newInputRotation atIndex:(NSInteger)textureIndex;
+{
+    if (newInputRotation != pyramidInputRotation)
+    {
+        pyramidInputRotation = newInputRotation;
+        [self reassignSizedOutputsToLevels];
+    }
+    
+    [super setInputRotation:newInputRotation atIndex:textureIndex];
+}
+
+- (void)setInputSize:(CGSize)newSize atIndex:(NSInteger)textureIndex;
+{
+    // Each output resamples from the smallest level still larger than it, which depends on the input size
+    if (!CGSizeEqualToSize(newSize, pyramidInputSize))
+    {
+        pyramidInputSize = newSize;
+        [self reassignSizedOutputsToLevels];
+    }
+    
+    [super setInputSize:newSize atIndex:textureIndex];
+}
+
+@end
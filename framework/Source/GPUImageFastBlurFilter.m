@@ -133,6 +133,40 @@ NSString *const kGPUImageFastBlurIgnoringAlphaFragmentShaderString = SHADER_STRI
     }
 }
 
+#pragma mark -
+#pragma mark Tiled processing
+
+- (NSUInteger)pixelFootprintRadius;
+{
+    // The outermost linearly interpolated sample also picks up half of the next texel out, and each additional pass widens the footprint again
+    return (NSUInteger)ceil(3.2307692308 * _blurSize + 0.5) * MAX(_blurPasses, 1);
+}
+
+#pragma mark -
+#pragma mark Changed regions
+
+- (CGRect)outputRegionAffectedByInputRegion:(CGRect)inputRegion atIndex:(NSInteger)textureIndex;
+{
+    // Additional passes read back the previous pass's full output, which only holds this frame's results within the redrawn region
+    if (_blurPasses > 1)
+    {
+        return kGPUImageFullFrameRegion;
+    }
+    
+    return [super outputRegionAffectedByInputRegion:inputRegion atIndex:textureIndex];
+}
+
+- (CGRect)outputRegionOfInterest;
+{
+    // For the same reason, every pass but the last is read across the whole frame
+    if (_blurPasses > 1)
+    {
+        return kGPUImageFullFrameRegion;
+    }
+    
+    return [super outputRegionOfInterest];
+}
+
 #pragma mark -
 #pragma mark Accessors
 
@@ -144,5 +178,11 @@ NSString *const kGPUImageFastBlurIgnoringAlphaFragmentShaderString = SHADER_STRI
     [self setFloat:_blurSize forUniform:secondBlurSizeUniform program:secondFilterProgram];
 }
 
+- (void)setBlurPasses:(NSUInteger)newValue;
+{
+    _blurPasses = newValue;
+    framebufferHoldsPreviousFrame = NO;
+}
+
 @end
 
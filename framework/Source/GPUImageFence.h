@@ -0,0 +1,43 @@
+#import <Foundation/Foundation.h>
+#import "GPUImageOpenGLESContext.h"
+
+/** A GPU command fence for waiting on specific rendering rather than draining the whole pipeline
+
+ Insert a fence right after the commands that produce a texture, then wait on it only when that texture is actually needed. Where GL_APPLE_sync is available this uses glFenceSyncAPPLE, so only the work issued before the fence is waited on. On devices without fence support, a CPU wait falls back to glFinish() and a GPU wait falls back to glFlush().
+
+ All methods must be called on the video processing queue with the image processing context current.
+ */
+@interface GPUImageFence : NSObject
+
+/** Name used when reporting wait times
+ */
+@property(readonly, nonatomic) NSString *label;
+
+/** Whether a fence has been inserted and not yet waited on
+ */
+@property(readonly, nonatomic) BOOL isPending;
+
+- (id)initWithLabel:(NSString *)newLabel;
+
+/** Places the fence after all commands issued so far in the current context, replacing any earlier pending fence
+ */
+- (void)insert;
+
+/** Blocks the calling thread until the commands before the fence have completed
+
+ Use this before touching the fenced output from the CPU, such as reading a pixel buffer backing a texture cache.
+ */
+- (void)waitUntilCompleted;
+
+/** Makes subsequent GPU commands wait for the fence without blocking the calling thread
+ */
+- (void)waitOnGPU;
+
+/// @name Debugging
+
+/** When enabled, every wait logs its label and how long the calling thread was blocked
+ */
++ (void)setReportsWaitTimes:(BOOL)newValue;
++ (BOOL)reportsWaitTimes;
+
+@end
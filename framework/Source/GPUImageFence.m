@@ -0,0 +1,152 @@
+#import "GPUImageFence.h"
+
+static BOOL reportsWaitTimes = NO;
+
+@interface GPUImageFence()
+{
+#ifdef GL_APPLE_sync
+    GLsync fenceObject;
+#endif
+    BOOL fenceInserted;
+}
+
+- (void)deleteFenceObject;
+- (void)reportWaitOfType:(NSString *)waitType startingAt:(CFAbsoluteTime)startTime;
+
+@end
+
+@implementation GPUImageFence
+
+@synthesize label = _label;
+
+#pragma mark -
+#pragma mark Initialization and teardown
+
+- (id)initWithLabel:(NSString *)newLabel;
+{
+    if (!(self = [super init]))
+    {
+		return nil;
+    }
+
+    _label = [newLabel copy];
+    fenceInserted = NO;
+
+    return self;
+}
+
+- (id)init;
+{
+    return [self initWithLabel:@"Unlabeled"];
+}
+
+- (void)dealloc;
+{
+    runSynchronouslyOnVideoProcessingQueue(^{
+        [GPUImageOpenGLESContext useImageProcessingContext];
+        [self deleteFenceObject];
+    });
+}
+
+#pragma mark -
+#pragma mark Fence operations
+
+- (void)insert;
+{
+    [self deleteFenceObject];
+
+#ifdef GL_APPLE_sync
+    if ([GPUImageOpenGLESContext deviceSupportsFenceSync])
+    {
+        fenceObject = glFenceSyncAPPLE(GL_SYNC_GPU_COMMANDS_COMPLETE_APPLE, 0);
+    }
+#endif
+
+    fenceInserted = YES;
+}
+
+- (void)waitUntilCompleted;
+{
+    CFAbsoluteTime startTime = CFAbsoluteTimeGetCurrent();
+
+#ifdef GL_APPLE_sync
+    if (fenceObject != NULL)
+    {
+        // The flush bit guarantees that the fence itself gets submitted, so this can't wait forever on an unflushed command stream
+        glClientWaitSyncAPPLE(fenceObject, GL_SYNC_FLUSH_COMMANDS_BIT_APPLE, GL_TIMEOUT_IGNORED_APPLE);
+    }
+    else
+    {
+        glFinish();
+    }
+#else
+    glFinish();
+#endif
+
+    [self deleteFenceObject];
+    [self reportWaitOfType:@"CPU" startingAt:startTime];
+}
+
+- (void)waitOnGPU;
+{
+    CFAbsoluteTime startTime = CFAbsoluteTimeGetCurrent();
+
+#ifdef GL_APPLE_sync
+    if (fenceObject != NULL)
+    {
+        glWaitSyncAPPLE(fenceObject, 0, GL_TIMEOUT_IGNORED_APPLE);
+    }
+    else
+    {
+        glFlush();
+    }
+#else
+    glFlush();
+#endif
+
+    [self deleteFenceObject];
+    [self reportWaitOfType:@"GPU" startingAt:startTime];
+}
+
+- (BOOL)isPending;
+{
+    return fenceInserted;
+}
+
+- (void)deleteFenceObject;
+{
+#ifdef GL_APPLE_sync
+    if (fenceObject != NULL)
+    {
+        glDeleteSyncAPPLE(fenceObject);
+        fenceObject = NULL;
+    }
+#endif
+
+    fenceInserted = NO;
+}
+
+#pragma mark -
+#pragma mark Debugging
+
++ (void)setReportsWaitTimes:(BOOL)newValue;
+{
+    reportsWaitTimes = newValue;
+}
+
++ (BOOL)reportsWaitTimes;
+{
+    return reportsWaitTimes;
+}
+
+- (void)reportWaitOfType:(NSString *)waitType startingAt:(CFAbsoluteTime)startTime;
+{
+    if (!reportsWaitTimes)
+    {
+        return;
+    }
+
+    NSLog(@"%@ fence wait for %@: %f ms", waitType, _label, 1000.0 * (CFAbsoluteTimeGetCurrent() - startTime));
+}
+
+@end
@@ -1,5 +1,8 @@
 #import "GPUImageOutput.h"
 
+@class GPUImageFence;
+@class GPUImageParameterAnimation;
+
 #define STRINGIZE(x) #x
 #define STRINGIZE2(x) STRINGIZE(x)
 #define SHADER_STRING(text) @ STRINGIZE2(text)
@@ -53,23 +56,36 @@ typedef struct GPUMatrix3x3 GPUMatrix3x3;
     GLfloat backgroundColorRed, backgroundColorGreen, backgroundColorBlue, backgroundColorAlpha;
     
     BOOL preparedToCaptureImage;
+    GPUImageFence *imageCaptureFence;
     
     CVOpenGLESTextureCacheRef filterTextureCache;
     CVPixelBufferRef renderTarget;
     CVOpenGLESTextureRef renderTexture;
     
-    CGSize currentFilterSize;
+    CGSize currentFilterSize, originallySuppliedInputSize;
     GPUImageRotationMode inputRotation;
     
     BOOL currentlyReceivingMonochromeInput;
     
     NSMutableDictionary *uniformStateRestorationBlocks;
+    
+    CGRect inputChangedRegion, outputChangedRegion, framebufferValidRegion;
+    BOOL hasReceivedInputChangedRegion, framebufferHoldsPreviousFrame;
+    BOOL outputTextureIsMonochrome;
+    
+    NSMutableArray *parameterAnimationBindings;
 }
 
 @property(readonly) CVPixelBufferRef renderTarget;
 @property(readwrite, nonatomic) BOOL preventRendering;
 @property(readwrite, nonatomic) BOOL currentlyReceivingMonochromeInput;
 
+/** The precision of the texture this filter renders into, which defaults to 8 bits per component
+ 
+ Half or full float output keeps intermediate results of multipass effects, such as reductions, derivatives or iterative blends, from being quantized at every stage. Devices that can't render into and linearly filter the requested precision fall back to the nearest lower one. High precision outputs aren't rendered into texture caches, so filters whose output is read back to the CPU are best left at 8 bits.
+ */
+@property(readwrite, nonatomic) GPUImageTexturePrecision outputTexturePrecision;
+
 /// @name Initialization and teardown
 
 /**
@@ -105,6 +121,12 @@ typedef struct GPUMatrix3x3 GPUMatrix3x3;
  */
 - (CGSize)sizeOfFBO;
 - (void)createFilterFBOofSize:(CGSize)currentFBOSize;
+/** The GL type to allocate this filter's render targets with, given outputTexturePrecision and what the device supports
+ */
+- (GLenum)outputTextureType;
+/** Whether the render target can be a single channel texture, which takes a quarter of the bandwidth of RGBA. That's the case when this filter provides monochrome output, every target wants monochrome input and the device supports GL_EXT_texture_rg.
+ */
+- (BOOL)rendersMonochromeOutputIntoRedTexture;
 
 /** Destroy the current filter frame buffer object
  */
@@ -118,6 +140,37 @@ typedef struct GPUMatrix3x3 GPUMatrix3x3;
 - (void)renderToTextureWithVertices:(const GLfloat *)vertices textureCoordinates:(const GLfloat *)textureCoordinates sourceTexture:(GLuint)sourceTexture;
 - (void)informTargetsAboutNewFrameAtTime:(CMTime)frameTime;
 - (CGSize)outputFrameSize;
+/** The size of the frames last sent to this filter, turned to match its input rotation, before any cropping or forced processing size is applied
+ */
+- (CGSize)originallySuppliedInputSize;
+
+/// @name Changed regions
+
+/** The part of this filter's output that changes when a region of one of its inputs changes
+ 
+ Only that part gets redrawn, with the rest of the framebuffer left holding the previous frame. The default assumes that the shader could sample its input anywhere, so any change redraws the whole frame. Filters whose output pixels depend only on nearby input pixels override this.
+ 
+ @param inputRegion The changed region of the input, in normalized coordinates, already rotated to match this filter's output. May be CGRectNull.
+ @param textureIndex The input that changed
+ @return The affected region of the output, in normalized coordinates, or CGRectNull if the output doesn't change
+ */
+- (CGRect)outputRegionAffectedByInputRegion:(CGRect)inputRegion atIndex:(NSInteger)textureIndex;
+
+/** The part of one of this filter's inputs that it reads to draw a region of its output
+ 
+ This is the other direction from outputRegionAffectedByInputRegion:atIndex:, and filters that override one override the other. It is used to work out how much of each input the targets of this filter will end up reading, so that the filters upstream only draw that much.
+ 
+ @param outputRegion A non-empty region of the output, in normalized coordinates
+ @param textureIndex The input being read
+ @return The region of the input, in normalized coordinates rotated to match this filter's output
+ */
+- (CGRect)inputRegionNeededForOutputRegion:(CGRect)outputRegion atIndex:(NSInteger)textureIndex;
+- (CGRect)outputRegionChangedSinceLastFrame;
+- (void)calculateOutputChangedRegion;
+- (CGRect)rotatedRegion:(CGRect)regionToRotate forRotation:(GPUImageRotationMode)rotation;
+- (CGRect)unrotatedRegion:(CGRect)regionToUnrotate forRotation:(GPUImageRotationMode)rotation;
+- (CGRect)region:(CGRect)regionToExpand expandedByPixels:(NSUInteger)pixelCount;
+- (void)restrictRenderingToRegion:(CGRect)regionToRender;
 
 /// @name Input parameters
 - (void)setBackgroundColorRed:(GLfloat)redComponent green:(GLfloat)greenComponent blue:(GLfloat)blueComponent alpha:(GLfloat)alphaComponent;
@@ -142,4 +195,15 @@ typedef struct GPUMatrix3x3 GPUMatrix3x3;
 - (void)setAndExecuteUniformStateCallbackAtIndex:(GLint)uniform forProgram:(GLProgram *)shaderProgram toBlock:(dispatch_block_t)uniformStateBlock;
 - (void)setUniformsForProgramAtIndex:(NSUInteger)programIndex;
 
+/// @name Parameter animation
+
+/** Animates a property of this filter, replacing any animation of the same property
+ 
+ The animation is sampled at the timestamp of every frame this filter renders, just before rendering it.
+ */
+- (void)addParameterAnimation:(GPUImageParameterAnimation *)animation;
+- (void)removeParameterAnimationForKey:(NSString *)key;
+- (void)removeAllParameterAnimations;
+- (void)applyParameterAnimationsAtTime:(CMTime)frameTime;
+
 @end
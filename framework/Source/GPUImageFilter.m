@@ -1,5 +1,7 @@
 #import "GPUImageFilter.h"
 #import "GPUImagePicture.h"
+#import "GPUImageFence.h"
+#import "GPUImageParameterAnimation.h"
 #import <AVFoundation/AVFoundation.h>
 
 // Hardcode the vertex shader for standard filters, but this can be overridden
@@ -37,6 +39,7 @@ void dataProviderUnlockCallback (void *info, const void *data, size_t size);
 @synthesize renderTarget;
 @synthesize preventRendering = _preventRendering;
 @synthesize currentlyReceivingMonochromeInput;
+@synthesize outputTexturePrecision = _outputTexturePrecision;
 
 #pragma mark -
 #pragma mark Initialization and teardown
@@ -49,6 +52,7 @@ void dataProviderUnlockCallback (void *info, const void *data, size_t size);
     }
 
     uniformStateRestorationBlocks = [NSMutableDictionary dictionaryWithCapacity:10];
+    parameterAnimationBindings = [[NSMutableArray alloc] init];
     preparedToCaptureImage = NO;
     _preventRendering = NO;
     currentlyReceivingMonochromeInput = NO;
@@ -57,6 +61,11 @@ void dataProviderUnlockCallback (void *info, const void *data, size_t size);
     backgroundColorGreen = 0.0;
     backgroundColorBlue = 0.0;
     backgroundColorAlpha = 0.0;
+    inputChangedRegion = kGPUImageFullFrameRegion;
+    outputChangedRegion = kGPUImageFullFrameRegion;
+    framebufferValidRegion = CGRectNull;
+    hasReceivedInputChangedRegion = NO;
+    framebufferHoldsPreviousFrame = NO;
     
     runSynchronouslyOnVideoProcessingQueue(^{
         [GPUImageOpenGLESContext useImageProcessingContext];
@@ -184,8 +193,8 @@ void dataProviderUnlockCallback (void *info, const void *data, size_t size)
         CGDataProviderRef dataProvider;
         if ([GPUImageOpenGLESContext supportsFastTextureUpload] && preparedToCaptureImage)
         {
-            //        glFlush();
-            glFinish();
+            // Only wait for the rendering of this filter's output, not anything enqueued after it
+            [imageCaptureFence waitUntilCompleted];
             CFRetain(renderTarget); // I need to retain the pixel buffer here and release in the data source callback to prevent its bytes from being prematurely deallocated during a photo write operation
             CVPixelBufferLockBaseAddress(renderTarget, 0);
             self.preventRendering = YES; // Locks don't seem to work, so prevent any rendering to the filter which might overwrite the pixel buffer data until done processing
@@ -278,12 +287,25 @@ void dataProviderUnlockCallback (void *info, const void *data, size_t size)
     }
 }
 
+- (GLenum)outputTextureType;
+{
+    return [GPUImageOpenGLESContext textureTypeForPrecision:_outputTexturePrecision];
+}
+
+- (BOOL)rendersMonochromeOutputIntoRedTexture;
+{
+    // Captured images are read from a BGRA texture cache, so they keep an RGBA target
+    return [self providesMonochromeOutput] && allTargetsWantMonochromeData && ([targets count] > 0) && !preparedToCaptureImage && ([self outputTextureType] == GL_UNSIGNED_BYTE) && [GPUImageOpenGLESContext deviceSupportsRedTextures];
+}
+
 - (void)createFilterFBOofSize:(CGSize)currentFBOSize;
 {
     runSynchronouslyOnVideoProcessingQueue(^{
         [GPUImageOpenGLESContext useImageProcessingContext];
         glActiveTexture(GL_TEXTURE1);
         
+        framebufferHoldsPreviousFrame = NO;
+        outputTextureIsMonochrome = NO;
         glGenFramebuffers(1, &filterFramebuffer);
         glBindFramebuffer(GL_FRAMEBUFFER, filterFramebuffer);
         
@@ -347,16 +369,19 @@ void dataProviderUnlockCallback (void *info, const void *data, size_t size)
         {
             [self initializeOutputTextureIfNeeded];
             
+            outputTextureIsMonochrome = [self rendersMonochromeOutputIntoRedTexture];
+
             glBindTexture(GL_TEXTURE_2D, outputTexture);
             
-//            if ([self providesMonochromeOutput] && [GPUImageOpenGLESContext deviceSupportsRedTextures])
-//            {
-//                glTexImage2D(GL_TEXTURE_2D, 0, GL_RG_EXT, (int)currentFBOSize.width, (int)currentFBOSize.height, 0, GL_RG_EXT, GL_UNSIGNED_BYTE, 0);
-//            }
-//            else
-//            {
-                glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, (int)currentFBOSize.width, (int)currentFBOSize.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, 0);
-//            }
+            // Targets that want monochrome input only read the red channel
+            if (outputTextureIsMonochrome)
+            {
+                glTexImage2D(GL_TEXTURE_2D, 0, GL_RED_EXT, (int)currentFBOSize.width, (int)currentFBOSize.height, 0, GL_RED_EXT, GL_UNSIGNED_BYTE, 0);
+            }
+            else
+            {
+                glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, (int)currentFBOSize.width, (int)currentFBOSize.height, 0, GL_RGBA, [self outputTextureType], 0);
+            }
             glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, outputTexture, 0);
             
             [self notifyTargetsAboutNewOutputTexture];
@@ -373,6 +398,8 @@ void dataProviderUnlockCallback (void *info, const void *data, size_t size)
 
 - (void)destroyFilterFBO;
 {
+    framebufferHoldsPreviousFrame = NO;
+    
     if (filterFramebuffer)
 	{
         runSynchronouslyOnVideoProcessingQueue(^{
@@ -402,6 +429,12 @@ void dataProviderUnlockCallback (void *info, const void *data, size_t size)
 
 - (void)setFilterFBO;
 {
+    // The render target switches between one channel and four as targets that want monochrome input come and go
+    if (filterFramebuffer && (outputTextureIsMonochrome != [self rendersMonochromeOutputIntoRedTexture]))
+    {
+        [self destroyFilterFBO];
+    }
+    
     if (!filterFramebuffer)
     {
         CGSize currentFBOSize = [self sizeOfFBO];
@@ -500,12 +533,15 @@ void dataProviderUnlockCallback (void *info, const void *data, size_t size)
 {
     if (self.preventRendering)
     {
+        // This frame's changes are being dropped, so the next frame can't build on what's in the framebuffer
+        framebufferHoldsPreviousFrame = NO;
         return;
     }
     
     [GPUImageOpenGLESContext setActiveShaderProgram:filterProgram];
     [self setFilterFBO];
     [self setUniformsForProgramAtIndex:0];
+    [self restrictRenderingToRegion:outputChangedRegion];
     
     glClearColor(backgroundColorRed, backgroundColorGreen, backgroundColorBlue, backgroundColorAlpha);
     glClear(GL_COLOR_BUFFER_BIT);
@@ -519,10 +555,24 @@ void dataProviderUnlockCallback (void *info, const void *data, size_t size)
 	glVertexAttribPointer(filterTextureCoordinateAttribute, 2, GL_FLOAT, 0, 0, textureCoordinates);
     
     glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    
+    glDisable(GL_SCISSOR_TEST);
+    framebufferHoldsPreviousFrame = YES;
 }
 
 - (void)informTargetsAboutNewFrameAtTime:(CMTime)frameTime;
 {
+    // Fence the finished frame before the completion block runs, since that's where most captures read it back
+    if ([GPUImageOpenGLESContext supportsFastTextureUpload] && preparedToCaptureImage)
+    {
+        [imageCaptureFence insert];
+    }
+    else
+    {
+        // Texture cache render targets can't be mipmapped, but anything else drawn at a reduced scale downstream can be
+        [self generateMipmapsForTargetsIfNeededWithOutputSize:[self sizeOfFBO]];
+    }
+    
     if (self.frameProcessingCompletionBlock != NULL)
     {
         self.frameProcessingCompletionBlock(self, frameTime);
@@ -532,20 +582,32 @@ void dataProviderUnlockCallback (void *info, const void *data, size_t size)
     
     for (id<GPUImageInput> currentTarget in targets)
     {
-        if (currentTarget != self.targetToIgnoreForUpdates)
+        NSInteger indexOfObject = [targets indexOfObject:currentTarget];
+        NSInteger textureIndex = [[targetTextureIndices objectAtIndex:indexOfObject] integerValue];
+        
+        // Even targets that ignore updates from here will sample this output the next time they render, so they need to know what changed
+        [self setInputChangedRegion:outputChangedRegion forTarget:currentTarget atIndex:textureIndex];
+        
+        if ( (currentTarget != self.targetToIgnoreForUpdates) && [self shouldSendFrameAtTime:frameTime toTarget:currentTarget] )
         {
-            NSInteger indexOfObject = [targets indexOfObject:currentTarget];
-            NSInteger textureIndex = [[targetTextureIndices objectAtIndex:indexOfObject] integerValue];
-            
             if ([GPUImageOpenGLESContext supportsFastTextureUpload] && preparedToCaptureImage)
             {
                 [self setInputTextureForTarget:currentTarget atIndex:textureIndex];
             }
             
+            // Like the luminance plane from a camera, monochrome output lets such targets skip their own luminance conversion
+            if ([currentTarget wantsMonochromeInput])
+            {
+                [currentTarget setCurrentlyReceivingMonochromeInput:[self providesMonochromeOutput]];
+            }
+            
             [currentTarget setInputSize:[self outputFrameSize] atIndex:textureIndex];
             [currentTarget newFrameReadyAtTime:frameTime atIndex:textureIndex];
         }
     }
+    
+    // Anything that renders without calculating a changed region redraws the whole frame
+    outputChangedRegion = kGPUImageFullFrameRegion;
 }
 
 - (CGSize)outputFrameSize;
@@ -553,14 +615,168 @@ void dataProviderUnlockCallback (void *info, const void *data, size_t size)
     return inputTextureSize;
 }
 
-- (void)prepareForImageCapture;
+- (CGSize)originallySuppliedInputSize;
+{
+    return originallySuppliedInputSize;
+}
+
+#pragma mark -
+#pragma mark Changed regions
+
+- (CGRect)outputRegionAffectedByInputRegion:(CGRect)inputRegion atIndex:(NSInteger)textureIndex;
+{
+    return kGPUImageFullFrameRegion;
+}
+
+- (CGRect)inputRegionNeededForOutputRegion:(CGRect)outputRegion atIndex:(NSInteger)textureIndex;
+{
+    return kGPUImageFullFrameRegion;
+}
+
+- (CGRect)outputRegionOfInterest;
 {
+    // A captured image is read back in full, whatever the targets want
     if (preparedToCaptureImage)
+    {
+        return kGPUImageFullFrameRegion;
+    }
+    
+    return [super outputRegionOfInterest];
+}
+
+- (CGRect)outputRegionChangedSinceLastFrame;
+{
+    CGRect changedRegion = hasReceivedInputChangedRegion ? inputChangedRegion : kGPUImageFullFrameRegion;
+    hasReceivedInputChangedRegion = NO;
+    
+    return [self outputRegionAffectedByInputRegion:[self rotatedRegion:changedRegion forRotation:inputRotation] atIndex:0];
+}
+
+- (void)calculateOutputChangedRegion;
+{
+    CGRect changedRegion = CGRectIntersection([self outputRegionChangedSinceLastFrame], kGPUImageFullFrameRegion);
+    CGRect regionOfInterest = [self outputRegionOfInterest];
+    
+    // Only the part of the framebuffer that has been drawn since it last went out of date holds the last frame
+    if (!framebufferHoldsPreviousFrame)
+    {
+        framebufferValidRegion = CGRectNull;
+    }
+    
+    if (CGRectIsEmpty(regionOfInterest))
+    {
+        // Nothing downstream will read this frame, and what changed in it is now out of date
+        outputChangedRegion = CGRectNull;
+        if (!CGRectIsEmpty(changedRegion))
+        {
+            framebufferValidRegion = CGRectNull;
+        }
+    }
+    else if (CGRectContainsRect(framebufferValidRegion, regionOfInterest))
+    {
+        // Redrawing only part of the frame relies on the rest of what the targets read still holding the last frame. Changes outside of that are left out of date.
+        outputChangedRegion = CGRectIntersection(changedRegion, regionOfInterest);
+        if (!CGRectIsEmpty(changedRegion) && !CGRectContainsRect(regionOfInterest, changedRegion))
+        {
+            framebufferValidRegion = regionOfInterest;
+        }
+    }
+    else
+    {
+        outputChangedRegion = regionOfInterest;
+        framebufferValidRegion = regionOfInterest;
+    }
+}
+
+- (CGRect)rotatedRegion:(CGRect)regionToRotate forRotation:(GPUImageRotationMode)rotation;
+{
+    if (CGRectIsNull(regionToRotate) || (rotation == kGPUImageNoRotation))
+    {
+        return regionToRotate;
+    }
+    
+    // rotatedPoint:forRotation: maps output coordinates back to input ones, so going the other way needs the opposite rotation. The remaining modes are their own inverses.
+    GPUImageRotationMode inverseRotation = rotation;
+    if (rotation == kGPUImageRotateLeft)
+    {
+        inverseRotation = kGPUImageRotateRight;
+    }
+    else if (rotation == kGPUImageRotateRight)
+    {
+        inverseRotation = kGPUImageRotateLeft;
+    }
+    
+    CGPoint firstCorner = [self rotatedPoint:CGPointMake(CGRectGetMinX(regionToRotate), CGRectGetMinY(regionToRotate)) forRotation:inverseRotation];
+    CGPoint oppositeCorner = [self rotatedPoint:CGPointMake(CGRectGetMaxX(regionToRotate), CGRectGetMaxY(regionToRotate)) forRotation:inverseRotation];
+    
+    return CGRectStandardize(CGRectMake(firstCorner.x, firstCorner.y, oppositeCorner.x - firstCorner.x, oppositeCorner.y - firstCorner.y));
+}
+
+- (CGRect)unrotatedRegion:(CGRect)regionToUnrotate forRotation:(GPUImageRotationMode)rotation;
+{
+    if (CGRectIsNull(regionToUnrotate) || (rotation == kGPUImageNoRotation))
+    {
+        return regionToUnrotate;
+    }
+    
+    CGPoint firstCorner = [self rotatedPoint:CGPointMake(CGRectGetMinX(regionToUnrotate), CGRectGetMinY(regionToUnrotate)) forRotation:rotation];
+    CGPoint oppositeCorner = [self rotatedPoint:CGPointMake(CGRectGetMaxX(regionToUnrotate), CGRectGetMaxY(regionToUnrotate)) forRotation:rotation];
+    
+    return CGRectStandardize(CGRectMake(firstCorner.x, firstCorner.y, oppositeCorner.x - firstCorner.x, oppositeCorner.y - firstCorner.y));
+}
+
+- (CGRect)region:(CGRect)regionToExpand expandedByPixels:(NSUInteger)pixelCount;
+{
+    if (CGRectIsNull(regionToExpand) || (pixelCount == 0))
+    {
+        return regionToExpand;
+    }
+    
+    CGSize currentFBOSize = [self sizeOfFBO];
+    if ( (currentFBOSize.width < 1.0) || (currentFBOSize.height < 1.0) )
+    {
+        return kGPUImageFullFrameRegion;
+    }
+    
+    return CGRectInset(regionToExpand, -(CGFloat)pixelCount / currentFBOSize.width, -(CGFloat)pixelCount / currentFBOSize.height);
+}
+
+- (void)restrictRenderingToRegion:(CGRect)regionToRender;
+{
+    if (CGRectEqualToRect(regionToRender, kGPUImageFullFrameRegion))
+    {
+        glDisable(GL_SCISSOR_TEST);
+        return;
+    }
+    
+    glEnable(GL_SCISSOR_TEST);
+    
+    if (CGRectIsEmpty(regionToRender))
+    {
+        glScissor(0, 0, 0, 0);
+        return;
+    }
+    
+    // Round outward to whole pixels. Row 0 of the framebuffer is the top of the image, the same as in normalized coordinates.
+    CGSize currentFBOSize = [self sizeOfFBO];
+    GLint minX = (GLint)floor(CGRectGetMinX(regionToRender) * currentFBOSize.width);
+    GLint minY = (GLint)floor(CGRectGetMinY(regionToRender) * currentFBOSize.height);
+    GLint maxX = (GLint)ceil(CGRectGetMaxX(regionToRender) * currentFBOSize.width);
+    GLint maxY = (GLint)ceil(CGRectGetMaxY(regionToRender) * currentFBOSize.height);
+    
+    glScissor(minX, minY, maxX - minX, maxY - minY);
+}
+
+- (void)prepareForImageCapture;
+{
+    // Texture caches only hold 8-bit BGRA, so higher precision output is captured through glReadPixels instead
+    if (preparedToCaptureImage || ([self outputTextureType] != GL_UNSIGNED_BYTE))
     {
         return;
     }
 
     preparedToCaptureImage = YES;
+    imageCaptureFence = [[GPUImageFence alloc] initWithLabel:NSStringFromClass([self class])];
     
     if ([GPUImageOpenGLESContext supportsFastTextureUpload])
     {
@@ -585,6 +801,8 @@ void dataProviderUnlockCallback (void *info, const void *data, size_t size)
     backgroundColorGreen = greenComponent;
     backgroundColorBlue = blueComponent;
     backgroundColorAlpha = alphaComponent;
+    
+    framebufferHoldsPreviousFrame = NO;
 }
 
 - (void)setInteger:(GLint)newInteger forUniformName:(NSString *)uniformName;
@@ -737,6 +955,9 @@ void dataProviderUnlockCallback (void *info, const void *data, size_t size)
 {
     [uniformStateRestorationBlocks setObject:[uniformStateBlock copy] forKey:[NSNumber numberWithInt:uniform]];
     uniformStateBlock();
+    
+    // A new parameter changes every pixel, not just the ones in the next changed region
+    framebufferHoldsPreviousFrame = NO;
 }
 
 - (void)setUniformsForProgramAtIndex:(NSUInteger)programIndex;
@@ -747,12 +968,60 @@ void dataProviderUnlockCallback (void *info, const void *data, size_t size)
     }];
 }
 
+#pragma mark -
+#pragma mark Parameter animation
+
+- (void)addParameterAnimation:(GPUImageParameterAnimation *)animation;
+{
+    // Animations are sampled while rendering, so the list only changes between frames. Each filter has its own binding, so the same animation can drive several filters
+    runSynchronouslyOnVideoProcessingQueue(^{
+        GPUImageParameterAnimationBinding *binding = [[GPUImageParameterAnimationBinding alloc] initWithAnimation:animation target:self];
+        if (binding == nil)
+        {
+            return;
+        }
+        
+        [self removeParameterAnimationForKey:animation.key];
+        [parameterAnimationBindings addObject:binding];
+    });
+}
+
+- (void)removeParameterAnimationForKey:(NSString *)key;
+{
+    runSynchronouslyOnVideoProcessingQueue(^{
+        for (NSUInteger bindingIndex = 0; bindingIndex < [parameterAnimationBindings count]; bindingIndex++)
+        {
+            if ([[[[parameterAnimationBindings objectAtIndex:bindingIndex] animation] key] isEqualToString:key])
+            {
+                [parameterAnimationBindings removeObjectAtIndex:bindingIndex];
+                return;
+            }
+        }
+    });
+}
+
+- (void)removeAllParameterAnimations;
+{
+    runSynchronouslyOnVideoProcessingQueue(^{
+        [parameterAnimationBindings removeAllObjects];
+    });
+}
+
+- (void)applyParameterAnimationsAtTime:(CMTime)frameTime;
+{
+    // This is already on the video processing queue, so the setters set their uniforms right away instead of queueing blocks to do it
+    for (GPUImageParameterAnimationBinding *binding in parameterAnimationBindings)
+    {
+        [binding applyAtFrameTime:frameTime];
+    }
+}
+
 #pragma mark -
 #pragma mark GPUImageInput
 
 - (void)newFrameReadyAtTime:(CMTime)frameTime atIndex:(NSInteger)textureIndex;
 {
-    outputTextureRetainCount = [targets count];
+    outputTextureRetainCount = [self numberOfTargetsToSendFrameAtTime:frameTime];
     
     static const GLfloat imageVertices[] = {
         -1.0f, -1.0f,
@@ -761,6 +1030,8 @@ void dataProviderUnlockCallback (void *info, const void *data, size_t size)
         1.0f,  1.0f,
     };
     
+    [self applyParameterAnimationsAtTime:frameTime];
+    [self calculateOutputChangedRegion];
     [self renderToTextureWithVertices:imageVertices textureCoordinates:[[self class] textureCoordinatesForRotation:inputRotation] sourceTexture:filterSourceTexture];
 
     [self informTargetsAboutNewFrameAtTime:frameTime];
@@ -773,9 +1044,32 @@ void dataProviderUnlockCallback (void *info, const void *data, size_t size)
 
 - (void)setInputTexture:(GLuint)newInputTexture atIndex:(NSInteger)textureIndex;
 {
+    if (newInputTexture != filterSourceTexture)
+    {
+        framebufferHoldsPreviousFrame = NO;
+    }
+    
     filterSourceTexture = newInputTexture;
 }
 
+- (void)setInputChangedRegion:(CGRect)changedRegion atIndex:(NSInteger)textureIndex;
+{
+    inputChangedRegion = hasReceivedInputChangedRegion ? CGRectUnion(inputChangedRegion, changedRegion) : changedRegion;
+    hasReceivedInputChangedRegion = YES;
+}
+
+- (CGRect)inputRegionOfInterestAtIndex:(NSInteger)textureIndex;
+{
+    CGRect regionOfInterest = [self outputRegionOfInterest];
+    if (CGRectIsEmpty(regionOfInterest))
+    {
+        return CGRectNull;
+    }
+    
+    CGRect inputRegion = [self inputRegionNeededForOutputRegion:regionOfInterest atIndex:textureIndex];
+    return CGRectIntersection([self unrotatedRegion:inputRegion forRotation:inputRotation], kGPUImageFullFrameRegion);
+}
+
 - (void)recreateFilterFBO
 {
     cachedMaximumOutputSize = CGSizeZero;
@@ -851,6 +1145,9 @@ void dataProviderUnlockCallback (void *info, const void *data, size_t size)
         return;
     }
     
+    CGSize rotatedSize = [self rotatedSize:newSize forIndex:textureIndex];
+    originallySuppliedInputSize = rotatedSize;
+    
     if (overrideInputSize)
     {
         if (CGSizeEqualToSize(forcedMaximumSize, CGSizeZero))
@@ -865,8 +1162,6 @@ void dataProviderUnlockCallback (void *info, const void *data, size_t size)
         }
     }
     
-    CGSize rotatedSize = [self rotatedSize:newSize forIndex:textureIndex];
-    
     if (CGSizeEqualToSize(rotatedSize, CGSizeZero))
     {
         inputTextureSize = rotatedSize;
@@ -880,6 +1175,11 @@ void dataProviderUnlockCallback (void *info, const void *data, size_t size)
 
 - (void)setInputRotation:(GPUImageRotationMode)newInputRotation atIndex:(NSInteger)textureIndex;
 {
+    if (newInputRotation != inputRotation)
+    {
+        framebufferHoldsPreviousFrame = NO;
+    }
+    
     inputRotation = newInputRotation;
 }
 
@@ -1006,7 +1306,54 @@ void dataProviderUnlockCallback (void *info, const void *data, size_t size)
     return NO;
 }
 
+- (BOOL)wantsMipmappedInputOfSize:(CGSize)inputSize atIndex:(NSInteger)textureIndex;
+{
+    CGSize renderedSize = [self sizeOfFBO];
+    if (GPUImageRotationSwapsWidthAndHeight(inputRotation))
+    {
+        inputSize = CGSizeMake(inputSize.height, inputSize.width);
+    }
+    
+    // Implicit derivatives pick the matching level once the output is half the input or less along either axis
+    if ( (renderedSize.width <= 0.0) || (renderedSize.height <= 0.0) )
+    {
+        return NO;
+    }
+    
+    return ( (renderedSize.width * 2.0 <= inputSize.width) || (renderedSize.height * 2.0 <= inputSize.height) );
+}
+
+- (BOOL)wantsNextFrame;
+{
+    // A captured image or a per-frame callback can consume the output even when no target does
+    if (preparedToCaptureImage || (self.frameProcessingCompletionBlock != NULL))
+    {
+        return YES;
+    }
+    
+    return [self anyTargetWantsNextFrame];
+}
+
 #pragma mark -
 #pragma mark Accessors
 
+- (void)setOutputTexturePrecision:(GPUImageTexturePrecision)newValue;
+{
+    if (newValue == _outputTexturePrecision)
+    {
+        return;
+    }
+    
+    _outputTexturePrecision = newValue;
+    
+    runSynchronouslyOnVideoProcessingQueue(^{
+        if ([self outputTextureType] != GL_UNSIGNED_BYTE)
+        {
+            preparedToCaptureImage = NO;
+        }
+        
+        [self recreateFilterFBO];
+    });
+}
+
 @end
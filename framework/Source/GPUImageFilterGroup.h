@@ -10,6 +10,9 @@
 @property(readwrite, nonatomic, strong) NSArray *initialFilters;
 @property(readwrite, nonatomic, strong) GPUImageOutput<GPUImageInput> *inputFilterToIgnoreForUpdates; 
 
+// Sets the render target precision of every filter in the group, including ones added later, so a whole multipass effect can be kept at half or full float
+@property(readwrite, nonatomic) GPUImageTexturePrecision outputTexturePrecision;
+
 // Filter management
 - (void)addFilter:(GPUImageOutput<GPUImageInput> *)newFilter;
 - (GPUImageOutput<GPUImageInput> *)filterAtIndex:(NSUInteger)filterIndex;
@@ -6,6 +6,7 @@
 @synthesize terminalFilter = _terminalFilter;
 @synthesize initialFilters = _initialFilters;
 @synthesize inputFilterToIgnoreForUpdates = _inputFilterToIgnoreForUpdates;
+@synthesize outputTexturePrecision = _outputTexturePrecision;
 
 - (id)init;
 {
@@ -25,6 +26,11 @@
 - (void)addFilter:(GPUImageOutput<GPUImageInput> *)newFilter;
 {
     [filters addObject:newFilter];
+    
+    if ((_outputTexturePrecision != kGPUImageTexturePrecisionUnsignedByte) && [newFilter respondsToSelector:@selector(setOutputTexturePrecision:)])
+    {
+        [(GPUImageFilter *)newFilter setOutputTexturePrecision:_outputTexturePrecision];
+    }
 }
 
 - (GPUImageOutput<GPUImageInput> *)filterAtIndex:(NSUInteger)filterIndex;
@@ -37,6 +43,19 @@
     return [filters count];
 }
 
+- (void)setOutputTexturePrecision:(GPUImageTexturePrecision)newValue;
+{
+    _outputTexturePrecision = newValue;
+    
+    for (GPUImageOutput<GPUImageInput> *currentFilter in filters)
+    {
+        if ([currentFilter respondsToSelector:@selector(setOutputTexturePrecision:)])
+        {
+            [(GPUImageFilter *)currentFilter setOutputTexturePrecision:newValue];
+        }
+    }
+}
+
 #pragma mark -
 #pragma mark Still image processing
 
@@ -73,6 +92,36 @@
     [_terminalFilter removeAllTargets];
 }
 
+- (void)handOffTarget:(id<GPUImageInput>)targetToHandOff;
+{
+    [_terminalFilter handOffTarget:targetToHandOff];
+}
+
+- (NSArray *)targets;
+{
+    return [_terminalFilter targets];
+}
+
+- (CGRect)outputRegionOfInterest;
+{
+    return [_terminalFilter outputRegionOfInterest];
+}
+
+- (NSUInteger)pixelFootprintRadius;
+{
+    NSUInteger widestRadius = 0;
+    for (GPUImageOutput<GPUImageInput> *currentFilter in _initialFilters)
+    {
+        NSUInteger radiusThroughGroup = [currentFilter pixelFootprintRadiusAlongPathToTarget:_terminalFilter];
+        if ( (radiusThroughGroup != NSNotFound) && (radiusThroughGroup > widestRadius) )
+        {
+            widestRadius = radiusThroughGroup;
+        }
+    }
+    
+    return widestRadius;
+}
+
 - (void)setFrameProcessingCompletionBlock:(void (^)(GPUImageOutput *, CMTime))frameProcessingCompletionBlock;
 {
     [_terminalFilter setFrameProcessingCompletionBlock:frameProcessingCompletionBlock];
@@ -88,24 +137,32 @@
 
 - (void)newFrameReadyAtTime:(CMTime)frameTime atIndex:(NSInteger)textureIndex;
 {
-    outputTextureRetainCount = [_initialFilters count];
-    
+    NSMutableArray *filtersToUpdate = [[NSMutableArray alloc] initWithCapacity:[_initialFilters count]];
     for (GPUImageOutput<GPUImageInput> *currentFilter in _initialFilters)
     {
-        if (currentFilter != self.inputFilterToIgnoreForUpdates)
+        if ( (currentFilter != self.inputFilterToIgnoreForUpdates) && [self shouldSendFrameAtTime:frameTime toTarget:currentFilter] )
         {
-            [currentFilter newFrameReadyAtTime:frameTime atIndex:textureIndex];
+            [filtersToUpdate addObject:currentFilter];
         }
     }
+    
+    outputTextureRetainCount = [filtersToUpdate count];
+    
+    for (GPUImageOutput<GPUImageInput> *currentFilter in filtersToUpdate)
+    {
+        [currentFilter newFrameReadyAtTime:frameTime atIndex:textureIndex];
+    }
 }
 
 - (void)setTextureDelegate:(id<GPUImageTextureDelegate>)newTextureDelegate atIndex:(NSInteger)textureIndex;
 {
     firstTextureDelegate = newTextureDelegate;
     
+    // A source going away is passed on as such, so that the filters inside can tell a removed input from a connected one
+    id<GPUImageTextureDelegate> delegateForInitialFilters = (newTextureDelegate != nil) ? self : nil;
     for (GPUImageOutput<GPUImageInput> *currentFilter in _initialFilters)
     {
-        [currentFilter setTextureDelegate:self atIndex:textureIndex];
+        [currentFilter setTextureDelegate:delegateForInitialFilters atIndex:textureIndex];
     }
 }
 
@@ -117,6 +174,33 @@
     }
 }
 
+- (void)setInputChangedRegion:(CGRect)changedRegion atIndex:(NSInteger)textureIndex;
+{
+    for (GPUImageOutput<GPUImageInput> *currentFilter in _initialFilters)
+    {
+        if ([currentFilter respondsToSelector:@selector(setInputChangedRegion:atIndex:)])
+        {
+            [currentFilter setInputChangedRegion:changedRegion atIndex:textureIndex];
+        }
+    }
+}
+
+- (CGRect)inputRegionOfInterestAtIndex:(NSInteger)textureIndex;
+{
+    CGRect regionOfInterest = CGRectNull;
+    for (GPUImageOutput<GPUImageInput> *currentFilter in _initialFilters)
+    {
+        if (![currentFilter respondsToSelector:@selector(inputRegionOfInterestAtIndex:)])
+        {
+            return kGPUImageFullFrameRegion;
+        }
+        
+        regionOfInterest = CGRectUnion(regionOfInterest, [currentFilter inputRegionOfInterestAtIndex:textureIndex]);
+    }
+    
+    return regionOfInterest;
+}
+
 - (NSInteger)nextAvailableTextureIndex;
 {
 //    if ([_initialFilters count] > 0)
@@ -208,6 +292,32 @@
     }
 }
 
+- (BOOL)wantsMipmappedInputOfSize:(CGSize)inputSize atIndex:(NSInteger)textureIndex;
+{
+    for (GPUImageOutput<GPUImageInput> *currentFilter in _initialFilters)
+    {
+        if ([currentFilter respondsToSelector:@selector(wantsMipmappedInputOfSize:atIndex:)] && [currentFilter wantsMipmappedInputOfSize:inputSize atIndex:textureIndex])
+        {
+            return YES;
+        }
+    }
+    
+    return NO;
+}
+
+- (BOOL)wantsNextFrame;
+{
+    for (GPUImageOutput<GPUImageInput> *currentFilter in _initialFilters)
+    {
+        if ( (currentFilter != self.inputFilterToIgnoreForUpdates) && [self targetWantsNextFrame:currentFilter] )
+        {
+            return YES;
+        }
+    }
+    
+    return NO;
+}
+
 #pragma mark -
 #pragma mark GPUImageTextureDelegate methods
 
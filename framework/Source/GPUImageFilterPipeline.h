@@ -1,27 +1,42 @@
 #import <Foundation/Foundation.h>
 #import "GPUImageFilter.h"
+#import "GPUImagePipelinePlan.h"
 
 @interface GPUImageFilterPipeline : NSObject
-{
-    NSString *stringValue;
-}
 
+// A copy of the filters as they are connected now. Setting this replaces all of them, like replaceAllFilters:.
 @property (strong) NSMutableArray *filters;
 
 @property (strong) GPUImageOutput *input;
 @property (strong) id <GPUImageInput> output;
 
+// The plan the filters were built from, while they are still connected as it describes. Adding or removing filters turns the pipeline back into a plain list, and clears this.
+@property (readonly, strong) GPUImagePipelinePlan *plan;
+
 - (id) initWithOrderedFilters:(NSArray*) filters input:(GPUImageOutput*)input output:(id <GPUImageInput>)output;
+- (id) initWithPlan:(GPUImagePipelinePlan*) plan input:(GPUImageOutput*)input output:(id <GPUImageInput>)output;
+
+// These compile the configuration into a GPUImagePipelinePlan, and return nil if it isn't valid. The versions without an error log it.
 - (id) initWithConfiguration:(NSDictionary*) configuration input:(GPUImageOutput*)input output:(id <GPUImageInput>)output;
+- (id) initWithConfiguration:(NSDictionary*) configuration input:(GPUImageOutput*)input output:(id <GPUImageInput>)output error:(NSError**)error;
 - (id) initWithConfigurationFile:(NSURL*) configuration input:(GPUImageOutput*)input output:(id <GPUImageInput>)output;
+- (id) initWithConfigurationFile:(NSURL*) configuration input:(GPUImageOutput*)input output:(id <GPUImageInput>)output error:(NSError**)error;
 
+// Changes to the filters are switched in atomically between frames, and are made to the filters as they are at that point, so changes from different threads or during a background switch all land. New filters have their framebuffers allocated for the current input size first, so the first frame through them doesn't stall.
 - (void) addFilter:(GPUImageFilter*)filter;
 - (void) addFilter:(GPUImageFilter*)filter atIndex:(NSUInteger)insertIndex;
 - (void) replaceFilterAtIndex:(NSUInteger)index withFilter:(GPUImageFilter*)filter;
 - (void) replaceAllFilters:(NSArray*) newFilters;
+- (void) replaceAllFiltersWithPlan:(GPUImagePipelinePlan*) plan;
+// Returns right away, and builds the new filters in the background before switching to them. The completion handler is called on the main queue once frames are going through them.
+// Only the caller is spared the wait. Filters still compile their shaders on the video processing queue, one at a time between frames, so a plan with many filters whose programs aren't cached yet can still cost frames while it builds.
+- (void) replaceAllFiltersWithPlan:(GPUImagePipelinePlan*) plan completionHandler:(void (^)(void))completionHandler;
 - (void) removeFilterAtIndex:(NSUInteger)index;
 - (void) removeAllFilters;
 
+// Filters given a Name in the plan's configuration
+- (GPUImageOutput *) filterNamed:(NSString*)filterName;
+
 - (UIImage *) currentFilteredFrame;
 - (CGImageRef) newCGImageFromCurrentFilteredFrame;
 - (CGImageRef) newCGImageFromCurrentFilteredFrameWithOrientation:(UIImageOrientation)imageOrientation;
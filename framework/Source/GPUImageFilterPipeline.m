@@ -1,138 +1,94 @@
 #import "GPUImageFilterPipeline.h"
 
-@interface GPUImageFilterPipeline ()
+// The filters and the plan they were built from, which are only ever replaced together
+@interface GPUImageFilterPipelineState : NSObject
+
+@property (readonly, strong) NSArray *filters;
+@property (readonly, strong) GPUImagePipelinePlan *plan;
+
+- (id)initWithFilters:(NSArray *)filters plan:(GPUImagePipelinePlan *)plan;
+
+@end
+
+@implementation GPUImageFilterPipelineState
 
-- (BOOL)_parseConfiguration:(NSDictionary *)configuration;
+@synthesize filters = _filters, plan = _plan;
 
-- (void)_refreshFilters;
+- (id)initWithFilters:(NSArray *)filters plan:(GPUImagePipelinePlan *)plan {
+    self = [super init];
+    if (self) {
+        _filters = [filters copy];
+        _plan = plan;
+    }
+    return self;
+}
+
+@end
+
+@interface GPUImageFilterPipeline ()
+{
+    // Only read or replaced on the video processing queue
+    GPUImageFilterPipelineState *_state;
+}
+
+- (void)_editFilters:(GPUImageFilterPipelineState *(^)(GPUImageFilterPipelineState *currentState))editBlock;
+- (void)_prepareState:(GPUImageFilterPipelineState *)newState;
+- (void)_switchToState:(GPUImageFilterPipelineState *)newState;
+- (void)_connectFiltersInOrder;
+- (NSSet *)_graphMembers;
+- (GPUImageOutput *)_terminalFilter;
 
 @end
 
 @implementation GPUImageFilterPipeline
 
-@synthesize filters = _filters, input = _input, output = _output;
+@synthesize input = _input, output = _output;
 
 #pragma mark Config file init
 
 - (id)initWithConfiguration:(NSDictionary *)configuration input:(GPUImageOutput *)input output:(id <GPUImageInput>)output {
-    self = [super init];
-    if (self) {
-        self.input = input;
-        self.output = output;
-        if (![self _parseConfiguration:configuration]) {
-            NSLog(@"Sorry, a parsing error occurred.");
-            abort();
-        }
-        [self _refreshFilters];
+    NSError *error = nil;
+    self = [self initWithConfiguration:configuration input:input output:output error:&error];
+    if (!self) {
+        NSLog(@"Couldn't set up the filter pipeline: %@", [error localizedDescription]);
     }
     return self;
 }
 
+- (id)initWithConfiguration:(NSDictionary *)configuration input:(GPUImageOutput *)input output:(id <GPUImageInput>)output error:(NSError **)error {
+    GPUImagePipelinePlan *plan = [GPUImagePipelinePlan planWithConfiguration:configuration error:error];
+    if (!plan) {
+        return nil;
+    }
+    return [self initWithPlan:plan input:input output:output];
+}
+
 - (id)initWithConfigurationFile:(NSURL *)configuration input:(GPUImageOutput *)input output:(id <GPUImageInput>)output {
-    return [self initWithConfiguration:[NSDictionary dictionaryWithContentsOfURL:configuration] input:input output:output];
+    NSError *error = nil;
+    self = [self initWithConfigurationFile:configuration input:input output:output error:&error];
+    if (!self) {
+        NSLog(@"Couldn't set up the filter pipeline: %@", [error localizedDescription]);
+    }
+    return self;
 }
 
-- (BOOL)_parseConfiguration:(NSDictionary *)configuration {
-    NSArray *filters = [configuration objectForKey:@"Filters"];
-    if (!filters) {
-        return NO;
+- (id)initWithConfigurationFile:(NSURL *)configuration input:(GPUImageOutput *)input output:(id <GPUImageInput>)output error:(NSError **)error {
+    // Files are compiled once, so loading the same preset again only builds its filters
+    GPUImagePipelinePlan *plan = [GPUImagePipelinePlan cachedPlanWithContentsOfURL:configuration error:error];
+    if (!plan) {
+        return nil;
     }
-    
-    NSError *regexError = nil;
-    NSRegularExpression *parsingRegex = [NSRegularExpression regularExpressionWithPattern:@"(float|CGPoint|NSString)\\((.*?)(?:,\\s*(.*?))*\\)"
-                                                                                  options:0
-                                                                                    error:&regexError];
-    
-    // It's faster to put them into an array and then pass it to the filters property than it is to call [self addFilter:] every time
-    NSMutableArray *orderedFilters = [NSMutableArray arrayWithCapacity:[filters count]];
-    for (NSDictionary *filter in filters) {
-        NSString *filterName = [filter objectForKey:@"FilterName"];
-        Class theClass = NSClassFromString(filterName);
-        GPUImageFilter *genericFilter = [[theClass alloc] init];
-        // Set up the properties
-        NSDictionary *filterAttributes;
-        if ((filterAttributes = [filter objectForKey:@"Attributes"])) {
-            for (NSString *propertyKey in filterAttributes) {
-                // Set up the selector
-                SEL theSelector = NSSelectorFromString(propertyKey);
-                NSInvocation *inv = [NSInvocation invocationWithMethodSignature:[theClass instanceMethodSignatureForSelector:theSelector]];
-                [inv setSelector:theSelector];
-                [inv setTarget:genericFilter];
-                
-                // check selector given with parameter
-                if ([propertyKey hasSuffix:@":"]) {
-                    
-                    stringValue = nil;
-                    
-                    // Then parse the arguments
-                    NSMutableArray *parsedArray;
-                    if ([[filterAttributes objectForKey:propertyKey] isKindOfClass:[NSArray class]]) {
-                        NSArray *array = [filterAttributes objectForKey:propertyKey];
-                        parsedArray = [NSMutableArray arrayWithCapacity:[array count]];
-                        for (NSString *string in array) {
-                            NSTextCheckingResult *parse = [parsingRegex firstMatchInString:string
-                                                                                   options:0
-                                                                                     range:NSMakeRange(0, [string length])];
-
-                            NSString *modifier = [string substringWithRange:[parse rangeAtIndex:1]];
-                            if ([modifier isEqualToString:@"float"]) {
-                                // Float modifier, one argument
-                                CGFloat value = [[string substringWithRange:[parse rangeAtIndex:2]] floatValue];
-                                [parsedArray addObject:[NSNumber numberWithFloat:value]];
-                                [inv setArgument:&value atIndex:2];
-                            } else if ([modifier isEqualToString:@"CGPoint"]) {
-                                // CGPoint modifier, two float arguments
-                                CGFloat x = [[string substringWithRange:[parse rangeAtIndex:2]] floatValue];
-                                CGFloat y = [[string substringWithRange:[parse rangeAtIndex:3]] floatValue];
-                                CGPoint value = CGPointMake(x, y);
-                                [parsedArray addObject:[NSValue valueWithCGPoint:value]];
-                            } else if ([modifier isEqualToString:@"NSString"]) {
-                                // NSString modifier, one string argument
-                                stringValue = [[string substringWithRange:[parse rangeAtIndex:2]] copy];
-                                [inv setArgument:&stringValue atIndex:2];
-                                
-                            } else {
-                                return NO;
-                            }
-                        }
-                        [inv setArgument:&parsedArray atIndex:2];
-                    } else {
-                        NSString *string = [filterAttributes objectForKey:propertyKey];
-                        NSTextCheckingResult *parse = [parsingRegex firstMatchInString:string
-                                                                               options:0
-                                                                                 range:NSMakeRange(0, [string length])];
-                        
-                        NSString *modifier = [string substringWithRange:[parse rangeAtIndex:1]];
-                        if ([modifier isEqualToString:@"float"]) {
-                            // Float modifier, one argument
-                            CGFloat value = [[string substringWithRange:[parse rangeAtIndex:2]] floatValue];
-                            [inv setArgument:&value atIndex:2];
-                        } else if ([modifier isEqualToString:@"CGPoint"]) {
-                            // CGPoint modifier, two float arguments
-                            CGFloat x = [[string substringWithRange:[parse rangeAtIndex:2]] floatValue];
-                            CGFloat y = [[string substringWithRange:[parse rangeAtIndex:3]] floatValue];
-                            CGPoint value = CGPointMake(x, y);
-                            [inv setArgument:&value atIndex:2];
-                        } else if ([modifier isEqualToString:@"NSString"]) {
-                            // NSString modifier, one string argument
-                            stringValue = [[string substringWithRange:[parse rangeAtIndex:2]] copy];
-                            [inv setArgument:&stringValue atIndex:2];
-                            
-                        } else {
-                            return NO;
-                        }
-                    }
-                }
-                
-
-                [inv invoke];
-            }
-        }
-        [orderedFilters addObject:genericFilter];
+    return [self initWithPlan:plan input:input output:output];
+}
+
+- (id)initWithPlan:(GPUImagePipelinePlan *)plan input:(GPUImageOutput *)input output:(id <GPUImageInput>)output {
+    self = [super init];
+    if (self) {
+        self.input = input;
+        self.output = output;
+        [self replaceAllFiltersWithPlan:plan];
     }
-    self.filters = orderedFilters;
-    
-    return YES;
+    return self;
 }
 
 #pragma mark Regular init
@@ -142,55 +98,215 @@
     if (self) {
         self.input = input;
         self.output = output;
-        self.filters = [NSMutableArray arrayWithArray:filters];
-        [self _refreshFilters];
+        [self replaceAllFilters:filters];
     }
     return self;
 }
 
+#pragma mark Current filters
+
+- (NSMutableArray *)filters {
+    __block NSArray *currentFilters = nil;
+    runSynchronouslyOnVideoProcessingQueue(^{
+        currentFilters = _state.filters;
+    });
+    return [NSMutableArray arrayWithArray:currentFilters];
+}
+
+- (void)setFilters:(NSMutableArray *)filters {
+    [self replaceAllFilters:filters];
+}
+
+- (GPUImagePipelinePlan *)plan {
+    __block GPUImagePipelinePlan *currentPlan = nil;
+    runSynchronouslyOnVideoProcessingQueue(^{
+        currentPlan = _state.plan;
+    });
+    return currentPlan;
+}
+
+- (GPUImageOutput *)filterNamed:(NSString *)filterName {
+    __block GPUImageOutput *namedFilter = nil;
+    runSynchronouslyOnVideoProcessingQueue(^{
+        NSUInteger filterIndex = [_state.plan indexOfFilterNamed:filterName];
+        namedFilter = (filterIndex != NSNotFound) ? [_state.filters objectAtIndex:filterIndex] : nil;
+    });
+    return namedFilter;
+}
+
+- (GPUImageOutput *)_terminalFilter {
+    __block GPUImageOutput *terminalFilter = nil;
+    runSynchronouslyOnVideoProcessingQueue(^{
+        if (_state.plan && ([_state.filters count] > 0)) {
+            terminalFilter = [_state.filters objectAtIndex:_state.plan.outputFilterIndex];
+        } else {
+            terminalFilter = [_state.filters lastObject];
+        }
+    });
+    return terminalFilter;
+}
+
+#pragma mark Changing filters
+
 - (void)addFilter:(GPUImageFilter *)filter atIndex:(NSUInteger)insertIndex {
-    [self.filters insertObject:filter atIndex:insertIndex];
-    [self _refreshFilters];
+    [self _editFilters:^GPUImageFilterPipelineState *(GPUImageFilterPipelineState *currentState) {
+        NSMutableArray *newFilters = [NSMutableArray arrayWithArray:currentState.filters];
+        [newFilters insertObject:filter atIndex:insertIndex];
+        return [[GPUImageFilterPipelineState alloc] initWithFilters:newFilters plan:nil];
+    }];
 }
 
 - (void)addFilter:(GPUImageFilter *)filter {
-    [self.filters addObject:filter];
-    [self _refreshFilters];
+    [self _editFilters:^GPUImageFilterPipelineState *(GPUImageFilterPipelineState *currentState) {
+        NSMutableArray *newFilters = [NSMutableArray arrayWithArray:currentState.filters];
+        [newFilters addObject:filter];
+        return [[GPUImageFilterPipelineState alloc] initWithFilters:newFilters plan:nil];
+    }];
 }
 
 - (void)replaceFilterAtIndex:(NSUInteger)index withFilter:(GPUImageFilter *)filter {
-    [self.filters replaceObjectAtIndex:index withObject:filter];
-    [self _refreshFilters];
+    [self _editFilters:^GPUImageFilterPipelineState *(GPUImageFilterPipelineState *currentState) {
+        NSMutableArray *newFilters = [NSMutableArray arrayWithArray:currentState.filters];
+        [newFilters replaceObjectAtIndex:index withObject:filter];
+        return [[GPUImageFilterPipelineState alloc] initWithFilters:newFilters plan:currentState.plan];
+    }];
 }
 
 - (void)removeFilterAtIndex:(NSUInteger)index {
-    [self.filters removeObjectAtIndex:index];
-    [self _refreshFilters];
+    [self _editFilters:^GPUImageFilterPipelineState *(GPUImageFilterPipelineState *currentState) {
+        NSMutableArray *newFilters = [NSMutableArray arrayWithArray:currentState.filters];
+        [newFilters removeObjectAtIndex:index];
+        return [[GPUImageFilterPipelineState alloc] initWithFilters:newFilters plan:nil];
+    }];
 }
 
 - (void)removeAllFilters {
-    [self.filters removeAllObjects];
-    [self _refreshFilters];
+    [self replaceAllFilters:[NSArray array]];
 }
 
 - (void)replaceAllFilters:(NSArray *)newFilters {
-    self.filters = [NSMutableArray arrayWithArray:newFilters];
-    [self _refreshFilters];
+    GPUImageFilterPipelineState *newState = [[GPUImageFilterPipelineState alloc] initWithFilters:newFilters plan:nil];
+    [self _editFilters:^GPUImageFilterPipelineState *(GPUImageFilterPipelineState *currentState) {
+        return newState;
+    }];
 }
 
-- (void)_refreshFilters {
+- (void)replaceAllFiltersWithPlan:(GPUImagePipelinePlan *)plan {
+    GPUImageFilterPipelineState *newState = [[GPUImageFilterPipelineState alloc] initWithFilters:[plan newFilters] plan:plan];
+    [self _editFilters:^GPUImageFilterPipelineState *(GPUImageFilterPipelineState *currentState) {
+        return newState;
+    }];
+}
+
+- (void)replaceAllFiltersWithPlan:(GPUImagePipelinePlan *)plan completionHandler:(void (^)(void))completionHandler {
+    // Creating the filters compiles their shaders, which takes turns with frames on the video processing queue rather than holding up the caller
+    dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        GPUImageFilterPipelineState *newState = [[GPUImageFilterPipelineState alloc] initWithFilters:[plan newFilters] plan:plan];
+        
+        // Nothing from the current filters goes into the new ones, so edits made in the meantime are simply replaced along with them
+        runAsynchronouslyOnVideoProcessingQueue(^{
+            [self _prepareState:newState];
+        });
+        runAsynchronouslyOnVideoProcessingQueue(^{
+            [self _switchToState:newState];
+            
+            if (completionHandler) {
+                dispatch_async(dispatch_get_main_queue(), completionHandler);
+            }
+        });
+    });
+}
+
+- (void)_editFilters:(GPUImageFilterPipelineState *(^)(GPUImageFilterPipelineState *currentState))editBlock {
+    // Framebuffers are allocated in one pass on the video processing queue and the graph is switched over in another, so a frame can go through the old graph in between, and none goes through a half-connected one
+    __block GPUImageFilterPipelineState *baseState = nil;
+    __block GPUImageFilterPipelineState *newState = nil;
+    runSynchronouslyOnVideoProcessingQueue(^{
+        baseState = _state;
+        newState = editBlock(baseState);
+        [self _prepareState:newState];
+    });
+    runSynchronouslyOnVideoProcessingQueue(^{
+        // Another change can be switched in between the two passes, and this one is then made again on top of it rather than undoing it
+        if (_state != baseState) {
+            newState = editBlock(_state);
+            [self _prepareState:newState];
+        }
+        [self _switchToState:newState];
+    });
+}
+
+- (void)_prepareState:(GPUImageFilterPipelineState *)newState {
+    // Whatever takes frames from the input has been told their size, which is what the new filters will get. That is the size as it arrived, before whatever cropping or forced processing size the current filter applies.
+    CGSize inputSize = CGSizeZero;
+    for (id<GPUImageInput> currentTarget in [self.input targets]) {
+        if ([(id)currentTarget isKindOfClass:[GPUImageFilter class]]) {
+            inputSize = [(GPUImageFilter *)currentTarget originallySuppliedInputSize];
+            break;
+        }
+    }
+    
+    if (CGSizeEqualToSize(inputSize, CGSizeZero)) {
+        return;
+    }
+    
+    if (newState.plan && !newState.plan.isLinear) {
+        [newState.plan prepareFilters:newState.filters forInputSize:inputSize];
+        return;
+    }
+    
+    CGSize filterInputSize = inputSize;
+    for (id<GPUImageInput> filter in newState.filters) {
+        [filter setInputSize:filterInputSize atIndex:0];
+        if ([(id)filter isKindOfClass:[GPUImageFilter class]]) {
+            [(GPUImageFilter *)filter setFilterFBO];
+            filterInputSize = [(GPUImageFilter *)filter outputFrameSize];
+        }
+    }
+}
+
+- (void)_switchToState:(GPUImageFilterPipelineState *)newState {
+    NSArray *oldFilters = _state.filters;
+    _state = newState;
+    
+    // Filters that were swapped out stop sending to the output and anything else downstream before the new graph is wired up, so they can't undo any of it. Targets that stay in the graph are handed off rather than reset, which would blank them and rebuild their framebuffers.
+    NSSet *graphMembers = [self _graphMembers];
+    for (GPUImageOutput *oldFilter in oldFilters) {
+        if (![newState.filters containsObject:oldFilter]) {
+            [oldFilter removeAllTargetsHandingOff:graphMembers];
+        }
+    }
+    
+    [self _connectFiltersInOrder];
+}
+
+- (NSSet *)_graphMembers {
+    NSMutableSet *graphMembers = [NSMutableSet setWithArray:_state.filters];
+    if (self.output != nil) {
+        [graphMembers addObject:self.output];
+    }
+    return graphMembers;
+}
+
+- (void)_connectFiltersInOrder {
+    
+    if (_state.plan && !_state.plan.isLinear) {
+        [_state.plan connectFilters:_state.filters input:self.input output:self.output];
+        return;
+    }
     
+    NSSet *graphMembers = [self _graphMembers];
     id prevFilter = self.input;
     GPUImageFilter *theFilter = nil;
     
-    for (int i = 0; i < [self.filters count]; i++) {
-        theFilter = [self.filters objectAtIndex:i];
-        [prevFilter removeAllTargets];
+    for (int i = 0; i < [_state.filters count]; i++) {
+        theFilter = [_state.filters objectAtIndex:i];
+        [prevFilter removeAllTargetsHandingOff:graphMembers];
         [prevFilter addTarget:theFilter];
         prevFilter = theFilter;
     }
     
-    [prevFilter removeAllTargets];
+    [prevFilter removeAllTargetsHandingOff:graphMembers];
     
     if (self.output != nil) {
         [prevFilter addTarget:self.output];
@@ -198,15 +314,15 @@
 }
 
 - (UIImage *)currentFilteredFrame {
-    return [(GPUImageFilter *)[_filters lastObject] imageFromCurrentlyProcessedOutput];
+    return [(GPUImageFilter *)[self _terminalFilter] imageFromCurrentlyProcessedOutput];
 }
 
 - (CGImageRef)newCGImageFromCurrentFilteredFrame {
-    return [(GPUImageFilter *)[_filters lastObject] newCGImageFromCurrentlyProcessedOutput];
+    return [(GPUImageFilter *)[self _terminalFilter] newCGImageFromCurrentlyProcessedOutput];
 }
 
 - (CGImageRef)newCGImageFromCurrentFilteredFrameWithOrientation:(UIImageOrientation)imageOrientation {
-    return [(GPUImageFilter *)[_filters lastObject] newCGImageFromCurrentlyProcessedOutputWithOrientation:imageOrientation];
+    return [(GPUImageFilter *)[self _terminalFilter] newCGImageFromCurrentlyProcessedOutputWithOrientation:imageOrientation];
 }
 
 
@@ -90,6 +90,13 @@ NSString *const kGPUImageGaussianBlurFragmentShaderString = SHADER_STRING
                       secondStageFragmentShaderFromString:nil];
 }
 
+#pragma mark Tiled processing
+
+- (NSUInteger)pixelFootprintRadius;
+{
+    return (NSUInteger)ceil(4.0 * _blurSize);
+}
+
 #pragma mark Getters and Setters
 
 - (void) setBlurSize:(CGFloat)blurSize {
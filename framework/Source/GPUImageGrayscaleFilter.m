@@ -1,4 +1,5 @@
 #import "GPUImageGrayscaleFilter.h"
+#import "GPUImageFence.h"
 
 @implementation GPUImageGrayscaleFilter
 
@@ -62,6 +63,11 @@ NSString *const kGPUImageLuminanceFragmentShaderString = SHADER_STRING
 
 - (void)informTargetsAboutNewFrameAtTime:(CMTime)frameTime;
 {
+    if ([GPUImageOpenGLESContext supportsFastTextureUpload] && preparedToCaptureImage)
+    {
+        [imageCaptureFence insert];
+    }
+    
     if (self.frameProcessingCompletionBlock != NULL)
     {
         self.frameProcessingCompletionBlock(self, frameTime);
@@ -71,7 +77,7 @@ NSString *const kGPUImageLuminanceFragmentShaderString = SHADER_STRING
     
     for (id<GPUImageInput> currentTarget in targets)
     {
-        if (currentTarget != self.targetToIgnoreForUpdates)
+        if ( (currentTarget != self.targetToIgnoreForUpdates) && [self shouldSendFrameAtTime:frameTime toTarget:currentTarget] )
         {
             NSInteger indexOfObject = [targets indexOfObject:currentTarget];
             NSInteger textureIndex = [[targetTextureIndices objectAtIndex:indexOfObject] integerValue];
@@ -81,6 +87,11 @@ NSString *const kGPUImageLuminanceFragmentShaderString = SHADER_STRING
                 [self setInputTextureForTarget:currentTarget atIndex:textureIndex];
             }
 
+            if ([currentTarget wantsMonochromeInput])
+            {
+                [currentTarget setCurrentlyReceivingMonochromeInput:YES];
+            }
+
             if (currentlyReceivingMonochromeInput)
             {
                 [currentTarget setInputRotation:inputRotation atIndex:textureIndex];
@@ -0,0 +1,12 @@
+#import "GPUImageFilter.h"
+
+/** Downsamples an image to half its width and height, prefiltering it with a tent-shaped kernel over a 4x4 block of input pixels to avoid aliasing
+
+ This is the building block of GPUImageDownscalePyramid, but can be chained on its own for fast, clean 2x reductions.
+ */
+@interface GPUImageHalfSizeDownsamplingFilter : GPUImageFilter
+{
+    GLint texelWidthUniform, texelHeightUniform;
+}
+
+@end
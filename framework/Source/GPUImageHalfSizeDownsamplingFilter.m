@@ -0,0 +1,118 @@
+#import "GPUImageHalfSizeDownsamplingFilter.h"
+
+// Each output pixel sits on the corner shared by a 2x2 block of input pixels, so one bilinear sample there averages the block, and samples one input texel diagonally out average the blocks overlapping its neighbors
+NSString *const kGPUImageHalfSizeDownsamplingVertexShaderString = SHADER_STRING
+(
+ attribute vec4 position;
+ attribute vec4 inputTextureCoordinate;
+ 
+ uniform float texelWidth;
+ uniform float texelHeight;
+ 
+ varying vec2 textureCoordinate;
+ varying vec2 topLeftTextureCoordinate;
+ varying vec2 topRightTextureCoordinate;
+ varying vec2 bottomLeftTextureCoordinate;
+ varying vec2 bottomRightTextureCoordinate;
+ 
+ void main()
+ {
+     gl_Position = position;
+     
+     vec2 widthStep = vec2(texelWidth, 0.0);
+     vec2 heightStep = vec2(0.0, texelHeight);
+     
+     textureCoordinate = inputTextureCoordinate.xy;
+     topLeftTextureCoordinate = inputTextureCoordinate.xy - widthStep - heightStep;
+     topRightTextureCoordinate = inputTextureCoordinate.xy + widthStep - heightStep;
+     bottomLeftTextureCoordinate = inputTextureCoordinate.xy - widthStep + heightStep;
+     bottomRightTextureCoordinate = inputTextureCoordinate.xy + widthStep + heightStep;
+ }
+);
+
+NSString *const kGPUImageHalfSizeDownsamplingFragmentShaderString = SHADER_STRING
+(
+ precision mediump float;
+ 
+ varying vec2 textureCoordinate;
+ varying vec2 topLeftTextureCoordinate;
+ varying vec2 topRightTextureCoordinate;
+ varying vec2 bottomLeftTextureCoordinate;
+ varying vec2 bottomRightTextureCoordinate;
+ 
+ uniform sampler2D inputImageTexture;
+ 
+ void main()
+ {
+     vec4 sum = texture2D(inputImageTexture, textureCoordinate) * 4.0;
+     sum += texture2D(inputImageTexture, topLeftTextureCoordinate);
+     sum += texture2D(inputImageTexture, topRightTextureCoordinate);
+     sum += texture2D(inputImageTexture, bottomLeftTextureCoordinate);
+     sum += texture2D(inputImageTexture, bottomRightTextureCoordinate);
+     
+     gl_FragColor = sum * 0.125;
+ }
+);
+
+@implementation GPUImageHalfSizeDownsamplingFilter
+
+#pragma mark -
+#pragma mark Initialization and teardown
+
+- (id)init;
+{
+    if (!(self = [super initWithVertexShaderFromString:kGPUImageHalfSizeDownsamplingVertexShaderString fragmentShaderFromString:kGPUImageHalfSizeDownsamplingFragmentShaderString]))
+    {
+        return nil;
+    }
+    
+    texelWidthUniform = [filterProgram uniformIndex:@"texelWidth"];
+    texelHeightUniform = [filterProgram uniformIndex:@"texelHeight"];
+    
+    return self;
+}
+
+- (void)setupFilterForSize:(CGSize)filterFrameSize;
+{
+    // The offsets step across input pixels, which run along the other axis of the texture when the input is rotated
+    GLfloat texelWidth = 1.0 / inputTextureSize.width;
+    GLfloat texelHeight = 1.0 / inputTextureSize.height;
+    
+    runSynchronouslyOnVideoProcessingQueue(^{
+        [GPUImageOpenGLESContext setActiveShaderProgram:filterProgram];
+        if (GPUImageRotationSwapsWidthAndHeight(inputRotation))
+        {
+            glUniform1f(texelWidthUniform, texelHeight);
+            glUniform1f(texelHeightUniform, texelWidth);
+        }
+        else
+        {
+            glUniform1f(texelWidthUniform, texelWidth);
+            glUniform1f(texelHeightUniform, texelHeight);
+        }
+    });
+}
+
+- (BOOL)wantsMipmappedInputOfSize:(CGSize)inputSize atIndex:(NSInteger)textureIndex;
+{
+    // The prefilter samples the full-resolution input at exact offsets, which a coarser level would blur further
+    return NO;
+}
+
+#pragma mark -
+#pragma mark Managing the display FBOs
+
+- (CGSize)sizeOfFBO;
+{
+    return [self outputFrameSize];
+}
+
+#pragma mark -
+#pragma mark Rendering
+
+- (CGSize)outputFrameSize;
+{
+    return CGSizeMake(ceil(inputTextureSize.width / 2.0), ceil(inputTextureSize.height / 2.0));
+}
+
+@end
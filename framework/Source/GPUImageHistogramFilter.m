@@ -215,7 +215,8 @@ NSString *const kGPUImageHistogramAccumulationFragmentShaderString = SHADER_STRI
 
 - (void)newFrameReadyAtTime:(CMTime)frameTime atIndex:(NSInteger)textureIndex;
 {
-    outputTextureRetainCount = [targets count];
+    outputTextureRetainCount = [self numberOfTargetsToSendFrameAtTime:frameTime];
+    [self applyParameterAnimationsAtTime:frameTime];
 
     if (vertexSamplingCoordinates == NULL)
     {
@@ -239,6 +240,7 @@ NSString *const kGPUImageHistogramAccumulationFragmentShaderString = SHADER_STRI
         return;
     }
     
+    originallySuppliedInputSize = newSize;
     inputTextureSize = newSize;
 }
 
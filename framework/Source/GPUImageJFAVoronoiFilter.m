@@ -355,7 +355,7 @@ NSString *const kGPUImageJFAVoronoiFragmentShaderString = SHADER_STRING
         [self initializeOutputTextureIfNeeded];
         
         glBindTexture(GL_TEXTURE_2D, secondFilterOutputTexture);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, (int)currentFBOSize.width, (int)currentFBOSize.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, (int)currentFBOSize.width, (int)currentFBOSize.height, 0, GL_RGBA, [self outputTextureType], 0);
         glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, secondFilterOutputTexture, 0);
         
         [self notifyTargetsAboutNewOutputTexture];
@@ -119,6 +119,14 @@ NSString *const kGPUImageKuwaharaFragmentShaderString = SHADER_STRING
     return self;
 }
 
+#pragma mark -
+#pragma mark Tiled processing
+
+- (NSUInteger)pixelFootprintRadius;
+{
+    return _radius;
+}
+
 #pragma mark -
 #pragma mark Accessors
 
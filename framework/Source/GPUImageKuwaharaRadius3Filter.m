@@ -283,4 +283,12 @@ NSString *const kGPUImageKuwaharaRadius3FragmentShaderString = SHADER_STRING
     return self;
 }
 
+#pragma mark -
+#pragma mark Tiled processing
+
+- (NSUInteger)pixelFootprintRadius;
+{
+    return 3;
+}
+
 @end
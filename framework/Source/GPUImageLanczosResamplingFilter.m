@@ -156,4 +156,30 @@ NSString *const kGPUImageLanczosFragmentShaderString = SHADER_STRING
     glViewport(0, 0, (int)currentFBOSize.width, (int)currentFBOSize.height);
 }
 
+- (BOOL)wantsMipmappedInputOfSize:(CGSize)inputSize atIndex:(NSInteger)textureIndex;
+{
+    // The kernel samples the full-resolution input at exact offsets, which a coarser level would blur further
+    return NO;
+}
+
+#pragma mark -
+#pragma mark Changed regions
+
+- (CGRect)outputRegionAffectedByInputRegion:(CGRect)inputRegion atIndex:(NSInteger)textureIndex;
+{
+    // The first pass renders at an intermediate size, so a region in output pixels doesn't carry over to it
+    return kGPUImageFullFrameRegion;
+}
+
+- (CGRect)inputRegionNeededForOutputRegion:(CGRect)outputRegion atIndex:(NSInteger)textureIndex;
+{
+    return kGPUImageFullFrameRegion;
+}
+
+- (CGRect)outputRegionOfInterest;
+{
+    // That also rules out drawing only part of the output, and the first pass reads across the whole input
+    return kGPUImageFullFrameRegion;
+}
+
 @end
@@ -0,0 +1,52 @@
+#import "GPUImageMultiInputFilter.h"
+
+#define kGPUImageMaximumCompositedLayers (kGPUImageMaximumFilterInputs - 1)
+
+typedef enum {
+    kGPUImageLayerBlendModeNormal,
+    kGPUImageLayerBlendModeSourceOver,
+    kGPUImageLayerBlendModeAlpha,
+    kGPUImageLayerBlendModeMultiply,
+    kGPUImageLayerBlendModeScreen,
+    kGPUImageLayerBlendModeAdd,
+    kGPUImageLayerBlendModeDarken,
+    kGPUImageLayerBlendModeLighten,
+    kGPUImageLayerBlendModeOverlay
+} GPUImageLayerBlendMode;
+
+/** Composites any number of layers over a background in as few draws as possible, instead of a cascade of two-input blends
+
+ The first input is the background, which sets the output size, and each input added after it is a layer drawn over the ones before it. Each layer has its own blend mode, opacity and placement, and a shader is generated for the combination of blend modes in use. As many layers as the device has spare texture units for go into a single draw, and larger stacks are split into several draws that each build on the last.
+ 
+ Frames from the background and the layers are matched by timestamp as in GPUImageMultiInputFilter, and layer i is input i + 1.
+ */
+@interface GPUImageLayerCompositingFilter : GPUImageMultiInputFilter
+{
+    GPUImageLayerBlendMode layerBlendModes[kGPUImageMaximumCompositedLayers];
+    CGFloat layerOpacities[kGPUImageMaximumCompositedLayers];
+    CGAffineTransform layerTransforms[kGPUImageMaximumCompositedLayers];
+    
+    NSMutableDictionary *compositingPrograms;
+    GLuint intermediateFramebuffers[2], intermediateTextures[2];
+}
+
+/** The number of layers over the background, counting up to the last one connected
+ */
+@property(readonly, nonatomic) NSUInteger numberOfLayers;
+
+/** How many layers can go into one draw on this device
+ */
+@property(readonly, nonatomic) NSUInteger maximumLayersPerPass;
+
+// Layer appearance
+- (void)setBlendMode:(GPUImageLayerBlendMode)blendMode forLayer:(NSUInteger)layerIndex;
+- (void)setOpacity:(CGFloat)opacity forLayer:(NSUInteger)layerIndex;
+
+/** Places a layer over the background
+ 
+ @param transform Maps the layer's unit square into the output, in normalized (0.0 - 1.0) coordinates with the origin at the upper left. The identity transform, the default, stretches the layer over the whole output, and anything outside the layer's square is left untouched.
+ @param layerIndex The layer, starting from 0 for the first input after the background
+ */
+- (void)setTransform:(CGAffineTransform)transform forLayer:(NSUInteger)layerIndex;
+
+@end
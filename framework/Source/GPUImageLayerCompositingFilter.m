@@ -0,0 +1,393 @@
+#import "GPUImageLayerCompositingFilter.h"
+
+// Layers are placed in output coordinates, which don't depend on how the background is rotated
+NSString *const kGPUImageLayerCompositingVertexShaderString = SHADER_STRING
+(
+ attribute vec4 position;
+ attribute vec4 inputTextureCoordinate;
+ 
+ varying vec2 textureCoordinate;
+ varying vec2 outputCoordinate;
+ 
+ void main()
+ {
+     gl_Position = position;
+     textureCoordinate = inputTextureCoordinate.xy;
+     outputCoordinate = position.xy * 0.5 + 0.5;
+ }
+);
+
+// These match the formulas of the corresponding two-input blend filters
+static NSString *const kGPUImageLayerBlendFunctions[] = {
+    @"lowp vec4 blendNormal(lowp vec4 base, lowp vec4 overlay)\n{\n    return vec4(overlay.rgb + base.rgb * base.a * (1.0 - overlay.a), overlay.a + base.a * (1.0 - overlay.a));\n}\n",
+    @"lowp vec4 blendSourceOver(lowp vec4 base, lowp vec4 overlay)\n{\n    return mix(base, overlay, overlay.a);\n}\n",
+    @"lowp vec4 blendAlpha(lowp vec4 base, lowp vec4 overlay)\n{\n    return vec4(mix(base.rgb, overlay.rgb, overlay.a), base.a);\n}\n",
+    @"lowp vec4 blendMultiply(lowp vec4 base, lowp vec4 overlay)\n{\n    return overlay * base + overlay * (1.0 - base.a) + base * (1.0 - overlay.a);\n}\n",
+    @"mediump vec4 blendScreen(mediump vec4 base, mediump vec4 overlay)\n{\n    return vec4(1.0) - ((vec4(1.0) - overlay) * (vec4(1.0) - base));\n}\n",
+    @"mediump vec4 blendAdd(mediump vec4 base, mediump vec4 overlay)\n{\n    mediump vec3 clipped = vec3(overlay.a * base.a) + overlay.rgb * (1.0 - base.a) + base.rgb * (1.0 - overlay.a);\n    mediump vec3 color = mix(overlay.rgb + base.rgb, clipped, step(vec3(overlay.a * base.a), overlay.rgb * base.a + base.rgb * overlay.a));\n    return vec4(color, overlay.a + base.a - overlay.a * base.a);\n}\n",
+    @"lowp vec4 blendDarken(lowp vec4 base, lowp vec4 overlay)\n{\n    return vec4(min(overlay.rgb * base.a, base.rgb * overlay.a) + overlay.rgb * (1.0 - base.a) + base.rgb * (1.0 - overlay.a), 1.0);\n}\n",
+    @"lowp vec4 blendLighten(lowp vec4 base, lowp vec4 overlay)\n{\n    return max(base, overlay);\n}\n",
+    @"mediump vec4 blendOverlay(mediump vec4 base, mediump vec4 overlay)\n{\n    mediump vec3 uncovered = overlay.rgb * (1.0 - base.a) + base.rgb * (1.0 - overlay.a);\n    mediump vec3 darkened = 2.0 * overlay.rgb * base.rgb + uncovered;\n    mediump vec3 lightened = overlay.a * base.a - 2.0 * (base.a - base.rgb) * (overlay.a - overlay.rgb) + uncovered;\n    return vec4(mix(darkened, lightened, step(vec3(base.a), 2.0 * base.rgb)), 1.0);\n}\n"
+};
+
+static NSString *const kGPUImageLayerBlendFunctionNames[] = {
+    @"blendNormal", @"blendSourceOver", @"blendAlpha", @"blendMultiply", @"blendScreen", @"blendAdd", @"blendDarken", @"blendLighten", @"blendOverlay"
+};
+
+// Uniform locations looked up for each layer: its texture sampler, the two rows of its transform, and its opacity
+#define kGPUImageLayerCompositingUniformsPerLayer 4
+
+@interface GPUImageLayerCompositingFilter()
+{
+    NSMutableDictionary *compositingProgramUniforms;
+    NSUInteger _maximumLayersPerPass;
+}
+
+- (NSString *)fragmentShaderForLayersInRange:(NSRange)layerRange;
+- (GLProgram *)programForLayersInRange:(NSRange)layerRange uniforms:(const GLint **)uniforms;
+- (void)createIntermediateFramebuffersOfSize:(CGSize)framebufferSize;
+- (void)destroyIntermediateFramebuffers;
+
+@end
+
+@implementation GPUImageLayerCompositingFilter
+
+#pragma mark -
+#pragma mark Initialization and teardown
+
+- (id)init;
+{
+    if (!(self = [super initWithVertexShaderFromString:kGPUImageLayerCompositingVertexShaderString fragmentShaderFromString:[self fragmentShaderForLayersInRange:NSMakeRange(0, 0)]]))
+    {
+		return nil;
+    }
+    
+    for (NSUInteger layerIndex = 0; layerIndex < kGPUImageMaximumCompositedLayers; layerIndex++)
+    {
+        layerBlendModes[layerIndex] = kGPUImageLayerBlendModeNormal;
+        layerOpacities[layerIndex] = 1.0;
+        layerTransforms[layerIndex] = CGAffineTransformIdentity;
+    }
+    
+    compositingPrograms = [[NSMutableDictionary alloc] init];
+    compositingProgramUniforms = [[NSMutableDictionary alloc] init];
+    
+    runSynchronouslyOnVideoProcessingQueue(^{
+        [GPUImageOpenGLESContext useImageProcessingContext];
+        
+        // The background or the previous draw takes one texture unit, and a few uniform vectors are left over for the compiler
+        GLint maximumFragmentUniformVectors;
+        glGetIntegerv(GL_MAX_FRAGMENT_UNIFORM_VECTORS, &maximumFragmentUniformVectors);
+        NSUInteger layersByTextureUnits = MAX([GPUImageOpenGLESContext maximumTextureUnitsForThisDevice] - 1, 1);
+        NSUInteger layersByUniforms = MAX((maximumFragmentUniformVectors - 4) / 3, 1);
+        _maximumLayersPerPass = MIN(MIN(layersByTextureUnits, layersByUniforms), kGPUImageMaximumCompositedLayers);
+    });
+    
+    return self;
+}
+
+- (void)dealloc;
+{
+    runSynchronouslyOnVideoProcessingQueue(^{
+        [GPUImageOpenGLESContext useImageProcessingContext];
+        [self destroyIntermediateFramebuffers];
+    });
+}
+
+#pragma mark -
+#pragma mark Layer appearance
+
+- (void)setBlendMode:(GPUImageLayerBlendMode)blendMode forLayer:(NSUInteger)layerIndex;
+{
+    NSAssert(layerIndex < kGPUImageMaximumCompositedLayers, @"Layer index %lu is past the maximum of %d layers", (unsigned long)layerIndex, kGPUImageMaximumCompositedLayers);
+    
+    runAsynchronouslyOnVideoProcessingQueue(^{
+        layerBlendModes[layerIndex] = blendMode;
+    });
+}
+
+- (void)setOpacity:(CGFloat)opacity forLayer:(NSUInteger)layerIndex;
+{
+    NSAssert(layerIndex < kGPUImageMaximumCompositedLayers, @"Layer index %lu is past the maximum of %d layers", (unsigned long)layerIndex, kGPUImageMaximumCompositedLayers);
+    
+    runAsynchronouslyOnVideoProcessingQueue(^{
+        layerOpacities[layerIndex] = opacity;
+    });
+}
+
+- (void)setTransform:(CGAffineTransform)transform forLayer:(NSUInteger)layerIndex;
+{
+    NSAssert(layerIndex < kGPUImageMaximumCompositedLayers, @"Layer index %lu is past the maximum of %d layers", (unsigned long)layerIndex, kGPUImageMaximumCompositedLayers);
+    
+    runAsynchronouslyOnVideoProcessingQueue(^{
+        layerTransforms[layerIndex] = transform;
+    });
+}
+
+#pragma mark -
+#pragma mark Shader generation
+
+- (NSString *)fragmentShaderForLayersInRange:(NSRange)layerRange;
+{
+    NSMutableString *shaderString = [[NSMutableString alloc] init];
+    
+    [shaderString appendString:@"varying highp vec2 textureCoordinate;\nvarying highp vec2 outputCoordinate;\n\nuniform sampler2D inputImageTexture;\n"];
+    
+    BOOL blendModeIsUsed[sizeof(kGPUImageLayerBlendFunctionNames) / sizeof(NSString *)] = {NO};
+    for (NSUInteger layerIndex = layerRange.location; layerIndex < NSMaxRange(layerRange); layerIndex++)
+    {
+        NSUInteger layerInPass = layerIndex - layerRange.location;
+        [shaderString appendFormat:@"uniform sampler2D layerTexture%lu;\nuniform highp vec3 layerTransformX%lu;\nuniform highp vec3 layerTransformY%lu;\nuniform lowp float layerOpacity%lu;\n", (unsigned long)layerInPass, (unsigned long)layerInPass, (unsigned long)layerInPass, (unsigned long)layerInPass];
+        blendModeIsUsed[layerBlendModes[layerIndex]] = YES;
+    }
+    [shaderString appendString:@"\n"];
+    
+    for (NSUInteger blendMode = 0; blendMode < sizeof(kGPUImageLayerBlendFunctionNames) / sizeof(NSString *); blendMode++)
+    {
+        if (blendModeIsUsed[blendMode])
+        {
+            [shaderString appendString:kGPUImageLayerBlendFunctions[blendMode]];
+            [shaderString appendString:@"\n"];
+        }
+    }
+    
+    [shaderString appendString:@"void main()\n{\n    lowp vec4 base = texture2D(inputImageTexture, textureCoordinate);\n    highp vec3 position = vec3(outputCoordinate, 1.0);\n    highp vec2 layerCoordinate;\n    lowp float coverage;\n"];
+    
+    for (NSUInteger layerIndex = layerRange.location; layerIndex < NSMaxRange(layerRange); layerIndex++)
+    {
+        NSUInteger layerInPass = layerIndex - layerRange.location;
+        [shaderString appendFormat:@"\n    layerCoordinate = vec2(dot(layerTransformX%lu, position), dot(layerTransformY%lu, position));\n", (unsigned long)layerInPass, (unsigned long)layerInPass];
+        [shaderString appendFormat:@"    coverage = layerOpacity%lu * step(0.0, layerCoordinate.x) * step(layerCoordinate.x, 1.0) * step(0.0, layerCoordinate.y) * step(layerCoordinate.y, 1.0);\n", (unsigned long)layerInPass];
+        [shaderString appendFormat:@"    base = mix(base, %@(base, texture2D(layerTexture%lu, layerCoordinate)), coverage);\n", kGPUImageLayerBlendFunctionNames[layerBlendModes[layerIndex]], (unsigned long)layerInPass];
+    }
+    
+    [shaderString appendString:@"\n    gl_FragColor = base;\n}\n"];
+    
+    return shaderString;
+}
+
+- (GLProgram *)programForLayersInRange:(NSRange)layerRange uniforms:(const GLint **)uniforms;
+{
+    // Programs only differ by the number of layers and their blend modes, so that's all that goes into the key
+    NSMutableString *programKey = [NSMutableString stringWithString:@"blend modes:"];
+    for (NSUInteger layerIndex = layerRange.location; layerIndex < NSMaxRange(layerRange); layerIndex++)
+    {
+        [programKey appendFormat:@" %d", layerBlendModes[layerIndex]];
+    }
+    
+    GLProgram *compositingProgram = [compositingPrograms objectForKey:programKey];
+    if (compositingProgram == nil)
+    {
+        compositingProgram = [[GPUImageOpenGLESContext sharedImageProcessingOpenGLESContext] programForVertexShaderString:kGPUImageLayerCompositingVertexShaderString fragmentShaderString:[self fragmentShaderForLayersInRange:layerRange]];
+        
+        if (!compositingProgram.initialized)
+        {
+            [compositingProgram addAttribute:@"position"];
+            [compositingProgram addAttribute:@"inputTextureCoordinate"];
+            
+            if (![compositingProgram link])
+            {
+                NSLog(@"Program link log: %@", [compositingProgram programLog]);
+                NSLog(@"Fragment shader compile log: %@", [compositingProgram fragmentShaderLog]);
+                NSLog(@"Vertex shader compile log: %@", [compositingProgram vertexShaderLog]);
+                NSAssert(NO, @"Layer compositing shader link failed");
+                return nil;
+            }
+        }
+        
+        NSMutableData *uniformData = [NSMutableData dataWithLength:(layerRange.length + 1) * kGPUImageLayerCompositingUniformsPerLayer * sizeof(GLint)];
+        GLint *uniformIndices = [uniformData mutableBytes];
+        uniformIndices[0] = [compositingProgram uniformIndex:@"inputImageTexture"];
+        for (NSUInteger layerInPass = 0; layerInPass < layerRange.length; layerInPass++)
+        {
+            GLint *layerUniforms = uniformIndices + (layerInPass + 1) * kGPUImageLayerCompositingUniformsPerLayer;
+            layerUniforms[0] = [compositingProgram uniformIndex:[NSString stringWithFormat:@"layerTexture%lu", (unsigned long)layerInPass]];
+            layerUniforms[1] = [compositingProgram uniformIndex:[NSString stringWithFormat:@"layerTransformX%lu", (unsigned long)layerInPass]];
+            layerUniforms[2] = [compositingProgram uniformIndex:[NSString stringWithFormat:@"layerTransformY%lu", (unsigned long)layerInPass]];
+            layerUniforms[3] = [compositingProgram uniformIndex:[NSString stringWithFormat:@"layerOpacity%lu", (unsigned long)layerInPass]];
+        }
+        
+        [compositingPrograms setObject:compositingProgram forKey:programKey];
+        [compositingProgramUniforms setObject:uniformData forKey:programKey];
+    }
+    
+    *uniforms = [[compositingProgramUniforms objectForKey:programKey] bytes];
+    return compositingProgram;
+}
+
+#pragma mark -
+#pragma mark Managing the display FBOs
+
+- (void)createIntermediateFramebuffersOfSize:(CGSize)framebufferSize;
+{
+    for (NSUInteger framebufferIndex = 0; framebufferIndex < 2; framebufferIndex++)
+    {
+        glActiveTexture(GL_TEXTURE1);
+        glGenTextures(1, &intermediateTextures[framebufferIndex]);
+        glBindTexture(GL_TEXTURE_2D, intermediateTextures[framebufferIndex]);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, (int)framebufferSize.width, (int)framebufferSize.height, 0, GL_RGBA, [self outputTextureType], 0);
+        
+        glGenFramebuffers(1, &intermediateFramebuffers[framebufferIndex]);
+        glBindFramebuffer(GL_FRAMEBUFFER, intermediateFramebuffers[framebufferIndex]);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, intermediateTextures[framebufferIndex], 0);
+        
+        GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+        NSAssert(status == GL_FRAMEBUFFER_COMPLETE, @"Incomplete layer compositing FBO: %d", status);
+    }
+    
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+- (void)destroyIntermediateFramebuffers;
+{
+    for (NSUInteger framebufferIndex = 0; framebufferIndex < 2; framebufferIndex++)
+    {
+        if (intermediateFramebuffers[framebufferIndex])
+        {
+            glDeleteFramebuffers(1, &intermediateFramebuffers[framebufferIndex]);
+            intermediateFramebuffers[framebufferIndex] = 0;
+        }
+        
+        if (intermediateTextures[framebufferIndex])
+        {
+            glDeleteTextures(1, &intermediateTextures[framebufferIndex]);
+            intermediateTextures[framebufferIndex] = 0;
+        }
+    }
+}
+
+- (void)destroyFilterFBO;
+{
+    [super destroyFilterFBO];
+    
+    runSynchronouslyOnVideoProcessingQueue(^{
+        [GPUImageOpenGLESContext useImageProcessingContext];
+        [self destroyIntermediateFramebuffers];
+    });
+}
+
+#pragma mark -
+#pragma mark Rendering
+
+- (void)renderToTextureWithVertices:(const GLfloat *)vertices textureCoordinates:(const GLfloat *)textureCoordinates sourceTexture:(GLuint)sourceTexture;
+{
+    if (self.preventRendering)
+    {
+        framebufferHoldsPreviousFrame = NO;
+        return;
+    }
+    
+    NSUInteger layerCount = [self numberOfLayers];
+    NSUInteger passCount = MAX((layerCount + _maximumLayersPerPass - 1) / _maximumLayersPerPass, 1);
+    
+    GLuint baseTexture = sourceTexture;
+    const GLfloat *baseTextureCoordinates = textureCoordinates;
+    
+    for (NSUInteger pass = 0; pass < passCount; pass++)
+    {
+        NSRange layerRange = NSMakeRange(pass * _maximumLayersPerPass, MIN(_maximumLayersPerPass, layerCount - MIN(layerCount, pass * _maximumLayersPerPass)));
+        BOOL isLastPass = (pass == (passCount - 1));
+        
+        // Stacks too deep for one draw are built up in alternating intermediate framebuffers, with the last draw going to the output
+        if (isLastPass)
+        {
+            [self setFilterFBO];
+        }
+        else
+        {
+            CGSize currentFBOSize = [self sizeOfFBO];
+            if (!intermediateFramebuffers[0])
+            {
+                [self createIntermediateFramebuffersOfSize:currentFBOSize];
+            }
+            glBindFramebuffer(GL_FRAMEBUFFER, intermediateFramebuffers[pass % 2]);
+            glViewport(0, 0, (int)currentFBOSize.width, (int)currentFBOSize.height);
+        }
+        
+        const GLint *uniforms;
+        GLProgram *compositingProgram = [self programForLayersInRange:layerRange uniforms:&uniforms];
+        [GPUImageOpenGLESContext setActiveShaderProgram:compositingProgram];
+        
+        glClearColor(backgroundColorRed, backgroundColorGreen, backgroundColorBlue, backgroundColorAlpha);
+        glClear(GL_COLOR_BUFFER_BIT);
+        
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, baseTexture);
+        glUniform1i(uniforms[0], 0);
+        
+        for (NSUInteger layerIndex = layerRange.location; layerIndex < NSMaxRange(layerRange); layerIndex++)
+        {
+            NSUInteger layerInPass = layerIndex - layerRange.location;
+            const GLint *layerUniforms = uniforms + (layerInPass + 1) * kGPUImageLayerCompositingUniformsPerLayer;
+            
+            glActiveTexture(GL_TEXTURE1 + layerInPass);
+            glBindTexture(GL_TEXTURE_2D, inputTextures[layerIndex + 1]);
+            glUniform1i(layerUniforms[0], 1 + layerInPass);
+            
+            // The shader needs to go from output coordinates to the layer's texture, so invert the placement and then apply the layer's rotation
+            const GLfloat *rotatedCoordinates = [[self class] textureCoordinatesForRotation:inputRotations[layerIndex + 1]];
+            CGAffineTransform rotationTransform = CGAffineTransformMake(rotatedCoordinates[2] - rotatedCoordinates[0], rotatedCoordinates[3] - rotatedCoordinates[1], rotatedCoordinates[4] - rotatedCoordinates[0], rotatedCoordinates[5] - rotatedCoordinates[1], rotatedCoordinates[0], rotatedCoordinates[1]);
+            CGAffineTransform placement = layerTransforms[layerIndex];
+            CGAffineTransform outputToLayerTransform = CGAffineTransformInvert(placement);
+            // A placement that collapses the layer to a line or a point can't be inverted, and covers nothing anyway
+            BOOL layerIsVisible = inputIsConnected[layerIndex + 1] && (fabs(placement.a * placement.d - placement.b * placement.c) > 1e-6);
+            CGAffineTransform textureTransform = CGAffineTransformConcat(outputToLayerTransform, rotationTransform);
+            
+            glUniform3f(layerUniforms[1], textureTransform.a, textureTransform.c, textureTransform.tx);
+            glUniform3f(layerUniforms[2], textureTransform.b, textureTransform.d, textureTransform.ty);
+            glUniform1f(layerUniforms[3], layerIsVisible ? layerOpacities[layerIndex] : 0.0);
+        }
+        
+        glVertexAttribPointer([compositingProgram attributeIndex:@"position"], 2, GL_FLOAT, 0, 0, vertices);
+        glVertexAttribPointer([compositingProgram attributeIndex:@"inputTextureCoordinate"], 2, GL_FLOAT, 0, 0, baseTextureCoordinates);
+        
+        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+        
+        baseTexture = intermediateTextures[pass % 2];
+        baseTextureCoordinates = [[self class] textureCoordinatesForRotation:kGPUImageNoRotation];
+    }
+    
+    framebufferHoldsPreviousFrame = YES;
+}
+
+#pragma mark -
+#pragma mark Changed regions
+
+- (CGRect)outputRegionAffectedByInputRegion:(CGRect)inputRegion atIndex:(NSInteger)textureIndex;
+{
+    // Transformed layers don't map changed regions simply onto the output, so every frame is redrawn in full
+    return kGPUImageFullFrameRegion;
+}
+
+- (CGRect)inputRegionNeededForOutputRegion:(CGRect)outputRegion atIndex:(NSInteger)textureIndex;
+{
+    return kGPUImageFullFrameRegion;
+}
+
+#pragma mark -
+#pragma mark Accessors
+
+- (NSUInteger)numberOfLayers;
+{
+    NSUInteger layerCount = 0;
+    for (NSUInteger layerIndex = 0; layerIndex < kGPUImageMaximumCompositedLayers; layerIndex++)
+    {
+        if (inputIsConnected[layerIndex + 1])
+        {
+            layerCount = layerIndex + 1;
+        }
+    }
+    
+    return layerCount;
+}
+
+- (NSUInteger)maximumLayersPerPass;
+{
+    return _maximumLayersPerPass;
+}
+
+@end
@@ -74,4 +74,9 @@ NSString *const kGPUImageLocalBinaryPatternFragmentShaderString = SHADER_STRING
     return self;
 }
 
+- (BOOL)providesMonochromeOutput;
+{
+    return YES;
+}
+
 @end
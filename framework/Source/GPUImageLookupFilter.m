@@ -50,4 +50,28 @@ NSString *const kGPUImageLookupFragmentShaderString = SHADER_STRING
     return self;
 }
 
+#pragma mark -
+#pragma mark Changed regions
+
+- (CGRect)outputRegionAffectedByInputRegion:(CGRect)inputRegion atIndex:(NSInteger)textureIndex;
+{
+    // Any pixel of the image can look up any entry in the table
+    if (textureIndex == 1)
+    {
+        return CGRectIsNull(inputRegion) ? CGRectNull : kGPUImageFullFrameRegion;
+    }
+    
+    return [super outputRegionAffectedByInputRegion:inputRegion atIndex:textureIndex];
+}
+
+- (CGRect)inputRegionNeededForOutputRegion:(CGRect)outputRegion atIndex:(NSInteger)textureIndex;
+{
+    if (textureIndex == 1)
+    {
+        return kGPUImageFullFrameRegion;
+    }
+    
+    return [super inputRegionNeededForOutputRegion:outputRegion atIndex:textureIndex];
+}
+
 @end
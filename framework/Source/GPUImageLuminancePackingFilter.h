@@ -0,0 +1,12 @@
+#import "GPUImageFilter.h"
+
+/** Packs the luminance of four horizontally adjacent pixels into the four components of each output texel
+
+ This starts a packed monochrome chain, where each fragment processed stands for four pixels. Luminance-only analysis then runs a quarter of the fragment shader invocations and moves a quarter of the bytes per pass, which matters most on devices that can't render into single channel textures. Follow this with the GPUImagePacked filters and finish with a GPUImageLuminanceUnpackingFilter. The output is a quarter of the input width, rounded up, with edge pixels repeated to fill the last texel. Input is expected to be unrotated.
+ */
+@interface GPUImageLuminancePackingFilter : GPUImageFilter
+{
+    GLint texelWidthUniform, widthScaleUniform;
+}
+
+@end
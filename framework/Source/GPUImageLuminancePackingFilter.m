@@ -0,0 +1,106 @@
+#import "GPUImageLuminancePackingFilter.h"
+
+NSString *const kGPUImageLuminancePackingVertexShaderString = SHADER_STRING
+(
+ attribute vec4 position;
+ attribute vec4 inputTextureCoordinate;
+ 
+ uniform highp float texelWidth;
+ uniform highp float widthScale;
+ 
+ varying vec2 firstTextureCoordinate;
+ varying vec2 secondTextureCoordinate;
+ varying vec2 thirdTextureCoordinate;
+ varying vec2 fourthTextureCoordinate;
+ 
+ void main()
+ {
+     gl_Position = position;
+     
+     // The center of each output texel lies between the second and third of the four input pixels it packs
+     vec2 blockCenterCoordinate = vec2(inputTextureCoordinate.x * widthScale, inputTextureCoordinate.y);
+     firstTextureCoordinate = blockCenterCoordinate - vec2(1.5 * texelWidth, 0.0);
+     secondTextureCoordinate = blockCenterCoordinate - vec2(0.5 * texelWidth, 0.0);
+     thirdTextureCoordinate = blockCenterCoordinate + vec2(0.5 * texelWidth, 0.0);
+     fourthTextureCoordinate = blockCenterCoordinate + vec2(1.5 * texelWidth, 0.0);
+ }
+);
+
+NSString *const kGPUImageLuminancePackingFragmentShaderString = SHADER_STRING
+(
+ precision lowp float;
+ 
+ uniform sampler2D inputImageTexture;
+ 
+ varying highp vec2 firstTextureCoordinate;
+ varying highp vec2 secondTextureCoordinate;
+ varying highp vec2 thirdTextureCoordinate;
+ varying highp vec2 fourthTextureCoordinate;
+ 
+ const mediump vec3 W = vec3(0.2125, 0.7154, 0.0721);
+ 
+ void main()
+ {
+     float firstIntensity = dot(texture2D(inputImageTexture, firstTextureCoordinate).rgb, W);
+     float secondIntensity = dot(texture2D(inputImageTexture, secondTextureCoordinate).rgb, W);
+     float thirdIntensity = dot(texture2D(inputImageTexture, thirdTextureCoordinate).rgb, W);
+     float fourthIntensity = dot(texture2D(inputImageTexture, fourthTextureCoordinate).rgb, W);
+     
+     gl_FragColor = vec4(firstIntensity, secondIntensity, thirdIntensity, fourthIntensity);
+ }
+);
+
+@implementation GPUImageLuminancePackingFilter
+
+#pragma mark -
+#pragma mark Initialization and teardown
+
+- (id)init;
+{
+    if (!(self = [super initWithVertexShaderFromString:kGPUImageLuminancePackingVertexShaderString fragmentShaderFromString:kGPUImageLuminancePackingFragmentShaderString]))
+    {
+        return nil;
+    }
+    
+    texelWidthUniform = [filterProgram uniformIndex:@"texelWidth"];
+    widthScaleUniform = [filterProgram uniformIndex:@"widthScale"];
+    
+    return self;
+}
+
+- (void)setupFilterForSize:(CGSize)filterFrameSize;
+{
+    GLfloat texelWidth = 1.0 / inputTextureSize.width;
+    // Widths that aren't a multiple of four leave the last texel hanging past the edge of the input
+    GLfloat widthScale = (filterFrameSize.width * 4.0) / inputTextureSize.width;
+    
+    runSynchronouslyOnVideoProcessingQueue(^{
+        [GPUImageOpenGLESContext setActiveShaderProgram:filterProgram];
+        glUniform1f(texelWidthUniform, texelWidth);
+        glUniform1f(widthScaleUniform, widthScale);
+    });
+}
+
+- (BOOL)wantsMipmappedInputOfSize:(CGSize)inputSize atIndex:(NSInteger)textureIndex;
+{
+    // Packing reads each input pixel individually, so it needs the full-resolution input
+    return NO;
+}
+
+#pragma mark -
+#pragma mark Managing the display FBOs
+
+- (CGSize)sizeOfFBO;
+{
+    return [self outputFrameSize];
+}
+
+#pragma mark -
+#pragma mark Rendering
+
+- (CGSize)outputFrameSize;
+{
+    return CGSizeMake(ceil(inputTextureSize.width / 4.0), inputTextureSize.height);
+}
+
+@end
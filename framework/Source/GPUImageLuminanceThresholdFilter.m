@@ -39,6 +39,11 @@ NSString *const kGPUImageLuminanceThresholdFragmentShaderString = SHADER_STRING
     return self;
 }
 
+- (BOOL)providesMonochromeOutput;
+{
+    return YES;
+}
+
 #pragma mark -
 #pragma mark Accessors
 
@@ -0,0 +1,12 @@
+#import "GPUImageFilter.h"
+
+/** Expands the output of a packed monochrome chain back into one grayscale pixel per input pixel
+
+ The output is four times the width of the packed input, so it can be up to three pixels wider than the image that was packed.
+ */
+@interface GPUImageLuminanceUnpackingFilter : GPUImageFilter
+{
+    GLint packedWidthUniform;
+}
+
+@end
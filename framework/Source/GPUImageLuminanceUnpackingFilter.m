@@ -0,0 +1,73 @@
+#import "GPUImageLuminanceUnpackingFilter.h"
+
+NSString *const kGPUImageLuminanceUnpackingFragmentShaderString = SHADER_STRING
+(
+ varying highp vec2 textureCoordinate;
+ 
+ uniform sampler2D inputImageTexture;
+ uniform highp float packedWidth;
+ 
+ void main()
+ {
+     highp float pixelPosition = textureCoordinate.x * packedWidth * 4.0;
+     highp float texelIndex = floor(pixelPosition / 4.0);
+     highp float componentIndex = floor(pixelPosition - (texelIndex * 4.0));
+     
+     // Sampling at the texel center keeps linear filtering from blending in the neighboring texel's pixels
+     lowp vec4 packedIntensities = texture2D(inputImageTexture, vec2((texelIndex + 0.5) / packedWidth, textureCoordinate.y));
+     lowp vec4 componentSelector = vec4(equal(vec4(componentIndex), vec4(0.0, 1.0, 2.0, 3.0)));
+     lowp float intensity = dot(packedIntensities, componentSelector);
+     
+     gl_FragColor = vec4(vec3(intensity), 1.0);
+ }
+);
+
+@implementation GPUImageLuminanceUnpackingFilter
+
+#pragma mark -
+#pragma mark Initialization and teardown
+
+- (id)init;
+{
+    if (!(self = [super initWithFragmentShaderFromString:kGPUImageLuminanceUnpackingFragmentShaderString]))
+    {
+        return nil;
+    }
+    
+    packedWidthUniform = [filterProgram uniformIndex:@"packedWidth"];
+    
+    return self;
+}
+
+- (void)setupFilterForSize:(CGSize)filterFrameSize;
+{
+    GLfloat packedWidth = inputTextureSize.width;
+    
+    runSynchronouslyOnVideoProcessingQueue(^{
+        [GPUImageOpenGLESContext setActiveShaderProgram:filterProgram];
+        glUniform1f(packedWidthUniform, packedWidth);
+    });
+}
+
+- (BOOL)providesMonochromeOutput;
+{
+    return YES;
+}
+
+#pragma mark -
+#pragma mark Managing the display FBOs
+
+- (CGSize)sizeOfFBO;
+{
+    return [self outputFrameSize];
+}
+
+#pragma mark -
+#pragma mark Rendering
+
+- (CGSize)outputFrameSize;
+{
+    return CGSizeMake(inputTextureSize.width * 4.0, inputTextureSize.height);
+}
+
+@end
@@ -137,4 +137,18 @@ NSString *const kGPUImageMosaicFragmentShaderString = SHADER_STRING
     [pic processImage];
 }
 
+#pragma mark -
+#pragma mark Changed regions
+
+- (CGRect)outputRegionAffectedByInputRegion:(CGRect)inputRegion atIndex:(NSInteger)textureIndex;
+{
+    // Each tile takes its color from a single sample of the image and is drawn from anywhere in the tile set
+    return kGPUImageFullFrameRegion;
+}
+
+- (CGRect)inputRegionNeededForOutputRegion:(CGRect)outputRegion atIndex:(NSInteger)textureIndex;
+{
+    return kGPUImageFullFrameRegion;
+}
+
 @end
@@ -2,6 +2,7 @@
 #import <AVFoundation/AVFoundation.h>
 #import "GPUImageOpenGLESContext.h"
 #import "GPUImageOutput.h"
+#import "GPUImageVideoSource.h"
 
 /** Protocol for getting Movie played callback.
  */
@@ -12,7 +13,7 @@
 
 /** Source object for filtering movies
  */
-@interface GPUImageMovie : GPUImageOutput
+@interface GPUImageMovie : GPUImageOutput <GPUImageVideoSource>
 
 @property (readwrite, retain) AVAsset *asset;
 @property(readwrite, retain) NSURL *url;
@@ -25,6 +26,22 @@
  */
 @property(readwrite, nonatomic) BOOL playAtActualSpeed;
 
+/** Whether to have frames decoded as YUV planes that are converted to RGB on the GPU, rather than as BGRA converted by the decoder. This is faster and uploads less than half the bytes per frame, and filters that want monochrome input get the luminance plane without any conversion. Defaults to YES, and takes effect the next time processing starts.
+ */
+@property(readwrite, nonatomic) BOOL decodeAsYUV;
+
+/** The part of the movie to read, for both video and audio. Defaults to kCMTimeRangeInvalid, which reads the whole movie, and takes effect the next time processing starts.
+ */
+@property(readwrite, nonatomic) CMTimeRange timeRange;
+
+/** The number of decoded frames around the playhead kept by seekToTime:, which hold on to memory for full decoded frames. Defaults to 16.
+ */
+@property(readwrite, nonatomic) NSUInteger maximumCachedSeekFrames;
+
+/** The number of frames decoded ahead on a separate queue while earlier ones are rendered, so that decoding and rendering overlap rather than taking turns. 0 decodes each frame only when it's needed. Defaults to 3, and takes effect the next time processing starts.
+ */
+@property(readwrite, nonatomic) NSUInteger maximumPrefetchedFrames;
+
 /** This is used to send the delete Movie did complete playing alert
  */
 @property (readwrite, nonatomic, assign) id <GPUImageMovieDelegate>delegate;
@@ -35,11 +52,24 @@
 - (void)textureCacheSetup;
 
 /// @name Movie processing
-- (void)enableSynchronizedEncodingUsingMovieWriter:(GPUImageMovieWriter *)movieWriter;
+- (void)enableSynchronizedEncodingUsingMovieWriter:(id<GPUImageVideoSink>)movieWriter;
 - (void)readNextVideoFrameFromOutput:(AVAssetReaderTrackOutput *)readerVideoTrackOutput;
 - (void)readNextAudioSampleFromOutput:(AVAssetReaderTrackOutput *)readerAudioTrackOutput;
 - (void)startProcessing;
 - (void)endProcessing;
 - (void)processMovieFrame:(CMSampleBufferRef)movieSampleBuffer; 
+- (void)processMovieFrame:(CVPixelBufferRef)movieFrame withSampleTime:(CMTime)currentSampleTime;
+
+/// @name Seeking
+
+/** Sends the frame on screen at seekTime through the targets, or the first or last frame for times outside the movie
+ 
+ Decoding starts from the keyframe before seekTime, and the frames decoded around it are kept, so that seeking to nearby times afterwards only re-renders them. This runs synchronously and shouldn't be used while the movie is being processed.
+ */
+- (void)seekToTime:(CMTime)seekTime;
+
+/** Drops the frames kept from earlier seeks
+ */
+- (void)clearSeekCache;
 
 @end
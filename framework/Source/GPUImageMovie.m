@@ -1,17 +1,38 @@
 #import "GPUImageMovie.h"
 #import "GPUImageMovieWriter.h"
+#import "GPUImageYUVConverter.h"
 
 @interface GPUImageMovie ()
 {
     BOOL audioEncodingIsFinished, videoEncodingIsFinished;
-    GPUImageMovieWriter *synchronizedMovieWriter;
+    id<GPUImageVideoSink> synchronizedMovieWriter;
     CVOpenGLESTextureCacheRef coreVideoTextureCache;
     AVAssetReader *reader;
     CMTime previousFrameTime;
     CFAbsoluteTime previousActualFrameTime;
+    
+    GPUImageYUVConverter *yuvConverter;
+    CGSize yuvConversionOutputSize;
+
+    NSMutableArray *cachedSeekFrames, *cachedSeekFrameTimes;
+    CMTime cachedSeekFrameDuration;
+
+    dispatch_queue_t decodingQueue;
+    NSCondition *prefetchCondition;
+    NSMutableArray *prefetchedSampleBuffers;
+    BOOL isPrefetching, prefetchingIsFinished, prefetchingIsCancelled;
 }
 
 - (void)processAsset;
+- (NSDictionary *)videoOutputSettings;
+- (NSUInteger)indexOfCachedFrameForTime:(CMTime)frameTime;
+- (CMTime)frameDurationOfTrack:(AVAssetTrack *)videoTrack;
+- (BOOL)decodeSeekFramesAroundTime:(CMTime)seekTime;
+- (void)processYUVMovieFrame:(CVPixelBufferRef)movieFrame atTime:(CMTime)currentSampleTime;
+- (void)processVideoSampleBuffer:(CMSampleBufferRef)sampleBufferRef;
+- (void)startPrefetchingFromOutput:(AVAssetReaderTrackOutput *)readerVideoTrackOutput;
+- (CMSampleBufferRef)copyNextPrefetchedSampleBuffer;
+- (void)stopPrefetching;
 
 @end
 
@@ -21,6 +42,10 @@
 @synthesize asset = _asset;
 @synthesize runBenchmark = _runBenchmark;
 @synthesize playAtActualSpeed = _playAtActualSpeed;
+@synthesize decodeAsYUV = _decodeAsYUV;
+@synthesize timeRange = _timeRange;
+@synthesize maximumCachedSeekFrames = _maximumCachedSeekFrames;
+@synthesize maximumPrefetchedFrames = _maximumPrefetchedFrames;
 @synthesize delegate = _delegate;
 
 #pragma mark -
@@ -36,6 +61,10 @@
     [self textureCacheSetup];
 
     self.url = url;
+    self.decodeAsYUV = YES;
+    self.timeRange = kCMTimeRangeInvalid;
+    self.maximumCachedSeekFrames = 16;
+    self.maximumPrefetchedFrames = 3;
     self.asset = nil;
 
     return self;
@@ -52,6 +81,10 @@
 
     self.url = nil;
     self.asset = asset;
+    self.decodeAsYUV = YES;
+    self.timeRange = kCMTimeRangeInvalid;
+    self.maximumCachedSeekFrames = 16;
+    self.maximumPrefetchedFrames = 3;
 
     return self;
 }
@@ -80,15 +113,25 @@
 
 - (void)dealloc
 {
+    [self stopPrefetching];
+
     if ([GPUImageOpenGLESContext supportsFastTextureUpload])
     {
         CFRelease(coreVideoTextureCache);
     }
+
+    // ARC forbids explicit message send of 'release'; since iOS 6 even for dispatch_release() calls: stripping it out in that case is required.
+#if ( (__IPHONE_OS_VERSION_MIN_REQUIRED < __IPHONE_6_0) || (!defined(__IPHONE_6_0)) )
+    if (decodingQueue != NULL)
+    {
+        dispatch_release(decodingQueue);
+    }
+#endif
 }
 #pragma mark -
 #pragma mark Movie processing
 
-- (void)enableSynchronizedEncodingUsingMovieWriter:(GPUImageMovieWriter *)movieWriter;
+- (void)enableSynchronizedEncodingUsingMovieWriter:(id<GPUImageVideoSink>)movieWriter;
 {
     synchronizedMovieWriter = movieWriter;
     movieWriter.encodingLiveVideo = NO;
@@ -125,10 +168,19 @@
     NSError *error = nil;
     reader = [AVAssetReader assetReaderWithAsset:self.asset error:&error];
 
-    NSMutableDictionary *outputSettings = [NSMutableDictionary dictionary];
-    [outputSettings setObject: [NSNumber numberWithInt:kCVPixelFormatType_32BGRA]  forKey: (NSString*)kCVPixelBufferPixelFormatTypeKey];
+    // Both are left set by the end of a previous run, and the read loop below waits on videoEncodingIsFinished
+    videoEncodingIsFinished = NO;
+    audioEncodingIsFinished = NO;
+
+    // A texture left over from converting the frames of an earlier run won't be used by this one, whichever way it decodes
+    runSynchronouslyOnVideoProcessingQueue(^{
+        [GPUImageOpenGLESContext useImageProcessingContext];
+        [self deleteOutputTexture];
+        yuvConversionOutputSize = CGSizeZero;
+    });
+
     // Maybe set alwaysCopiesSampleData to NO on iOS 5.0 for faster video decoding
-    AVAssetReaderTrackOutput *readerVideoTrackOutput = [AVAssetReaderTrackOutput assetReaderTrackOutputWithTrack:[[self.asset tracksWithMediaType:AVMediaTypeVideo] objectAtIndex:0] outputSettings:outputSettings];
+    AVAssetReaderTrackOutput *readerVideoTrackOutput = [AVAssetReaderTrackOutput assetReaderTrackOutputWithTrack:[[self.asset tracksWithMediaType:AVMediaTypeVideo] objectAtIndex:0] outputSettings:[self videoOutputSettings]];
     [reader addOutput:readerVideoTrackOutput];
 
     NSArray *audioTracks = [self.asset tracksWithMediaType:AVMediaTypeAudio];
@@ -137,19 +189,28 @@
 
     if (shouldRecordAudioTrack)
     {
-        audioEncodingIsFinished = NO;
-
         // This might need to be extended to handle movies with more than one audio track
         AVAssetTrack* audioTrack = [audioTracks objectAtIndex:0];
         readerAudioTrackOutput = [AVAssetReaderTrackOutput assetReaderTrackOutputWithTrack:audioTrack outputSettings:nil];
         [reader addOutput:readerAudioTrackOutput];
     }
 
+    if (CMTIMERANGE_IS_VALID(_timeRange))
+    {
+        reader.timeRange = _timeRange;
+    }
+
     if ([reader startReading] == NO) 
     {
             NSLog(@"Error reading from file at URL: %@", weakSelf.url);
         return;
     }
+
+    isPrefetching = NO;
+    if (_maximumPrefetchedFrames > 0)
+    {
+        [self startPrefetchingFromOutput:readerVideoTrackOutput];
+    }
         
     if (synchronizedMovieWriter != nil)
     {
@@ -165,7 +226,8 @@
     }
     else
     {
-        while (reader.status == AVAssetReaderStatusReading) 
+        // Prefetched frames can still be waiting to be processed after the reader has finished
+        while ((reader.status == AVAssetReaderStatusReading) || (isPrefetching && !videoEncodingIsFinished))
         {
                 [weakSelf readNextVideoFrameFromOutput:readerVideoTrackOutput];
 
@@ -185,39 +247,45 @@
     }
 }
 
+- (NSDictionary *)videoOutputSettings;
+{
+    if (_decodeAsYUV)
+    {
+        // Like the camera, ask for full range so that the Y plane can be handed to monochrome targets as is. Movies are encoded in video range, but the decoder expands it for free, where the raw 16 - 235 plane would leave those targets with washed-out blacks and whites
+        return [NSDictionary dictionaryWithObject:[NSNumber numberWithInt:kCVPixelFormatType_420YpCbCr8BiPlanarFullRange] forKey:(NSString*)kCVPixelBufferPixelFormatTypeKey];
+    }
+    else
+    {
+        return [NSDictionary dictionaryWithObject:[NSNumber numberWithInt:kCVPixelFormatType_32BGRA] forKey:(NSString*)kCVPixelBufferPixelFormatTypeKey];
+    }
+}
+
 - (void)readNextVideoFrameFromOutput:(AVAssetReaderTrackOutput *)readerVideoTrackOutput;
 {
-    if (reader.status == AVAssetReaderStatusReading)
+    if (isPrefetching)
+    {
+        if (videoEncodingIsFinished)
+        {
+            return;
+        }
+
+        CMSampleBufferRef sampleBufferRef = [self copyNextPrefetchedSampleBuffer];
+        if (sampleBufferRef)
+        {
+            [self processVideoSampleBuffer:sampleBufferRef];
+        }
+        else
+        {
+            videoEncodingIsFinished = YES;
+            [self endProcessing];
+        }
+    }
+    else if (reader.status == AVAssetReaderStatusReading)
     {
         CMSampleBufferRef sampleBufferRef = [readerVideoTrackOutput copyNextSampleBuffer];
         if (sampleBufferRef) 
         {
-            if (_playAtActualSpeed)
-            {
-                // Do this outside of the video processing queue to not slow that down while waiting
-                CMTime currentSampleTime = CMSampleBufferGetOutputPresentationTimeStamp(sampleBufferRef);
-                CMTime differenceFromLastFrame = CMTimeSubtract(currentSampleTime, previousFrameTime);
-                CFAbsoluteTime currentActualTime = CFAbsoluteTimeGetCurrent();
-                
-                CGFloat frameTimeDifference = CMTimeGetSeconds(differenceFromLastFrame);
-                CGFloat actualTimeDifference = currentActualTime - previousActualFrameTime;
-                
-                if (frameTimeDifference > actualTimeDifference)
-                {
-                    usleep(1000000.0 * (frameTimeDifference - actualTimeDifference));
-                }
-                
-                previousFrameTime = currentSampleTime;
-                previousActualFrameTime = CFAbsoluteTimeGetCurrent();
-            }
-
-            __unsafe_unretained GPUImageMovie *weakSelf = self;
-            runSynchronouslyOnVideoProcessingQueue(^{
-                [weakSelf processMovieFrame:sampleBufferRef];
-            });
-            
-            CMSampleBufferInvalidate(sampleBufferRef);
-            CFRelease(sampleBufferRef);
+            [self processVideoSampleBuffer:sampleBufferRef];
         }
         else
         {
@@ -234,6 +302,36 @@
     }
 }
 
+- (void)processVideoSampleBuffer:(CMSampleBufferRef)sampleBufferRef;
+{
+    if (_playAtActualSpeed)
+    {
+        // Do this outside of the video processing queue to not slow that down while waiting
+        CMTime currentSampleTime = CMSampleBufferGetOutputPresentationTimeStamp(sampleBufferRef);
+        CMTime differenceFromLastFrame = CMTimeSubtract(currentSampleTime, previousFrameTime);
+        CFAbsoluteTime currentActualTime = CFAbsoluteTimeGetCurrent();
+        
+        CGFloat frameTimeDifference = CMTimeGetSeconds(differenceFromLastFrame);
+        CGFloat actualTimeDifference = currentActualTime - previousActualFrameTime;
+        
+        if (frameTimeDifference > actualTimeDifference)
+        {
+            usleep(1000000.0 * (frameTimeDifference - actualTimeDifference));
+        }
+        
+        previousFrameTime = currentSampleTime;
+        previousActualFrameTime = CFAbsoluteTimeGetCurrent();
+    }
+
+    __unsafe_unretained GPUImageMovie *weakSelf = self;
+    runSynchronouslyOnVideoProcessingQueue(^{
+        [weakSelf processMovieFrame:sampleBufferRef];
+    });
+    
+    CMSampleBufferInvalidate(sampleBufferRef);
+    CFRelease(sampleBufferRef);
+}
+
 - (void)readNextAudioSampleFromOutput:(AVAssetReaderTrackOutput *)readerAudioTrackOutput;
 {
     if (audioEncodingIsFinished)
@@ -266,6 +364,11 @@
     CMTime currentSampleTime = CMSampleBufferGetOutputPresentationTimeStamp(movieSampleBuffer);
     CVImageBufferRef movieFrame = CMSampleBufferGetImageBuffer(movieSampleBuffer);
 
+    [self processMovieFrame:movieFrame withSampleTime:currentSampleTime];
+}
+
+- (void)processMovieFrame:(CVPixelBufferRef)movieFrame withSampleTime:(CMTime)currentSampleTime;
+{
     int bufferHeight = CVPixelBufferGetHeight(movieFrame);
 #if TARGET_IPHONE_SIMULATOR
     int bufferWidth = CVPixelBufferGetBytesPerRow(movieFrame) / 4; // This works around certain movie frame types on the Simulator (see https://github.com/BradLarson/GPUImage/issues/424)
@@ -275,7 +378,11 @@
 
     CFAbsoluteTime startTime = CFAbsoluteTimeGetCurrent();
 
-    if ([GPUImageOpenGLESContext supportsFastTextureUpload])
+    if (CVPixelBufferGetPlaneCount(movieFrame) > 0) // Check for YUV planar frames to convert to RGB on the GPU
+    {
+        [self processYUVMovieFrame:movieFrame atTime:currentSampleTime];
+    }
+    else if ([GPUImageOpenGLESContext supportsFastTextureUpload])
     {
         CVPixelBufferLockBaseAddress(movieFrame, 0);
         
@@ -298,6 +405,11 @@
         
         for (id<GPUImageInput> currentTarget in targets)
         {
+            if (![self shouldSendFrameAtTime:currentSampleTime toTarget:currentTarget])
+            {
+                continue;
+            }
+            
             NSInteger indexOfObject = [targets indexOfObject:currentTarget];
             NSInteger targetTextureIndex = [[targetTextureIndices objectAtIndex:indexOfObject] integerValue];
             
@@ -327,6 +439,11 @@
         CGSize currentSize = CGSizeMake(bufferWidth, bufferHeight);
         for (id<GPUImageInput> currentTarget in targets)
         {
+            if (![self shouldSendFrameAtTime:currentSampleTime toTarget:currentTarget])
+            {
+                continue;
+            }
+            
             NSInteger indexOfObject = [targets indexOfObject:currentTarget];
             NSInteger targetTextureIndex = [[targetTextureIndices objectAtIndex:indexOfObject] integerValue];
 
@@ -343,8 +460,120 @@
     }
 }
 
+- (void)processYUVMovieFrame:(CVPixelBufferRef)movieFrame atTime:(CMTime)currentSampleTime;
+{
+    int bufferWidth = (int)CVPixelBufferGetWidth(movieFrame);
+    int bufferHeight = (int)CVPixelBufferGetHeight(movieFrame);
+    CGSize currentSize = CGSizeMake(bufferWidth, bufferHeight);
+    
+    [GPUImageOpenGLESContext useImageProcessingContext];
+    CVPixelBufferLockBaseAddress(movieFrame, 0);
+    
+    if (yuvConverter == nil)
+    {
+        yuvConverter = [[GPUImageYUVConverter alloc] initWithPlaneLayout:kGPUImageYUVBiPlanar];
+    }
+    [yuvConverter matchColorSpaceOfPixelBuffer:movieFrame];
+    
+    CVOpenGLESTextureRef planeTextureRefs[2] = {NULL, NULL};
+    for (NSUInteger planeIndex = 0; planeIndex < 2; planeIndex++)
+    {
+        int planeWidth = (int)CVPixelBufferGetWidthOfPlane(movieFrame, planeIndex);
+        int planeHeight = (int)CVPixelBufferGetHeightOfPlane(movieFrame, planeIndex);
+        
+        if ([GPUImageOpenGLESContext supportsFastTextureUpload])
+        {
+            GLenum planeFormat = (planeIndex == 0) ? GL_LUMINANCE : GL_LUMINANCE_ALPHA;
+            CVReturn err = CVOpenGLESTextureCacheCreateTextureFromImage(kCFAllocatorDefault, coreVideoTextureCache, movieFrame, NULL, GL_TEXTURE_2D, planeFormat, planeWidth, planeHeight, planeFormat, GL_UNSIGNED_BYTE, planeIndex, &planeTextureRefs[planeIndex]);
+            if (!planeTextureRefs[planeIndex] || err)
+            {
+                NSLog(@"Movie CVOpenGLESTextureCacheCreateTextureFromImage failed (error: %d)", err);
+                break;
+            }
+            
+            GLuint planeTexture = CVOpenGLESTextureGetName(planeTextureRefs[planeIndex]);
+            glBindTexture(GL_TEXTURE_2D, planeTexture);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+            [yuvConverter setTexture:planeTexture forPlane:planeIndex];
+        }
+        else
+        {
+            [yuvConverter uploadPlane:planeIndex fromBytes:CVPixelBufferGetBaseAddressOfPlane(movieFrame, planeIndex) width:planeWidth height:planeHeight bytesPerRow:CVPixelBufferGetBytesPerRowOfPlane(movieFrame, planeIndex)];
+        }
+    }
+    
+    if ( ![GPUImageOpenGLESContext supportsFastTextureUpload] || ((planeTextureRefs[0] != NULL) && (planeTextureRefs[1] != NULL)) )
+    {
+        // Filters that only want luminance read the Y plane directly, so conversion is only needed when something wants color or the plane is still in video range
+        BOOL canShareLuminancePlane = [yuvConverter fullRange];
+        if (!allTargetsWantMonochromeData || !canShareLuminancePlane)
+        {
+            if (!CGSizeEqualToSize(currentSize, yuvConversionOutputSize))
+            {
+                [self initializeOutputTextureIfNeeded];
+                glBindTexture(GL_TEXTURE_2D, outputTexture);
+                glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, bufferWidth, bufferHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+                yuvConversionOutputSize = currentSize;
+            }
+            
+            [yuvConverter convertToTexture:outputTexture ofSize:currentSize];
+        }
+        
+        for (id<GPUImageInput> currentTarget in targets)
+        {
+            if (![self shouldSendFrameAtTime:currentSampleTime toTarget:currentTarget])
+            {
+                continue;
+            }
+            
+            NSInteger indexOfObject = [targets indexOfObject:currentTarget];
+            NSInteger targetTextureIndex = [[targetTextureIndices objectAtIndex:indexOfObject] integerValue];
+            
+            if ([currentTarget wantsMonochromeInput] && canShareLuminancePlane)
+            {
+                [currentTarget setCurrentlyReceivingMonochromeInput:YES];
+                [currentTarget setInputTexture:[yuvConverter luminanceTexture] atIndex:targetTextureIndex];
+            }
+            else
+            {
+                [currentTarget setCurrentlyReceivingMonochromeInput:NO];
+                [currentTarget setInputTexture:outputTexture atIndex:targetTextureIndex];
+            }
+            
+            [currentTarget setInputSize:currentSize atIndex:targetTextureIndex];
+            [currentTarget newFrameReadyAtTime:currentSampleTime atIndex:targetTextureIndex];
+        }
+    }
+    
+    CVPixelBufferUnlockBaseAddress(movieFrame, 0);
+    
+    if ([GPUImageOpenGLESContext supportsFastTextureUpload])
+    {
+        CVOpenGLESTextureCacheFlush(coreVideoTextureCache, 0);
+        for (NSUInteger planeIndex = 0; planeIndex < 2; planeIndex++)
+        {
+            if (planeTextureRefs[planeIndex] != NULL)
+            {
+                CFRelease(planeTextureRefs[planeIndex]);
+            }
+        }
+    }
+}
+
 - (void)endProcessing;
 {
+    if (isPrefetching)
+    {
+        // The decoder owns the video output while prefetching, so ending early has to stop the reader and the decoder together
+        videoEncodingIsFinished = YES;
+        if (reader.status == AVAssetReaderStatusReading)
+        {
+            [reader cancelReading];
+        }
+        [self stopPrefetching];
+    }
+
     for (id<GPUImageInput> currentTarget in targets)
     {
         [currentTarget endProcessing];
@@ -357,4 +586,232 @@
     }
 }
 
+#pragma mark -
+#pragma mark Prefetching
+
+- (void)startPrefetchingFromOutput:(AVAssetReaderTrackOutput *)readerVideoTrackOutput;
+{
+    [self stopPrefetching];
+
+    if (decodingQueue == NULL)
+    {
+        decodingQueue = dispatch_queue_create("com.sunsetlakesoftware.GPUImage.movieDecodingQueue", NULL);
+        prefetchCondition = [[NSCondition alloc] init];
+    }
+
+    [prefetchCondition lock];
+    prefetchedSampleBuffers = [[NSMutableArray alloc] init];
+    prefetchingIsFinished = NO;
+    prefetchingIsCancelled = NO;
+    isPrefetching = YES;
+    [prefetchCondition unlock];
+
+    NSUInteger maximumPrefetchedFrames = _maximumPrefetchedFrames;
+    NSMutableArray *sampleBufferRing = prefetchedSampleBuffers;
+    NSCondition *ringCondition = prefetchCondition;
+
+    // Decoding runs ahead on its own queue, so the next frame is usually ready by the time the last one has been rendered
+    dispatch_async(decodingQueue, ^{
+        BOOL reachedEndOfOutput = NO;
+        while (!reachedEndOfOutput)
+        {
+            CMSampleBufferRef sampleBufferRef = [readerVideoTrackOutput copyNextSampleBuffer];
+            reachedEndOfOutput = (sampleBufferRef == NULL);
+
+            [ringCondition lock];
+            while (([sampleBufferRing count] >= maximumPrefetchedFrames) && !prefetchingIsCancelled)
+            {
+                [ringCondition wait];
+            }
+
+            if (prefetchingIsCancelled)
+            {
+                reachedEndOfOutput = YES;
+            }
+            else if (sampleBufferRef != NULL)
+            {
+                [sampleBufferRing addObject:(__bridge id)sampleBufferRef];
+            }
+
+            if (reachedEndOfOutput)
+            {
+                prefetchingIsFinished = YES;
+            }
+            [ringCondition broadcast];
+            [ringCondition unlock];
+
+            if (sampleBufferRef != NULL)
+            {
+                CFRelease(sampleBufferRef);
+            }
+        }
+    });
+}
+
+- (CMSampleBufferRef)copyNextPrefetchedSampleBuffer;
+{
+    [prefetchCondition lock];
+    while (([prefetchedSampleBuffers count] == 0) && !prefetchingIsFinished && !prefetchingIsCancelled)
+    {
+        [prefetchCondition wait];
+    }
+
+    CMSampleBufferRef sampleBufferRef = NULL;
+    if ([prefetchedSampleBuffers count] > 0)
+    {
+        sampleBufferRef = (CMSampleBufferRef)CFRetain((__bridge CFTypeRef)[prefetchedSampleBuffers objectAtIndex:0]);
+        [prefetchedSampleBuffers removeObjectAtIndex:0];
+    }
+    [prefetchCondition broadcast];
+    [prefetchCondition unlock];
+
+    return sampleBufferRef;
+}
+
+- (void)stopPrefetching;
+{
+    if (prefetchCondition == nil)
+    {
+        return;
+    }
+
+    [prefetchCondition lock];
+    prefetchingIsCancelled = YES;
+    [prefetchedSampleBuffers removeAllObjects];
+    [prefetchCondition broadcast];
+    [prefetchCondition unlock];
+
+    // The decoder may still be inside copyNextSampleBuffer, so let it see the cancellation and leave before the next run starts
+    dispatch_sync(decodingQueue, ^{});
+}
+
+#pragma mark -
+#pragma mark Seeking
+
+- (void)seekToTime:(CMTime)seekTime;
+{
+    // The reader has nothing to hand back for a window that starts after the last frame, so seeks past the end land on that frame instead
+    NSArray *videoTracks = [self.asset tracksWithMediaType:AVMediaTypeVideo];
+    if ([videoTracks count] > 0)
+    {
+        AVAssetTrack *videoTrack = [videoTracks objectAtIndex:0];
+        CMTime lastFrameTime = CMTimeSubtract(CMTimeRangeGetEnd(videoTrack.timeRange), [self frameDurationOfTrack:videoTrack]);
+        seekTime = CMTimeMaximum(videoTrack.timeRange.start, CMTimeMinimum(seekTime, lastFrameTime));
+    }
+
+    NSUInteger cachedFrameIndex = [self indexOfCachedFrameForTime:seekTime];
+    if (cachedFrameIndex == NSNotFound)
+    {
+        if (![self decodeSeekFramesAroundTime:seekTime])
+        {
+            return;
+        }
+
+        cachedFrameIndex = [self indexOfCachedFrameForTime:seekTime];
+        if (cachedFrameIndex == NSNotFound)
+        {
+            // Frame times don't always line up exactly with the track's time range, so a seek that still falls just outside the decoded frames shows whichever is closest
+            cachedFrameIndex = (CMTIME_COMPARE_INLINE(seekTime, <, [[cachedSeekFrameTimes objectAtIndex:0] CMTimeValue])) ? 0 : ([cachedSeekFrames count] - 1);
+        }
+    }
+
+    CVPixelBufferRef cachedFrame = (__bridge CVPixelBufferRef)[cachedSeekFrames objectAtIndex:cachedFrameIndex];
+    CMTime cachedFrameTime = [[cachedSeekFrameTimes objectAtIndex:cachedFrameIndex] CMTimeValue];
+
+    runSynchronouslyOnVideoProcessingQueue(^{
+        [self processMovieFrame:cachedFrame withSampleTime:cachedFrameTime];
+    });
+}
+
+- (void)clearSeekCache;
+{
+    cachedSeekFrames = nil;
+    cachedSeekFrameTimes = nil;
+}
+
+- (NSUInteger)indexOfCachedFrameForTime:(CMTime)frameTime;
+{
+    NSUInteger numberOfCachedFrames = [cachedSeekFrameTimes count];
+    for (NSUInteger frameIndex = 0; frameIndex < numberOfCachedFrames; frameIndex++)
+    {
+        CMTime currentFrameTime = [[cachedSeekFrameTimes objectAtIndex:frameIndex] CMTimeValue];
+        CMTime nextFrameTime = (frameIndex + 1 < numberOfCachedFrames) ? [[cachedSeekFrameTimes objectAtIndex:(frameIndex + 1)] CMTimeValue] : CMTimeAdd(currentFrameTime, cachedSeekFrameDuration);
+
+        // A frame stays on screen until the next one's time
+        if (CMTIME_COMPARE_INLINE(currentFrameTime, <=, frameTime) && CMTIME_COMPARE_INLINE(frameTime, <, nextFrameTime))
+        {
+            return frameIndex;
+        }
+    }
+
+    return NSNotFound;
+}
+
+- (CMTime)frameDurationOfTrack:(AVAssetTrack *)videoTrack;
+{
+    CMTime frameDuration = videoTrack.minFrameDuration;
+    if (!CMTIME_IS_NUMERIC(frameDuration) || (CMTimeGetSeconds(frameDuration) <= 0.0))
+    {
+        frameDuration = CMTimeMakeWithSeconds(1.0 / MAX(videoTrack.nominalFrameRate, 1.0), 600);
+    }
+    
+    return frameDuration;
+}
+
+- (BOOL)decodeSeekFramesAroundTime:(CMTime)seekTime;
+{
+    NSArray *videoTracks = [self.asset tracksWithMediaType:AVMediaTypeVideo];
+    if ([videoTracks count] == 0)
+    {
+        return NO;
+    }
+
+    AVAssetTrack *videoTrack = [videoTracks objectAtIndex:0];
+    CMTime frameDuration = [self frameDurationOfTrack:videoTrack];
+
+    // Center the window on the playhead, so scrubbing in either direction stays within it for a while
+    NSUInteger framesToCache = MAX(_maximumCachedSeekFrames, 1);
+    CMTime windowStartTime = CMTimeMaximum(videoTrack.timeRange.start, CMTimeSubtract(seekTime, CMTimeMultiply(frameDuration, (int32_t)(framesToCache / 2))));
+    CMTimeRange windowTimeRange = CMTimeRangeMake(windowStartTime, CMTimeMultiply(frameDuration, (int32_t)framesToCache));
+
+    NSError *error = nil;
+    AVAssetReader *seekReader = [AVAssetReader assetReaderWithAsset:self.asset error:&error];
+    AVAssetReaderTrackOutput *seekOutput = [AVAssetReaderTrackOutput assetReaderTrackOutputWithTrack:videoTrack outputSettings:[self videoOutputSettings]];
+    [seekReader addOutput:seekOutput];
+    // The reader decodes from the keyframe before the start of the window, but only hands back frames from around the window onward
+    seekReader.timeRange = windowTimeRange;
+
+    if ((seekReader == nil) || ![seekReader startReading])
+    {
+        NSLog(@"Error seeking in movie: %@", error);
+        return NO;
+    }
+
+    NSMutableArray *decodedFrames = [[NSMutableArray alloc] init];
+    NSMutableArray *decodedFrameTimes = [[NSMutableArray alloc] init];
+    CMSampleBufferRef sampleBuffer = NULL;
+    while ((sampleBuffer = [seekOutput copyNextSampleBuffer]) != NULL)
+    {
+        CVImageBufferRef decodedFrame = CMSampleBufferGetImageBuffer(sampleBuffer);
+        if ((decodedFrame != NULL) && ([decodedFrames count] < framesToCache))
+        {
+            [decodedFrames addObject:(__bridge id)decodedFrame];
+            [decodedFrameTimes addObject:[NSValue valueWithCMTime:CMSampleBufferGetOutputPresentationTimeStamp(sampleBuffer)]];
+        }
+        CFRelease(sampleBuffer);
+    }
+    [seekReader cancelReading];
+
+    if ([decodedFrames count] == 0)
+    {
+        return NO;
+    }
+
+    cachedSeekFrames = decodedFrames;
+    cachedSeekFrameTimes = decodedFrameTimes;
+    cachedSeekFrameDuration = frameDuration;
+
+    return YES;
+}
+
 @end
@@ -1,6 +1,7 @@
 #import <Foundation/Foundation.h>
 #import <AVFoundation/AVFoundation.h>
 #import "GPUImageOpenGLESContext.h"
+#import "GPUImageVideoSink.h"
 
 extern NSString *const kGPUImageColorSwizzlingFragmentShaderString;
 
@@ -12,7 +13,7 @@ extern NSString *const kGPUImageColorSwizzlingFragmentShaderString;
 
 @end
 
-@interface GPUImageMovieWriter : NSObject <GPUImageInput>
+@interface GPUImageMovieWriter : NSObject <GPUImageVideoSink>
 {
     CMVideoDimensions videoDimensions;
 	CMVideoCodecType videoType;
@@ -45,6 +46,10 @@ extern NSString *const kGPUImageColorSwizzlingFragmentShaderString;
 @property(nonatomic, copy) void(^audioInputReadyCallback)(void);
 @property(nonatomic) BOOL enabled;
 
+/** Whether frames are converted to 4:2:0 YUV on the GPU and handed to the encoder as such, which saves the encoder a colorspace conversion and moves 1.5 bytes per pixel instead of 4. This is used unless the device can render into texture-cached pixel buffers but lacks single- and two-channel render targets, and is fixed at initialization.
+ */
+@property(readonly, nonatomic) BOOL encodesYUVFrames;
+
 // Initialization and teardown
 - (id)initWithMovieURL:(NSURL *)newMovieURL size:(CGSize)newSize;
 - (id)initWithMovieURL:(NSURL *)newMovieURL size:(CGSize)newSize fileType:(NSString *)newFileType outputSettings:(NSMutableDictionary *)outputSettings;
@@ -3,6 +3,8 @@
 #import "GPUImageOpenGLESContext.h"
 #import "GLProgram.h"
 #import "GPUImageFilter.h"
+#import "GPUImageFence.h"
+#import "GPUImageYUVRenderer.h"
 
 NSString *const kGPUImageColorSwizzlingFragmentShaderString = SHADER_STRING
 (
@@ -29,6 +31,10 @@ NSString *const kGPUImageColorSwizzlingFragmentShaderString = SHADER_STRING
     
     GLubyte *frameData;
     
+    GPUImageFence *movieFrameFence;
+
+    GPUImageYUVRenderer *yuvRenderer;
+    
     CMTime startTime, previousFrameTime;
     
     BOOL isRecording;
@@ -43,6 +49,7 @@ NSString *const kGPUImageColorSwizzlingFragmentShaderString = SHADER_STRING
 - (void)setFilterFBO;
 
 - (void)renderAtInternalSize;
+- (CVPixelBufferRef)newYUVPixelBufferFromCurrentFrame;
 
 @end
 
@@ -56,6 +63,7 @@ NSString *const kGPUImageColorSwizzlingFragmentShaderString = SHADER_STRING
 @synthesize videoInputReadyCallback;
 @synthesize audioInputReadyCallback;
 @synthesize enabled;
+@synthesize encodesYUVFrames = _encodesYUVFrames;
 
 @synthesize delegate = _delegate;
 
@@ -83,6 +91,7 @@ NSString *const kGPUImageColorSwizzlingFragmentShaderString = SHADER_STRING
     _encodingLiveVideo = YES;
     previousFrameTime = kCMTimeNegativeInfinity;
     inputRotation = kGPUImageNoRotation;
+    movieFrameFence = [[GPUImageFence alloc] initWithLabel:@"GPUImageMovieWriter frame"];
 
     runSynchronouslyOnVideoProcessingQueue(^{
         [GPUImageOpenGLESContext useImageProcessingContext];
@@ -123,6 +132,15 @@ NSString *const kGPUImageColorSwizzlingFragmentShaderString = SHADER_STRING
         
         glEnableVertexAttribArray(colorSwizzlingPositionAttribute);
         glEnableVertexAttribArray(colorSwizzlingTextureCoordinateAttribute);
+
+        // Rendering into a texture-cached YUV pixel buffer needs red and red-green render targets, but reading back planes packed into RGBA works anywhere
+        _encodesYUVFrames = (![GPUImageOpenGLESContext supportsFastTextureUpload] || [GPUImageOpenGLESContext deviceSupportsRedTextures]);
+        if (_encodesYUVFrames)
+        {
+            yuvRenderer = [[GPUImageYUVRenderer alloc] initWithPlaneLayout:kGPUImageYUVBiPlanar];
+            // Follow the same convention that GPUImageYUVConverter falls back to for untagged frames, so that movies round-trip even if a player ignores the tag
+            yuvRenderer.colorMatrix = (videoSize.height >= 720) ? kGPUImageYUVColorMatrixBT709 : kGPUImageYUVColorMatrixBT601;
+        }
     });
         
     [self initializeMovieWithOutputSettings:outputSettings];
@@ -217,7 +235,8 @@ NSString *const kGPUImageColorSwizzlingFragmentShaderString = SHADER_STRING
     assetWriterVideoInput.expectsMediaDataInRealTime = _encodingLiveVideo;
     
     // You need to use BGRA for the video in order to get realtime encoding. I use a color-swizzling shader to line up glReadPixels' normal RGBA output with the movie input's BGRA.
-    NSDictionary *sourcePixelBufferAttributesDictionary = [NSDictionary dictionaryWithObjectsAndKeys: [NSNumber numberWithInt:kCVPixelFormatType_32BGRA], kCVPixelBufferPixelFormatTypeKey,
+    OSType sourcePixelFormat = _encodesYUVFrames ? kCVPixelFormatType_420YpCbCr8BiPlanarVideoRange : kCVPixelFormatType_32BGRA;
+    NSDictionary *sourcePixelBufferAttributesDictionary = [NSDictionary dictionaryWithObjectsAndKeys: [NSNumber numberWithInt:sourcePixelFormat], kCVPixelBufferPixelFormatTypeKey,
                                                            [NSNumber numberWithInt:videoSize.width], kCVPixelBufferWidthKey,
                                                            [NSNumber numberWithInt:videoSize.height], kCVPixelBufferHeightKey,
                                                            nil];
@@ -481,7 +500,102 @@ NSString *const kGPUImageColorSwizzlingFragmentShaderString = SHADER_STRING
     
     glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
     
-    glFinish();
+    // glReadPixels() synchronizes on its own, so only the texture cache path needs to know when this frame lands in the pixel buffer
+    if ([GPUImageOpenGLESContext supportsFastTextureUpload])
+    {
+        [movieFrameFence insert];
+    }
+}
+
+- (CVPixelBufferRef)newYUVPixelBufferFromCurrentFrame;
+{
+    CVPixelBufferRef pixel_buffer = NULL;
+    CVReturn status = CVPixelBufferPoolCreatePixelBuffer (NULL, [assetWriterPixelBufferInput pixelBufferPool], &pixel_buffer);
+    if ((pixel_buffer == NULL) || (status != kCVReturnSuccess))
+    {
+        return NULL;
+    }
+
+    // Tag the matrix the planes were rendered with, which the encoder carries into the movie's color description
+    CFStringRef colorMatrix = ([yuvRenderer colorMatrix] == kGPUImageYUVColorMatrixBT601) ? kCVImageBufferYCbCrMatrix_ITU_R_601_4 : kCVImageBufferYCbCrMatrix_ITU_R_709_2;
+    CVBufferSetAttachment(pixel_buffer, kCVImageBufferYCbCrMatrixKey, colorMatrix, kCVAttachmentMode_ShouldPropagate);
+
+    if ([GPUImageOpenGLESContext supportsFastTextureUpload])
+    {
+        if (coreVideoTextureCache == NULL)
+        {
+#if defined(__IPHONE_6_0)
+            CVReturn err = CVOpenGLESTextureCacheCreate(kCFAllocatorDefault, NULL, [[GPUImageOpenGLESContext sharedImageProcessingOpenGLESContext] context], NULL, &coreVideoTextureCache);
+#else
+            CVReturn err = CVOpenGLESTextureCacheCreate(kCFAllocatorDefault, NULL, (__bridge void *)[[GPUImageOpenGLESContext sharedImageProcessingOpenGLESContext] context], NULL, &coreVideoTextureCache);
+#endif
+            if (err)
+            {
+                NSAssert(NO, @"Error at CVOpenGLESTextureCacheCreate %d", err);
+            }
+        }
+
+        // Draw the Y plane and the interleaved CbCr plane straight into the encoder's pixel buffer
+        CVOpenGLESTextureRef planeTextures[2] = {NULL, NULL};
+        GLenum planeFormats[2] = {GL_RED_EXT, GL_RG_EXT};
+        for (NSUInteger planeIndex = 0; planeIndex < 2; planeIndex++)
+        {
+            CGSize planeSize = [yuvRenderer sizeOfPlane:planeIndex forFrameSize:videoSize];
+            CVReturn err = CVOpenGLESTextureCacheCreateTextureFromImage(kCFAllocatorDefault, coreVideoTextureCache, pixel_buffer, NULL, GL_TEXTURE_2D, planeFormats[planeIndex], (int)planeSize.width, (int)planeSize.height, planeFormats[planeIndex], GL_UNSIGNED_BYTE, planeIndex, &planeTextures[planeIndex]);
+            if (err)
+            {
+                NSLog(@"Error at CVOpenGLESTextureCacheCreateTextureFromImage %d", err);
+                break;
+            }
+
+            glActiveTexture(GL_TEXTURE1);
+            glBindTexture(CVOpenGLESTextureGetTarget(planeTextures[planeIndex]), CVOpenGLESTextureGetName(planeTextures[planeIndex]));
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+            [yuvRenderer renderTexture:inputTextureForMovieRendering intoPlane:planeIndex texture:CVOpenGLESTextureGetName(planeTextures[planeIndex]) frameSize:videoSize];
+        }
+
+        BOOL renderedAllPlanes = ((planeTextures[0] != NULL) && (planeTextures[1] != NULL));
+        if (renderedAllPlanes)
+        {
+            [movieFrameFence insert];
+            [movieFrameFence waitUntilCompleted];
+        }
+
+        for (NSUInteger planeIndex = 0; planeIndex < 2; planeIndex++)
+        {
+            if (planeTextures[planeIndex])
+            {
+                CFRelease(planeTextures[planeIndex]);
+            }
+        }
+        CVOpenGLESTextureCacheFlush(coreVideoTextureCache, 0);
+
+        if (!renderedAllPlanes)
+        {
+            CVPixelBufferRelease(pixel_buffer);
+            return NULL;
+        }
+
+        CVPixelBufferLockBaseAddress(pixel_buffer, 0);
+    }
+    else
+    {
+        CVPixelBufferLockBaseAddress(pixel_buffer, 0);
+
+        GLubyte *planeBytes[2];
+        size_t bytesPerRow[2];
+        for (NSUInteger planeIndex = 0; planeIndex < 2; planeIndex++)
+        {
+            planeBytes[planeIndex] = (GLubyte *)CVPixelBufferGetBaseAddressOfPlane(pixel_buffer, planeIndex);
+            bytesPerRow[planeIndex] = CVPixelBufferGetBytesPerRowOfPlane(pixel_buffer, planeIndex);
+        }
+
+        [yuvRenderer readPlanesFromTexture:inputTextureForMovieRendering frameSize:videoSize intoBytes:planeBytes bytesPerRow:bytesPerRow];
+    }
+
+    return pixel_buffer;
 }
 
 #pragma mark -
@@ -518,19 +632,31 @@ NSString *const kGPUImageColorSwizzlingFragmentShaderString = SHADER_STRING
         return;
     }
     
-    // Render the frame with swizzled colors, so that they can be uploaded quickly as BGRA frames
     [GPUImageOpenGLESContext useImageProcessingContext];
-    [self renderAtInternalSize];
 
     CVPixelBufferRef pixel_buffer = NULL;
 
-    if ([GPUImageOpenGLESContext supportsFastTextureUpload])
+    if (_encodesYUVFrames)
+    {
+        pixel_buffer = [self newYUVPixelBufferFromCurrentFrame];
+        if (pixel_buffer == NULL)
+        {
+            return;
+        }
+    }
+    else if ([GPUImageOpenGLESContext supportsFastTextureUpload])
     {
+        // Render the frame with swizzled colors, so that they can be uploaded quickly as BGRA frames
+        [self renderAtInternalSize];
+
         pixel_buffer = renderTarget; 
+        [movieFrameFence waitUntilCompleted];
         CVPixelBufferLockBaseAddress(pixel_buffer, 0);
     }
     else
     {
+        [self renderAtInternalSize];
+
         CVReturn status = CVPixelBufferPoolCreatePixelBuffer (NULL, [assetWriterPixelBufferInput pixelBufferPool], &pixel_buffer);
         if ((pixel_buffer == NULL) || (status != kCVReturnSuccess))
         {
@@ -558,7 +684,7 @@ NSString *const kGPUImageColorSwizzlingFragmentShaderString = SHADER_STRING
     
     previousFrameTime = frameTime;
     
-    if (![GPUImageOpenGLESContext supportsFastTextureUpload])
+    if (_encodesYUVFrames || ![GPUImageOpenGLESContext supportsFastTextureUpload])
     {
         CVPixelBufferRelease(pixel_buffer);
     }
@@ -628,6 +754,11 @@ NSString *const kGPUImageColorSwizzlingFragmentShaderString = SHADER_STRING
     
 }
 
+- (BOOL)wantsNextFrame;
+{
+    return enabled && isRecording;
+}
+
 #pragma mark -
 #pragma mark Accessors
 
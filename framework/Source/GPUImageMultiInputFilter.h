@@ -0,0 +1,45 @@
+#import "GPUImageFilter.h"
+
+#define kGPUImageMaximumFilterInputs 33
+
+/** The base for filters that draw from several inputs at once, which keeps track of each input and decides when a new set of frames is ready to render
+
+ Frames are matched by presentation timestamp. When a timed frame arrives, the output is rendered if every other timed input either has delivered a frame that hasn't been drawn yet or has one within frameMatchingTolerance of it. Inputs on the same clock and rate render once per matched set, a slower input sets the pace for faster ones, and inputs on unrelated clocks render once each has delivered a new frame. Frames no newer than the last one seen on their input are ignored. Still images, with indefinite timestamps, never hold up timed inputs and only cause a render by themselves when every input is still.
+ 
+ Subclasses set numberOfInputs and do their own drawing from inputTextures and inputRotations. Input 0 also goes through the single-input state of GPUImageFilter, so it sets the output size.
+ */
+@interface GPUImageMultiInputFilter : GPUImageFilter
+{
+    NSUInteger numberOfInputs;
+    
+    GLuint inputTextures[kGPUImageMaximumFilterInputs];
+    GPUImageRotationMode inputRotations[kGPUImageMaximumFilterInputs];
+    __unsafe_unretained id<GPUImageTextureDelegate> inputTextureDelegates[kGPUImageMaximumFilterInputs];
+    BOOL inputIsConnected[kGPUImageMaximumFilterInputs];
+    
+    CMTime latestInputFrameTimes[kGPUImageMaximumFilterInputs];
+    BOOL hasReceivedInputFrame[kGPUImageMaximumFilterInputs];
+    BOOL inputHasUnrenderedFrame[kGPUImageMaximumFilterInputs];
+    BOOL inputFrameCheckDisabled[kGPUImageMaximumFilterInputs];
+    CMTime inputFrameIntervals[kGPUImageMaximumFilterInputs];
+    BOOL isRenderingMatchedFrames;
+    
+    CGRect outputRegionChangedByInputs;
+    BOOL hasReceivedChangedRegionForInput[kGPUImageMaximumFilterInputs];
+}
+
+/** How far apart the timestamps of frames on different inputs can be and still count as the same moment
+ 
+ By default this is a quarter of the shortest interval seen between frames on any timed input, so that neighboring frames are never mistaken for the same moment at any frame rate. Setting kCMTimeInvalid goes back to that.
+ */
+@property(readwrite, nonatomic) CMTime frameMatchingTolerance;
+
+/** Stops waiting for frames on an input before rendering. Frames on that input never cause a render, which is what breaks feedback loops through the filter
+ */
+- (void)disableFrameCheckForInputAtIndex:(NSInteger)textureIndex;
+
+/** Whether a new set of frames is ready after one arrived at textureIndex. Called with the input's state already updated
+ */
+- (BOOL)shouldRenderAfterFrameAtTime:(CMTime)frameTime atIndex:(NSInteger)textureIndex;
+
+@end
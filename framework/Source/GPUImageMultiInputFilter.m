@@ -0,0 +1,362 @@
+#import "GPUImageMultiInputFilter.h"
+
+@implementation GPUImageMultiInputFilter
+
+@synthesize frameMatchingTolerance = _frameMatchingTolerance;
+
+#pragma mark -
+#pragma mark Initialization and teardown
+
+- (id)initWithVertexShaderFromString:(NSString *)vertexShaderString fragmentShaderFromString:(NSString *)fragmentShaderString;
+{
+    if (!(self = [super initWithVertexShaderFromString:vertexShaderString fragmentShaderFromString:fragmentShaderString]))
+    {
+		return nil;
+    }
+    
+    numberOfInputs = kGPUImageMaximumFilterInputs;
+    
+    for (NSUInteger inputIndex = 0; inputIndex < kGPUImageMaximumFilterInputs; inputIndex++)
+    {
+        inputRotations[inputIndex] = kGPUImageNoRotation;
+        latestInputFrameTimes[inputIndex] = kCMTimeInvalid;
+        inputFrameIntervals[inputIndex] = kCMTimeInvalid;
+    }
+    
+    isRenderingMatchedFrames = NO;
+    outputRegionChangedByInputs = CGRectNull;
+    _frameMatchingTolerance = kCMTimeInvalid;
+    
+    return self;
+}
+
+- (void)disableFrameCheckForInputAtIndex:(NSInteger)textureIndex;
+{
+    NSAssert(textureIndex < kGPUImageMaximumFilterInputs, @"Input %ld is past the maximum of %d inputs", (long)textureIndex, kGPUImageMaximumFilterInputs);
+    inputFrameCheckDisabled[textureIndex] = YES;
+}
+
+#pragma mark -
+#pragma mark Frame matching
+
+- (BOOL)shouldRenderAfterFrameAtTime:(CMTime)frameTime atIndex:(NSInteger)textureIndex;
+{
+    if (inputFrameCheckDisabled[textureIndex])
+    {
+        return NO;
+    }
+    
+    BOOL anyInputIsTimed = NO;
+    for (NSUInteger inputIndex = 0; inputIndex < numberOfInputs; inputIndex++)
+    {
+        if (!inputIsConnected[inputIndex] || inputFrameCheckDisabled[inputIndex])
+        {
+            continue;
+        }
+        
+        // Nothing can be drawn until every input has had something to draw
+        if (!hasReceivedInputFrame[inputIndex])
+        {
+            return NO;
+        }
+        
+        if (CMTIME_IS_NUMERIC(latestInputFrameTimes[inputIndex]))
+        {
+            anyInputIsTimed = YES;
+        }
+    }
+    
+    if (!CMTIME_IS_NUMERIC(frameTime))
+    {
+        // A still image changing alongside moving ones is picked up with their next frame
+        return !anyInputIsTimed;
+    }
+    
+    CMTime tolerance = [self frameMatchingTolerance];
+    for (NSUInteger inputIndex = 0; inputIndex < numberOfInputs; inputIndex++)
+    {
+        if ((inputIndex == textureIndex) || !inputIsConnected[inputIndex] || inputFrameCheckDisabled[inputIndex] || !CMTIME_IS_NUMERIC(latestInputFrameTimes[inputIndex]))
+        {
+            continue;
+        }
+        
+        // An undrawn frame is the newest this input has, even if it is from a slower input or another clock. A frame that has been drawn can only be reused for what is effectively the same moment
+        if (inputHasUnrenderedFrame[inputIndex])
+        {
+            continue;
+        }
+        
+        CMTime timeApart = CMTimeAbsoluteValue(CMTimeSubtract(frameTime, latestInputFrameTimes[inputIndex]));
+        if (CMTimeCompare(timeApart, tolerance) > 0)
+        {
+            return NO;
+        }
+    }
+    
+    return YES;
+}
+
+- (void)recordFrameAtTime:(CMTime)frameTime atIndex:(NSInteger)textureIndex;
+{
+    // The shortest spacing seen is the input's frame interval, since dropped frames only ever make the spacing longer
+    if (CMTIME_IS_NUMERIC(frameTime) && CMTIME_IS_NUMERIC(latestInputFrameTimes[textureIndex]))
+    {
+        CMTime frameInterval = CMTimeSubtract(frameTime, latestInputFrameTimes[textureIndex]);
+        if ((CMTimeCompare(frameInterval, kCMTimeZero) > 0) && (!CMTIME_IS_NUMERIC(inputFrameIntervals[textureIndex]) || (CMTimeCompare(frameInterval, inputFrameIntervals[textureIndex]) < 0)))
+        {
+            inputFrameIntervals[textureIndex] = frameInterval;
+        }
+    }
+    
+    latestInputFrameTimes[textureIndex] = frameTime;
+    hasReceivedInputFrame[textureIndex] = YES;
+    inputHasUnrenderedFrame[textureIndex] = YES;
+}
+
+#pragma mark -
+#pragma mark Rendering
+
+- (void)releaseInputTexturesIfNeeded;
+{
+    if (shouldConserveMemoryForNextFrame)
+    {
+        for (NSUInteger inputIndex = 0; inputIndex < numberOfInputs; inputIndex++)
+        {
+            [inputTextureDelegates[inputIndex] textureNoLongerNeededForTarget:self];
+        }
+        shouldConserveMemoryForNextFrame = NO;
+    }
+}
+
+#pragma mark -
+#pragma mark Changed regions
+
+- (CGRect)outputRegionAffectedByInputRegion:(CGRect)inputRegion atIndex:(NSInteger)textureIndex;
+{
+    // Blends and other multi-input operations sample every input at the pixel being drawn
+    return [self region:inputRegion expandedByPixels:[self pixelFootprintRadius]];
+}
+
+- (CGRect)inputRegionNeededForOutputRegion:(CGRect)outputRegion atIndex:(NSInteger)textureIndex;
+{
+    return [self region:outputRegion expandedByPixels:[self pixelFootprintRadius]];
+}
+
+- (CGRect)outputRegionChangedSinceLastFrame;
+{
+    CGRect changedRegion = outputRegionChangedByInputs;
+    outputRegionChangedByInputs = CGRectNull;
+    
+    return changedRegion;
+}
+
+#pragma mark -
+#pragma mark GPUImageInput
+
+- (void)disconnectInputAtIndex:(NSInteger)textureIndex;
+{
+    inputIsConnected[textureIndex] = NO;
+    inputTextures[textureIndex] = 0;
+    hasReceivedInputFrame[textureIndex] = NO;
+    inputHasUnrenderedFrame[textureIndex] = NO;
+    latestInputFrameTimes[textureIndex] = kCMTimeInvalid;
+    inputFrameIntervals[textureIndex] = kCMTimeInvalid;
+}
+
+- (NSInteger)nextAvailableTextureIndex;
+{
+    for (NSUInteger inputIndex = 0; inputIndex < numberOfInputs; inputIndex++)
+    {
+        if (!inputIsConnected[inputIndex])
+        {
+            return inputIndex;
+        }
+    }
+    
+    NSAssert(NO, @"All %lu inputs of this filter are already connected", (unsigned long)numberOfInputs);
+    return numberOfInputs - 1;
+}
+
+- (void)setInputTexture:(GLuint)newInputTexture atIndex:(NSInteger)textureIndex;
+{
+    if (textureIndex >= numberOfInputs)
+    {
+        return;
+    }
+    
+    if (textureIndex == 0)
+    {
+        [super setInputTexture:newInputTexture atIndex:textureIndex];
+    }
+    else if (newInputTexture != inputTextures[textureIndex])
+    {
+        framebufferHoldsPreviousFrame = NO;
+    }
+    
+    inputTextures[textureIndex] = newInputTexture;
+}
+
+- (void)setInputChangedRegion:(CGRect)changedRegion atIndex:(NSInteger)textureIndex;
+{
+    // Any input can change without triggering a render, so map each change to the output as it arrives and redraw the union of them
+    CGRect affectedRegion = [self outputRegionAffectedByInputRegion:[self rotatedRegion:changedRegion forRotation:inputRotations[textureIndex]] atIndex:textureIndex];
+    outputRegionChangedByInputs = CGRectUnion(outputRegionChangedByInputs, affectedRegion);
+    hasReceivedChangedRegionForInput[textureIndex] = YES;
+}
+
+- (CGRect)inputRegionOfInterestAtIndex:(NSInteger)textureIndex;
+{
+    CGRect regionOfInterest = [self outputRegionOfInterest];
+    if ( (textureIndex >= numberOfInputs) || CGRectIsEmpty(regionOfInterest) )
+    {
+        return CGRectNull;
+    }
+    
+    CGRect inputRegion = [self inputRegionNeededForOutputRegion:regionOfInterest atIndex:textureIndex];
+    return CGRectIntersection([self unrotatedRegion:inputRegion forRotation:inputRotations[textureIndex]], kGPUImageFullFrameRegion);
+}
+
+- (void)setInputSize:(CGSize)newSize atIndex:(NSInteger)textureIndex;
+{
+    if (textureIndex == 0)
+    {
+        [super setInputSize:newSize atIndex:textureIndex];
+    }
+    
+    // Removed inputs are sent a zero size, and stop being waited on
+    if ( (textureIndex < numberOfInputs) && CGSizeEqualToSize(newSize, CGSizeZero) )
+    {
+        [self disconnectInputAtIndex:textureIndex];
+    }
+}
+
+- (void)setInputRotation:(GPUImageRotationMode)newInputRotation atIndex:(NSInteger)textureIndex;
+{
+    if (textureIndex >= numberOfInputs)
+    {
+        return;
+    }
+    
+    if (textureIndex == 0)
+    {
+        [super setInputRotation:newInputRotation atIndex:textureIndex];
+    }
+    else if (newInputRotation != inputRotations[textureIndex])
+    {
+        framebufferHoldsPreviousFrame = NO;
+    }
+    
+    inputRotations[textureIndex] = newInputRotation;
+}
+
+- (CGSize)rotatedSize:(CGSize)sizeToRotate forIndex:(NSInteger)textureIndex;
+{
+    CGSize rotatedSize = sizeToRotate;
+    
+    if (GPUImageRotationSwapsWidthAndHeight(inputRotations[textureIndex]))
+    {
+        rotatedSize.width = sizeToRotate.height;
+        rotatedSize.height = sizeToRotate.width;
+    }
+    
+    return rotatedSize;
+}
+
+- (void)setTextureDelegate:(id<GPUImageTextureDelegate>)newTextureDelegate atIndex:(NSInteger)textureIndex;
+{
+    if (textureIndex >= numberOfInputs)
+    {
+        return;
+    }
+    
+    if (textureIndex == 0)
+    {
+        firstTextureDelegate = newTextureDelegate;
+    }
+    
+    inputTextureDelegates[textureIndex] = newTextureDelegate;
+    
+    // Sources hand over their delegate when they connect and clear it when they go, where the texture itself is also reset to 0 on removal and so can't tell the two apart
+    if (newTextureDelegate != nil)
+    {
+        inputIsConnected[textureIndex] = YES;
+    }
+    else
+    {
+        [self disconnectInputAtIndex:textureIndex];
+    }
+}
+
+- (void)newFrameReadyAtTime:(CMTime)frameTime atIndex:(NSInteger)textureIndex;
+{
+    if (textureIndex >= numberOfInputs)
+    {
+        return;
+    }
+    
+    // A frame that arrives without a changed region replaces the whole input
+    if (!hasReceivedChangedRegionForInput[textureIndex])
+    {
+        [self setInputChangedRegion:kGPUImageFullFrameRegion atIndex:textureIndex];
+    }
+    hasReceivedChangedRegionForInput[textureIndex] = NO;
+    
+    // Timed frames that are no newer than the last one on their input have nothing new to show, unless time has jumped back further than a late frame would, as when a movie loops
+    if (CMTIME_IS_NUMERIC(frameTime) && CMTIME_IS_NUMERIC(latestInputFrameTimes[textureIndex]) && (CMTimeCompare(frameTime, latestInputFrameTimes[textureIndex]) <= 0))
+    {
+        CMTime lateFrameAllowance = CMTIME_IS_NUMERIC(inputFrameIntervals[textureIndex]) ? inputFrameIntervals[textureIndex] : [self frameMatchingTolerance];
+        if (CMTimeCompare(frameTime, CMTimeSubtract(latestInputFrameTimes[textureIndex], lateFrameAllowance)) >= 0)
+        {
+            return;
+        }
+        
+        latestInputFrameTimes[textureIndex] = kCMTimeInvalid;
+    }
+    
+    [self recordFrameAtTime:frameTime atIndex:textureIndex];
+    
+    // Filters can be set up in loops, and a frame that comes back around while this one is being rendered must not start another render
+    if (isRenderingMatchedFrames || ![self shouldRenderAfterFrameAtTime:frameTime atIndex:textureIndex])
+    {
+        return;
+    }
+    
+    for (NSUInteger inputIndex = 0; inputIndex < numberOfInputs; inputIndex++)
+    {
+        inputHasUnrenderedFrame[inputIndex] = NO;
+    }
+    
+    isRenderingMatchedFrames = YES;
+    [super newFrameReadyAtTime:frameTime atIndex:0];
+    isRenderingMatchedFrames = NO;
+}
+
+#pragma mark -
+#pragma mark Accessors
+
+- (CMTime)frameMatchingTolerance;
+{
+    if (CMTIME_IS_NUMERIC(_frameMatchingTolerance))
+    {
+        return _frameMatchingTolerance;
+    }
+    
+    CMTime shortestFrameInterval = kCMTimeInvalid;
+    for (NSUInteger inputIndex = 0; inputIndex < numberOfInputs; inputIndex++)
+    {
+        if (inputIsConnected[inputIndex] && CMTIME_IS_NUMERIC(inputFrameIntervals[inputIndex]))
+        {
+            shortestFrameInterval = CMTIME_IS_NUMERIC(shortestFrameInterval) ? CMTimeMinimum(shortestFrameInterval, inputFrameIntervals[inputIndex]) : inputFrameIntervals[inputIndex];
+        }
+    }
+    
+    // Until any input has shown its frame rate, assume 60 FPS
+    if (!CMTIME_IS_NUMERIC(shortestFrameInterval))
+    {
+        shortestFrameInterval = CMTimeMake(1, 60);
+    }
+    
+    return CMTimeMultiplyByRatio(shortestFrameInterval, 1, 4);
+}
+
+@end
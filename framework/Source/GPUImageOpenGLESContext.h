@@ -8,6 +8,9 @@
 
 #define GPUImageRotationSwapsWidthAndHeight(rotation) ((rotation) == kGPUImageRotateLeft || (rotation) == kGPUImageRotateRight || (rotation) == kGPUImageRotateRightFlipVertical)
 
+// The type of texture that filters render into. Higher precisions fall back to the best one the device can render into and filter linearly.
+typedef enum { kGPUImageTexturePrecisionUnsignedByte, kGPUImageTexturePrecisionHalfFloat, kGPUImageTexturePrecisionFloat } GPUImageTexturePrecision;
+
 typedef enum { kGPUImageNoRotation, kGPUImageRotateLeft, kGPUImageRotateRight, kGPUImageFlipVertical, kGPUImageFlipHorizonal, kGPUImageRotateRightFlipVertical, kGPUImageRotate180 } GPUImageRotationMode;
 
 @interface GPUImageOpenGLESContext : NSObject
@@ -24,6 +27,11 @@ typedef enum { kGPUImageNoRotation, kGPUImageRotateLeft, kGPUImageRotateRight, k
 + (GLint)maximumTextureUnitsForThisDevice;
 + (BOOL)deviceSupportsOpenGLESExtension:(NSString *)extension;
 + (BOOL)deviceSupportsRedTextures;
++ (BOOL)deviceSupportsFenceSync;
++ (BOOL)deviceSupportsMipmapsForTextureOfSize:(CGSize)textureSize;
++ (BOOL)deviceSupportsRenderingToTexturePrecision:(GPUImageTexturePrecision)precision;
++ (GLenum)textureTypeForPrecision:(GPUImageTexturePrecision)precision;
+// Scales down sizes that don't fit within a single texture. Use GPUImageTiledImageProcessor to filter such images at full size.
 + (CGSize)sizeThatFitsWithinATextureForSize:(CGSize)inputSize;
 
 - (void)presentBufferForDisplay;
@@ -52,6 +60,16 @@ typedef enum { kGPUImageNoRotation, kGPUImageRotateLeft, kGPUImageRotateRight, k
 - (void)conserveMemoryForNextFrame;
 - (BOOL)wantsMonochromeInput;
 - (void)setCurrentlyReceivingMonochromeInput:(BOOL)newValue;
+
+@optional
+// The part of the next frame that differs from the last one, in normalized coordinates of the sender's output. Regions sent before a newFrameReadyAtTime:atIndex: accumulate, and a frame that arrives without one replaces the whole input.
+- (void)setInputChangedRegion:(CGRect)changedRegion atIndex:(NSInteger)textureIndex;
+// The part of an input that this target will read from its next frame, in normalized coordinates of the sender's output. Filters only draw what their targets will read. Targets that don't implement this read the whole input.
+- (CGRect)inputRegionOfInterestAtIndex:(NSInteger)textureIndex;
+// Whether anything would be done with the next frame. Sources skip sending timed frames to targets that answer NO, so branches that lead nowhere visible do no work. Targets that don't implement this are sent every frame while enabled.
+- (BOOL)wantsNextFrame;
+// Whether this target samples an input of the given size at a reduced scale, and so would read less texture memory and alias less from a mip chain. Sources that were asked to smoothly scale their output generate one when any target answers YES.
+- (BOOL)wantsMipmappedInputOfSize:(CGSize)inputSize atIndex:(NSInteger)textureIndex;
 @end
 
 @protocol GPUImageTextureDelegate <NSObject>
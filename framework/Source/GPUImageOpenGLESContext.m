@@ -1,4 +1,5 @@
 #import "GPUImageOpenGLESContext.h"
+#import "GPUImageOutput.h"
 #import <OpenGLES/EAGLDrawable.h>
 #import <AVFoundation/AVFoundation.h>
 
@@ -8,6 +9,8 @@
     EAGLSharegroup *_sharegroup;
 }
 
++ (BOOL)textureTypeIsRenderable:(GLenum)textureType;
+
 @end
 
 @implementation GPUImageOpenGLESContext
@@ -121,6 +124,121 @@
     return supportsRedTextures;
 }
 
+// http://www.khronos.org/registry/gles/extensions/APPLE/APPLE_sync.txt
+
++ (BOOL)deviceSupportsFenceSync;
+{
+    static dispatch_once_t pred;
+    static BOOL supportsFenceSync = NO;
+    
+    dispatch_once(&pred, ^{
+        supportsFenceSync = [GPUImageOpenGLESContext deviceSupportsOpenGLESExtension:@"GL_APPLE_sync"];
+    });
+    
+    return supportsFenceSync;
+}
+
+// http://www.khronos.org/registry/gles/extensions/OES/OES_texture_npot.txt
+
++ (BOOL)deviceSupportsMipmapsForTextureOfSize:(CGSize)textureSize;
+{
+    static dispatch_once_t pred;
+    static BOOL supportsNonPowerOfTwoMipmaps = NO;
+    
+    dispatch_once(&pred, ^{
+        supportsNonPowerOfTwoMipmaps = [GPUImageOpenGLESContext deviceSupportsOpenGLESExtension:@"GL_OES_texture_npot"];
+    });
+    
+    if (supportsNonPowerOfTwoMipmaps)
+    {
+        return YES;
+    }
+    
+    // Without full non-power-of-two support, OpenGL ES 2.0 only mipmaps power-of-two textures
+    NSUInteger width = (NSUInteger)textureSize.width, height = (NSUInteger)textureSize.height;
+    return (width > 0) && (height > 0) && ((width & (width - 1)) == 0) && ((height & (height - 1)) == 0);
+}
+
+// http://www.khronos.org/registry/gles/extensions/OES/OES_texture_float.txt
+// http://www.khronos.org/registry/gles/extensions/EXT/EXT_color_buffer_half_float.txt
+
++ (BOOL)deviceSupportsRenderingToTexturePrecision:(GPUImageTexturePrecision)precision;
+{
+    static dispatch_once_t halfFloatPred, floatPred;
+    static BOOL supportsHalfFloat = NO, supportsFloat = NO;
+    
+    // The probes run on the video processing queue, so the first check is made there as well. Otherwise a check from another thread could hold the dispatch_once while waiting on the queue, as a filter on the queue waits on the dispatch_once.
+    switch (precision)
+    {
+        case kGPUImageTexturePrecisionHalfFloat:
+        {
+            runSynchronouslyOnVideoProcessingQueue(^{
+                dispatch_once(&halfFloatPred, ^{
+                    supportsHalfFloat = [GPUImageOpenGLESContext deviceSupportsOpenGLESExtension:@"GL_OES_texture_half_float"] && [GPUImageOpenGLESContext deviceSupportsOpenGLESExtension:@"GL_OES_texture_half_float_linear"] && [GPUImageOpenGLESContext textureTypeIsRenderable:GL_HALF_FLOAT_OES];
+                });
+            });
+            return supportsHalfFloat;
+        }
+        case kGPUImageTexturePrecisionFloat:
+        {
+            runSynchronouslyOnVideoProcessingQueue(^{
+                dispatch_once(&floatPred, ^{
+                    supportsFloat = [GPUImageOpenGLESContext deviceSupportsOpenGLESExtension:@"GL_OES_texture_float"] && [GPUImageOpenGLESContext deviceSupportsOpenGLESExtension:@"GL_OES_texture_float_linear"] && [GPUImageOpenGLESContext textureTypeIsRenderable:GL_FLOAT];
+                });
+            });
+            return supportsFloat;
+        }
+        default: return YES;
+    }
+}
+
++ (GLenum)textureTypeForPrecision:(GPUImageTexturePrecision)precision;
+{
+    if ((precision == kGPUImageTexturePrecisionFloat) && [GPUImageOpenGLESContext deviceSupportsRenderingToTexturePrecision:kGPUImageTexturePrecisionFloat])
+    {
+        return GL_FLOAT;
+    }
+    else if ((precision != kGPUImageTexturePrecisionUnsignedByte) && [GPUImageOpenGLESContext deviceSupportsRenderingToTexturePrecision:kGPUImageTexturePrecisionHalfFloat])
+    {
+        return GL_HALF_FLOAT_OES;
+    }
+    
+    return GL_UNSIGNED_BYTE;
+}
+
+// Some devices can sample from floating point textures without being able to render into them, and there's no extension that reports 32-bit float color buffers under OpenGL ES 2.0, so this tries attaching one
++ (BOOL)textureTypeIsRenderable:(GLenum)textureType;
+{
+    // The image processing context is only safe to touch from the video processing queue, where filters may be partway through setting up their own bindings
+    __block BOOL textureIsRenderable = NO;
+    runSynchronouslyOnVideoProcessingQueue(^{
+        [GPUImageOpenGLESContext useImageProcessingContext];
+        
+        GLint previousFramebuffer, previousTexture;
+        glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previousFramebuffer);
+        glGetIntegerv(GL_TEXTURE_BINDING_2D, &previousTexture);
+        
+        GLuint testTexture, testFramebuffer;
+        glGenTextures(1, &testTexture);
+        glBindTexture(GL_TEXTURE_2D, testTexture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 4, 4, 0, GL_RGBA, textureType, 0);
+        
+        glGenFramebuffers(1, &testFramebuffer);
+        glBindFramebuffer(GL_FRAMEBUFFER, testFramebuffer);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, testTexture, 0);
+        textureIsRenderable = (glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE);
+        
+        glBindFramebuffer(GL_FRAMEBUFFER, previousFramebuffer);
+        glBindTexture(GL_TEXTURE_2D, previousTexture);
+        glDeleteFramebuffers(1, &testFramebuffer);
+        glDeleteTextures(1, &testTexture);
+    });
+    
+    return textureIsRenderable;
+}
+
 
 + (CGSize)sizeThatFitsWithinATextureForSize:(CGSize)inputSize;
 {
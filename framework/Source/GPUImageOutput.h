@@ -7,6 +7,9 @@ void runSynchronouslyOnVideoProcessingQueue(void (^block)(void));
 void runAsynchronouslyOnVideoProcessingQueue(void (^block)(void));
 void reportAvailableMemoryForGPUImage(NSString *tag);
 
+// The whole frame, in the normalized coordinates used for changed regions
+extern const CGRect kGPUImageFullFrameRegion;
+
 @class GPUImageMovieWriter;
 
 /** GPUImage's base source object
@@ -36,8 +39,13 @@ void reportAvailableMemoryForGPUImage(NSString *tag);
     BOOL shouldConserveMemoryForNextFrame;
     
     BOOL allTargetsWantMonochromeData;
+    BOOL isCheckingForLiveTargets, isCalculatingRegionOfInterest;
+    
+    GLuint mipmappedOutputTexture;
 }
 
+/** Whether to generate a mip chain for the output whenever a target samples it at a reduced scale, so that heavy downsampling reads less texture memory and aliases less. Without device support for non-power-of-two mipmaps, this only applies to power-of-two outputs.
+ */
 @property(readwrite, nonatomic) BOOL shouldSmoothlyScaleOutput;
 @property(readwrite, nonatomic) BOOL shouldIgnoreUpdatesToThisTarget;
 @property(readwrite, nonatomic, retain) GPUImageMovieWriter *audioEncodingTarget;
@@ -47,6 +55,14 @@ void reportAvailableMemoryForGPUImage(NSString *tag);
 
 /// @name Managing targets
 - (void)setInputTextureForTarget:(id<GPUImageInput>)target atIndex:(NSInteger)inputTextureIndex;
+
+/** Tells a target which part of the next frame changed, if it cares
+ 
+ Sources that know only part of a frame changed call this before newFrameReadyAtTime:atIndex:, so that filters downstream only need to redraw that part. Targets that aren't told anything assume the whole frame changed.
+ 
+ @param changedRegion The changed region in normalized (0.0 - 1.0) coordinates, with the origin at the upper left of the frame. CGRectNull means that nothing changed.
+ */
+- (void)setInputChangedRegion:(CGRect)changedRegion forTarget:(id<GPUImageInput>)target atIndex:(NSInteger)inputTextureIndex;
 - (GLuint)textureForOutput;
 - (void)notifyTargetsAboutNewOutputTexture;
 
@@ -82,10 +98,25 @@ void reportAvailableMemoryForGPUImage(NSString *tag);
  */
 - (void)removeAllTargets;
 
+/** Stops sending frames to a target that another output is about to take over before the next frame
+ 
+ Unlike removeTarget:, this leaves the target's input texture, size and framebuffer as they are, so that it doesn't go blank or rebuild its framebuffer while it is being rewired.
+ 
+ @param targetToHandOff Target to be removed
+ */
+- (void)handOffTarget:(id<GPUImageInput>)targetToHandOff;
+
+/** Removes all targets, handing off those that are about to be connected to another output and resetting the rest
+ 
+ @param targetsToHandOff Targets that will be given a new source before the next frame
+ */
+- (void)removeAllTargetsHandingOff:(NSSet *)targetsToHandOff;
+
 /// @name Manage the output texture
 
 - (void)initializeOutputTextureIfNeeded;
 - (void)deleteOutputTexture;
+- (void)generateMipmapsForTargetsIfNeededWithOutputSize:(CGSize)outputSize;
 - (void)forceProcessingAtSize:(CGSize)frameSize;
 - (void)forceProcessingAtSizeRespectingAspectRatio:(CGSize)frameSize;
 - (void)cleanupOutputImage;
@@ -116,6 +147,56 @@ void reportAvailableMemoryForGPUImage(NSString *tag);
 
 - (BOOL)providesMonochromeOutput;
 
+/// @name Tiled processing
+
+/** How many pixels out from an output pixel, in each direction, the input can affect that output pixel
+ 
+ Pointwise operations have a radius of 0. Filters that sample neighboring pixels override this so that tiles of an oversized image can be given enough surrounding context. See GPUImageTiledImageProcessor.
+ */
+- (NSUInteger)pixelFootprintRadius;
+
+/** The combined footprint radius of this output and every filter between it and the given downstream target, following the widest path
+ 
+ @param finalTarget The last output in the chain, whose own footprint is included
+ @return The summed radius, or NSNotFound if finalTarget isn't downstream of this output
+ */
+- (NSUInteger)pixelFootprintRadiusAlongPathToTarget:(GPUImageOutput *)finalTarget;
+
+/// @name Demand-driven processing
+
+/** Whether a target should be sent a frame at all
+ 
+ Frames without a numeric time, such as still images, are always sent, because they won't come around again for a target that missed them. Timed frames are only sent to enabled targets that want the next frame.
+ 
+ @param frameTime The time of the frame about to be sent
+ @param target The target to check
+ */
+- (BOOL)shouldSendFrameAtTime:(CMTime)frameTime toTarget:(id<GPUImageInput>)target;
+
+/** Whether an enabled target wants the next frame, according to its wantsNextFrame if it implements one
+ */
+- (BOOL)targetWantsNextFrame:(id<GPUImageInput>)target;
+
+/** How many targets will actually be sent a frame, so that the output texture is held until exactly that many of them release it
+ 
+ Targets skipped by shouldSendFrameAtTime:toTarget:, and the target ignoring updates, never read the frame and so are left out.
+ 
+ @param frameTime The time of the frame about to be sent
+ */
+- (NSUInteger)numberOfTargetsToSendFrameAtTime:(CMTime)frameTime;
+
+/** Whether anything downstream will use this output's next frame
+ 
+ An output with no targets counts as live, since its result may be read back directly. Loops that feed back into this output don't count as consumers.
+ */
+- (BOOL)anyTargetWantsNextFrame;
+
+/** The part of this output that its targets will read from the next frame, in normalized coordinates
+ 
+ This is the union of what each target asks for through inputRegionOfInterestAtIndex:, and filters leave the rest of their frame undrawn. An output with no targets may be read back directly, and so needs all of it. So do feedback loops back into this output, and targets that don't say what they read.
+ */
+- (CGRect)outputRegionOfInterest;
+
 - (void)prepareForImageCapture;
 - (void)conserveMemoryForNextFrame;
 
@@ -3,6 +3,8 @@
 #import "GPUImagePicture.h"
 #import <mach/mach.h>
 
+const CGRect kGPUImageFullFrameRegion = {{0.0, 0.0}, {1.0, 1.0}};
+
 void runOnMainQueueWithoutDeadlocking(void (^block)(void))
 {
 	if ([NSThread isMainThread])
@@ -107,6 +109,14 @@ void reportAvailableMemoryForGPUImage(NSString *tag)
     [target setInputTexture:[self textureForOutput] atIndex:inputTextureIndex];
 }
 
+- (void)setInputChangedRegion:(CGRect)changedRegion forTarget:(id<GPUImageInput>)target atIndex:(NSInteger)inputTextureIndex;
+{
+    if ([target respondsToSelector:@selector(setInputChangedRegion:atIndex:)])
+    {
+        [target setInputChangedRegion:changedRegion atIndex:inputTextureIndex];
+    }
+}
+
 - (GLuint)textureForOutput;
 {
     return outputTexture;
@@ -211,6 +221,43 @@ void reportAvailableMemoryForGPUImage(NSString *tag)
     });
 }
 
+- (void)handOffTarget:(id<GPUImageInput>)targetToHandOff;
+{
+    if(![targets containsObject:targetToHandOff])
+    {
+        return;
+    }
+    
+    if (_targetToIgnoreForUpdates == targetToHandOff)
+    {
+        _targetToIgnoreForUpdates = nil;
+    }
+    
+    cachedMaximumOutputSize = CGSizeZero;
+    
+    runSynchronouslyOnVideoProcessingQueue(^{
+        NSInteger indexOfObject = [targets indexOfObject:targetToHandOff];
+        [targetTextureIndices removeObjectAtIndex:indexOfObject];
+        [targets removeObject:targetToHandOff];
+    });
+}
+
+- (void)removeAllTargetsHandingOff:(NSSet *)targetsToHandOff;
+{
+    // Built on the single-target methods, so that outputs which keep their targets elsewhere, like filter groups, only need to override those
+    for (id<GPUImageInput> currentTarget in [self targets])
+    {
+        if ([targetsToHandOff containsObject:currentTarget])
+        {
+            [self handOffTarget:currentTarget];
+        }
+        else
+        {
+            [self removeTarget:currentTarget];
+        }
+    }
+}
+
 #pragma mark -
 #pragma mark Manage the output texture
 
@@ -243,6 +290,47 @@ void reportAvailableMemoryForGPUImage(NSString *tag)
     }
 }
 
+- (void)generateMipmapsForTargetsIfNeededWithOutputSize:(CGSize)outputSize;
+{
+    GLuint currentOutputTexture = [self textureForOutput];
+    BOOL targetsWantMipmaps = NO;
+    
+    if (_shouldSmoothlyScaleOutput && (currentOutputTexture != 0) && [GPUImageOpenGLESContext deviceSupportsMipmapsForTextureOfSize:outputSize])
+    {
+        for (id<GPUImageInput> currentTarget in targets)
+        {
+            NSInteger indexOfObject = [targets indexOfObject:currentTarget];
+            NSInteger textureIndex = [[targetTextureIndices objectAtIndex:indexOfObject] integerValue];
+            
+            if ([currentTarget respondsToSelector:@selector(wantsMipmappedInputOfSize:atIndex:)] && [currentTarget wantsMipmappedInputOfSize:outputSize atIndex:textureIndex])
+            {
+                targetsWantMipmaps = YES;
+                break;
+            }
+        }
+    }
+    
+    if (!targetsWantMipmaps && (mipmappedOutputTexture != currentOutputTexture))
+    {
+        return;
+    }
+    
+    // The smaller levels go stale as soon as anything is drawn into the texture again, so they're rebuilt every frame while wanted and switched off when not
+    glBindTexture(GL_TEXTURE_2D, currentOutputTexture);
+    if (targetsWantMipmaps)
+    {
+        glGenerateMipmap(GL_TEXTURE_2D);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        mipmappedOutputTexture = currentOutputTexture;
+    }
+    else
+    {
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        mipmappedOutputTexture = 0;
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
 - (void)forceProcessingAtSize:(CGSize)frameSize;
 {
     
@@ -370,6 +458,141 @@ void reportAvailableMemoryForGPUImage(NSString *tag)
     return NO;
 }
 
+#pragma mark -
+#pragma mark Tiled processing
+
+- (NSUInteger)pixelFootprintRadius;
+{
+    return 0;
+}
+
+- (NSUInteger)pixelFootprintRadiusAlongPathToTarget:(GPUImageOutput *)finalTarget;
+{
+    if (self == finalTarget)
+    {
+        return [self pixelFootprintRadius];
+    }
+    
+    NSUInteger widestDownstreamRadius = NSNotFound;
+    for (id<GPUImageInput> currentTarget in [self targets])
+    {
+        if (![currentTarget isKindOfClass:[GPUImageOutput class]])
+        {
+            continue;
+        }
+        
+        NSUInteger downstreamRadius = [(GPUImageOutput *)currentTarget pixelFootprintRadiusAlongPathToTarget:finalTarget];
+        if ( (downstreamRadius != NSNotFound) && ((widestDownstreamRadius == NSNotFound) || (downstreamRadius > widestDownstreamRadius)) )
+        {
+            widestDownstreamRadius = downstreamRadius;
+        }
+    }
+    
+    if (widestDownstreamRadius == NSNotFound)
+    {
+        return NSNotFound;
+    }
+    
+    return [self pixelFootprintRadius] + widestDownstreamRadius;
+}
+
+#pragma mark -
+#pragma mark Demand-driven processing
+
+- (BOOL)shouldSendFrameAtTime:(CMTime)frameTime toTarget:(id<GPUImageInput>)target;
+{
+    if (!CMTIME_IS_NUMERIC(frameTime))
+    {
+        return YES;
+    }
+    
+    return [self targetWantsNextFrame:target];
+}
+
+- (BOOL)targetWantsNextFrame:(id<GPUImageInput>)target;
+{
+    if (![target enabled])
+    {
+        return NO;
+    }
+    
+    if ([target respondsToSelector:@selector(wantsNextFrame)])
+    {
+        return [target wantsNextFrame];
+    }
+    
+    return YES;
+}
+
+- (NSUInteger)numberOfTargetsToSendFrameAtTime:(CMTime)frameTime;
+{
+    NSUInteger numberOfTargets = 0;
+    for (id<GPUImageInput> currentTarget in targets)
+    {
+        if ( (currentTarget != self.targetToIgnoreForUpdates) && [self shouldSendFrameAtTime:frameTime toTarget:currentTarget] )
+        {
+            numberOfTargets++;
+        }
+    }
+    
+    return numberOfTargets;
+}
+
+- (BOOL)anyTargetWantsNextFrame;
+{
+    if ([targets count] == 0)
+    {
+        return YES;
+    }
+    
+    // Reaching this output again means a feedback loop, which says nothing about whether a real consumer exists
+    if (isCheckingForLiveTargets)
+    {
+        return NO;
+    }
+    
+    isCheckingForLiveTargets = YES;
+    BOOL targetWantsFrame = NO;
+    for (id<GPUImageInput> currentTarget in targets)
+    {
+        if ([self targetWantsNextFrame:currentTarget])
+        {
+            targetWantsFrame = YES;
+            break;
+        }
+    }
+    isCheckingForLiveTargets = NO;
+    
+    return targetWantsFrame;
+}
+
+- (CGRect)outputRegionOfInterest;
+{
+    // Reaching this output again means a feedback loop, where what comes back around depends on what's drawn here
+    if ( ([targets count] == 0) || isCalculatingRegionOfInterest )
+    {
+        return kGPUImageFullFrameRegion;
+    }
+    
+    isCalculatingRegionOfInterest = YES;
+    CGRect regionOfInterest = CGRectNull;
+    for (NSUInteger targetIndex = 0; targetIndex < [targets count]; targetIndex++)
+    {
+        id<GPUImageInput> currentTarget = [targets objectAtIndex:targetIndex];
+        if (![currentTarget respondsToSelector:@selector(inputRegionOfInterestAtIndex:)])
+        {
+            regionOfInterest = kGPUImageFullFrameRegion;
+            break;
+        }
+        
+        NSInteger textureIndex = [[targetTextureIndices objectAtIndex:targetIndex] integerValue];
+        regionOfInterest = CGRectUnion(regionOfInterest, [currentTarget inputRegionOfInterestAtIndex:textureIndex]);
+    }
+    isCalculatingRegionOfInterest = NO;
+    
+    return CGRectIntersection(regionOfInterest, kGPUImageFullFrameRegion);
+}
+
 - (void)prepareForImageCapture;
 {
     
@@ -0,0 +1,7 @@
+#import "GPUImage3x3TextureSamplingFilter.h"
+
+/** Local binary patterns of packed monochrome input, with the pattern of each of the four packed pixels in its own component
+ */
+@interface GPUImagePackedLocalBinaryPatternFilter : GPUImage3x3TextureSamplingFilter
+
+@end
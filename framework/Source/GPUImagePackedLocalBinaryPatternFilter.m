@@ -0,0 +1,69 @@
+#import "GPUImagePackedLocalBinaryPatternFilter.h"
+
+NSString *const kGPUImagePackedLocalBinaryPatternFragmentShaderString = SHADER_STRING
+(
+ precision highp float;
+ 
+ varying vec2 textureCoordinate;
+ varying vec2 leftTextureCoordinate;
+ varying vec2 rightTextureCoordinate;
+ 
+ varying vec2 topTextureCoordinate;
+ varying vec2 topLeftTextureCoordinate;
+ varying vec2 topRightTextureCoordinate;
+ 
+ varying vec2 bottomTextureCoordinate;
+ varying vec2 bottomLeftTextureCoordinate;
+ varying vec2 bottomRightTextureCoordinate;
+ 
+ uniform sampler2D inputImageTexture;
+ 
+ void main()
+ {
+     lowp vec4 centerIntensity = texture2D(inputImageTexture, textureCoordinate);
+     lowp vec4 leftTexel = texture2D(inputImageTexture, leftTextureCoordinate);
+     lowp vec4 rightTexel = texture2D(inputImageTexture, rightTextureCoordinate);
+     lowp vec4 topIntensity = texture2D(inputImageTexture, topTextureCoordinate);
+     lowp vec4 topLeftTexel = texture2D(inputImageTexture, topLeftTextureCoordinate);
+     lowp vec4 topRightTexel = texture2D(inputImageTexture, topRightTextureCoordinate);
+     lowp vec4 bottomIntensity = texture2D(inputImageTexture, bottomTextureCoordinate);
+     lowp vec4 bottomLeftTexel = texture2D(inputImageTexture, bottomLeftTextureCoordinate);
+     lowp vec4 bottomRightTexel = texture2D(inputImageTexture, bottomRightTextureCoordinate);
+     
+     // The left and right neighbors of the four packed pixels shift in one component from the adjacent texels
+     lowp vec4 leftIntensity = vec4(leftTexel.a, centerIntensity.rgb);
+     lowp vec4 rightIntensity = vec4(centerIntensity.gba, rightTexel.r);
+     lowp vec4 topLeftIntensity = vec4(topLeftTexel.a, topIntensity.rgb);
+     lowp vec4 topRightIntensity = vec4(topIntensity.gba, topRightTexel.r);
+     lowp vec4 bottomLeftIntensity = vec4(bottomLeftTexel.a, bottomIntensity.rgb);
+     lowp vec4 bottomRightIntensity = vec4(bottomIntensity.gba, bottomRightTexel.r);
+     
+     lowp vec4 byteTally = 1.0 / 255.0 * step(centerIntensity, topRightIntensity);
+     byteTally += 2.0 / 255.0 * step(centerIntensity, topIntensity);
+     byteTally += 4.0 / 255.0 * step(centerIntensity, topLeftIntensity);
+     byteTally += 8.0 / 255.0 * step(centerIntensity, leftIntensity);
+     byteTally += 16.0 / 255.0 * step(centerIntensity, bottomLeftIntensity);
+     byteTally += 32.0 / 255.0 * step(centerIntensity, bottomIntensity);
+     byteTally += 64.0 / 255.0 * step(centerIntensity, bottomRightIntensity);
+     byteTally += 128.0 / 255.0 * step(centerIntensity, rightIntensity);
+     
+     gl_FragColor = byteTally;
+ }
+);
+
+@implementation GPUImagePackedLocalBinaryPatternFilter
+
+#pragma mark -
+#pragma mark Initialization and teardown
+
+- (id)init;
+{
+    if (!(self = [super initWithFragmentShaderFromString:kGPUImagePackedLocalBinaryPatternFragmentShaderString]))
+    {
+		return nil;
+    }
+    
+    return self;
+}
+
+@end
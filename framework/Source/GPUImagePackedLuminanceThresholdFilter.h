@@ -0,0 +1,14 @@
+#import "GPUImageFilter.h"
+
+/** Thresholds packed monochrome input, turning each of the four packed pixels of a texel white or black
+ */
+@interface GPUImagePackedLuminanceThresholdFilter : GPUImageFilter
+{
+    GLint thresholdUniform;
+}
+
+/** Anything above this luminance will be white, and anything below black. Ranges from 0.0 to 1.0, with 0.5 as the default
+ */
+@property(readwrite, nonatomic) CGFloat threshold;
+
+@end
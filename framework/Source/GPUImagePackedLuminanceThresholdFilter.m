@@ -0,0 +1,48 @@
+#import "GPUImagePackedLuminanceThresholdFilter.h"
+
+NSString *const kGPUImagePackedLuminanceThresholdFragmentShaderString = SHADER_STRING
+(
+ varying highp vec2 textureCoordinate;
+ 
+ uniform sampler2D inputImageTexture;
+ uniform highp float threshold;
+ 
+ void main()
+ {
+     highp vec4 packedIntensities = texture2D(inputImageTexture, textureCoordinate);
+     
+     gl_FragColor = step(vec4(threshold), packedIntensities);
+ }
+);
+
+@implementation GPUImagePackedLuminanceThresholdFilter
+
+@synthesize threshold = _threshold;
+
+#pragma mark -
+#pragma mark Initialization and teardown
+
+- (id)init;
+{
+    if (!(self = [super initWithFragmentShaderFromString:kGPUImagePackedLuminanceThresholdFragmentShaderString]))
+    {
+		return nil;
+    }
+    
+    thresholdUniform = [filterProgram uniformIndex:@"threshold"];
+    self.threshold = 0.5;
+    
+    return self;
+}
+
+#pragma mark -
+#pragma mark Accessors
+
+- (void)setThreshold:(CGFloat)newValue;
+{
+    _threshold = newValue;
+    
+    [self setFloat:_threshold forUniform:thresholdUniform program:filterProgram];
+}
+
+@end
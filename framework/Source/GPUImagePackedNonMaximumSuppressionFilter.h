@@ -0,0 +1,7 @@
+#import "GPUImage3x3TextureSamplingFilter.h"
+
+/** Non-maximum suppression on packed monochrome input, keeping the four packed pixels of each texel that are local maxima and zeroing the rest
+ */
+@interface GPUImagePackedNonMaximumSuppressionFilter : GPUImage3x3TextureSamplingFilter
+
+@end
@@ -0,0 +1,66 @@
+#import "GPUImagePackedNonMaximumSuppressionFilter.h"
+
+NSString *const kGPUImagePackedNonMaximumSuppressionFragmentShaderString = SHADER_STRING
+(
+ uniform sampler2D inputImageTexture;
+ 
+ varying highp vec2 textureCoordinate;
+ varying highp vec2 leftTextureCoordinate;
+ varying highp vec2 rightTextureCoordinate;
+ 
+ varying highp vec2 topTextureCoordinate;
+ varying highp vec2 topLeftTextureCoordinate;
+ varying highp vec2 topRightTextureCoordinate;
+ 
+ varying highp vec2 bottomTextureCoordinate;
+ varying highp vec2 bottomLeftTextureCoordinate;
+ varying highp vec2 bottomRightTextureCoordinate;
+ 
+ void main()
+ {
+     lowp vec4 centerColor = texture2D(inputImageTexture, textureCoordinate);
+     lowp vec4 leftTexel = texture2D(inputImageTexture, leftTextureCoordinate);
+     lowp vec4 rightTexel = texture2D(inputImageTexture, rightTextureCoordinate);
+     lowp vec4 topColor = texture2D(inputImageTexture, topTextureCoordinate);
+     lowp vec4 topLeftTexel = texture2D(inputImageTexture, topLeftTextureCoordinate);
+     lowp vec4 topRightTexel = texture2D(inputImageTexture, topRightTextureCoordinate);
+     lowp vec4 bottomColor = texture2D(inputImageTexture, bottomTextureCoordinate);
+     lowp vec4 bottomLeftTexel = texture2D(inputImageTexture, bottomLeftTextureCoordinate);
+     lowp vec4 bottomRightTexel = texture2D(inputImageTexture, bottomRightTextureCoordinate);
+     
+     // The left and right neighbors of the four packed pixels shift in one component from the adjacent texels
+     lowp vec4 leftColor = vec4(leftTexel.a, centerColor.rgb);
+     lowp vec4 rightColor = vec4(centerColor.gba, rightTexel.r);
+     lowp vec4 topLeftColor = vec4(topLeftTexel.a, topColor.rgb);
+     lowp vec4 topRightColor = vec4(topColor.gba, topRightTexel.r);
+     lowp vec4 bottomLeftColor = vec4(bottomLeftTexel.a, bottomColor.rgb);
+     lowp vec4 bottomRightColor = vec4(bottomColor.gba, bottomRightTexel.r);
+     
+     // Use a tiebreaker for pixels to the left and immediately above this one
+     lowp vec4 multiplier = (1.0 - step(centerColor, topColor)) * (1.0 - step(centerColor, topLeftColor)) * (1.0 - step(centerColor, leftColor)) * (1.0 - step(centerColor, bottomLeftColor));
+     
+     lowp vec4 maxValue = max(centerColor, bottomColor);
+     maxValue = max(maxValue, bottomRightColor);
+     maxValue = max(maxValue, rightColor);
+     maxValue = max(maxValue, topRightColor);
+     
+     gl_FragColor = centerColor * step(maxValue, centerColor) * multiplier;
+ }
+);
+
+@implementation GPUImagePackedNonMaximumSuppressionFilter
+
+#pragma mark -
+#pragma mark Initialization and teardown
+
+- (id)init;
+{
+    if (!(self = [super initWithFragmentShaderFromString:kGPUImagePackedNonMaximumSuppressionFragmentShaderString]))
+    {
+		return nil;
+    }
+    
+    return self;
+}
+
+@end
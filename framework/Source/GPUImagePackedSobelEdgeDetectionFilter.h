@@ -0,0 +1,9 @@
+#import "GPUImage3x3TextureSamplingFilter.h"
+
+/** Sobel edge detection on the output of a GPUImageLuminancePackingFilter, calculating the edge strength of four pixels per fragment
+
+ The result stays packed, for further packed filters or a GPUImageLuminanceUnpackingFilter.
+ */
+@interface GPUImagePackedSobelEdgeDetectionFilter : GPUImage3x3TextureSamplingFilter
+
+@end
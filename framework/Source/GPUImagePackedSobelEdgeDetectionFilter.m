@@ -0,0 +1,63 @@
+#import "GPUImagePackedSobelEdgeDetectionFilter.h"
+
+NSString *const kGPUImagePackedSobelEdgeDetectionFragmentShaderString = SHADER_STRING
+(
+ precision mediump float;
+ 
+ varying vec2 textureCoordinate;
+ varying vec2 leftTextureCoordinate;
+ varying vec2 rightTextureCoordinate;
+ 
+ varying vec2 topTextureCoordinate;
+ varying vec2 topLeftTextureCoordinate;
+ varying vec2 topRightTextureCoordinate;
+ 
+ varying vec2 bottomTextureCoordinate;
+ varying vec2 bottomLeftTextureCoordinate;
+ varying vec2 bottomRightTextureCoordinate;
+ 
+ uniform sampler2D inputImageTexture;
+ 
+ void main()
+ {
+     vec4 centerTexel = texture2D(inputImageTexture, textureCoordinate);
+     vec4 leftTexel = texture2D(inputImageTexture, leftTextureCoordinate);
+     vec4 rightTexel = texture2D(inputImageTexture, rightTextureCoordinate);
+     vec4 topIntensity = texture2D(inputImageTexture, topTextureCoordinate);
+     vec4 topLeftTexel = texture2D(inputImageTexture, topLeftTextureCoordinate);
+     vec4 topRightTexel = texture2D(inputImageTexture, topRightTextureCoordinate);
+     vec4 bottomIntensity = texture2D(inputImageTexture, bottomTextureCoordinate);
+     vec4 bottomLeftTexel = texture2D(inputImageTexture, bottomLeftTextureCoordinate);
+     vec4 bottomRightTexel = texture2D(inputImageTexture, bottomRightTextureCoordinate);
+     
+     // The left and right neighbors of the four packed pixels shift in one component from the adjacent texels
+     vec4 leftIntensity = vec4(leftTexel.a, centerTexel.rgb);
+     vec4 rightIntensity = vec4(centerTexel.gba, rightTexel.r);
+     vec4 topLeftIntensity = vec4(topLeftTexel.a, topIntensity.rgb);
+     vec4 topRightIntensity = vec4(topIntensity.gba, topRightTexel.r);
+     vec4 bottomLeftIntensity = vec4(bottomLeftTexel.a, bottomIntensity.rgb);
+     vec4 bottomRightIntensity = vec4(bottomIntensity.gba, bottomRightTexel.r);
+     
+     vec4 h = -topLeftIntensity - 2.0 * topIntensity - topRightIntensity + bottomLeftIntensity + 2.0 * bottomIntensity + bottomRightIntensity;
+     vec4 v = -bottomLeftIntensity - 2.0 * leftIntensity - topLeftIntensity + bottomRightIntensity + 2.0 * rightIntensity + topRightIntensity;
+     
+     gl_FragColor = sqrt((h * h) + (v * v));
+ }
+);
+
+@implementation GPUImagePackedSobelEdgeDetectionFilter
+
+#pragma mark -
+#pragma mark Initialization and teardown
+
+- (id)init;
+{
+    if (!(self = [super initWithFragmentShaderFromString:kGPUImagePackedSobelEdgeDetectionFragmentShaderString]))
+    {
+		return nil;
+    }
+    
+    return self;
+}
+
+@end
@@ -70,7 +70,8 @@ NSString *const kGPUImageHoughAccumulationFragmentShaderString = SHADER_STRING
 
 - (void)newFrameReadyAtTime:(CMTime)frameTime atIndex:(NSInteger)textureIndex;
 {
-    outputTextureRetainCount = [targets count];
+    outputTextureRetainCount = [self numberOfTargetsToSendFrameAtTime:frameTime];
+    [self applyParameterAnimationsAtTime:frameTime];
 
     if (lineCoordinates == NULL)
     {
@@ -93,7 +94,7 @@ NSString *const kGPUImageHoughAccumulationFragmentShaderString = SHADER_STRING
     
     // Grab the edge points from the previous frame and create the parallel coordinate lines for them
     // This would be a great place to have a working histogram pyramid implementation
-    glFinish();
+    // glReadPixels() already waits on the rendering into the framebuffer it reads from, so there's no need to drain the whole pipeline first
     glReadPixels(0, 0, inputTextureSize.width, inputTextureSize.height, GL_RGBA, GL_UNSIGNED_BYTE, rawImagePixels);
     
     CGFloat xAspectMultiplier = 1.0, yAspectMultiplier = 1.0;
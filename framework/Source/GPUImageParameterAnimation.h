@@ -0,0 +1,68 @@
+#import "GPUImageFilter.h"
+
+typedef enum {
+    kGPUImageParameterInterpolationStep,
+    kGPUImageParameterInterpolationLinear,
+    kGPUImageParameterInterpolationEaseInEaseOut,
+    kGPUImageParameterInterpolationCatmullRom
+} GPUImageParameterInterpolation;
+
+/** Keyframes for one property of a filter, which the filter samples at the timestamp of each frame it renders
+
+ Sampling happens on the video processing queue just before rendering, and the property's setter is called there directly, so its uniform is set without a block being queued for every change. The value of a frame only depends on its timestamp, so movies rendered offline come out the same every time. Frames without a timestamp, like those of still images, leave the property as it is.
+ 
+ Properties can take a CGFloat, a double, a CGPoint, a CGSize, a GPUVector3 or a GPUVector4, and keyframe values are given as GPUVector4s for all of them, of which only as many components as the property has are used.
+ */
+@interface GPUImageParameterAnimation : NSObject
+
+/** The name of the animated property, such as @"intensity" for setIntensity:
+ */
+@property(readonly, nonatomic, copy) NSString *key;
+
+@property(readwrite, nonatomic) GPUImageParameterInterpolation interpolation;
+
+/** Whether the keyframes start over after the last one, instead of holding its value. Defaults to NO
+ */
+@property(readwrite, nonatomic) BOOL repeats;
+
+/** The frame timestamp that keyframe time 0 falls on. By default this is the timestamp of the first frame the animation is sampled for on each filter it's added to
+ */
+@property(readwrite, nonatomic) CMTime startTime;
+
+/** The time of the last keyframe
+ */
+@property(readonly, nonatomic) NSTimeInterval duration;
+
+// Initialization and teardown
++ (GPUImageParameterAnimation *)animationWithKey:(NSString *)key;
+- (id)initWithKey:(NSString *)key;
+
+// Keyframes, at times in seconds from startTime. A keyframe at the same time as an existing one replaces it
+- (void)addKeyframeAtTime:(NSTimeInterval)time value:(CGFloat)value;
+- (void)addKeyframeAtTime:(NSTimeInterval)time pointValue:(CGPoint)value;
+- (void)addKeyframeAtTime:(NSTimeInterval)time vectorValue:(GPUVector4)value;
+- (void)removeAllKeyframes;
+
+/** The interpolated value at a time in seconds from startTime
+ */
+- (GPUVector4)vectorValueAtTime:(NSTimeInterval)time;
+
+@end
+
+/** An animation as added to one filter, with the setter it calls there and the state of its playback on that filter
+
+ Filters make one of these for each animation added to them, so the same animation can be added to several filters. All methods need to be called on the video processing queue.
+ */
+@interface GPUImageParameterAnimationBinding : NSObject
+
+@property(readonly, nonatomic) GPUImageParameterAnimation *animation;
+
+/** Looks up the setter of the animated property, and returns nil if the target has no setter of a type that can be animated
+ */
+- (id)initWithAnimation:(GPUImageParameterAnimation *)animation target:(id)target;
+
+/** Calls the setter with the value at frameTime, unless that's what it was last set to
+ */
+- (void)applyAtFrameTime:(CMTime)frameTime;
+
+@end
@@ -0,0 +1,327 @@
+#import "GPUImageParameterAnimation.h"
+
+typedef enum {
+    kGPUImageParameterSetterFloat,
+    kGPUImageParameterSetterDouble,
+    kGPUImageParameterSetterPoint,
+    kGPUImageParameterSetterSize,
+    kGPUImageParameterSetterVector3,
+    kGPUImageParameterSetterVector4
+} GPUImageParameterSetterType;
+
+@interface GPUImageParameterAnimation ()
+{
+    NSTimeInterval *keyframeTimes;
+    GPUVector4 *keyframeValues;
+    NSUInteger numberOfKeyframes, keyframeCapacity;
+}
+
+- (void)insertKeyframeAtTime:(NSTimeInterval)time vectorValue:(GPUVector4)value;
+- (BOOL)hasKeyframes;
+
+@end
+
+@interface GPUImageParameterAnimationBinding ()
+{
+    __unsafe_unretained id target;
+    SEL setterSelector;
+    IMP setterImplementation;
+    GPUImageParameterSetterType setterType;
+    
+    CMTime startTime;
+    GPUVector4 lastAppliedValue;
+    BOOL hasAppliedValue;
+}
+
+@end
+
+static inline GPUVector4 GPUImageParameterMix(GPUVector4 a, GPUVector4 b, GLfloat t)
+{
+    GPUVector4 result = {a.one + (b.one - a.one) * t, a.two + (b.two - a.two) * t, a.three + (b.three - a.three) * t, a.four + (b.four - a.four) * t};
+    return result;
+}
+
+static inline GLfloat GPUImageParameterCatmullRom(GLfloat p0, GLfloat p1, GLfloat p2, GLfloat p3, GLfloat t)
+{
+    return 0.5 * ( (2.0 * p1) + (p2 - p0) * t + (2.0 * p0 - 5.0 * p1 + 4.0 * p2 - p3) * t * t + (3.0 * p1 - p0 - 3.0 * p2 + p3) * t * t * t );
+}
+
+@implementation GPUImageParameterAnimation
+
+@synthesize key = _key;
+@synthesize interpolation = _interpolation;
+@synthesize repeats = _repeats;
+@synthesize startTime = _startTime;
+
+#pragma mark -
+#pragma mark Initialization and teardown
+
++ (GPUImageParameterAnimation *)animationWithKey:(NSString *)key;
+{
+    return [[self alloc] initWithKey:key];
+}
+
+- (id)initWithKey:(NSString *)key;
+{
+    if (!(self = [super init]))
+    {
+		return nil;
+    }
+    
+    _key = [key copy];
+    _interpolation = kGPUImageParameterInterpolationLinear;
+    _repeats = NO;
+    _startTime = kCMTimeInvalid;
+    
+    return self;
+}
+
+- (void)dealloc;
+{
+    free(keyframeTimes);
+    free(keyframeValues);
+}
+
+#pragma mark -
+#pragma mark Keyframes
+
+- (void)addKeyframeAtTime:(NSTimeInterval)time value:(CGFloat)value;
+{
+    GPUVector4 vectorValue = {value, 0.0, 0.0, 0.0};
+    [self addKeyframeAtTime:time vectorValue:vectorValue];
+}
+
+- (void)addKeyframeAtTime:(NSTimeInterval)time pointValue:(CGPoint)value;
+{
+    GPUVector4 vectorValue = {value.x, value.y, 0.0, 0.0};
+    [self addKeyframeAtTime:time vectorValue:vectorValue];
+}
+
+- (void)addKeyframeAtTime:(NSTimeInterval)time vectorValue:(GPUVector4)value;
+{
+    // Keyframes are read while rendering, so they only change between frames
+    runSynchronouslyOnVideoProcessingQueue(^{
+        [self insertKeyframeAtTime:time vectorValue:value];
+    });
+}
+
+- (void)insertKeyframeAtTime:(NSTimeInterval)time vectorValue:(GPUVector4)value;
+{
+    NSUInteger insertionIndex = 0;
+    while ( (insertionIndex < numberOfKeyframes) && (keyframeTimes[insertionIndex] < time) )
+    {
+        insertionIndex++;
+    }
+    
+    if ( (insertionIndex < numberOfKeyframes) && (keyframeTimes[insertionIndex] == time) )
+    {
+        keyframeValues[insertionIndex] = value;
+        return;
+    }
+    
+    if (numberOfKeyframes == keyframeCapacity)
+    {
+        keyframeCapacity = MAX(keyframeCapacity * 2, 8);
+        keyframeTimes = realloc(keyframeTimes, keyframeCapacity * sizeof(NSTimeInterval));
+        keyframeValues = realloc(keyframeValues, keyframeCapacity * sizeof(GPUVector4));
+    }
+    
+    memmove(&keyframeTimes[insertionIndex + 1], &keyframeTimes[insertionIndex], (numberOfKeyframes - insertionIndex) * sizeof(NSTimeInterval));
+    memmove(&keyframeValues[insertionIndex + 1], &keyframeValues[insertionIndex], (numberOfKeyframes - insertionIndex) * sizeof(GPUVector4));
+    keyframeTimes[insertionIndex] = time;
+    keyframeValues[insertionIndex] = value;
+    numberOfKeyframes++;
+}
+
+- (void)removeAllKeyframes;
+{
+    runSynchronouslyOnVideoProcessingQueue(^{
+        numberOfKeyframes = 0;
+    });
+}
+
+- (GPUVector4)vectorValueAtTime:(NSTimeInterval)time;
+{
+    GPUVector4 noValue = {0.0, 0.0, 0.0, 0.0};
+    if (numberOfKeyframes == 0)
+    {
+        return noValue;
+    }
+    
+    NSTimeInterval firstTime = keyframeTimes[0], lastTime = keyframeTimes[numberOfKeyframes - 1];
+    if ( _repeats && (lastTime > firstTime) && (time > lastTime) )
+    {
+        time = firstTime + fmod(time - firstTime, lastTime - firstTime);
+    }
+    
+    if (time <= firstTime)
+    {
+        return keyframeValues[0];
+    }
+    else if (time >= lastTime)
+    {
+        return keyframeValues[numberOfKeyframes - 1];
+    }
+    
+    // Keyframes are few enough that a search from the start costs less than keeping track of where the last sample was
+    NSUInteger nextIndex = 1;
+    while (keyframeTimes[nextIndex] < time)
+    {
+        nextIndex++;
+    }
+    NSUInteger previousIndex = nextIndex - 1;
+    GLfloat t = (time - keyframeTimes[previousIndex]) / (keyframeTimes[nextIndex] - keyframeTimes[previousIndex]);
+    
+    switch (_interpolation)
+    {
+        case kGPUImageParameterInterpolationStep: return keyframeValues[previousIndex];
+        case kGPUImageParameterInterpolationLinear: return GPUImageParameterMix(keyframeValues[previousIndex], keyframeValues[nextIndex], t);
+        case kGPUImageParameterInterpolationEaseInEaseOut: return GPUImageParameterMix(keyframeValues[previousIndex], keyframeValues[nextIndex], t * t * (3.0 - 2.0 * t));
+        case kGPUImageParameterInterpolationCatmullRom:
+        {
+            // The end keyframes stand in for the missing neighbors, which flattens the curve out at either end
+            GPUVector4 p0 = keyframeValues[(previousIndex > 0) ? (previousIndex - 1) : previousIndex];
+            GPUVector4 p1 = keyframeValues[previousIndex];
+            GPUVector4 p2 = keyframeValues[nextIndex];
+            GPUVector4 p3 = keyframeValues[(nextIndex < numberOfKeyframes - 1) ? (nextIndex + 1) : nextIndex];
+            
+            GPUVector4 result = {
+                GPUImageParameterCatmullRom(p0.one, p1.one, p2.one, p3.one, t),
+                GPUImageParameterCatmullRom(p0.two, p1.two, p2.two, p3.two, t),
+                GPUImageParameterCatmullRom(p0.three, p1.three, p2.three, p3.three, t),
+                GPUImageParameterCatmullRom(p0.four, p1.four, p2.four, p3.four, t)
+            };
+            return result;
+        }
+    }
+    
+    return noValue;
+}
+
+#pragma mark -
+#pragma mark Accessors
+
+- (NSTimeInterval)duration;
+{
+    return (numberOfKeyframes > 0) ? keyframeTimes[numberOfKeyframes - 1] : 0.0;
+}
+
+- (BOOL)hasKeyframes;
+{
+    return (numberOfKeyframes > 0);
+}
+
+@end
+
+@implementation GPUImageParameterAnimationBinding
+
+@synthesize animation = _animation;
+
+#pragma mark -
+#pragma mark Initialization and teardown
+
+- (id)initWithAnimation:(GPUImageParameterAnimation *)animation target:(id)newTarget;
+{
+    if (!(self = [super init]))
+    {
+		return nil;
+    }
+    
+    _animation = animation;
+    target = newTarget;
+    startTime = kCMTimeInvalid;
+    hasAppliedValue = NO;
+    
+    NSString *key = [animation key];
+    NSString *setterName = [NSString stringWithFormat:@"set%@%@:", [[key substringToIndex:1] uppercaseString], [key substringFromIndex:1]];
+    setterSelector = NSSelectorFromString(setterName);
+    
+    NSMethodSignature *setterSignature = [target methodSignatureForSelector:setterSelector];
+    if ( (setterSignature == nil) || ([setterSignature numberOfArguments] != 3) )
+    {
+        NSLog(@"%@ has no setter for %@ to animate", [target class], key);
+        return nil;
+    }
+    
+    const char *argumentType = [setterSignature getArgumentTypeAtIndex:2];
+    if (strcmp(argumentType, @encode(float)) == 0)
+    {
+        setterType = kGPUImageParameterSetterFloat;
+    }
+    else if (strcmp(argumentType, @encode(double)) == 0)
+    {
+        setterType = kGPUImageParameterSetterDouble;
+    }
+    else if (strcmp(argumentType, @encode(CGPoint)) == 0)
+    {
+        setterType = kGPUImageParameterSetterPoint;
+    }
+    else if (strcmp(argumentType, @encode(CGSize)) == 0)
+    {
+        setterType = kGPUImageParameterSetterSize;
+    }
+    else if (strcmp(argumentType, @encode(GPUVector3)) == 0)
+    {
+        setterType = kGPUImageParameterSetterVector3;
+    }
+    else if (strcmp(argumentType, @encode(GPUVector4)) == 0)
+    {
+        setterType = kGPUImageParameterSetterVector4;
+    }
+    else
+    {
+        NSLog(@"The %@ property of %@ isn't a type that can be animated", key, [target class]);
+        return nil;
+    }
+    
+    // Looked up once here, rather than going through message dispatch every frame
+    setterImplementation = [target methodForSelector:setterSelector];
+    
+    return self;
+}
+
+#pragma mark -
+#pragma mark Applying to the filter
+
+- (void)applyAtFrameTime:(CMTime)frameTime;
+{
+    if ( ![_animation hasKeyframes] || !CMTIME_IS_NUMERIC(frameTime) )
+    {
+        return;
+    }
+    
+    if (CMTIME_IS_NUMERIC([_animation startTime]))
+    {
+        startTime = [_animation startTime];
+    }
+    else if (!CMTIME_IS_NUMERIC(startTime))
+    {
+        startTime = frameTime;
+    }
+    
+    GPUVector4 value = [_animation vectorValueAtTime:CMTimeGetSeconds(CMTimeSubtract(frameTime, startTime))];
+    
+    // Setting a uniform invalidates the previous frame held in the framebuffer, so a settled animation shouldn't keep setting the same value
+    if ( hasAppliedValue && (value.one == lastAppliedValue.one) && (value.two == lastAppliedValue.two) && (value.three == lastAppliedValue.three) && (value.four == lastAppliedValue.four) )
+    {
+        return;
+    }
+    lastAppliedValue = value;
+    hasAppliedValue = YES;
+    
+    switch (setterType)
+    {
+        case kGPUImageParameterSetterFloat: ((void (*)(id, SEL, float))setterImplementation)(target, setterSelector, value.one); break;
+        case kGPUImageParameterSetterDouble: ((void (*)(id, SEL, double))setterImplementation)(target, setterSelector, value.one); break;
+        case kGPUImageParameterSetterPoint: ((void (*)(id, SEL, CGPoint))setterImplementation)(target, setterSelector, CGPointMake(value.one, value.two)); break;
+        case kGPUImageParameterSetterSize: ((void (*)(id, SEL, CGSize))setterImplementation)(target, setterSelector, CGSizeMake(value.one, value.two)); break;
+        case kGPUImageParameterSetterVector3:
+        {
+            GPUVector3 vectorValue = {value.one, value.two, value.three};
+            ((void (*)(id, SEL, GPUVector3))setterImplementation)(target, setterSelector, vectorValue);
+        }; break;
+        case kGPUImageParameterSetterVector4: ((void (*)(id, SEL, GPUVector4))setterImplementation)(target, setterSelector, value); break;
+    }
+}
+
+@end
@@ -0,0 +1,63 @@
+#import <Foundation/Foundation.h>
+#import "GPUImageOutput.h"
+
+extern NSString *const GPUImagePipelinePlanErrorDomain;
+
+typedef enum {
+    kGPUImagePipelinePlanUnreadableConfiguration = 1,
+    kGPUImagePipelinePlanMissingFilters,
+    kGPUImagePipelinePlanUnknownFilterClass,
+    kGPUImagePipelinePlanDuplicateFilterName,
+    kGPUImagePipelinePlanUnknownAttribute,
+    kGPUImagePipelinePlanInvalidAttributeValue,
+    kGPUImagePipelinePlanUnknownInput,
+    kGPUImagePipelinePlanUnknownOutput
+} GPUImagePipelinePlanErrorCode;
+
+/** A filter graph description that has been checked and compiled once, so that building filters from it only creates them, calls already resolved setters, and connects them
+
+ Configurations are dictionaries, loaded from property list (XML or binary) or JSON files, with a Filters array of filter descriptions:
+ 
+ - FilterName: the class of the filter, which has to be a GPUImageOutput that takes input
+ - Attributes: optional setters to call after creating it, as a dictionary of selectors to values. Values are numbers, strings in the form float(0.5), CGPoint(0.5, 0.5) or NSString(text), or arrays of those, which are passed as NSArrays of NSNumbers, NSValues and NSStrings. Selectors without an argument are called with no value.
+ - Name: an optional name, for other filters to take input from
+ - Inputs: optional names of the filters feeding this one, in the order of their texture indices, where Input is the source of the pipeline. Names have to be of filters earlier in the list, which keeps the graph acyclic. Filters without Inputs take the filter before them, or the source for the first one, so plain lists work as they always have.
+ 
+ An optional Output names the filter that feeds the pipeline's output, and defaults to the last one.
+ 
+ Plans don't change after they are compiled and don't hold any filters, so one plan can be used to build any number of filter graphs, from any thread.
+ */
+@interface GPUImagePipelinePlan : NSObject
+
+@property(readonly, nonatomic) NSUInteger numberOfFilters;
+
+/** The position in the Filters array of the filter that feeds the output
+ */
+@property(readonly, nonatomic) NSUInteger outputFilterIndex;
+
+/** Whether each filter just takes the one before it, with the last one feeding the output
+ */
+@property(readonly, nonatomic) BOOL isLinear;
+
+// Compilation. These return nil and set error when the configuration doesn't describe a valid graph
++ (GPUImagePipelinePlan *)planWithConfiguration:(NSDictionary *)configuration error:(NSError **)error;
++ (GPUImagePipelinePlan *)planWithContentsOfURL:(NSURL *)configurationURL error:(NSError **)error;
+
+/** Like planWithContentsOfURL:error:, but plans are cached by file and only compiled again when the file changes
+ */
++ (GPUImagePipelinePlan *)cachedPlanWithContentsOfURL:(NSURL *)configurationURL error:(NSError **)error;
++ (void)removeAllCachedPlans;
+
+// Building filter graphs
+- (NSArray *)newFilters;
+- (void)connectFilters:(NSArray *)filters input:(GPUImageOutput *)input output:(id<GPUImageInput>)output;
+
+/** Sizes filters built from this plan for frames of the given size and allocates their framebuffers, so the first frame through them doesn't have to. Must be called on the video processing queue
+ */
+- (void)prepareFilters:(NSArray *)filters forInputSize:(CGSize)inputSize;
+
+/** The position of the filter with the given Name, or NSNotFound
+ */
+- (NSUInteger)indexOfFilterNamed:(NSString *)filterName;
+
+@end
@@ -0,0 +1,621 @@
+#import "GPUImagePipelinePlan.h"
+#import "GPUImageFilter.h"
+#import <objc/runtime.h>
+
+NSString *const GPUImagePipelinePlanErrorDomain = @"GPUImagePipelinePlanErrorDomain";
+
+static NSString *const kGPUImagePipelinePlanSourceName = @"Input";
+static const NSInteger kGPUImagePipelinePlanSourceIndex = -1;
+
+#pragma mark -
+#pragma mark Compiled setters
+
+typedef enum {
+    kGPUImagePipelineSetterNoArgument,
+    kGPUImagePipelineSetterFloat,
+    kGPUImagePipelineSetterDouble,
+    kGPUImagePipelineSetterInteger,
+    kGPUImagePipelineSetterUnsignedInteger,
+    kGPUImagePipelineSetterLongLong,
+    kGPUImagePipelineSetterUnsignedLongLong,
+    kGPUImagePipelineSetterBool,
+    kGPUImagePipelineSetterPoint,
+    kGPUImagePipelineSetterObject
+} GPUImagePipelineSetterType;
+
+// One setter call with its argument already parsed and its implementation already looked up
+@interface GPUImagePipelinePlanSetter : NSObject
+{
+@public
+    SEL selector;
+    IMP implementation;
+    GPUImagePipelineSetterType setterType;
+    double numericValue;
+    CGPoint pointValue;
+    id objectValue;
+}
+
+- (void)applyToFilter:(id)filter;
+
+@end
+
+@implementation GPUImagePipelinePlanSetter
+
+- (void)applyToFilter:(id)filter;
+{
+    switch (setterType)
+    {
+        case kGPUImagePipelineSetterNoArgument: ((void (*)(id, SEL))implementation)(filter, selector); break;
+        case kGPUImagePipelineSetterFloat: ((void (*)(id, SEL, float))implementation)(filter, selector, (float)numericValue); break;
+        case kGPUImagePipelineSetterDouble: ((void (*)(id, SEL, double))implementation)(filter, selector, numericValue); break;
+        case kGPUImagePipelineSetterInteger: ((void (*)(id, SEL, long))implementation)(filter, selector, (long)numericValue); break;
+        case kGPUImagePipelineSetterUnsignedInteger: ((void (*)(id, SEL, unsigned long))implementation)(filter, selector, (unsigned long)numericValue); break;
+        case kGPUImagePipelineSetterLongLong: ((void (*)(id, SEL, long long))implementation)(filter, selector, (long long)numericValue); break;
+        case kGPUImagePipelineSetterUnsignedLongLong: ((void (*)(id, SEL, unsigned long long))implementation)(filter, selector, (unsigned long long)numericValue); break;
+        case kGPUImagePipelineSetterBool: ((void (*)(id, SEL, BOOL))implementation)(filter, selector, (numericValue != 0.0)); break;
+        case kGPUImagePipelineSetterPoint: ((void (*)(id, SEL, CGPoint))implementation)(filter, selector, pointValue); break;
+        case kGPUImagePipelineSetterObject: ((void (*)(id, SEL, id))implementation)(filter, selector, objectValue); break;
+    }
+}
+
+@end
+
+// One filter of the graph, with its inputs as positions of earlier filters or the pipeline's source
+@interface GPUImagePipelinePlanNode : NSObject
+{
+@public
+    Class filterClass;
+    NSString *name;
+    NSArray *setters;
+    NSInteger *inputIndices;
+    NSUInteger numberOfInputs;
+}
+
+@end
+
+@implementation GPUImagePipelinePlanNode
+
+- (void)dealloc;
+{
+    free(inputIndices);
+}
+
+@end
+
+#pragma mark -
+#pragma mark GPUImagePipelinePlan
+
+static NSCache *GPUImagePipelinePlanCache(void)
+{
+    static NSCache *planCache = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        planCache = [[NSCache alloc] init];
+    });
+    
+    return planCache;
+}
+
+@interface GPUImagePipelinePlan ()
+{
+    NSArray *nodes;
+    NSDictionary *nodeIndicesByName;
+}
+
+- (id)initWithNodes:(NSArray *)compiledNodes namedIndices:(NSDictionary *)namedIndices outputFilterIndex:(NSUInteger)outputIndex;
+
++ (NSError *)errorWithCode:(GPUImagePipelinePlanErrorCode)code description:(NSString *)description;
++ (BOOL)parseValue:(id)value intoSetter:(GPUImagePipelinePlanSetter *)setter argumentType:(const char *)argumentType;
++ (id)objectFromValue:(id)value;
++ (NSArray *)argumentsOfValueString:(NSString *)valueString withModifier:(NSString *)modifier;
++ (NSNumber *)numberFromArgument:(NSString *)argument;
+
+@end
+
+@implementation GPUImagePipelinePlan
+
+@synthesize outputFilterIndex = _outputFilterIndex;
+@synthesize isLinear = _isLinear;
+
+#pragma mark -
+#pragma mark Initialization and teardown
+
+- (id)initWithNodes:(NSArray *)compiledNodes namedIndices:(NSDictionary *)namedIndices outputFilterIndex:(NSUInteger)outputIndex;
+{
+    if (!(self = [super init]))
+    {
+		return nil;
+    }
+    
+    nodes = compiledNodes;
+    nodeIndicesByName = namedIndices;
+    _outputFilterIndex = outputIndex;
+    
+    _isLinear = ([nodes count] == 0) || (outputIndex == ([nodes count] - 1));
+    for (NSUInteger nodeIndex = 0; _isLinear && (nodeIndex < [nodes count]); nodeIndex++)
+    {
+        GPUImagePipelinePlanNode *node = [nodes objectAtIndex:nodeIndex];
+        _isLinear = (node->numberOfInputs == 1) && (node->inputIndices[0] == ((NSInteger)nodeIndex - 1));
+    }
+    
+    return self;
+}
+
+#pragma mark -
+#pragma mark Compilation
+
++ (NSError *)errorWithCode:(GPUImagePipelinePlanErrorCode)code description:(NSString *)description;
+{
+    return [NSError errorWithDomain:GPUImagePipelinePlanErrorDomain code:code userInfo:[NSDictionary dictionaryWithObject:description forKey:NSLocalizedDescriptionKey]];
+}
+
++ (GPUImagePipelinePlan *)planWithContentsOfURL:(NSURL *)configurationURL error:(NSError **)error;
+{
+    NSData *configurationData = [NSData dataWithContentsOfURL:configurationURL];
+    
+    // Property lists come in XML and binary, and anything that isn't one is tried as JSON
+    id configuration = nil;
+    if (configurationData != nil)
+    {
+        configuration = [NSPropertyListSerialization propertyListWithData:configurationData options:NSPropertyListImmutable format:NULL error:NULL];
+        if (configuration == nil)
+        {
+            configuration = [NSJSONSerialization JSONObjectWithData:configurationData options:0 error:NULL];
+        }
+    }
+    
+    if (![configuration isKindOfClass:[NSDictionary class]])
+    {
+        if (error != NULL)
+        {
+            *error = [self errorWithCode:kGPUImagePipelinePlanUnreadableConfiguration description:[NSString stringWithFormat:@"%@ isn't a property list or JSON dictionary", configurationURL]];
+        }
+        return nil;
+    }
+    
+    return [self planWithConfiguration:configuration error:error];
+}
+
++ (GPUImagePipelinePlan *)cachedPlanWithContentsOfURL:(NSURL *)configurationURL error:(NSError **)error;
+{
+    // The modification date goes into the key, so an edited file is compiled again
+    NSDate *modificationDate = nil;
+    if ([configurationURL isFileURL])
+    {
+        modificationDate = [[[NSFileManager defaultManager] attributesOfItemAtPath:[configurationURL path] error:NULL] fileModificationDate];
+    }
+    NSString *cacheKey = [NSString stringWithFormat:@"%@ %f", [configurationURL absoluteString], [modificationDate timeIntervalSinceReferenceDate]];
+    
+    GPUImagePipelinePlan *plan = [GPUImagePipelinePlanCache() objectForKey:cacheKey];
+    if (plan == nil)
+    {
+        plan = [self planWithContentsOfURL:configurationURL error:error];
+        if (plan != nil)
+        {
+            [GPUImagePipelinePlanCache() setObject:plan forKey:cacheKey];
+        }
+    }
+    
+    return plan;
+}
+
++ (void)removeAllCachedPlans;
+{
+    [GPUImagePipelinePlanCache() removeAllObjects];
+}
+
++ (GPUImagePipelinePlan *)planWithConfiguration:(NSDictionary *)configuration error:(NSError **)error;
+{
+    NSError *compilationError = nil;
+    NSArray *filterDescriptions = [configuration objectForKey:@"Filters"];
+    if (![filterDescriptions isKindOfClass:[NSArray class]])
+    {
+        compilationError = [self errorWithCode:kGPUImagePipelinePlanMissingFilters description:@"The configuration has no Filters array"];
+    }
+    
+    NSMutableArray *compiledNodes = [NSMutableArray array];
+    NSMutableDictionary *namedIndices = [NSMutableDictionary dictionary];
+    
+    for (NSUInteger filterIndex = 0; (compilationError == nil) && (filterIndex < [filterDescriptions count]); filterIndex++)
+    {
+        NSDictionary *filterDescription = [filterDescriptions objectAtIndex:filterIndex];
+        if (![filterDescription isKindOfClass:[NSDictionary class]])
+        {
+            compilationError = [self errorWithCode:kGPUImagePipelinePlanUnknownFilterClass description:[NSString stringWithFormat:@"Filter %lu isn't a dictionary", (unsigned long)filterIndex]];
+            break;
+        }
+        
+        GPUImagePipelinePlanNode *node = [[GPUImagePipelinePlanNode alloc] init];
+        
+        NSString *filterName = [filterDescription objectForKey:@"FilterName"];
+        node->filterClass = [filterName isKindOfClass:[NSString class]] ? NSClassFromString(filterName) : Nil;
+        if ( (node->filterClass == Nil) || ![node->filterClass isSubclassOfClass:[GPUImageOutput class]] || ![node->filterClass conformsToProtocol:@protocol(GPUImageInput)] )
+        {
+            compilationError = [self errorWithCode:kGPUImagePipelinePlanUnknownFilterClass description:[NSString stringWithFormat:@"Filter %lu, %@, isn't a filter class", (unsigned long)filterIndex, filterName]];
+            break;
+        }
+        
+        // Names are resolved to positions now, so building a graph never looks anything up by name
+        node->name = [filterDescription objectForKey:@"Name"];
+        if (node->name != nil)
+        {
+            if ( ![node->name isKindOfClass:[NSString class]] || [node->name isEqualToString:kGPUImagePipelinePlanSourceName] || ([namedIndices objectForKey:node->name] != nil) )
+            {
+                compilationError = [self errorWithCode:kGPUImagePipelinePlanDuplicateFilterName description:[NSString stringWithFormat:@"Filter %lu can't be named %@", (unsigned long)filterIndex, node->name]];
+                break;
+            }
+            [namedIndices setObject:[NSNumber numberWithUnsignedInteger:filterIndex] forKey:node->name];
+        }
+        
+        NSArray *inputNames = [filterDescription objectForKey:@"Inputs"];
+        if (inputNames == nil)
+        {
+            node->numberOfInputs = 1;
+            node->inputIndices = calloc(1, sizeof(NSInteger));
+            node->inputIndices[0] = (NSInteger)filterIndex - 1;
+        }
+        else
+        {
+            if ([inputNames isKindOfClass:[NSString class]])
+            {
+                inputNames = [NSArray arrayWithObject:inputNames];
+            }
+            
+            node->numberOfInputs = [inputNames isKindOfClass:[NSArray class]] ? [inputNames count] : 0;
+            node->inputIndices = calloc(MAX(node->numberOfInputs, 1), sizeof(NSInteger));
+            if (node->numberOfInputs == 0)
+            {
+                compilationError = [self errorWithCode:kGPUImagePipelinePlanUnknownInput description:[NSString stringWithFormat:@"Filter %lu, %@, has no inputs", (unsigned long)filterIndex, filterName]];
+                break;
+            }
+            
+            for (NSUInteger inputIndex = 0; inputIndex < node->numberOfInputs; inputIndex++)
+            {
+                NSString *inputName = [inputNames objectAtIndex:inputIndex];
+                NSNumber *namedIndex = [inputName isKindOfClass:[NSString class]] ? [namedIndices objectForKey:inputName] : nil;
+                if ([inputName isEqual:kGPUImagePipelinePlanSourceName])
+                {
+                    node->inputIndices[inputIndex] = kGPUImagePipelinePlanSourceIndex;
+                }
+                else if ( (namedIndex != nil) && ([namedIndex unsignedIntegerValue] < filterIndex) )
+                {
+                    node->inputIndices[inputIndex] = [namedIndex integerValue];
+                }
+                else
+                {
+                    compilationError = [self errorWithCode:kGPUImagePipelinePlanUnknownInput description:[NSString stringWithFormat:@"Filter %lu, %@, takes input from %@, which isn't a filter before it", (unsigned long)filterIndex, filterName, inputName]];
+                    break;
+                }
+            }
+            
+            if (compilationError != nil)
+            {
+                break;
+            }
+        }
+        
+        NSDictionary *filterAttributes = [filterDescription objectForKey:@"Attributes"];
+        if ( (filterAttributes != nil) && ![filterAttributes isKindOfClass:[NSDictionary class]] )
+        {
+            compilationError = [self errorWithCode:kGPUImagePipelinePlanInvalidAttributeValue description:[NSString stringWithFormat:@"The attributes of filter %lu, %@, aren't a dictionary", (unsigned long)filterIndex, filterName]];
+            break;
+        }
+        
+        NSMutableArray *setters = [NSMutableArray arrayWithCapacity:[filterAttributes count]];
+        
+        for (NSString *propertyKey in filterAttributes)
+        {
+            GPUImagePipelinePlanSetter *setter = [[GPUImagePipelinePlanSetter alloc] init];
+            setter->selector = NSSelectorFromString(propertyKey);
+            
+            NSMethodSignature *setterSignature = [node->filterClass instanceMethodSignatureForSelector:setter->selector];
+            if ( (setterSignature == nil) || ([setterSignature numberOfArguments] > 3) )
+            {
+                compilationError = [self errorWithCode:kGPUImagePipelinePlanUnknownAttribute description:[NSString stringWithFormat:@"Filter %lu, %@, has no setter %@", (unsigned long)filterIndex, filterName, propertyKey]];
+                break;
+            }
+            setter->implementation = [node->filterClass instanceMethodForSelector:setter->selector];
+            
+            const char *argumentType = ([setterSignature numberOfArguments] == 3) ? [setterSignature getArgumentTypeAtIndex:2] : NULL;
+            if (![self parseValue:[filterAttributes objectForKey:propertyKey] intoSetter:setter argumentType:argumentType])
+            {
+                compilationError = [self errorWithCode:kGPUImagePipelinePlanInvalidAttributeValue description:[NSString stringWithFormat:@"Filter %lu, %@, can't pass %@ to %@", (unsigned long)filterIndex, filterName, [filterAttributes objectForKey:propertyKey], propertyKey]];
+                break;
+            }
+            
+            [setters addObject:setter];
+        }
+        
+        node->setters = setters;
+        [compiledNodes addObject:node];
+    }
+    
+    NSUInteger outputIndex = MAX([compiledNodes count], 1) - 1;
+    id outputName = [configuration objectForKey:@"Output"];
+    if ( (compilationError == nil) && (outputName != nil) )
+    {
+        NSNumber *namedIndex = [outputName isKindOfClass:[NSString class]] ? [namedIndices objectForKey:outputName] : nil;
+        if (namedIndex == nil)
+        {
+            compilationError = [self errorWithCode:kGPUImagePipelinePlanUnknownOutput description:[NSString stringWithFormat:@"The output, %@, isn't one of the filters", outputName]];
+        }
+        outputIndex = [namedIndex unsignedIntegerValue];
+    }
+    
+    if (compilationError != nil)
+    {
+        if (error != NULL)
+        {
+            *error = compilationError;
+        }
+        return nil;
+    }
+    
+    return [[GPUImagePipelinePlan alloc] initWithNodes:compiledNodes namedIndices:namedIndices outputFilterIndex:outputIndex];
+}
+
++ (BOOL)parseValue:(id)value intoSetter:(GPUImagePipelinePlanSetter *)setter argumentType:(const char *)argumentType;
+{
+    if (argumentType == NULL)
+    {
+        setter->setterType = kGPUImagePipelineSetterNoArgument;
+        return YES;
+    }
+    
+    // Qualifiers like const and oneway don't change how the argument is passed
+    while ( (*argumentType == 'r') || (*argumentType == 'n') || (*argumentType == 'N') || (*argumentType == 'o') || (*argumentType == 'O') || (*argumentType == 'R') || (*argumentType == 'V') )
+    {
+        argumentType++;
+    }
+    
+    if (*argumentType == _C_ID)
+    {
+        setter->setterType = kGPUImagePipelineSetterObject;
+        setter->objectValue = [self objectFromValue:value];
+        return (setter->objectValue != nil);
+    }
+    
+    if (strncmp(argumentType, "{CGPoint=", 9) == 0)
+    {
+        NSArray *arguments = [value isKindOfClass:[NSString class]] ? [self argumentsOfValueString:value withModifier:@"CGPoint"] : nil;
+        NSNumber *x = ([arguments count] == 2) ? [self numberFromArgument:[arguments objectAtIndex:0]] : nil;
+        NSNumber *y = ([arguments count] == 2) ? [self numberFromArgument:[arguments objectAtIndex:1]] : nil;
+        if ( (x == nil) || (y == nil) )
+        {
+            return NO;
+        }
+        
+        setter->setterType = kGPUImagePipelineSetterPoint;
+        setter->pointValue = CGPointMake([x floatValue], [y floatValue]);
+        return YES;
+    }
+    
+    NSNumber *numericValue = nil;
+    if ([value isKindOfClass:[NSNumber class]])
+    {
+        numericValue = value;
+    }
+    else if ([value isKindOfClass:[NSString class]])
+    {
+        NSArray *arguments = [self argumentsOfValueString:value withModifier:@"float"];
+        numericValue = ([arguments count] == 1) ? [self numberFromArgument:[arguments objectAtIndex:0]] : nil;
+    }
+    
+    if (numericValue == nil)
+    {
+        return NO;
+    }
+    setter->numericValue = [numericValue doubleValue];
+    
+    switch (*argumentType)
+    {
+        case _C_FLT: setter->setterType = kGPUImagePipelineSetterFloat; break;
+        case _C_DBL: setter->setterType = kGPUImagePipelineSetterDouble; break;
+        case _C_INT: case _C_LNG: case _C_SHT: setter->setterType = kGPUImagePipelineSetterInteger; break;
+        case _C_UINT: case _C_ULNG: case _C_USHT: setter->setterType = kGPUImagePipelineSetterUnsignedInteger; break;
+        case _C_LNG_LNG: setter->setterType = kGPUImagePipelineSetterLongLong; break;
+        case _C_ULNG_LNG: setter->setterType = kGPUImagePipelineSetterUnsignedLongLong; break;
+        case _C_CHR: case _C_UCHR: case _C_BOOL: setter->setterType = kGPUImagePipelineSetterBool; break;
+        default: return NO;
+    }
+    
+    return YES;
+}
+
++ (id)objectFromValue:(id)value;
+{
+    if ([value isKindOfClass:[NSArray class]])
+    {
+        NSMutableArray *parsedArray = [NSMutableArray arrayWithCapacity:[value count]];
+        for (id element in value)
+        {
+            id parsedElement = [self objectFromValue:element];
+            if ( (parsedElement == nil) || [parsedElement isKindOfClass:[NSArray class]] )
+            {
+                return nil;
+            }
+            [parsedArray addObject:parsedElement];
+        }
+        return [parsedArray copy];
+    }
+    else if ([value isKindOfClass:[NSNumber class]])
+    {
+        return value;
+    }
+    else if (![value isKindOfClass:[NSString class]])
+    {
+        return nil;
+    }
+    
+    NSArray *arguments;
+    if ((arguments = [self argumentsOfValueString:value withModifier:@"float"]))
+    {
+        NSNumber *number = ([arguments count] == 1) ? [self numberFromArgument:[arguments objectAtIndex:0]] : nil;
+        return (number != nil) ? [NSNumber numberWithFloat:[number floatValue]] : nil;
+    }
+    else if ((arguments = [self argumentsOfValueString:value withModifier:@"CGPoint"]))
+    {
+        NSNumber *x = ([arguments count] == 2) ? [self numberFromArgument:[arguments objectAtIndex:0]] : nil;
+        NSNumber *y = ([arguments count] == 2) ? [self numberFromArgument:[arguments objectAtIndex:1]] : nil;
+        return ( (x != nil) && (y != nil) ) ? [NSValue valueWithCGPoint:CGPointMake([x floatValue], [y floatValue])] : nil;
+    }
+    else if ((arguments = [self argumentsOfValueString:value withModifier:@"NSString"]))
+    {
+        // Strings can have commas in them, so they are taken whole
+        NSRange openingParenthesis = [value rangeOfString:@"("];
+        NSRange closingParenthesis = [value rangeOfString:@")" options:NSBackwardsSearch];
+        return [value substringWithRange:NSMakeRange(NSMaxRange(openingParenthesis), closingParenthesis.location - NSMaxRange(openingParenthesis))];
+    }
+    
+    // Anything else is taken as a plain string, which is how JSON configurations usually give them
+    return value;
+}
+
+// Splits a string like CGPoint(0.5, 0.25) into its arguments, or returns nil if it doesn't have the given modifier
++ (NSArray *)argumentsOfValueString:(NSString *)valueString withModifier:(NSString *)modifier;
+{
+    NSString *trimmedString = [valueString stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceCharacterSet]];
+    NSString *prefix = [modifier stringByAppendingString:@"("];
+    if ( ![trimmedString hasPrefix:prefix] || ![trimmedString hasSuffix:@")"] )
+    {
+        return nil;
+    }
+    
+    NSString *argumentString = [trimmedString substringWithRange:NSMakeRange([prefix length], [trimmedString length] - [prefix length] - 1)];
+    NSMutableArray *arguments = [NSMutableArray array];
+    for (NSString *argument in [argumentString componentsSeparatedByString:@","])
+    {
+        [arguments addObject:[argument stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceCharacterSet]]];
+    }
+    
+    return arguments;
+}
+
+// Reads an argument that has to be a number in its entirety, or returns nil, where -doubleValue would quietly turn anything else into 0
++ (NSNumber *)numberFromArgument:(NSString *)argument;
+{
+    NSScanner *scanner = [NSScanner scannerWithString:argument];
+    double number;
+    if ( ![scanner scanDouble:&number] || ![scanner isAtEnd] )
+    {
+        return nil;
+    }
+    
+    return [NSNumber numberWithDouble:number];
+}
+
+#pragma mark -
+#pragma mark Building filter graphs
+
+- (NSArray *)newFilters;
+{
+    NSMutableArray *filters = [[NSMutableArray alloc] initWithCapacity:[nodes count]];
+    for (GPUImagePipelinePlanNode *node in nodes)
+    {
+        id filter = [[node->filterClass alloc] init];
+        for (GPUImagePipelinePlanSetter *setter in node->setters)
+        {
+            [setter applyToFilter:filter];
+        }
+        [filters addObject:filter];
+    }
+    
+    return filters;
+}
+
+- (void)connectFilters:(NSArray *)filters input:(GPUImageOutput *)input output:(id<GPUImageInput>)output;
+{
+    NSAssert([filters count] == [nodes count], @"The plan has %lu filters, and can't connect %lu", (unsigned long)[nodes count], (unsigned long)[filters count]);
+    
+    // Filters and the output that stay connected are handed over to their new sources without being reset in between
+    NSMutableSet *graphMembers = [NSMutableSet setWithArray:filters];
+    if (output != nil)
+    {
+        [graphMembers addObject:output];
+    }
+    
+    [input removeAllTargetsHandingOff:graphMembers];
+    for (GPUImageOutput *filter in filters)
+    {
+        [filter removeAllTargetsHandingOff:graphMembers];
+    }
+    
+    for (NSUInteger nodeIndex = 0; nodeIndex < [nodes count]; nodeIndex++)
+    {
+        GPUImagePipelinePlanNode *node = [nodes objectAtIndex:nodeIndex];
+        id<GPUImageInput> filter = [filters objectAtIndex:nodeIndex];
+        
+        for (NSUInteger inputIndex = 0; inputIndex < node->numberOfInputs; inputIndex++)
+        {
+            NSInteger sourceIndex = node->inputIndices[inputIndex];
+            GPUImageOutput *source = (sourceIndex == kGPUImagePipelinePlanSourceIndex) ? input : [filters objectAtIndex:sourceIndex];
+            
+            if (node->numberOfInputs == 1)
+            {
+                [source addTarget:filter];
+            }
+            else
+            {
+                [source addTarget:filter atTextureLocation:inputIndex];
+            }
+        }
+    }
+    
+    if (output != nil)
+    {
+        GPUImageOutput *terminalOutput = ([filters count] > 0) ? [filters objectAtIndex:_outputFilterIndex] : input;
+        [terminalOutput addTarget:output];
+    }
+}
+
+- (void)prepareFilters:(NSArray *)filters forInputSize:(CGSize)inputSize;
+{
+    NSAssert([filters count] == [nodes count], @"The plan has %lu filters, and can't prepare %lu", (unsigned long)[nodes count], (unsigned long)[filters count]);
+    
+    // Filters only take input from ones before them, so sizes can be worked out in a single pass
+    CGSize outputSizes[MAX([nodes count], 1)];
+    for (NSUInteger nodeIndex = 0; nodeIndex < [nodes count]; nodeIndex++)
+    {
+        GPUImagePipelinePlanNode *node = [nodes objectAtIndex:nodeIndex];
+        id<GPUImageInput> filter = [filters objectAtIndex:nodeIndex];
+        
+        CGSize firstInputSize = CGSizeZero;
+        for (NSUInteger inputIndex = 0; inputIndex < node->numberOfInputs; inputIndex++)
+        {
+            NSInteger sourceIndex = node->inputIndices[inputIndex];
+            CGSize sourceSize = (sourceIndex == kGPUImagePipelinePlanSourceIndex) ? inputSize : outputSizes[sourceIndex];
+            [filter setInputSize:sourceSize atIndex:inputIndex];
+            
+            if (inputIndex == 0)
+            {
+                firstInputSize = sourceSize;
+            }
+        }
+        
+        if ([(id)filter isKindOfClass:[GPUImageFilter class]])
+        {
+            [(GPUImageFilter *)filter setFilterFBO];
+            outputSizes[nodeIndex] = [(GPUImageFilter *)filter outputFrameSize];
+        }
+        else
+        {
+            outputSizes[nodeIndex] = firstInputSize;
+        }
+    }
+}
+
+#pragma mark -
+#pragma mark Accessors
+
+- (NSUInteger)numberOfFilters;
+{
+    return [nodes count];
+}
+
+- (NSUInteger)indexOfFilterNamed:(NSString *)filterName;
+{
+    NSNumber *namedIndex = [nodeIndicesByName objectForKey:filterName];
+    return (namedIndex != nil) ? [namedIndex unsignedIntegerValue] : NSNotFound;
+}
+
+@end
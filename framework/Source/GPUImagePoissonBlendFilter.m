@@ -202,7 +202,7 @@ NSString *const kGPUImagePoissonBlendFragmentShaderString = SHADER_STRING
             //            }
             //            else
             //            {
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, (int)currentFBOSize.width, (int)currentFBOSize.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, (int)currentFBOSize.width, (int)currentFBOSize.height, 0, GL_RGBA, [self outputTextureType], 0);
             //            }
             glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, secondFilterOutputTexture, 0);
             
@@ -302,16 +302,36 @@ NSString *const kGPUImagePoissonBlendFragmentShaderString = SHADER_STRING
             glUniform1i(filterInputTextureUniform, 2);
             
             glActiveTexture(GL_TEXTURE3);
-            glBindTexture(GL_TEXTURE_2D, filterSourceTexture2);
+            glBindTexture(GL_TEXTURE_2D, inputTextures[1]);
             glUniform1i(filterInputTextureUniform2, 3);
             
             glVertexAttribPointer(filterPositionAttribute, 2, GL_FLOAT, 0, 0, vertices);
             glVertexAttribPointer(filterTextureCoordinateAttribute, 2, GL_FLOAT, 0, 0, [[self class] textureCoordinatesForRotation:kGPUImageNoRotation]);
-            glVertexAttribPointer(filterSecondTextureCoordinateAttribute, 2, GL_FLOAT, 0, 0, [[self class] textureCoordinatesForRotation:inputRotation2]);
+            glVertexAttribPointer(filterSecondTextureCoordinateAttribute, 2, GL_FLOAT, 0, 0, [[self class] textureCoordinatesForRotation:inputRotations[1]]);
             
             glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);            
         }
     }
 }
 
+#pragma mark -
+#pragma mark Changed regions
+
+- (CGRect)outputRegionAffectedByInputRegion:(CGRect)inputRegion atIndex:(NSInteger)textureIndex;
+{
+    // Every iteration spreads a change out by another pixel, through intermediate framebuffers that aren't kept in step with a partial redraw
+    return kGPUImageFullFrameRegion;
+}
+
+- (CGRect)inputRegionNeededForOutputRegion:(CGRect)outputRegion atIndex:(NSInteger)textureIndex;
+{
+    return kGPUImageFullFrameRegion;
+}
+
+- (CGRect)outputRegionOfInterest;
+{
+    // Later iterations read back the whole of the earlier ones, so the output is drawn in full
+    return kGPUImageFullFrameRegion;
+}
+
 @end
\ No newline at end of file
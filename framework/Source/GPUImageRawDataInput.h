@@ -1,9 +1,12 @@
 #import "GPUImageOutput.h"
+#import "GPUImageYUVConverter.h"
 
 // The bytes passed into this input are not copied or retained, but you are free to deallocate them after they are used by this filter.
 // The bytes are uploaded and stored within a texture, so nothing is kept locally.
 // The default format for input bytes is GPUPixelFormatBGRA, unless specified with pixelFormat:
 // The default type for input bytes is GPUPixelTypeUByte, unless specified with pixelType:
+// Inputs created with initWithYUVBytes:size:planeLayout: instead take 4:2:0 frames with their planes packed one after another, as in NV12 or I420 files, and convert them to RGB on the GPU
+// BGRA bytes of unsigned type are copied straight into a small ring of texture-cache backed pixel buffers on devices that support it, rather than being uploaded through glTexSubImage2D
 
 typedef enum {
 	GPUPixelFormatBGRA = GL_BGRA,
@@ -16,9 +19,18 @@ typedef enum {
 	GPUPixelTypeFloat = GL_FLOAT
 } GPUPixelType;
 
+typedef enum {
+    kGPUImageRawDataDropFramesWhenBusy,
+    kGPUImageRawDataQueueFramesWhenBusy
+} GPUImageRawDataQueueingPolicy;
+
 @interface GPUImageRawDataInput : GPUImageOutput
 {
-    CGSize uploadedImageSize;
+    CGSize uploadedImageSize, allocatedTextureSize;
+    GPUPixelFormat allocatedTextureFormat;
+    GPUPixelType allocatedTextureType;
+    
+    GPUImageYUVConverter *yuvConverter;
 	
 	dispatch_semaphore_t dataUpdateSemaphore;
 }
@@ -27,15 +39,43 @@ typedef enum {
 - (id)initWithBytes:(GLubyte *)bytesToUpload size:(CGSize)imageSize;
 - (id)initWithBytes:(GLubyte *)bytesToUpload size:(CGSize)imageSize pixelFormat:(GPUPixelFormat)pixelFormat;
 - (id)initWithBytes:(GLubyte *)bytesToUpload size:(CGSize)imageSize pixelFormat:(GPUPixelFormat)pixelFormat type:(GPUPixelType)pixelType;
+- (id)initWithYUVBytes:(GLubyte *)bytesToUpload size:(CGSize)imageSize planeLayout:(GPUImageYUVPlaneLayout)planeLayout;
 
 /** Input data pixel format
  */
 @property (readwrite, nonatomic) GPUPixelFormat pixelFormat;
 @property (readwrite, nonatomic) GPUPixelType   pixelType;
 
+/** What processData does when the previous frame is still being processed
+
+ kGPUImageRawDataDropFramesWhenBusy, the default, returns immediately without processing the new frame and counts it in droppedFrameCount. kGPUImageRawDataQueueFramesWhenBusy blocks the caller until the previous frame has been handed to all targets, so every frame is processed in order. Use the latter when feeding frames at a fixed rate that must all reach a movie writer.
+ */
+@property (readwrite, nonatomic) GPUImageRawDataQueueingPolicy queueingPolicy;
+
+/** How many frames processData has dropped because the previous frame was still being processed
+ */
+@property (readonly, nonatomic) NSUInteger droppedFrameCount;
+
+/** Whether uploads are written into texture-cache backed pixel buffers instead of going through glTexSubImage2D. This is the case for BGRA bytes of unsigned type on devices that support fast texture upload.
+ */
+@property (readonly, nonatomic) BOOL uploadsThroughStagingBuffers;
+
+/** The conversion used for YUV input, where the color matrix and range can be set. This is nil for inputs that take RGB bytes.
+ */
+@property (readonly, nonatomic) GPUImageYUVConverter *yuvConverter;
+
 // Image rendering
 - (void)updateDataFromBytes:(GLubyte *)bytesToUpload size:(CGSize)imageSize;
+// Rows of bytesToUpload may be padded out to bytesPerRow, as with pixel buffers or images from other libraries, without having to pack them first
+- (void)updateDataFromBytes:(GLubyte *)bytesToUpload size:(CGSize)imageSize bytesPerRow:(NSUInteger)bytesPerRow;
+// Only uploads the given rows of a frame the same size as the last one, where bytesToUpload still points at the first row of the frame. Follow this with processDataWithChangedRegion: covering the same rows. YUV inputs always upload the whole frame.
+- (void)updateRowsInRange:(NSRange)rowRange fromBytes:(GLubyte *)bytesToUpload bytesPerRow:(NSUInteger)bytesPerRow;
 - (void)processData;
+// Only the given region (normalized coordinates, origin at the first row of bytes) differs from the last processed frame, so filters that support it only redraw that part
+- (void)processDataWithChangedRegion:(CGRect)changedRegion;
+// Frames with a timestamp can be recorded by a GPUImageMovieWriter, which drops untimed ones
+- (void)processDataForTimestamp:(CMTime)frameTime;
+- (void)processDataWithChangedRegion:(CGRect)changedRegion forTimestamp:(CMTime)frameTime;
 - (CGSize)outputImageSize;
 
 @end
@@ -1,13 +1,39 @@
 #import "GPUImageRawDataInput.h"
+#import "GPUImageFence.h"
+
+// One buffer can be filled on the CPU while the GPU is still reading the two before it
+#define kGPUImageRawDataInputStagingBufferCount 3
 
 @interface GPUImageRawDataInput()
+{
+    CVOpenGLESTextureCacheRef stagingTextureCache;
+    CVPixelBufferRef stagingPixelBuffers[kGPUImageRawDataInputStagingBufferCount];
+    CVOpenGLESTextureRef stagingTextures[kGPUImageRawDataInputStagingBufferCount];
+    NSRange stagingBufferStaleRows[kGPUImageRawDataInputStagingBufferCount];
+    NSArray *stagingFences;
+    CGSize stagingBufferSize;
+    NSUInteger lastStagedBufferIndex;
+}
+
+- (NSUInteger)bytesPerPixel;
 - (void)uploadBytes:(GLubyte *)bytesToUpload;
+- (void)uploadBytes:(GLubyte *)bytesToUpload bytesPerRow:(NSUInteger)bytesPerRow rowRange:(NSRange)rowRange;
+- (void)uploadBytesToTexture:(GLubyte *)bytesToUpload bytesPerRow:(NSUInteger)bytesPerRow rowRange:(NSRange)rowRange;
+- (void)uploadYUVBytes:(GLubyte *)bytesToUpload bytesPerRow:(NSUInteger)bytesPerRow;
+
+// Staging buffers
+- (void)stageBytes:(GLubyte *)bytesToUpload bytesPerRow:(NSUInteger)bytesPerRow rowRange:(NSRange)rowRange;
+- (void)createStagingBuffers;
+- (void)destroyStagingBuffers;
 @end
 
 @implementation GPUImageRawDataInput
 
 @synthesize pixelFormat = _pixelFormat;
 @synthesize pixelType = _pixelType;
+@synthesize yuvConverter = yuvConverter;
+@synthesize queueingPolicy = _queueingPolicy;
+@synthesize droppedFrameCount = _droppedFrameCount;
 
 #pragma mark -
 #pragma mark Initialization and teardown
@@ -50,9 +76,32 @@
     return self;
 }
 
+- (id)initWithYUVBytes:(GLubyte *)bytesToUpload size:(CGSize)imageSize planeLayout:(GPUImageYUVPlaneLayout)planeLayout;
+{
+    if (!(self = [super init]))
+    {
+		return nil;
+    }
+    
+	dataUpdateSemaphore = dispatch_semaphore_create(1);
+    
+    uploadedImageSize = imageSize;
+	self.pixelFormat = GPUPixelFormatRGBA;
+	self.pixelType = GPUPixelTypeUByte;
+    yuvConverter = [[GPUImageYUVConverter alloc] initWithPlaneLayout:planeLayout];
+    
+    [self uploadBytes:bytesToUpload];
+    
+    return self;
+}
+
 // ARC forbids explicit message send of 'release'; since iOS 6 even for dispatch_release() calls: stripping it out in that case is required.
 - (void)dealloc;
 {
+    runSynchronouslyOnVideoProcessingQueue(^{
+        [self destroyStagingBuffers];
+    });
+
 #if ( (__IPHONE_OS_VERSION_MIN_REQUIRED < __IPHONE_6_0) || (!defined(__IPHONE_6_0)) )
     if (dataUpdateSemaphore != NULL)
     {
@@ -64,14 +113,148 @@
 #pragma mark -
 #pragma mark Image rendering
 
+- (NSUInteger)bytesPerPixel;
+{
+    NSUInteger componentsPerPixel = (_pixelFormat == GPUPixelFormatRGB) ? 3 : 4;
+    return (_pixelType == GPUPixelTypeFloat) ? (componentsPerPixel * sizeof(GLfloat)) : componentsPerPixel;
+}
+
 - (void)uploadBytes:(GLubyte *)bytesToUpload;
+{
+    [self uploadBytes:bytesToUpload bytesPerRow:0 rowRange:NSMakeRange(0, (NSUInteger)uploadedImageSize.height)];
+}
+
+- (void)uploadBytes:(GLubyte *)bytesToUpload bytesPerRow:(NSUInteger)bytesPerRow rowRange:(NSRange)rowRange;
+{
+    if (yuvConverter != nil)
+    {
+        [self uploadYUVBytes:bytesToUpload bytesPerRow:bytesPerRow];
+        return;
+    }
+    
+    NSUInteger packedBytesPerRow = (NSUInteger)uploadedImageSize.width * [self bytesPerPixel];
+    if (bytesPerRow == 0)
+    {
+        bytesPerRow = packedBytesPerRow;
+    }
+    NSAssert(bytesPerRow >= packedBytesPerRow, @"Rows of %d bytes are too short for an image %d pixels wide", (int)bytesPerRow, (int)uploadedImageSize.width);
+    
+    rowRange = NSIntersectionRange(rowRange, NSMakeRange(0, (NSUInteger)uploadedImageSize.height));
+    
+    if ([GPUImageOpenGLESContext supportsFastTextureUpload] && (_pixelFormat == GPUPixelFormatBGRA) && (_pixelType == GPUPixelTypeUByte))
+    {
+        [self stageBytes:bytesToUpload bytesPerRow:bytesPerRow rowRange:rowRange];
+    }
+    else
+    {
+        runSynchronouslyOnVideoProcessingQueue(^{
+            [self uploadBytesToTexture:bytesToUpload bytesPerRow:bytesPerRow rowRange:rowRange];
+        });
+    }
+}
+
+- (void)uploadBytesToTexture:(GLubyte *)bytesToUpload bytesPerRow:(NSUInteger)bytesPerRow rowRange:(NSRange)rowRange;
 {
     [GPUImageOpenGLESContext useImageProcessingContext];
     
+    [self destroyStagingBuffers];
 	[self initializeOutputTextureIfNeeded];
 
     glBindTexture(GL_TEXTURE_2D, outputTexture);
-    glTexImage2D(GL_TEXTURE_2D, 0, _pixelFormat==GPUPixelFormatRGB ? GL_RGB : GL_RGBA, (int)uploadedImageSize.width, (int)uploadedImageSize.height, 0, (GLint)_pixelFormat, (GLenum)_pixelType, bytesToUpload);
+    
+    int imageWidth = (int)uploadedImageSize.width;
+    int imageHeight = (int)uploadedImageSize.height;
+    NSUInteger bytesPerPixel = [self bytesPerPixel];
+    NSUInteger packedBytesPerRow = imageWidth * bytesPerPixel;
+    
+    // Rows of RGB or odd-width images are rarely a multiple of 4 bytes long
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    // Reuse the existing texture storage when the new bytes have the same dimensions and layout, rather than reallocating it on every update
+    if (!CGSizeEqualToSize(allocatedTextureSize, uploadedImageSize) || (allocatedTextureFormat != _pixelFormat) || (allocatedTextureType != _pixelType))
+    {
+        BOOL canUploadWhileAllocating = (bytesPerRow == packedBytesPerRow);
+        glTexImage2D(GL_TEXTURE_2D, 0, _pixelFormat==GPUPixelFormatRGB ? GL_RGB : GL_RGBA, imageWidth, imageHeight, 0, (GLint)_pixelFormat, (GLenum)_pixelType, canUploadWhileAllocating ? bytesToUpload : NULL);
+        allocatedTextureSize = uploadedImageSize;
+        allocatedTextureFormat = _pixelFormat;
+        allocatedTextureType = _pixelType;
+        
+        // Rows outside of the updated range would be undefined in the new storage, so the first upload at a size always covers the whole frame
+        rowRange = canUploadWhileAllocating ? NSMakeRange(0, 0) : NSMakeRange(0, imageHeight);
+    }
+    
+    if ((bytesToUpload != NULL) && (rowRange.length > 0))
+    {
+        GLubyte *firstRowBytes = bytesToUpload + (rowRange.location * bytesPerRow);
+        
+        if (bytesPerRow == packedBytesPerRow)
+        {
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, (GLint)rowRange.location, imageWidth, (GLsizei)rowRange.length, (GLint)_pixelFormat, (GLenum)_pixelType, firstRowBytes);
+        }
+#if defined(GL_UNPACK_ROW_LENGTH_EXT)
+        else if (((bytesPerRow % bytesPerPixel) == 0) && [GPUImageOpenGLESContext deviceSupportsOpenGLESExtension:@"GL_EXT_unpack_subimage"])
+        {
+            glPixelStorei(GL_UNPACK_ROW_LENGTH_EXT, (GLint)(bytesPerRow / bytesPerPixel));
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, (GLint)rowRange.location, imageWidth, (GLsizei)rowRange.length, (GLint)_pixelFormat, (GLenum)_pixelType, firstRowBytes);
+            glPixelStorei(GL_UNPACK_ROW_LENGTH_EXT, 0);
+        }
+#endif
+        else
+        {
+            // OpenGL ES 2.0 has no GL_UNPACK_ROW_LENGTH, so padded rows go up one at a time rather than being packed together on the CPU first
+            for (NSUInteger currentRow = rowRange.location; currentRow < NSMaxRange(rowRange); currentRow++)
+            {
+                glTexSubImage2D(GL_TEXTURE_2D, 0, 0, (GLint)currentRow, imageWidth, 1, (GLint)_pixelFormat, (GLenum)_pixelType, bytesToUpload + (currentRow * bytesPerRow));
+            }
+        }
+    }
+    
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+}
+
+- (void)uploadYUVBytes:(GLubyte *)bytesToUpload bytesPerRow:(NSUInteger)bytesPerRow;
+{
+    if (bytesToUpload == NULL)
+    {
+        return;
+    }
+    
+    runSynchronouslyOnVideoProcessingQueue(^{
+        [GPUImageOpenGLESContext useImageProcessingContext];
+        [self initializeOutputTextureIfNeeded];
+        
+        int imageWidth = (int)uploadedImageSize.width;
+        int imageHeight = (int)uploadedImageSize.height;
+        int chromaWidth = (imageWidth + 1) / 2;
+        int chromaHeight = (imageHeight + 1) / 2;
+        
+        // Padded frames keep the same row stride for the interleaved chroma plane, and half of it for separate ones
+        NSUInteger lumaBytesPerRow = (bytesPerRow == 0) ? imageWidth : bytesPerRow;
+        NSUInteger interleavedChromaBytesPerRow = (bytesPerRow == 0) ? (chromaWidth * 2) : bytesPerRow;
+        NSUInteger chromaBytesPerRow = (bytesPerRow == 0) ? chromaWidth : ((bytesPerRow + 1) / 2);
+        
+        GLubyte *chromaBytes = bytesToUpload + (lumaBytesPerRow * imageHeight);
+        [yuvConverter uploadPlane:0 fromBytes:bytesToUpload width:imageWidth height:imageHeight bytesPerRow:lumaBytesPerRow];
+        if ([yuvConverter planeLayout] == kGPUImageYUVBiPlanar)
+        {
+            [yuvConverter uploadPlane:1 fromBytes:chromaBytes width:chromaWidth height:chromaHeight bytesPerRow:interleavedChromaBytesPerRow];
+        }
+        else
+        {
+            [yuvConverter uploadPlane:1 fromBytes:chromaBytes width:chromaWidth height:chromaHeight bytesPerRow:chromaBytesPerRow];
+            [yuvConverter uploadPlane:2 fromBytes:(chromaBytes + (chromaBytesPerRow * chromaHeight)) width:chromaWidth height:chromaHeight bytesPerRow:chromaBytesPerRow];
+        }
+        
+        if (!CGSizeEqualToSize(allocatedTextureSize, uploadedImageSize))
+        {
+            glBindTexture(GL_TEXTURE_2D, outputTexture);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, imageWidth, imageHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+            allocatedTextureSize = uploadedImageSize;
+        }
+        
+        // Converting here rather than when processing keeps the output texture holding RGB, as it does for other inputs
+        [yuvConverter convertToTexture:outputTexture ofSize:uploadedImageSize];
+    });
 }
 
 - (void)updateDataFromBytes:(GLubyte *)bytesToUpload size:(CGSize)imageSize;
@@ -81,25 +264,84 @@
     [self uploadBytes:bytesToUpload];
 }
 
+- (void)updateDataFromBytes:(GLubyte *)bytesToUpload size:(CGSize)imageSize bytesPerRow:(NSUInteger)bytesPerRow;
+{
+    uploadedImageSize = imageSize;
+    
+    [self uploadBytes:bytesToUpload bytesPerRow:bytesPerRow rowRange:NSMakeRange(0, (NSUInteger)imageSize.height)];
+}
+
+- (void)updateRowsInRange:(NSRange)rowRange fromBytes:(GLubyte *)bytesToUpload bytesPerRow:(NSUInteger)bytesPerRow;
+{
+    [self uploadBytes:bytesToUpload bytesPerRow:bytesPerRow rowRange:rowRange];
+}
+
 - (void)processData;
 {
-	if (dispatch_semaphore_wait(dataUpdateSemaphore, DISPATCH_TIME_NOW) != 0)
+    [self processDataWithChangedRegion:kGPUImageFullFrameRegion];
+}
+
+- (void)processDataWithChangedRegion:(CGRect)changedRegion;
+{
+    [self processDataWithChangedRegion:changedRegion forTimestamp:kCMTimeInvalid];
+}
+
+- (void)processDataForTimestamp:(CMTime)frameTime;
+{
+    [self processDataWithChangedRegion:kGPUImageFullFrameRegion forTimestamp:frameTime];
+}
+
+- (void)processDataWithChangedRegion:(CGRect)changedRegion forTimestamp:(CMTime)frameTime;
+{
+    if (_queueingPolicy == kGPUImageRawDataQueueFramesWhenBusy)
     {
+        dispatch_semaphore_wait(dataUpdateSemaphore, DISPATCH_TIME_FOREVER);
+    }
+    else if (dispatch_semaphore_wait(dataUpdateSemaphore, DISPATCH_TIME_NOW) != 0)
+    {
+        _droppedFrameCount++;
         return;
     }
 	
+    // Each staged frame lives in its own pixel buffer, so the texture for this frame is picked now rather than when it is processed
+    BOOL frameIsStaged = (stagingTextureCache != NULL);
+    NSUInteger stagedBufferIndex = lastStagedBufferIndex;
+    
 	runAsynchronouslyOnVideoProcessingQueue(^{
+        
+        if (frameIsStaged && (stagingTextures[stagedBufferIndex] != NULL))
+        {
+            outputTexture = CVOpenGLESTextureGetName(stagingTextures[stagedBufferIndex]);
+        }
 
 		CGSize pixelSizeOfImage = [self outputImageSize];
+        
+        // Staged frames live in texture cache pixel buffers, which can't be mipmapped
+        if (!frameIsStaged)
+        {
+            [self generateMipmapsForTargetsIfNeededWithOutputSize:pixelSizeOfImage];
+        }
     
 		for (id<GPUImageInput> currentTarget in targets)
 		{
 			NSInteger indexOfObject = [targets indexOfObject:currentTarget];
 			NSInteger textureIndexOfTarget = [[targetTextureIndices objectAtIndex:indexOfObject] integerValue];
         
+			[self setInputChangedRegion:changedRegion forTarget:currentTarget atIndex:textureIndexOfTarget];
+            if (![self shouldSendFrameAtTime:frameTime toTarget:currentTarget])
+            {
+                continue;
+            }
+
+			[self setInputTextureForTarget:currentTarget atIndex:textureIndexOfTarget];
 			[currentTarget setInputSize:pixelSizeOfImage atIndex:textureIndexOfTarget];
-			[currentTarget newFrameReadyAtTime:kCMTimeInvalid atIndex:textureIndexOfTarget];
+			[currentTarget newFrameReadyAtTime:frameTime atIndex:textureIndexOfTarget];
 		}
+        
+        if (frameIsStaged && (stagingFences != nil))
+        {
+            [[stagingFences objectAtIndex:stagedBufferIndex] insert];
+        }
 	
 		dispatch_semaphore_signal(dataUpdateSemaphore);
 	});
@@ -110,4 +352,197 @@
     return uploadedImageSize;
 }
 
+#pragma mark -
+#pragma mark Staging buffers
+
+- (void)stageBytes:(GLubyte *)bytesToUpload bytesPerRow:(NSUInteger)bytesPerRow rowRange:(NSRange)rowRange;
+{
+    __block NSUInteger stagingBufferIndex = 0;
+    
+    runSynchronouslyOnVideoProcessingQueue(^{
+        [GPUImageOpenGLESContext useImageProcessingContext];
+        
+        if ((stagingTextureCache == NULL) || !CGSizeEqualToSize(stagingBufferSize, uploadedImageSize))
+        {
+            [self createStagingBuffers];
+        }
+        
+        stagingBufferIndex = (lastStagedBufferIndex + 1) % kGPUImageRawDataInputStagingBufferCount;
+        
+        // This buffer was last read for the frame before the previous one, so the GPU has almost always finished with it
+        GPUImageFence *stagingFence = [stagingFences objectAtIndex:stagingBufferIndex];
+        if ([stagingFence isPending])
+        {
+            [stagingFence waitUntilCompleted];
+        }
+    });
+    
+    if (bytesToUpload == NULL)
+    {
+        return;
+    }
+    
+    // The copy happens off the video processing queue, so it overlaps with the filtering of earlier frames
+    CVPixelBufferRef stagingBuffer = stagingPixelBuffers[stagingBufferIndex];
+    CVPixelBufferLockBaseAddress(stagingBuffer, 0);
+    GLubyte *stagingBytes = (GLubyte *)CVPixelBufferGetBaseAddress(stagingBuffer);
+    size_t stagingBytesPerRow = CVPixelBufferGetBytesPerRow(stagingBuffer);
+    size_t packedBytesPerRow = (size_t)uploadedImageSize.width * 4;
+    NSUInteger imageHeight = (NSUInteger)uploadedImageSize.height;
+    
+    // Rows that changed since this buffer was last filled, but aren't part of this update, come from the most recently filled buffer
+    NSRange staleRows = stagingBufferStaleRows[stagingBufferIndex];
+    if (staleRows.length > 0)
+    {
+        CVPixelBufferRef previousBuffer = stagingPixelBuffers[lastStagedBufferIndex];
+        CVPixelBufferLockBaseAddress(previousBuffer, kCVPixelBufferLock_ReadOnly);
+        GLubyte *previousBytes = (GLubyte *)CVPixelBufferGetBaseAddress(previousBuffer);
+        size_t previousBytesPerRow = CVPixelBufferGetBytesPerRow(previousBuffer);
+        
+        for (NSUInteger currentRow = staleRows.location; currentRow < NSMaxRange(staleRows); currentRow++)
+        {
+            if (!NSLocationInRange(currentRow, rowRange))
+            {
+                memcpy(stagingBytes + (currentRow * stagingBytesPerRow), previousBytes + (currentRow * previousBytesPerRow), packedBytesPerRow);
+            }
+        }
+        
+        CVPixelBufferUnlockBaseAddress(previousBuffer, kCVPixelBufferLock_ReadOnly);
+    }
+    
+    if ((bytesPerRow == stagingBytesPerRow) && (rowRange.length == imageHeight))
+    {
+        memcpy(stagingBytes, bytesToUpload, bytesPerRow * imageHeight);
+    }
+    else
+    {
+        for (NSUInteger currentRow = rowRange.location; currentRow < NSMaxRange(rowRange); currentRow++)
+        {
+            memcpy(stagingBytes + (currentRow * stagingBytesPerRow), bytesToUpload + (currentRow * bytesPerRow), packedBytesPerRow);
+        }
+    }
+    
+    CVPixelBufferUnlockBaseAddress(stagingBuffer, 0);
+    
+    for (NSUInteger currentBufferIndex = 0; currentBufferIndex < kGPUImageRawDataInputStagingBufferCount; currentBufferIndex++)
+    {
+        if (currentBufferIndex == stagingBufferIndex)
+        {
+            stagingBufferStaleRows[currentBufferIndex] = NSMakeRange(0, 0);
+        }
+        else if (stagingBufferStaleRows[currentBufferIndex].length == 0)
+        {
+            stagingBufferStaleRows[currentBufferIndex] = rowRange;
+        }
+        else
+        {
+            stagingBufferStaleRows[currentBufferIndex] = NSUnionRange(stagingBufferStaleRows[currentBufferIndex], rowRange);
+        }
+    }
+    
+    lastStagedBufferIndex = stagingBufferIndex;
+}
+
+- (void)createStagingBuffers;
+{
+    [self destroyStagingBuffers];
+    
+    // Any texture left from uploading through glTexImage2D is replaced by the staging buffers
+    [self deleteOutputTexture];
+    allocatedTextureSize = CGSizeZero;
+    
+#if defined(__IPHONE_6_0)
+    CVReturn err = CVOpenGLESTextureCacheCreate(kCFAllocatorDefault, NULL, [[GPUImageOpenGLESContext sharedImageProcessingOpenGLESContext] context], NULL, &stagingTextureCache);
+#else
+    CVReturn err = CVOpenGLESTextureCacheCreate(kCFAllocatorDefault, NULL, (__bridge void *)[[GPUImageOpenGLESContext sharedImageProcessingOpenGLESContext] context], NULL, &stagingTextureCache);
+#endif
+    
+    if (err)
+    {
+        NSAssert(NO, @"Error at CVOpenGLESTextureCacheCreate %d", err);
+    }
+    
+    CFDictionaryRef empty; // empty value for attr value.
+    CFMutableDictionaryRef attrs;
+    empty = CFDictionaryCreate(kCFAllocatorDefault, NULL, NULL, 0, &kCFTypeDictionaryKeyCallBacks, &kCFTypeDictionaryValueCallBacks); // our empty IOSurface properties dictionary
+    attrs = CFDictionaryCreateMutable(kCFAllocatorDefault, 1, &kCFTypeDictionaryKeyCallBacks, &kCFTypeDictionaryValueCallBacks);
+    CFDictionarySetValue(attrs, kCVPixelBufferIOSurfacePropertiesKey, empty);
+    
+    NSMutableArray *newStagingFences = [[NSMutableArray alloc] initWithCapacity:kGPUImageRawDataInputStagingBufferCount];
+    
+    for (NSUInteger currentBufferIndex = 0; currentBufferIndex < kGPUImageRawDataInputStagingBufferCount; currentBufferIndex++)
+    {
+        err = CVPixelBufferCreate(kCFAllocatorDefault, (int)uploadedImageSize.width, (int)uploadedImageSize.height, kCVPixelFormatType_32BGRA, attrs, &stagingPixelBuffers[currentBufferIndex]);
+        if (err)
+        {
+            NSLog(@"Staging buffer size: %f, %f", uploadedImageSize.width, uploadedImageSize.height);
+            NSAssert(NO, @"Error at CVPixelBufferCreate %d", err);
+        }
+        
+        err = CVOpenGLESTextureCacheCreateTextureFromImage(kCFAllocatorDefault, stagingTextureCache, stagingPixelBuffers[currentBufferIndex], NULL, GL_TEXTURE_2D, GL_RGBA, (int)uploadedImageSize.width, (int)uploadedImageSize.height, GL_BGRA, GL_UNSIGNED_BYTE, 0, &stagingTextures[currentBufferIndex]);
+        if (err)
+        {
+            NSAssert(NO, @"Error at CVOpenGLESTextureCacheCreateTextureFromImage %d", err);
+        }
+        
+        glBindTexture(CVOpenGLESTextureGetTarget(stagingTextures[currentBufferIndex]), CVOpenGLESTextureGetName(stagingTextures[currentBufferIndex]));
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        
+        // Nothing has been written yet, so every row needs filling the first time a buffer is used
+        stagingBufferStaleRows[currentBufferIndex] = NSMakeRange(0, (NSUInteger)uploadedImageSize.height);
+        [newStagingFences addObject:[[GPUImageFence alloc] initWithLabel:[NSString stringWithFormat:@"Raw data staging buffer %d", (int)currentBufferIndex]]];
+    }
+    
+    CFRelease(attrs);
+    CFRelease(empty);
+    
+    stagingFences = newStagingFences;
+    stagingBufferSize = uploadedImageSize;
+    
+    // The first update fills the first buffer, and until then targets are given the last one
+    lastStagedBufferIndex = kGPUImageRawDataInputStagingBufferCount - 1;
+    outputTexture = CVOpenGLESTextureGetName(stagingTextures[lastStagedBufferIndex]);
+}
+
+- (void)destroyStagingBuffers;
+{
+    if (stagingTextureCache == NULL)
+    {
+        return;
+    }
+    
+    [GPUImageOpenGLESContext useImageProcessingContext];
+    
+    for (NSUInteger currentBufferIndex = 0; currentBufferIndex < kGPUImageRawDataInputStagingBufferCount; currentBufferIndex++)
+    {
+        if (stagingTextures[currentBufferIndex] != NULL)
+        {
+            CFRelease(stagingTextures[currentBufferIndex]);
+            stagingTextures[currentBufferIndex] = NULL;
+        }
+        
+        if (stagingPixelBuffers[currentBufferIndex] != NULL)
+        {
+            CVPixelBufferRelease(stagingPixelBuffers[currentBufferIndex]);
+            stagingPixelBuffers[currentBufferIndex] = NULL;
+        }
+    }
+    
+    CFRelease(stagingTextureCache);
+    stagingTextureCache = NULL;
+    stagingFences = nil;
+    stagingBufferSize = CGSizeZero;
+    
+    // The texture belonged to the cache, so it mustn't be deleted along with this output
+    outputTexture = 0;
+}
+
+- (BOOL)uploadsThroughStagingBuffers;
+{
+    return (stagingTextureCache != NULL);
+}
+
 @end
@@ -1,5 +1,6 @@
 #import <Foundation/Foundation.h>
 #import "GPUImageOpenGLESContext.h"
+#import "GPUImageYUVConverter.h"
 
 struct GPUByteColorVector {
     GLubyte red;
@@ -29,6 +30,12 @@ typedef struct GPUByteColorVector GPUByteColorVector;
 // Initialization and teardown
 - (id)initWithImageSize:(CGSize)newImageSize resultsInBGRAFormat:(BOOL)resultsInBGRAFormat;
 
+/** Reads frames back as 4:2:0 YUV instead of RGBA
+ 
+ The planes are converted on the GPU and rawBytesForImage holds them back to back with no row padding: the Y plane, then either the interleaved CbCr plane (NV12) or the Cb and Cr planes (I420), each chroma plane being half the width and height of the image, rounded up. This reads back 1.5 bytes per pixel instead of 4. Colors are encoded with BT.709 in video range. colorAtLocation: isn't available in this mode.
+ */
+- (id)initWithImageSize:(CGSize)newImageSize yuvPlaneLayout:(GPUImageYUVPlaneLayout)planeLayout;
+
 // Data access
 - (GPUByteColorVector)colorAtLocation:(CGPoint)locationInImage;
 - (NSUInteger)bytesPerRowInOutput;
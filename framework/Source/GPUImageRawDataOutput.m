@@ -4,6 +4,8 @@
 #import "GLProgram.h"
 #import "GPUImageFilter.h"
 #import "GPUImageMovieWriter.h"
+#import "GPUImageFence.h"
+#import "GPUImageYUVRenderer.h"
 
 @interface GPUImageRawDataOutput ()
 {
@@ -19,6 +21,10 @@
     GLint dataInputTextureUniform;
     
     GLubyte *_rawBytesForImage;
+    
+    GPUImageFence *rawDataFence;
+
+    GPUImageYUVRenderer *yuvRenderer;
 }
 
 // Frame rendering
@@ -27,6 +33,7 @@
 - (void)setFilterFBO;
 
 - (void)renderAtInternalSize;
+- (GLubyte *)rawBytesForYUVImage;
 
 @end
 
@@ -52,6 +59,7 @@
     hasReadFromTheCurrentFrame = NO;
     _rawBytesForImage = NULL;
     inputRotation = kGPUImageNoRotation;
+    rawDataFence = [[GPUImageFence alloc] initWithLabel:@"GPUImageRawDataOutput readback"];
 
     [GPUImageOpenGLESContext useImageProcessingContext];
     if ( (outputBGRA && ![GPUImageOpenGLESContext supportsFastTextureUpload]) || (!outputBGRA && [GPUImageOpenGLESContext supportsFastTextureUpload]) )
@@ -94,11 +102,25 @@
     return self;
 }
 
+- (id)initWithImageSize:(CGSize)newImageSize yuvPlaneLayout:(GPUImageYUVPlaneLayout)planeLayout;
+{
+    if (!(self = [self initWithImageSize:newImageSize resultsInBGRAFormat:NO]))
+    {
+		return nil;
+    }
+
+    runSynchronouslyOnVideoProcessingQueue(^{
+        yuvRenderer = [[GPUImageYUVRenderer alloc] initWithPlaneLayout:planeLayout];
+    });
+
+    return self;
+}
+
 - (void)dealloc
 {
     [self destroyDataFBO];
     
-    if (_rawBytesForImage != NULL && (![GPUImageOpenGLESContext supportsFastTextureUpload])) 
+    if (_rawBytesForImage != NULL && ((yuvRenderer != nil) || ![GPUImageOpenGLESContext supportsFastTextureUpload]))
     {
         free(_rawBytesForImage);
         _rawBytesForImage = NULL;
@@ -259,6 +281,8 @@
 
 - (GPUByteColorVector)colorAtLocation:(CGPoint)locationInImage;
 {
+    NSAssert(yuvRenderer == nil, @"Colors can't be picked from YUV output");
+
     GPUByteColorVector *imageColorBytes = (GPUByteColorVector *)self.rawBytesForImage;
 //    NSLog(@"Row start");
 //    for (unsigned int currentXPosition = 0; currentXPosition < (imageSize.width * 2.0); currentXPosition++)
@@ -300,6 +324,19 @@
 {
     hasReadFromTheCurrentFrame = NO;
     
+    // Start the texture cache render as the frame arrives and only wait on it when the bytes are read, so the GPU gets a head start on the readback
+    if ( (yuvRenderer == nil) && [GPUImageOpenGLESContext supportsFastTextureUpload] )
+    {
+        [GPUImageOpenGLESContext useImageProcessingContext];
+        if (renderTarget != NULL)
+        {
+            CVPixelBufferUnlockBaseAddress(renderTarget, 0);
+        }
+        
+        [self renderAtInternalSize];
+        [rawDataFence insert];
+    }
+    
     if (_newFrameAvailableBlock != NULL)
     {
         _newFrameAvailableBlock();
@@ -359,11 +396,60 @@
     
 }
 
+- (BOOL)wantsNextFrame;
+{
+    // The bytes can be read at any time, with or without a newFrameAvailableBlock, so only disabling this stops frames
+    return enabled;
+}
+
 #pragma mark -
 #pragma mark Accessors
 
+- (GLubyte *)rawBytesForYUVImage;
+{
+    if (_rawBytesForImage == NULL)
+    {
+        size_t totalBytes = 0;
+        for (NSUInteger planeIndex = 0; planeIndex < [yuvRenderer numberOfPlanes]; planeIndex++)
+        {
+            totalBytes += [yuvRenderer bytesPerRowOfPlane:planeIndex forFrameSize:imageSize] * (size_t)[yuvRenderer sizeOfPlane:planeIndex forFrameSize:imageSize].height;
+        }
+
+        _rawBytesForImage = (GLubyte *) calloc(totalBytes, sizeof(GLubyte));
+        hasReadFromTheCurrentFrame = NO;
+    }
+
+    if (!hasReadFromTheCurrentFrame)
+    {
+        runSynchronouslyOnVideoProcessingQueue(^{
+            [GPUImageOpenGLESContext useImageProcessingContext];
+
+            GLubyte *planeBytes[3];
+            size_t bytesPerRow[3];
+            GLubyte *currentPlaneBytes = _rawBytesForImage;
+            for (NSUInteger planeIndex = 0; planeIndex < [yuvRenderer numberOfPlanes]; planeIndex++)
+            {
+                planeBytes[planeIndex] = currentPlaneBytes;
+                bytesPerRow[planeIndex] = [yuvRenderer bytesPerRowOfPlane:planeIndex forFrameSize:imageSize];
+                currentPlaneBytes += bytesPerRow[planeIndex] * (size_t)[yuvRenderer sizeOfPlane:planeIndex forFrameSize:imageSize].height;
+            }
+
+            [yuvRenderer readPlanesFromTexture:inputTextureForDisplay frameSize:imageSize intoBytes:planeBytes bytesPerRow:bytesPerRow];
+        });
+
+        hasReadFromTheCurrentFrame = YES;
+    }
+
+    return _rawBytesForImage;
+}
+
 - (GLubyte *)rawBytesForImage;
 {
+    if (yuvRenderer != nil)
+    {
+        return [self rawBytesForYUVImage];
+    }
+
     if ( (_rawBytesForImage == NULL) && (![GPUImageOpenGLESContext supportsFastTextureUpload]) )
     {
         _rawBytesForImage = (GLubyte *) calloc(imageSize.width * imageSize.height * 4, sizeof(GLubyte));
@@ -382,33 +468,35 @@
             [GPUImageOpenGLESContext useImageProcessingContext];
             if ([GPUImageOpenGLESContext supportsFastTextureUpload])
             {
-                CVPixelBufferUnlockBaseAddress(renderTarget, 0);
-                //            CVOpenGLESTextureCacheFlush(rawDataTextureCache, 0);
-            }
-            
-            [self renderAtInternalSize];
-            
-            if ([GPUImageOpenGLESContext supportsFastTextureUpload])
-            {
-                glFinish();
+                // The frame was rendered and fenced when it arrived, so this is the only point that has to wait for the GPU
+                [rawDataFence waitUntilCompleted];
                 CVPixelBufferLockBaseAddress(renderTarget, 0);
                 _rawBytesForImage = (GLubyte *)CVPixelBufferGetBaseAddress(renderTarget);
             }
             else
             {
+                [self renderAtInternalSize];
                 glReadPixels(0, 0, imageSize.width, imageSize.height, GL_RGBA, GL_UNSIGNED_BYTE, _rawBytesForImage);
                 // GL_EXT_read_format_bgra
                 //            glReadPixels(0, 0, imageSize.width, imageSize.height, GL_BGRA_EXT, GL_UNSIGNED_BYTE, _rawBytesForImage);
             }
         });
         
+        // Reading again within the same frame would otherwise lock the pixel buffer a second time
+        hasReadFromTheCurrentFrame = YES;
+        
         return _rawBytesForImage;
     }
 }
 
 - (NSUInteger)bytesPerRowInOutput;
 {
-    if ([GPUImageOpenGLESContext supportsFastTextureUpload]) 
+    if (yuvRenderer != nil)
+    {
+        // The bytes per row of the Y plane, since each plane is tightly packed
+        return [yuvRenderer bytesPerRowOfPlane:0 forFrameSize:imageSize];
+    }
+    else if ([GPUImageOpenGLESContext supportsFastTextureUpload]) 
     {
         return CVPixelBufferGetBytesPerRow(renderTarget);
     }
@@ -0,0 +1,52 @@
+#import "GPUImageRawDataInput.h"
+#import "GPUImageVideoSource.h"
+
+@protocol GPUImageMovieDelegate;
+
+/** Something that reads uncompressed 4:2:0 frames, with their planes packed one after another, from a file or stream
+ */
+@protocol GPUImageRawVideoReader <NSObject>
+
+- (CGSize)frameSize;
+- (GPUImageYUVPlaneLayout)planeLayout;
+
+/** Gets ready to read from the first frame, returning NO if the video can't be opened or isn't in a format that can be read
+ */
+- (BOOL)openForReading;
+
+/** Reads the next frame, returning NO at the end of the video
+ 
+ @param frameBytes Room for one frame of planes, which is 1.5 bytes per pixel with chroma planes rounded up to whole samples
+ @param frameTime Set to the presentation time of the frame
+ */
+- (BOOL)readNextFrameIntoBytes:(GLubyte *)frameBytes frameTime:(CMTime *)frameTime;
+
+- (void)close;
+
+@end
+
+/** Source object for filtering uncompressed YUV videos, such as Y4M files
+ 
+ Frames are read on the thread that calls startProcessing, or pulled one at a time by a sink set through enableSynchronizedEncodingUsingMovieWriter:, and converted to RGB on the GPU. Each frame goes out with the time the reader gives it, so that it can be recorded.
+ */
+@interface GPUImageRawVideoInput : GPUImageRawDataInput <GPUImageVideoSource>
+
+@property(readonly, nonatomic) id<GPUImageRawVideoReader> frameReader;
+
+/** Told once every frame has been read
+ */
+@property(readwrite, nonatomic, assign) id <GPUImageMovieDelegate>delegate;
+
+/// @name Initialization and teardown
+- (id)initWithFrameReader:(id<GPUImageRawVideoReader>)newFrameReader;
+
+/// @name Movie processing
+- (void)enableSynchronizedEncodingUsingMovieWriter:(id<GPUImageVideoSink>)movieWriter;
+- (void)startProcessing;
+- (void)endProcessing;
+
+/** Reads, uploads, and processes one frame, ending processing if there are none left
+ */
+- (BOOL)readNextFrame;
+
+@end
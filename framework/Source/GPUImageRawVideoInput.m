@@ -0,0 +1,148 @@
+#import "GPUImageRawVideoInput.h"
+#import "GPUImageMovie.h"
+
+@interface GPUImageRawVideoInput ()
+{
+    id<GPUImageVideoSink> synchronizedMovieWriter;
+    GLubyte *frameBytes;
+    BOOL isProcessing;
+}
+
+- (size_t)bytesPerFrame;
+
+@end
+
+@implementation GPUImageRawVideoInput
+
+@synthesize frameReader = _frameReader;
+@synthesize delegate = _delegate;
+
+#pragma mark -
+#pragma mark Initialization and teardown
+
+- (id)initWithFrameReader:(id<GPUImageRawVideoReader>)newFrameReader;
+{
+    // No bytes are uploaded until the first frame is read
+    if (!(self = [super initWithYUVBytes:NULL size:[newFrameReader frameSize] planeLayout:[newFrameReader planeLayout]]))
+    {
+		return nil;
+    }
+
+    _frameReader = newFrameReader;
+    isProcessing = NO;
+    frameBytes = (GLubyte *) malloc([self bytesPerFrame]);
+
+    // Targets pick up the output texture when they're added, which can be before the first frame is read
+    runSynchronouslyOnVideoProcessingQueue(^{
+        [GPUImageOpenGLESContext useImageProcessingContext];
+        [self initializeOutputTextureIfNeeded];
+    });
+
+    return self;
+}
+
+- (void)dealloc;
+{
+    [_frameReader close];
+    free(frameBytes);
+}
+
+- (size_t)bytesPerFrame;
+{
+    size_t frameWidth = (size_t)[_frameReader frameSize].width;
+    size_t frameHeight = (size_t)[_frameReader frameSize].height;
+    size_t chromaSamples = ((frameWidth + 1) / 2) * ((frameHeight + 1) / 2);
+
+    return (frameWidth * frameHeight) + (2 * chromaSamples);
+}
+
+#pragma mark -
+#pragma mark Movie processing
+
+- (void)enableSynchronizedEncodingUsingMovieWriter:(id<GPUImageVideoSink>)movieWriter;
+{
+    synchronizedMovieWriter = movieWriter;
+    movieWriter.encodingLiveVideo = NO;
+}
+
+- (void)startProcessing;
+{
+    if (![_frameReader openForReading])
+    {
+        NSLog(@"Error opening raw video for reading");
+        return;
+    }
+
+    isProcessing = YES;
+
+    if (synchronizedMovieWriter != nil)
+    {
+        __unsafe_unretained GPUImageRawVideoInput *weakSelf = self;
+        [synchronizedMovieWriter setVideoInputReadyCallback:^{
+            [weakSelf readNextFrame];
+        }];
+
+        // Raw video has no audio to interleave
+        [synchronizedMovieWriter setAudioInputReadyCallback:^{}];
+
+        [synchronizedMovieWriter enableSynchronizationCallbacks];
+    }
+    else
+    {
+        while ([self readNextFrame])
+        {
+        }
+    }
+}
+
+- (BOOL)readNextFrame;
+{
+    if (!isProcessing)
+    {
+        return NO;
+    }
+
+    CMTime frameTime = kCMTimeInvalid;
+    if (![_frameReader readNextFrameIntoBytes:frameBytes frameTime:&frameTime])
+    {
+        [self endProcessing];
+        return NO;
+    }
+
+    // Running this synchronously keeps the frame from being dropped by the check for frames still in flight
+    runSynchronouslyOnVideoProcessingQueue(^{
+        [self updateDataFromBytes:frameBytes size:[_frameReader frameSize]];
+        [self processDataForTimestamp:frameTime];
+    });
+
+    return YES;
+}
+
+- (void)endProcessing;
+{
+    if (!isProcessing)
+    {
+        return;
+    }
+    isProcessing = NO;
+
+    [_frameReader close];
+
+    for (id<GPUImageInput> currentTarget in targets)
+    {
+        [currentTarget endProcessing];
+    }
+
+    if (synchronizedMovieWriter != nil)
+    {
+        [synchronizedMovieWriter setVideoInputReadyCallback:^{}];
+        [synchronizedMovieWriter setAudioInputReadyCallback:^{}];
+    }
+
+    if ([self.delegate respondsToSelector:@selector(didCompletePlayingMovie)])
+    {
+        [self.delegate didCompletePlayingMovie];
+    }
+}
+
+@end
@@ -0,0 +1,53 @@
+#import <Foundation/Foundation.h>
+#import "GPUImageOpenGLESContext.h"
+#import "GPUImageVideoSink.h"
+#import "GPUImageYUVRenderer.h"
+
+/** Something that writes uncompressed 4:2:0 frames, with their planes packed one after another, to a file or stream
+ */
+@protocol GPUImageRawVideoWriter <NSObject>
+
+- (GPUImageYUVPlaneLayout)planeLayout;
+
+/** Gets ready to write frames of the given size, returning NO if the destination can't be opened
+ */
+- (BOOL)openForWritingWithFrameSize:(CGSize)frameSize;
+
+/** Whether a frame can be appended right now. Writers that block until their frames are written can always return YES.
+ */
+- (BOOL)isReadyForMoreFrames;
+
+- (BOOL)appendFrameBytes:(const GLubyte *)frameBytes frameTime:(CMTime)frameTime;
+
+- (void)close;
+
+@end
+
+/** Records the end of a filter chain as uncompressed YUV, such as a Y4M file
+ 
+ Frames are converted to YUV on the GPU and read back at 1.5 bytes per pixel before being handed to the frame writer. Like GPUImageMovieWriter, this drops frames without a time, and can pace a source through enableSynchronizedEncodingUsingMovieWriter: so that no frames are lost.
+ */
+@interface GPUImageRawVideoOutput : NSObject <GPUImageVideoSink>
+
+@property(readonly, nonatomic) id<GPUImageRawVideoWriter> frameWriter;
+@property(readwrite, nonatomic) BOOL encodingLiveVideo;
+@property(nonatomic, copy) void(^videoInputReadyCallback)(void);
+@property(nonatomic, copy) void(^audioInputReadyCallback)(void);
+@property(nonatomic, copy) void(^completionBlock)(void);
+@property(nonatomic) BOOL enabled;
+
+/** The conversion applied to frames before they're written, where the color matrix and range can be set
+ */
+@property(readonly, nonatomic) GPUImageYUVRenderer *yuvRenderer;
+
+// Initialization and teardown
+- (id)initWithFrameWriter:(id<GPUImageRawVideoWriter>)newFrameWriter size:(CGSize)newSize;
+
+// Movie recording
+- (void)startRecording;
+- (void)finishRecording;
+- (void)cancelRecording;
+- (void)processAudioBuffer:(CMSampleBufferRef)audioBuffer;
+- (void)enableSynchronizationCallbacks;
+
+@end
@@ -0,0 +1,249 @@
+#import "GPUImageRawVideoOutput.h"
+
+@interface GPUImageRawVideoOutput ()
+{
+    CGSize videoSize;
+    GLuint inputTextureForRecording;
+    GPUImageRotationMode inputRotation;
+
+    GLubyte *frameData;
+    size_t planeOffsets[3], planeBytesPerRow[3];
+
+    CMTime previousFrameTime;
+    BOOL isRecording, videoEncodingIsFinished;
+
+    __unsafe_unretained id<GPUImageTextureDelegate> textureDelegate;
+}
+
+- (void)requestFramesWhileReady;
+
+@end
+
+@implementation GPUImageRawVideoOutput
+
+@synthesize frameWriter = _frameWriter;
+@synthesize encodingLiveVideo = _encodingLiveVideo;
+@synthesize videoInputReadyCallback;
+@synthesize audioInputReadyCallback;
+@synthesize completionBlock;
+@synthesize enabled;
+@synthesize yuvRenderer = _yuvRenderer;
+
+#pragma mark -
+#pragma mark Initialization and teardown
+
+- (id)initWithFrameWriter:(id<GPUImageRawVideoWriter>)newFrameWriter size:(CGSize)newSize;
+{
+    if (!(self = [super init]))
+    {
+		return nil;
+    }
+
+    self.enabled = YES;
+    _frameWriter = newFrameWriter;
+    _encodingLiveVideo = YES;
+    videoSize = newSize;
+    inputRotation = kGPUImageNoRotation;
+    previousFrameTime = kCMTimeNegativeInfinity;
+
+    runSynchronouslyOnVideoProcessingQueue(^{
+        _yuvRenderer = [[GPUImageYUVRenderer alloc] initWithPlaneLayout:[_frameWriter planeLayout]];
+    });
+
+    // Planes are packed one after another with no row padding, as raw video files store them
+    size_t frameLength = 0;
+    for (NSUInteger planeIndex = 0; planeIndex < [_yuvRenderer numberOfPlanes]; planeIndex++)
+    {
+        planeOffsets[planeIndex] = frameLength;
+        planeBytesPerRow[planeIndex] = [_yuvRenderer bytesPerRowOfPlane:planeIndex forFrameSize:videoSize];
+        frameLength += planeBytesPerRow[planeIndex] * (size_t)[_yuvRenderer sizeOfPlane:planeIndex forFrameSize:videoSize].height;
+    }
+    frameData = (GLubyte *) malloc(frameLength);
+
+    return self;
+}
+
+- (void)dealloc;
+{
+    if (isRecording)
+    {
+        [_frameWriter close];
+    }
+    free(frameData);
+}
+
+#pragma mark -
+#pragma mark Movie recording
+
+- (void)startRecording;
+{
+    if (![_frameWriter openForWritingWithFrameSize:videoSize])
+    {
+        NSLog(@"Error opening raw video for writing");
+        return;
+    }
+
+    previousFrameTime = kCMTimeNegativeInfinity;
+    videoEncodingIsFinished = NO;
+    isRecording = YES;
+}
+
+- (void)finishRecording;
+{
+    runSynchronouslyOnVideoProcessingQueue(^{
+        // Both the source running out and the client can finish a recording, but the writer only gets closed once
+        if (!isRecording)
+        {
+            return;
+        }
+
+        isRecording = NO;
+        [_frameWriter close];
+    });
+}
+
+- (void)cancelRecording;
+{
+    [self finishRecording];
+}
+
+- (void)processAudioBuffer:(CMSampleBufferRef)audioBuffer;
+{
+    // Raw video files have no audio track
+}
+
+- (void)enableSynchronizationCallbacks;
+{
+    if (videoInputReadyCallback == NULL)
+    {
+        return;
+    }
+
+    dispatch_async([GPUImageOpenGLESContext sharedOpenGLESQueue], ^{
+        [self requestFramesWhileReady];
+    });
+}
+
+- (void)requestFramesWhileReady;
+{
+    // Like AVAssetWriterInput, keep asking for frames until the writer can't take any more, then check back
+    while (isRecording && !videoEncodingIsFinished && [_frameWriter isReadyForMoreFrames])
+    {
+        videoInputReadyCallback();
+    }
+
+    if (isRecording && !videoEncodingIsFinished)
+    {
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, 10 * NSEC_PER_MSEC), [GPUImageOpenGLESContext sharedOpenGLESQueue], ^{
+            [self requestFramesWhileReady];
+        });
+    }
+}
+
+#pragma mark -
+#pragma mark GPUImageInput protocol
+
+- (void)newFrameReadyAtTime:(CMTime)frameTime atIndex:(NSInteger)textureIndex;
+{
+    if (!isRecording || !enabled)
+    {
+        return;
+    }
+
+    // As with GPUImageMovieWriter, frames without a time can't be placed in the video, and repeated times would be out of order
+    if ( (CMTIME_IS_INVALID(frameTime)) || (CMTIME_COMPARE_INLINE(frameTime, ==, previousFrameTime)) || (CMTIME_IS_INDEFINITE(frameTime)) )
+    {
+        return;
+    }
+
+    if (![_frameWriter isReadyForMoreFrames])
+    {
+        NSLog(@"Had to drop a video frame");
+        return;
+    }
+
+    [GPUImageOpenGLESContext useImageProcessingContext];
+
+    GLubyte *planeBytes[3];
+    for (NSUInteger planeIndex = 0; planeIndex < [_yuvRenderer numberOfPlanes]; planeIndex++)
+    {
+        planeBytes[planeIndex] = frameData + planeOffsets[planeIndex];
+    }
+    [_yuvRenderer readPlanesFromTexture:inputTextureForRecording frameSize:videoSize intoBytes:planeBytes bytesPerRow:planeBytesPerRow];
+
+    if (![_frameWriter appendFrameBytes:frameData frameTime:frameTime])
+    {
+        NSLog(@"Problem appending raw video frame at time: %lld", frameTime.value);
+    }
+
+    previousFrameTime = frameTime;
+}
+
+- (NSInteger)nextAvailableTextureIndex;
+{
+    return 0;
+}
+
+- (void)setInputTexture:(GLuint)newInputTexture atIndex:(NSInteger)textureIndex;
+{
+    inputTextureForRecording = newInputTexture;
+}
+
+- (void)setInputRotation:(GPUImageRotationMode)newInputRotation atIndex:(NSInteger)textureIndex;
+{
+    inputRotation = newInputRotation;
+}
+
+- (void)setInputSize:(CGSize)newSize atIndex:(NSInteger)textureIndex;
+{
+}
+
+- (CGSize)maximumOutputSize;
+{
+    return videoSize;
+}
+
+- (void)endProcessing;
+{
+    videoEncodingIsFinished = YES;
+
+    // Once the source has run out nothing else will close the writer, and the last frames may not be flushed until it's closed
+    [self finishRecording];
+
+    if (completionBlock)
+    {
+        completionBlock();
+    }
+}
+
+- (BOOL)shouldIgnoreUpdatesToThisTarget;
+{
+    return NO;
+}
+
+- (void)setTextureDelegate:(id<GPUImageTextureDelegate>)newTextureDelegate atIndex:(NSInteger)textureIndex;
+{
+    textureDelegate = newTextureDelegate;
+}
+
+- (void)conserveMemoryForNextFrame;
+{
+
+}
+
+- (BOOL)wantsMonochromeInput;
+{
+    return NO;
+}
+
+- (void)setCurrentlyReceivingMonochromeInput:(BOOL)newValue;
+{
+
+}
+
+- (BOOL)wantsNextFrame;
+{
+    return enabled && isRecording;
+}
+
+@end
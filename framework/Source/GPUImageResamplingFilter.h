@@ -0,0 +1,17 @@
+#import "GPUImageFilterGroup.h"
+#import "GPUImageResamplingPassFilter.h"
+
+/** A separable resampler, which scales the width and then the height of its input with Lanczos, Mitchell, Catmull-Rom, area or bilinear kernels
+
+ Set the output size with -forceProcessingAtSize:. Kernel weights are precomputed for each output column and row and reused across frames of the same size, and large reductions get a correspondingly wider prefilter.
+ */
+@interface GPUImageResamplingFilter : GPUImageFilterGroup
+{
+    GPUImageResamplingPassFilter *horizontalPassFilter, *verticalPassFilter;
+}
+
+/** The kernel used for both axes. Defaults to kGPUImageResamplingKernelLanczos3
+ */
+@property(readwrite, nonatomic) GPUImageResamplingKernel kernel;
+
+@end
@@ -0,0 +1,54 @@
+#import "GPUImageResamplingFilter.h"
+
+@implementation GPUImageResamplingFilter
+
+@synthesize kernel = _kernel;
+
+#pragma mark -
+#pragma mark Initialization and teardown
+
+- (id)init;
+{
+    if (!(self = [super init]))
+    {
+		return nil;
+    }
+    
+    // The width is resampled first, at the height of the input, and then the height
+    horizontalPassFilter = [[GPUImageResamplingPassFilter alloc] init];
+    [self addFilter:horizontalPassFilter];
+    
+    verticalPassFilter = [[GPUImageResamplingPassFilter alloc] init];
+    verticalPassFilter.resamplesVertically = YES;
+    [self addFilter:verticalPassFilter];
+    
+    [horizontalPassFilter addTarget:verticalPassFilter];
+    
+    self.initialFilters = [NSArray arrayWithObject:horizontalPassFilter];
+    self.terminalFilter = verticalPassFilter;
+    
+    self.kernel = kGPUImageResamplingKernelLanczos3;
+    
+    return self;
+}
+
+#pragma mark -
+#pragma mark GPUImageInput protocol
+
+- (void)forceProcessingAtSize:(CGSize)frameSize;
+{
+    horizontalPassFilter.outputLength = (NSUInteger)round(frameSize.width);
+    verticalPassFilter.outputLength = (NSUInteger)round(frameSize.height);
+}
+
+#pragma mark -
+#pragma mark Accessors
+
+- (void)setKernel:(GPUImageResamplingKernel)newValue;
+{
+    _kernel = newValue;
+    horizontalPassFilter.kernel = _kernel;
+    verticalPassFilter.kernel = _kernel;
+}
+
+@end
@@ -0,0 +1,39 @@
+#import "GPUImageFilter.h"
+
+typedef enum {
+    kGPUImageResamplingKernelBilinear,
+    kGPUImageResamplingKernelLanczos2,
+    kGPUImageResamplingKernelLanczos3,
+    kGPUImageResamplingKernelMitchell,
+    kGPUImageResamplingKernelCatmullRom,
+    kGPUImageResamplingKernelArea
+} GPUImageResamplingKernel;
+
+// The most source pixels one output pixel can be built from, which bounds the prefilter width for large reductions
+extern const NSUInteger kGPUImageResamplingMaximumTaps;
+
+/** One axis of a GPUImageResamplingFilter, which resamples the input to a new width or height with a chosen kernel
+
+ The source pixels and weights for each output column or row are worked out on the CPU and stored in a small lookup texture, which is only rebuilt when the input size, output size or kernel changes. When reducing, the kernel is stretched by the reduction factor so that it prefilters the input rather than aliasing, up to kGPUImageResamplingMaximumTaps source pixels.
+ */
+@interface GPUImageResamplingPassFilter : GPUImageFilter
+{
+    GLint tapCountUniform, sourceLengthUniform, resamplingAxisUniform, weightTextureUniform;
+    GLuint weightTexture;
+    NSUInteger weightTableInputLength, weightTableOutputLength, weightTableTapCount;
+    GPUImageResamplingKernel weightTableKernel;
+}
+
+/** Whether this resamples the height of the image rather than its width
+ */
+@property(readwrite, nonatomic) BOOL resamplesVertically;
+
+/** The width or height of the output, in pixels. 0, the default, leaves it at the size of the input
+ */
+@property(readwrite, nonatomic) NSUInteger outputLength;
+
+/** The kernel to resample with. Defaults to kGPUImageResamplingKernelLanczos3
+ */
+@property(readwrite, nonatomic) GPUImageResamplingKernel kernel;
+
+@end
@@ -0,0 +1,307 @@
+#import "GPUImageResamplingPassFilter.h"
+
+const NSUInteger kGPUImageResamplingMaximumTaps = 64;
+
+// Each texel of the weight texture holds one tap for one output column or row: the source pixel index in red and green, and the weight, mapped from [-1, 2], in blue and alpha, both as 16-bit fixed point. The loop bound has to match kGPUImageResamplingMaximumTaps.
+NSString *const kGPUImageResamplingPassFragmentShaderString = SHADER_STRING
+(
+ precision highp float;
+ 
+ varying vec2 textureCoordinate;
+ 
+ uniform sampler2D inputImageTexture;
+ uniform sampler2D weightTexture;
+ 
+ uniform float tapCount;
+ uniform float sourceLength;
+ uniform vec2 resamplingAxis;
+ 
+ const vec2 fixedPointDecoding = vec2(255.0 * 256.0, 255.0);
+ 
+ void main()
+ {
+     float outputPosition = dot(textureCoordinate, resamplingAxis);
+     vec4 sum = vec4(0.0);
+     
+     for (int tap = 0; tap < 64; tap++)
+     {
+         if (float(tap) >= tapCount)
+         {
+             break;
+         }
+         
+         vec4 encodedTap = floor(texture2D(weightTexture, vec2(outputPosition, (float(tap) + 0.5) / tapCount)) * 255.0 + 0.5) / 255.0;
+         float sourceIndex = dot(encodedTap.rg, fixedPointDecoding);
+         float weight = (dot(encodedTap.ba, fixedPointDecoding) / 65535.0) * 3.0 - 1.0;
+         
+         vec2 sourceCoordinate = mix(textureCoordinate, vec2((sourceIndex + 0.5) / sourceLength), resamplingAxis);
+         sum += texture2D(inputImageTexture, sourceCoordinate) * weight;
+     }
+     
+     gl_FragColor = sum;
+ }
+);
+
+static CGFloat GPUImageSinc(CGFloat x)
+{
+    if (fabs(x) < 1e-6)
+    {
+        return 1.0;
+    }
+    
+    return sin(M_PI * x) / (M_PI * x);
+}
+
+// Mitchell-Netravali cubics, from "Reconstruction Filters in Computer Graphics"
+static CGFloat GPUImageCubicFilter(CGFloat x, CGFloat B, CGFloat C)
+{
+    x = fabs(x);
+    if (x < 1.0)
+    {
+        return ((12.0 - 9.0 * B - 6.0 * C) * x * x * x + (-18.0 + 12.0 * B + 6.0 * C) * x * x + (6.0 - 2.0 * B)) / 6.0;
+    }
+    else if (x < 2.0)
+    {
+        return ((-B - 6.0 * C) * x * x * x + (6.0 * B + 30.0 * C) * x * x + (-12.0 * B - 48.0 * C) * x + (8.0 * B + 24.0 * C)) / 6.0;
+    }
+    
+    return 0.0;
+}
+
+static CGFloat GPUImageResamplingKernelSupport(GPUImageResamplingKernel kernel)
+{
+    switch (kernel)
+    {
+        case kGPUImageResamplingKernelLanczos3: return 3.0;
+        case kGPUImageResamplingKernelLanczos2:
+        case kGPUImageResamplingKernelMitchell:
+        case kGPUImageResamplingKernelCatmullRom: return 2.0;
+        case kGPUImageResamplingKernelArea: return 0.5;
+        default: return 1.0;
+    }
+}
+
+static CGFloat GPUImageResamplingKernelWeight(GPUImageResamplingKernel kernel, CGFloat x)
+{
+    switch (kernel)
+    {
+        case kGPUImageResamplingKernelLanczos2: return (fabs(x) < 2.0) ? GPUImageSinc(x) * GPUImageSinc(x / 2.0) : 0.0;
+        case kGPUImageResamplingKernelLanczos3: return (fabs(x) < 3.0) ? GPUImageSinc(x) * GPUImageSinc(x / 3.0) : 0.0;
+        case kGPUImageResamplingKernelMitchell: return GPUImageCubicFilter(x, 1.0 / 3.0, 1.0 / 3.0);
+        case kGPUImageResamplingKernelCatmullRom: return GPUImageCubicFilter(x, 0.0, 0.5);
+        // Area weights are the overlap of each source pixel with the output pixel, and are worked out separately
+        case kGPUImageResamplingKernelArea: return (fabs(x) <= 0.5) ? 1.0 : 0.0;
+        default: return fmax(1.0 - fabs(x), 0.0);
+    }
+}
+
+@interface GPUImageResamplingPassFilter()
+
+- (void)updateWeightTextureIfNeeded;
+
+@end
+
+@implementation GPUImageResamplingPassFilter
+
+@synthesize resamplesVertically = _resamplesVertically;
+@synthesize outputLength = _outputLength;
+@synthesize kernel = _kernel;
+
+#pragma mark -
+#pragma mark Initialization and teardown
+
+- (id)init;
+{
+    if (!(self = [super initWithFragmentShaderFromString:kGPUImageResamplingPassFragmentShaderString]))
+    {
+		return nil;
+    }
+    
+    tapCountUniform = [filterProgram uniformIndex:@"tapCount"];
+    sourceLengthUniform = [filterProgram uniformIndex:@"sourceLength"];
+    resamplingAxisUniform = [filterProgram uniformIndex:@"resamplingAxis"];
+    weightTextureUniform = [filterProgram uniformIndex:@"weightTexture"];
+    
+    _kernel = kGPUImageResamplingKernelLanczos3;
+    
+    return self;
+}
+
+- (void)dealloc
+{
+    if (weightTexture)
+    {
+        runSynchronouslyOnVideoProcessingQueue(^{
+            [GPUImageOpenGLESContext useImageProcessingContext];
+            glDeleteTextures(1, &weightTexture);
+            weightTexture = 0;
+        });
+    }
+}
+
+#pragma mark -
+#pragma mark Weight calculation
+
+- (void)updateWeightTextureIfNeeded;
+{
+    NSUInteger inputLength = (NSUInteger)round(_resamplesVertically ? inputTextureSize.height : inputTextureSize.width);
+    NSUInteger outputLength = (NSUInteger)round(_resamplesVertically ? [self sizeOfFBO].height : [self sizeOfFBO].width);
+    
+    if ( weightTexture && (inputLength == weightTableInputLength) && (outputLength == weightTableOutputLength) && (_kernel == weightTableKernel) )
+    {
+        return;
+    }
+    
+    if ( (inputLength == 0) || (outputLength == 0) )
+    {
+        return;
+    }
+    
+    // When reducing, stretch the kernel over as many source pixels as each output pixel covers, so it acts as a prefilter
+    CGFloat scale = (CGFloat)inputLength / (CGFloat)outputLength;
+    CGFloat kernelScale = fmax(scale, 1.0);
+    CGFloat support = GPUImageResamplingKernelSupport(_kernel) * kernelScale;
+    // Area weights also take in the partly covered source pixels at either end
+    NSUInteger extraTaps = (_kernel == kGPUImageResamplingKernelArea) ? 2 : 1;
+    NSUInteger tapCount = (NSUInteger)ceil(2.0 * support) + extraTaps;
+    if (tapCount > kGPUImageResamplingMaximumTaps)
+    {
+        tapCount = kGPUImageResamplingMaximumTaps;
+        support = (CGFloat)(tapCount - extraTaps) / 2.0;
+        kernelScale = support / GPUImageResamplingKernelSupport(_kernel);
+    }
+    
+    GLubyte *weightBytes = calloc(outputLength * tapCount * 4, sizeof(GLubyte));
+    CGFloat *tapWeights = calloc(tapCount, sizeof(CGFloat));
+    NSInteger *tapIndices = calloc(tapCount, sizeof(NSInteger));
+    
+    for (NSUInteger outputIndex = 0; outputIndex < outputLength; outputIndex++)
+    {
+        CGFloat center = ((CGFloat)outputIndex + 0.5) * scale;
+        NSInteger firstIndex = (_kernel == kGPUImageResamplingKernelArea) ? (NSInteger)floor(center - support) : (NSInteger)ceil(center - support - 0.5);
+        CGFloat weightSum = 0.0;
+        
+        for (NSUInteger tap = 0; tap < tapCount; tap++)
+        {
+            NSInteger sourceIndex = firstIndex + (NSInteger)tap;
+            CGFloat weight;
+            if (_kernel == kGPUImageResamplingKernelArea)
+            {
+                CGFloat overlapStart = fmax((CGFloat)sourceIndex, center - 0.5 * kernelScale);
+                CGFloat overlapEnd = fmin((CGFloat)sourceIndex + 1.0, center + 0.5 * kernelScale);
+                weight = fmax(overlapEnd - overlapStart, 0.0);
+            }
+            else
+            {
+                weight = GPUImageResamplingKernelWeight(_kernel, ((CGFloat)sourceIndex + 0.5 - center) / kernelScale);
+            }
+            
+            // Pixels past the edge repeat the edge pixel
+            tapIndices[tap] = MIN(MAX(sourceIndex, 0), (NSInteger)inputLength - 1);
+            tapWeights[tap] = weight;
+            weightSum += weight;
+        }
+        
+        for (NSUInteger tap = 0; tap < tapCount; tap++)
+        {
+            CGFloat normalizedWeight = (weightSum != 0.0) ? (tapWeights[tap] / weightSum) : ((tap == tapCount / 2) ? 1.0 : 0.0);
+            NSUInteger encodedWeight = (NSUInteger)round(fmin(fmax((normalizedWeight + 1.0) / 3.0, 0.0), 1.0) * 65535.0);
+            
+            GLubyte *tapBytes = weightBytes + ((tap * outputLength) + outputIndex) * 4;
+            tapBytes[0] = (tapIndices[tap] >> 8) & 0xFF;
+            tapBytes[1] = tapIndices[tap] & 0xFF;
+            tapBytes[2] = (encodedWeight >> 8) & 0xFF;
+            tapBytes[3] = encodedWeight & 0xFF;
+        }
+    }
+    
+    if (!weightTexture)
+    {
+        glGenTextures(1, &weightTexture);
+        glBindTexture(GL_TEXTURE_2D, weightTexture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    }
+    else
+    {
+        glBindTexture(GL_TEXTURE_2D, weightTexture);
+    }
+    
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, (int)outputLength, (int)tapCount, 0, GL_RGBA, GL_UNSIGNED_BYTE, weightBytes);
+    
+    free(tapIndices);
+    free(tapWeights);
+    free(weightBytes);
+    
+    weightTableInputLength = inputLength;
+    weightTableOutputLength = outputLength;
+    weightTableTapCount = tapCount;
+    weightTableKernel = _kernel;
+}
+
+- (BOOL)wantsMipmappedInputOfSize:(CGSize)inputSize atIndex:(NSInteger)textureIndex;
+{
+    // The weights already prefilter the full-resolution input, which a coarser level would blur further
+    return NO;
+}
+
+#pragma mark -
+#pragma mark Managing the display FBOs
+
+- (CGSize)sizeOfFBO;
+{
+    return [self outputFrameSize];
+}
+
+#pragma mark -
+#pragma mark Rendering
+
+- (void)renderToTextureWithVertices:(const GLfloat *)vertices textureCoordinates:(const GLfloat *)textureCoordinates sourceTexture:(GLuint)sourceTexture;
+{
+    if (self.preventRendering)
+    {
+        framebufferHoldsPreviousFrame = NO;
+        return;
+    }
+    
+    [GPUImageOpenGLESContext setActiveShaderProgram:filterProgram];
+    
+    glActiveTexture(GL_TEXTURE3);
+    [self updateWeightTextureIfNeeded];
+    glBindTexture(GL_TEXTURE_2D, weightTexture);
+    glUniform1i(weightTextureUniform, 3);
+    
+    // The axis being resampled runs along the other direction of the source texture when the input is rotated
+    BOOL resamplesAlongTextureHeight = (_resamplesVertically != GPUImageRotationSwapsWidthAndHeight(inputRotation));
+    glUniform1f(tapCountUniform, (GLfloat)weightTableTapCount);
+    glUniform1f(sourceLengthUniform, (GLfloat)weightTableInputLength);
+    glUniform2f(resamplingAxisUniform, resamplesAlongTextureHeight ? 0.0 : 1.0, resamplesAlongTextureHeight ? 1.0 : 0.0);
+    
+    [super renderToTextureWithVertices:vertices textureCoordinates:textureCoordinates sourceTexture:sourceTexture];
+}
+
+- (CGSize)outputFrameSize;
+{
+    if (_outputLength == 0)
+    {
+        return inputTextureSize;
+    }
+    
+    return _resamplesVertically ? CGSizeMake(inputTextureSize.width, _outputLength) : CGSizeMake(_outputLength, inputTextureSize.height);
+}
+
+#pragma mark -
+#pragma mark Accessors
+
+- (void)setOutputLength:(NSUInteger)newValue;
+{
+    _outputLength = newValue;
+    
+    runSynchronouslyOnVideoProcessingQueue(^{
+        [self recreateFilterFBO];
+    });
+}
+
+@end
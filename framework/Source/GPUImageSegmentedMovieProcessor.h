@@ -0,0 +1,61 @@
+#import <Foundation/Foundation.h>
+#import <AVFoundation/AVFoundation.h>
+#import "GPUImageOutput.h"
+
+extern NSString *const GPUImageSegmentedMovieProcessorErrorDomain;
+
+/** Filters a whole movie into a new file by splitting it into segments that are decoded, filtered, and encoded side by side
+
+ The video track is cut at keyframes near evenly spaced times, so that no segment has to decode frames from before its start. Each segment gets its own GPUImageMovie, its own copy of the filter graph from the filterFactory, and its own GPUImageMovieWriter writing to a temporary file. The segments are then joined in order, along with the untouched audio of the source, without being reencoded.
+
+ Decoding and encoding of the segments run concurrently, while rendering for all of them takes turns on the shared video processing queue. Long movies go faster as long as rendering isn't the slowest stage. Only filter graphs that don't carry anything from one frame to the next, such as low pass or motion detection filters do, give the same result as processing the movie in one pass.
+ */
+@interface GPUImageSegmentedMovieProcessor : NSObject
+
+@property(readonly, nonatomic) AVAsset *asset;
+@property(readonly, nonatomic) NSURL *outputURL;
+
+/** The size to encode at. Defaults to the natural size of the source's video track.
+ */
+@property(readwrite, nonatomic) CGSize outputSize;
+
+/** The number of segments, all of which are processed at once. Defaults to the number of active processor cores.
+ */
+@property(readwrite, nonatomic) NSUInteger numberOfSegments;
+
+/** The container of the joined movie. Defaults to AVFileTypeQuickTimeMovie.
+ */
+@property(readwrite, nonatomic, copy) NSString *fileType;
+
+/** Video settings for each segment's writer, as for GPUImageMovieWriter. Defaults to nil, which encodes H.264 at the output size.
+ */
+@property(readwrite, nonatomic, copy) NSDictionary *outputSettings;
+
+@property(readonly, nonatomic, getter=isProcessing) BOOL processing;
+
+/// @name Initialization and teardown
+
+/**
+ @param newAsset The movie to process, whose tracks should already be loaded
+ @param newOutputURL Where to write the filtered movie, which must not already exist
+ @param newFilterFactory Called once per segment to build a fresh filter or filter group with the same settings
+ */
+- (id)initWithAsset:(AVAsset *)newAsset outputURL:(NSURL *)newOutputURL filterFactory:(GPUImageOutput<GPUImageInput> *(^)(void))newFilterFactory;
+
+/// @name Processing
+
+/** Splits the video track into up to numberOfSegments ranges that start on keyframes. This reads through the compressed track without decoding it.
+ */
+- (NSArray *)keyframeAlignedSegmentTimeRanges;
+
+/** Starts processing in the background
+
+ @param completionBlock Called on the main queue once the output has been written, with nil, or with the error that stopped it
+ */
+- (void)processWithCompletion:(void (^)(NSError *error))completionBlock;
+
+/** Stops the segments being processed, after which the completionBlock is called with an error
+ */
+- (void)cancelProcessing;
+
+@end
@@ -0,0 +1,374 @@
+#import "GPUImageSegmentedMovieProcessor.h"
+#import "GPUImageMovie.h"
+#import "GPUImageMovieWriter.h"
+
+NSString *const GPUImageSegmentedMovieProcessorErrorDomain = @"GPUImageSegmentedMovieProcessorErrorDomain";
+
+@interface GPUImageSegmentedMovieProcessor ()
+{
+    GPUImageOutput<GPUImageInput> *(^filterFactory)(void);
+
+    dispatch_queue_t schedulingQueue;
+    NSMutableArray *segmentMovies, *segmentWriters, *segmentURLs;
+    NSMutableIndexSet *finishedSegments;
+    BOOL cancelRequested;
+}
+
+- (NSArray *)keyframeTimesOfTrack:(AVAssetTrack *)videoTrack;
+- (void)processSegmentsInTimeRanges:(NSArray *)segmentTimeRanges group:(dispatch_group_t)segmentGroup;
+- (void)finishSegment:(NSUInteger)segmentIndex group:(dispatch_group_t)segmentGroup;
+- (void)joinSegmentsWithCompletion:(void (^)(NSError *error))completionBlock;
+- (void)removeSegmentFiles;
+
+@end
+
+@implementation GPUImageSegmentedMovieProcessor
+
+@synthesize asset = _asset;
+@synthesize outputURL = _outputURL;
+@synthesize outputSize = _outputSize;
+@synthesize numberOfSegments = _numberOfSegments;
+@synthesize fileType = _fileType;
+@synthesize outputSettings = _outputSettings;
+@synthesize processing = _processing;
+
+#pragma mark -
+#pragma mark Initialization and teardown
+
+- (id)initWithAsset:(AVAsset *)newAsset outputURL:(NSURL *)newOutputURL filterFactory:(GPUImageOutput<GPUImageInput> *(^)(void))newFilterFactory;
+{
+    if (!(self = [super init]))
+    {
+		return nil;
+    }
+
+    _asset = newAsset;
+    _outputURL = newOutputURL;
+    filterFactory = [newFilterFactory copy];
+
+    NSArray *videoTracks = [_asset tracksWithMediaType:AVMediaTypeVideo];
+    _outputSize = ([videoTracks count] > 0) ? [[videoTracks objectAtIndex:0] naturalSize] : CGSizeZero;
+    _numberOfSegments = MAX([[NSProcessInfo processInfo] activeProcessorCount], 1);
+    _fileType = AVFileTypeQuickTimeMovie;
+    _processing = NO;
+
+    schedulingQueue = dispatch_queue_create("com.sunsetlakesoftware.GPUImage.segmentSchedulingQueue", NULL);
+
+    return self;
+}
+
+- (void)dealloc;
+{
+    // ARC forbids explicit message send of 'release'; since iOS 6 even for dispatch_release() calls: stripping it out in that case is required.
+#if ( (__IPHONE_OS_VERSION_MIN_REQUIRED < __IPHONE_6_0) || (!defined(__IPHONE_6_0)) )
+    if (schedulingQueue != NULL)
+    {
+        dispatch_release(schedulingQueue);
+    }
+#endif
+}
+
+#pragma mark -
+#pragma mark Segmenting
+
+- (NSArray *)keyframeTimesOfTrack:(AVAssetTrack *)videoTrack;
+{
+    NSMutableArray *keyframeTimes = [[NSMutableArray alloc] init];
+
+    NSError *error = nil;
+    AVAssetReader *keyframeReader = [AVAssetReader assetReaderWithAsset:_asset error:&error];
+    // No output settings means compressed samples come out as stored, without being decoded
+    AVAssetReaderTrackOutput *compressedOutput = [AVAssetReaderTrackOutput assetReaderTrackOutputWithTrack:videoTrack outputSettings:nil];
+    [keyframeReader addOutput:compressedOutput];
+
+    if ((keyframeReader == nil) || ![keyframeReader startReading])
+    {
+        NSLog(@"Error scanning for keyframes: %@", error);
+        return keyframeTimes;
+    }
+
+    CMSampleBufferRef sampleBuffer = NULL;
+    while ((sampleBuffer = [compressedOutput copyNextSampleBuffer]) != NULL)
+    {
+        BOOL isKeyframe = YES;
+        CFArrayRef sampleAttachments = CMSampleBufferGetSampleAttachmentsArray(sampleBuffer, false);
+        if ((sampleAttachments != NULL) && (CFArrayGetCount(sampleAttachments) > 0))
+        {
+            CFDictionaryRef firstSampleAttachments = (CFDictionaryRef)CFArrayGetValueAtIndex(sampleAttachments, 0);
+            isKeyframe = !CFDictionaryContainsKey(firstSampleAttachments, kCMSampleAttachmentKey_NotSync);
+        }
+
+        if (isKeyframe && (CMSampleBufferGetNumSamples(sampleBuffer) > 0))
+        {
+            [keyframeTimes addObject:[NSValue valueWithCMTime:CMSampleBufferGetPresentationTimeStamp(sampleBuffer)]];
+        }
+
+        CFRelease(sampleBuffer);
+    }
+
+    return keyframeTimes;
+}
+
+- (NSArray *)keyframeAlignedSegmentTimeRanges;
+{
+    NSArray *videoTracks = [_asset tracksWithMediaType:AVMediaTypeVideo];
+    if ([videoTracks count] == 0)
+    {
+        return [NSArray array];
+    }
+
+    AVAssetTrack *videoTrack = [videoTracks objectAtIndex:0];
+    CMTimeRange trackTimeRange = videoTrack.timeRange;
+    CMTime trackEndTime = CMTimeRangeGetEnd(trackTimeRange);
+    NSArray *keyframeTimes = [self keyframeTimesOfTrack:videoTrack];
+
+    NSMutableArray *segmentStartTimes = [NSMutableArray arrayWithObject:[NSValue valueWithCMTime:trackTimeRange.start]];
+    for (NSUInteger segmentIndex = 1; segmentIndex < _numberOfSegments; segmentIndex++)
+    {
+        CMTime idealStartTime = CMTimeAdd(trackTimeRange.start, CMTimeMultiplyByFloat64(trackTimeRange.duration, (Float64)segmentIndex / (Float64)_numberOfSegments));
+        CMTime previousStartTime = [[segmentStartTimes lastObject] CMTimeValue];
+
+        // Snap to the nearest keyframe that still comes after the previous cut
+        NSValue *closestKeyframe = nil;
+        Float64 closestDistance = INFINITY;
+        for (NSValue *keyframeTime in keyframeTimes)
+        {
+            CMTime currentKeyframeTime = [keyframeTime CMTimeValue];
+            if (CMTIME_COMPARE_INLINE(currentKeyframeTime, <=, previousStartTime) || CMTIME_COMPARE_INLINE(currentKeyframeTime, >=, trackEndTime))
+            {
+                continue;
+            }
+
+            Float64 distance = fabs(CMTimeGetSeconds(CMTimeSubtract(currentKeyframeTime, idealStartTime)));
+            if (distance < closestDistance)
+            {
+                closestDistance = distance;
+                closestKeyframe = keyframeTime;
+            }
+        }
+
+        if (closestKeyframe != nil)
+        {
+            [segmentStartTimes addObject:closestKeyframe];
+        }
+    }
+
+    NSMutableArray *segmentTimeRanges = [[NSMutableArray alloc] init];
+    for (NSUInteger segmentIndex = 0; segmentIndex < [segmentStartTimes count]; segmentIndex++)
+    {
+        CMTime segmentStartTime = [[segmentStartTimes objectAtIndex:segmentIndex] CMTimeValue];
+        CMTime segmentEndTime = (segmentIndex + 1 < [segmentStartTimes count]) ? [[segmentStartTimes objectAtIndex:(segmentIndex + 1)] CMTimeValue] : trackEndTime;
+        [segmentTimeRanges addObject:[NSValue valueWithCMTimeRange:CMTimeRangeFromTimeToTime(segmentStartTime, segmentEndTime)]];
+    }
+
+    return segmentTimeRanges;
+}
+
+#pragma mark -
+#pragma mark Processing
+
+- (void)processWithCompletion:(void (^)(NSError *error))completionBlock;
+{
+    NSAssert(!_processing, @"Only one movie can be processed at a time by a GPUImageSegmentedMovieProcessor");
+
+    _processing = YES;
+    cancelRequested = NO;
+
+    dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        NSArray *segmentTimeRanges = [self keyframeAlignedSegmentTimeRanges];
+
+        dispatch_group_t segmentGroup = dispatch_group_create();
+        [self processSegmentsInTimeRanges:segmentTimeRanges group:segmentGroup];
+        dispatch_group_wait(segmentGroup, DISPATCH_TIME_FOREVER);
+#if ( (__IPHONE_OS_VERSION_MIN_REQUIRED < __IPHONE_6_0) || (!defined(__IPHONE_6_0)) )
+        dispatch_release(segmentGroup);
+#endif
+
+        __block BOOL wasCancelled;
+        dispatch_sync(schedulingQueue, ^{
+            wasCancelled = cancelRequested;
+            segmentMovies = nil;
+            segmentWriters = nil;
+        });
+
+        void (^finishProcessing)(NSError *) = ^(NSError *error) {
+            [self removeSegmentFiles];
+            dispatch_async(dispatch_get_main_queue(), ^{
+                _processing = NO;
+                if (completionBlock != NULL)
+                {
+                    completionBlock(error);
+                }
+            });
+        };
+
+        if (wasCancelled || ([segmentTimeRanges count] == 0))
+        {
+            NSString *failureReason = wasCancelled ? @"Processing was cancelled" : @"The movie has no video track";
+            finishProcessing([NSError errorWithDomain:GPUImageSegmentedMovieProcessorErrorDomain code:(wasCancelled ? 1 : 2) userInfo:[NSDictionary dictionaryWithObject:failureReason forKey:NSLocalizedDescriptionKey]]);
+            return;
+        }
+
+        [self joinSegmentsWithCompletion:finishProcessing];
+    });
+}
+
+- (void)processSegmentsInTimeRanges:(NSArray *)segmentTimeRanges group:(dispatch_group_t)segmentGroup;
+{
+    dispatch_sync(schedulingQueue, ^{
+        segmentMovies = [[NSMutableArray alloc] init];
+        segmentWriters = [[NSMutableArray alloc] init];
+        segmentURLs = [[NSMutableArray alloc] init];
+        finishedSegments = [[NSMutableIndexSet alloc] init];
+
+        for (NSUInteger segmentIndex = 0; segmentIndex < [segmentTimeRanges count]; segmentIndex++)
+        {
+            NSString *segmentPath = [NSTemporaryDirectory() stringByAppendingPathComponent:[NSString stringWithFormat:@"GPUImageSegment-%@.mov", [[NSProcessInfo processInfo] globallyUniqueString]]];
+            NSURL *segmentURL = [NSURL fileURLWithPath:segmentPath];
+
+            GPUImageMovie *segmentMovie = [[GPUImageMovie alloc] initWithAsset:_asset];
+            segmentMovie.timeRange = [[segmentTimeRanges objectAtIndex:segmentIndex] CMTimeRangeValue];
+
+            GPUImageOutput<GPUImageInput> *segmentFilter = filterFactory();
+            GPUImageMovieWriter *segmentWriter = [[GPUImageMovieWriter alloc] initWithMovieURL:segmentURL size:_outputSize fileType:AVFileTypeQuickTimeMovie outputSettings:[_outputSettings mutableCopy]];
+
+            [segmentMovie addTarget:segmentFilter];
+            [segmentFilter addTarget:segmentWriter];
+            [segmentMovie enableSynchronizedEncodingUsingMovieWriter:segmentWriter];
+
+            __unsafe_unretained GPUImageSegmentedMovieProcessor *weakSelf = self;
+            [segmentWriter setCompletionBlock:^{
+                [weakSelf finishSegment:segmentIndex group:segmentGroup];
+            }];
+
+            [segmentMovies addObject:segmentMovie];
+            [segmentWriters addObject:segmentWriter];
+            [segmentURLs addObject:segmentURL];
+            dispatch_group_enter(segmentGroup);
+        }
+    });
+
+    // Start them outside of the scheduling queue, since a segment can finish before its startProcessing returns
+    NSArray *moviesToStart = [segmentMovies copy];
+    NSArray *writersToStart = [segmentWriters copy];
+    for (NSUInteger segmentIndex = 0; segmentIndex < [moviesToStart count]; segmentIndex++)
+    {
+        [[writersToStart objectAtIndex:segmentIndex] startRecording];
+        [[moviesToStart objectAtIndex:segmentIndex] startProcessing];
+    }
+}
+
+- (void)finishSegment:(NSUInteger)segmentIndex group:(dispatch_group_t)segmentGroup;
+{
+    __block GPUImageMovieWriter *segmentWriter = nil;
+    __block BOOL wasCancelled = NO;
+    dispatch_sync(schedulingQueue, ^{
+        // Ending processing can reach the writer more than once when a segment is cancelled as it finishes
+        if (![finishedSegments containsIndex:segmentIndex])
+        {
+            [finishedSegments addIndex:segmentIndex];
+            segmentWriter = [segmentWriters objectAtIndex:segmentIndex];
+            wasCancelled = cancelRequested;
+        }
+    });
+
+    if (segmentWriter == nil)
+    {
+        return;
+    }
+
+    segmentWriter.completionBlock = nil;
+    if (wasCancelled)
+    {
+        [segmentWriter cancelRecording];
+        dispatch_group_leave(segmentGroup);
+    }
+    else
+    {
+        [segmentWriter finishRecordingWithCompletionHandler:^{
+            dispatch_group_leave(segmentGroup);
+        }];
+    }
+}
+
+- (void)cancelProcessing;
+{
+    __block NSArray *moviesToCancel = nil;
+    dispatch_sync(schedulingQueue, ^{
+        cancelRequested = YES;
+        moviesToCancel = [segmentMovies copy];
+    });
+
+    for (GPUImageMovie *segmentMovie in moviesToCancel)
+    {
+        [segmentMovie endProcessing];
+    }
+}
+
+- (void)joinSegmentsWithCompletion:(void (^)(NSError *error))completionBlock;
+{
+    AVMutableComposition *joinedComposition = [AVMutableComposition composition];
+    AVMutableCompositionTrack *joinedVideoTrack = [joinedComposition addMutableTrackWithMediaType:AVMediaTypeVideo preferredTrackID:kCMPersistentTrackID_Invalid];
+
+    CMTime insertionTime = kCMTimeZero;
+    for (NSURL *segmentURL in segmentURLs)
+    {
+        AVURLAsset *segmentAsset = [AVURLAsset URLAssetWithURL:segmentURL options:[NSDictionary dictionaryWithObject:[NSNumber numberWithBool:YES] forKey:AVURLAssetPreferPreciseDurationAndTimingKey]];
+        NSArray *segmentVideoTracks = [segmentAsset tracksWithMediaType:AVMediaTypeVideo];
+        if ([segmentVideoTracks count] == 0)
+        {
+            completionBlock([NSError errorWithDomain:GPUImageSegmentedMovieProcessorErrorDomain code:3 userInfo:[NSDictionary dictionaryWithObject:@"A segment failed to encode" forKey:NSLocalizedDescriptionKey]]);
+            return;
+        }
+
+        AVAssetTrack *segmentVideoTrack = [segmentVideoTracks objectAtIndex:0];
+        NSError *insertionError = nil;
+        if (![joinedVideoTrack insertTimeRange:segmentVideoTrack.timeRange ofTrack:segmentVideoTrack atTime:insertionTime error:&insertionError])
+        {
+            completionBlock(insertionError);
+            return;
+        }
+
+        insertionTime = CMTimeAdd(insertionTime, segmentVideoTrack.timeRange.duration);
+    }
+
+    // The audio was never touched, so it's copied over from the source in one piece
+    NSArray *audioTracks = [_asset tracksWithMediaType:AVMediaTypeAudio];
+    if ([audioTracks count] > 0)
+    {
+        AVAssetTrack *sourceAudioTrack = [audioTracks objectAtIndex:0];
+        AVMutableCompositionTrack *joinedAudioTrack = [joinedComposition addMutableTrackWithMediaType:AVMediaTypeAudio preferredTrackID:kCMPersistentTrackID_Invalid];
+        [joinedAudioTrack insertTimeRange:CMTimeRangeMake(sourceAudioTrack.timeRange.start, CMTimeMinimum(sourceAudioTrack.timeRange.duration, insertionTime)) ofTrack:sourceAudioTrack atTime:kCMTimeZero error:nil];
+    }
+
+    AVAssetExportSession *exportSession = [[AVAssetExportSession alloc] initWithAsset:joinedComposition presetName:AVAssetExportPresetPassthrough];
+    exportSession.outputURL = _outputURL;
+    exportSession.outputFileType = _fileType;
+
+    [exportSession exportAsynchronouslyWithCompletionHandler:^{
+        if (exportSession.status == AVAssetExportSessionStatusCompleted)
+        {
+            completionBlock(nil);
+        }
+        else
+        {
+            completionBlock(exportSession.error);
+        }
+    }];
+}
+
+- (void)removeSegmentFiles;
+{
+    __block NSArray *urlsToRemove = nil;
+    dispatch_sync(schedulingQueue, ^{
+        urlsToRemove = segmentURLs;
+        segmentURLs = nil;
+    });
+
+    for (NSURL *segmentURL in urlsToRemove)
+    {
+        [[NSFileManager defaultManager] removeItemAtURL:segmentURL error:nil];
+    }
+}
+
+@end
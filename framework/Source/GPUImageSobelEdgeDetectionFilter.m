@@ -100,6 +100,21 @@ NSString *const kGPUImageSobelEdgeDetectionFragmentShaderString = SHADER_STRING
     return YES;
 }
 
+#pragma mark -
+#pragma mark Tiled processing
+
+- (NSUInteger)pixelFootprintRadius;
+{
+    // The second stage samples the 3x3 neighborhood of each pixel of the first, so the first has to be drawn that much further out
+    if (!hasOverriddenImageSizeFactor)
+    {
+        return 1;
+    }
+    
+    CGSize currentFBOSize = [self sizeOfFBO];
+    return (NSUInteger)ceil(MAX(_texelWidth * currentFBOSize.width, _texelHeight * currentFBOSize.height));
+}
+
 #pragma mark -
 #pragma mark Accessors
 
@@ -30,8 +30,15 @@
 - (void)processTextureWithFrameTime:(CMTime)frameTime;
 {
     runAsynchronouslyOnVideoProcessingQueue(^{
+        [self generateMipmapsForTargetsIfNeededWithOutputSize:textureSize];
+        
         for (id<GPUImageInput> currentTarget in targets)
         {
+            if (![self shouldSendFrameAtTime:frameTime toTarget:currentTarget])
+            {
+                continue;
+            }
+            
             NSInteger indexOfObject = [targets indexOfObject:currentTarget];
             NSInteger targetTextureIndex = [[targetTextureIndices objectAtIndex:indexOfObject] integerValue];
             
@@ -81,4 +81,9 @@
     
 }
 
+- (BOOL)wantsNextFrame;
+{
+    return enabled && (_delegate != nil);
+}
+
 @end
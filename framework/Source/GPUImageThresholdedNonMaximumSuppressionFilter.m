@@ -71,6 +71,11 @@ NSString *const kGPUImageThresholdedNonMaximumSuppressionFragmentShaderString =
     return self;
 }
 
+- (BOOL)providesMonochromeOutput;
+{
+    return YES;
+}
+
 #pragma mark -
 #pragma mark Accessors
 
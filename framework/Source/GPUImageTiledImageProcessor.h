@@ -0,0 +1,48 @@
+#import <UIKit/UIKit.h>
+#import "GPUImageOutput.h"
+
+/** Filters still images larger than the maximum texture size by processing them in overlapping tiles
+
+ GPUImagePicture scales down anything that doesn't fit within a single texture. This instead cuts the image into tiles that do fit, pads each tile on every side by the combined pixelFootprintRadius of the filters between the input and output filters, runs the padded tile through the graph, and keeps only the unpadded interior of the result. Only one tile is decoded and rendered at a time.
+
+ Tiling reproduces the untiled result for filters whose output depends on a neighborhood of pixels around each pixel. Filters whose parameters are expressed in normalized image coordinates (vignettes, distortions centered on a point, and the like) or that compute statistics across the whole image will see each tile as a separate image. The filters must also produce output at the size of their input.
+
+ As with GPUImageBatchProcessor, the output filter should not have been prepared for image capture.
+ */
+@interface GPUImageTiledImageProcessor : NSObject
+
+@property(readonly, nonatomic) id<GPUImageInput> inputFilter;
+@property(readonly, nonatomic) GPUImageOutput *outputFilter;
+
+/** The largest tile, padding included, to send through the filters. Defaults to the maximum texture size for this device.
+ */
+@property(readwrite, nonatomic) CGSize maximumTileSize;
+
+/** How many pixels of context each tile is padded with, derived from the filters between the input and output
+ */
+@property(readonly, nonatomic) NSUInteger tileOverlap;
+
+/// @name Initialization and teardown
+
+- (id)initWithFilter:(GPUImageOutput<GPUImageInput> *)newFilter;
+- (id)initWithInputFilter:(GPUImageOutput<GPUImageInput> *)newInputFilter outputFilter:(GPUImageOutput *)newOutputFilter;
+
+/// @name Tiled processing
+
+/** Filters an image one tile at a time, handing each finished tile to a block
+
+ Memory use is bounded by the tile size, which makes this the method to use for very large images. It runs synchronously and must not be called from the video processing queue.
+
+ @param imageToProcess The image to filter, at any size
+ @param tileProcessedBlock Called on the calling thread for each finished tile, with the tile's rectangle in the image (origin at the upper left) and its filtered pixels. The tile image is released after the block returns.
+ */
+- (void)processImage:(CGImageRef)imageToProcess tileProcessedBlock:(void (^)(CGRect tileRect, CGImageRef processedTile))tileProcessedBlock;
+
+/** Filters an image one tile at a time and stitches the tiles into a full-size result
+
+ The result needs as much memory as the full uncompressed image.
+ */
+- (CGImageRef)newCGImageByProcessingImage:(CGImageRef)imageToProcess;
+- (UIImage *)imageByProcessingImage:(UIImage *)imageToProcess;
+
+@end
@@ -0,0 +1,200 @@
+#import "GPUImageTiledImageProcessor.h"
+#import "GPUImageRawDataInput.h"
+
+@interface GPUImageTiledImageProcessor()
+{
+    GPUImageRawDataInput *tileInput;
+}
+
+- (GLubyte *)newDecodedBytesForRect:(CGRect)tileRect ofImage:(CGImageRef)sourceImage;
+- (CGImageRef)newCGImageByRenderingTileBytes:(GLubyte *)tileBytes size:(CGSize)tileSize;
+
+@end
+
+@implementation GPUImageTiledImageProcessor
+
+@synthesize inputFilter = _inputFilter;
+@synthesize outputFilter = _outputFilter;
+@synthesize maximumTileSize = _maximumTileSize;
+
+#pragma mark -
+#pragma mark Initialization and teardown
+
+- (id)initWithFilter:(GPUImageOutput<GPUImageInput> *)newFilter;
+{
+    if (!(self = [self initWithInputFilter:newFilter outputFilter:newFilter]))
+    {
+		return nil;
+    }
+
+    return self;
+}
+
+- (id)initWithInputFilter:(GPUImageOutput<GPUImageInput> *)newInputFilter outputFilter:(GPUImageOutput *)newOutputFilter;
+{
+    if (!(self = [super init]))
+    {
+		return nil;
+    }
+
+    _inputFilter = newInputFilter;
+    _outputFilter = newOutputFilter;
+
+    __block GLint maxTextureSize;
+    runSynchronouslyOnVideoProcessingQueue(^{
+        maxTextureSize = [GPUImageOpenGLESContext maximumTextureSizeForThisDevice];
+    });
+    _maximumTileSize = CGSizeMake(maxTextureSize, maxTextureSize);
+
+    return self;
+}
+
+- (void)dealloc;
+{
+    runSynchronouslyOnVideoProcessingQueue(^{
+        [tileInput removeAllTargets];
+    });
+}
+
+#pragma mark -
+#pragma mark Tiled processing
+
+- (NSUInteger)tileOverlap;
+{
+    NSUInteger overlap = [(GPUImageOutput *)_inputFilter pixelFootprintRadiusAlongPathToTarget:_outputFilter];
+    NSAssert(overlap != NSNotFound, @"The output filter of a GPUImageTiledImageProcessor needs to be downstream of its input filter");
+
+    return overlap;
+}
+
+- (void)processImage:(CGImageRef)imageToProcess tileProcessedBlock:(void (^)(CGRect tileRect, CGImageRef processedTile))tileProcessedBlock;
+{
+    CGRect imageBounds = CGRectMake(0.0, 0.0, CGImageGetWidth(imageToProcess), CGImageGetHeight(imageToProcess));
+    NSUInteger overlap = [self tileOverlap];
+
+    CGFloat tileInteriorWidth = floor(_maximumTileSize.width) - (CGFloat)(2 * overlap);
+    CGFloat tileInteriorHeight = floor(_maximumTileSize.height) - (CGFloat)(2 * overlap);
+    NSAssert((tileInteriorWidth > 0.0) && (tileInteriorHeight > 0.0), @"The filters sample too far out (%lu pixels) to fit a tile within %f x %f", (unsigned long)overlap, _maximumTileSize.width, _maximumTileSize.height);
+
+    for (CGFloat tileOriginY = 0.0; tileOriginY < imageBounds.size.height; tileOriginY += tileInteriorHeight)
+    {
+        for (CGFloat tileOriginX = 0.0; tileOriginX < imageBounds.size.width; tileOriginX += tileInteriorWidth)
+        {
+            @autoreleasepool {
+                CGRect tileRect = CGRectMake(tileOriginX, tileOriginY, MIN(tileInteriorWidth, imageBounds.size.width - tileOriginX), MIN(tileInteriorHeight, imageBounds.size.height - tileOriginY));
+                CGRect paddedTileRect = CGRectIntersection(CGRectInset(tileRect, -(CGFloat)overlap, -(CGFloat)overlap), imageBounds);
+
+                GLubyte *tileBytes = [self newDecodedBytesForRect:paddedTileRect ofImage:imageToProcess];
+                if (tileBytes == NULL)
+                {
+                    continue;
+                }
+
+                __block CGImageRef processedPaddedTile;
+                runSynchronouslyOnVideoProcessingQueue(^{
+                    processedPaddedTile = [self newCGImageByRenderingTileBytes:tileBytes size:paddedTileRect.size];
+                });
+                free(tileBytes);
+
+                // Throw away the padding, which only existed to give the filters valid pixels to sample near the tile's edges
+                CGRect interiorRect = CGRectOffset(tileRect, -paddedTileRect.origin.x, -paddedTileRect.origin.y);
+                CGImageRef processedTile = CGImageCreateWithImageInRect(processedPaddedTile, interiorRect);
+                CGImageRelease(processedPaddedTile);
+
+                tileProcessedBlock(tileRect, processedTile);
+                CGImageRelease(processedTile);
+            }
+        }
+    }
+}
+
+- (CGImageRef)newCGImageByProcessingImage:(CGImageRef)imageToProcess;
+{
+    size_t widthOfImage = CGImageGetWidth(imageToProcess);
+    size_t heightOfImage = CGImageGetHeight(imageToProcess);
+
+    CGColorSpaceRef genericRGBColorspace = CGColorSpaceCreateDeviceRGB();
+    CGContextRef stitchingContext = CGBitmapContextCreate(NULL, widthOfImage, heightOfImage, 8, widthOfImage * 4, genericRGBColorspace, kCGBitmapByteOrder32Little | kCGImageAlphaPremultipliedFirst);
+    CGColorSpaceRelease(genericRGBColorspace);
+
+    if (stitchingContext == NULL)
+    {
+        return NULL;
+    }
+
+    CGContextSetBlendMode(stitchingContext, kCGBlendModeCopy);
+
+    [self processImage:imageToProcess tileProcessedBlock:^(CGRect tileRect, CGImageRef processedTile) {
+        // Core Graphics places the origin at the lower left
+        CGRect flippedTileRect = tileRect;
+        flippedTileRect.origin.y = (CGFloat)heightOfImage - tileRect.origin.y - tileRect.size.height;
+        CGContextDrawImage(stitchingContext, flippedTileRect, processedTile);
+    }];
+
+    CGImageRef stitchedImage = CGBitmapContextCreateImage(stitchingContext);
+    CGContextRelease(stitchingContext);
+
+    return stitchedImage;
+}
+
+- (UIImage *)imageByProcessingImage:(UIImage *)imageToProcess;
+{
+    CGImageRef image = [self newCGImageByProcessingImage:[imageToProcess CGImage]];
+    UIImage *processedImage = [UIImage imageWithCGImage:image scale:[imageToProcess scale] orientation:[imageToProcess imageOrientation]];
+    CGImageRelease(image);
+    return processedImage;
+}
+
+#pragma mark -
+#pragma mark Tile stages
+
+- (GLubyte *)newDecodedBytesForRect:(CGRect)tileRect ofImage:(CGImageRef)sourceImage;
+{
+    size_t widthOfTile = (size_t)tileRect.size.width;
+    size_t heightOfTile = (size_t)tileRect.size.height;
+
+    // Image rects have the same upper-left origin as tile rects. Drawing only the tile's part of the image converts just those pixels, rather than the whole image once for every tile
+    CGImageRef tileImage = CGImageCreateWithImageInRect(sourceImage, tileRect);
+    if (tileImage == NULL)
+    {
+        return NULL;
+    }
+
+    GLubyte *tileData = (GLubyte *) calloc(1, widthOfTile * heightOfTile * 4);
+    if (tileData == NULL)
+    {
+        CGImageRelease(tileImage);
+        return NULL;
+    }
+
+    CGColorSpaceRef genericRGBColorspace = CGColorSpaceCreateDeviceRGB();
+    CGContextRef tileContext = CGBitmapContextCreate(tileData, widthOfTile, heightOfTile, 8, widthOfTile * 4, genericRGBColorspace,  kCGBitmapByteOrder32Little | kCGImageAlphaPremultipliedFirst);
+    CGContextSetBlendMode(tileContext, kCGBlendModeCopy);
+
+    CGContextDrawImage(tileContext, CGRectMake(0.0, 0.0, widthOfTile, heightOfTile), tileImage);
+
+    CGContextRelease(tileContext);
+    CGImageRelease(tileImage);
+    CGColorSpaceRelease(genericRGBColorspace);
+
+    return tileData;
+}
+
+- (CGImageRef)newCGImageByRenderingTileBytes:(GLubyte *)tileBytes size:(CGSize)tileSize;
+{
+    if (tileInput == nil)
+    {
+        tileInput = [[GPUImageRawDataInput alloc] initWithBytes:tileBytes size:tileSize];
+        [tileInput addTarget:_inputFilter];
+    }
+    else
+    {
+        [tileInput updateDataFromBytes:tileBytes size:tileSize];
+    }
+
+    [tileInput processData];
+
+    return [_outputFilter newCGImageFromCurrentlyProcessedOutputWithOrientation:UIImageOrientationUp];
+}
+
+@end
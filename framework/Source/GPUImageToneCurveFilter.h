@@ -1,28 +1,57 @@
-#import "GPUImageFilter.h"
-
-@interface GPUImageToneCurveFilter : GPUImageFilter
-
-@property(readwrite, nonatomic, copy) NSArray *redControlPoints;
-@property(readwrite, nonatomic, copy) NSArray *greenControlPoints;
-@property(readwrite, nonatomic, copy) NSArray *blueControlPoints;
-@property(readwrite, nonatomic, copy) NSArray *rgbCompositeControlPoints;
-
-// Initialization and teardown
-- (id)initWithACV:(NSString*)curveFilename;
-- (id)initWithACVURL:(NSURL*)curveFileURL;
-
-// This lets you set all three red, green, and blue tone curves at once.
-// NOTE: Deprecated this function because this effect can be accomplished
-// using the rgbComposite channel rather then setting all 3 R, G, and B channels.
-- (void)setRGBControlPoints:(NSArray *)points DEPRECATED_ATTRIBUTE;
-
-- (void)setPointsWithACV:(NSString*)curveFilename;
-- (void)setPointsWithACVURL:(NSURL*)curveFileURL;
-
-// Curve calculation
-- (NSMutableArray *)getPreparedSplineCurve:(NSArray *)points;
-- (NSMutableArray *)splineCurve:(NSArray *)points;
-- (NSMutableArray *)secondDerivative:(NSArray *)cgPoints;
-- (void)updateToneCurveTexture;
-   
-@end
+#import "GPUImageFilter.h"
+
+#define kGPUImageToneCurveLength 1024
+
+typedef enum {
+    kGPUImageToneCurveRGBComposite,
+    kGPUImageToneCurveRed,
+    kGPUImageToneCurveGreen,
+    kGPUImageToneCurveBlue
+} GPUImageToneCurveChannel;
+
+// Curves are solved as natural cubic splines straight from C arrays of points into 1024-entry tables, which go into a half-float texture on devices that can filter one and an 8-bit texture otherwise.
+// Setting control points doesn't allocate, and the texture is uploaded once before the next frame no matter how many curves changed, so curves can be dragged or animated every frame.
+// A second set of curves can be set as an interpolation target, and curveInterpolation blends between the two on the GPU without recalculating either.
+
+@interface GPUImageToneCurveFilter : GPUImageFilter
+
+@property(readwrite, nonatomic, copy) NSArray *redControlPoints;
+@property(readwrite, nonatomic, copy) NSArray *greenControlPoints;
+@property(readwrite, nonatomic, copy) NSArray *blueControlPoints;
+@property(readwrite, nonatomic, copy) NSArray *rgbCompositeControlPoints;
+
+/** How far to blend from the curves toward the interpolation target curves, from 0.0 (the default) to 1.0
+ */
+@property(readwrite, nonatomic) CGFloat curveInterpolation;
+
+// Initialization and teardown
+- (id)initWithACV:(NSString*)curveFilename;
+- (id)initWithACVURL:(NSURL*)curveFileURL;
+
+// This lets you set all three red, green, and blue tone curves at once.
+// NOTE: Deprecated this function because this effect can be accomplished
+// using the rgbComposite channel rather then setting all 3 R, G, and B channels.
+- (void)setRGBControlPoints:(NSArray *)points DEPRECATED_ATTRIBUTE;
+
+- (void)setPointsWithACV:(NSString*)curveFilename;
+- (void)setPointsWithACVURL:(NSURL*)curveFileURL;
+
+/** Sets a curve from a C array of points, without going through NSArray. Points are in normalized (0.0 - 1.0) coordinates and don't need to be sorted. Fewer than two points give a straight line. The points aren't kept, so the array can be reused right away.
+ 
+ The NSArray control point properties aren't updated by this, since that would mean allocating.
+ */
+- (void)setControlPoints:(const CGPoint *)points count:(NSUInteger)pointCount forChannel:(GPUImageToneCurveChannel)channel;
+
+// The curves that curveInterpolation blends toward, which start out as straight lines
+- (void)setInterpolationTargetControlPoints:(const CGPoint *)points count:(NSUInteger)pointCount forChannel:(GPUImageToneCurveChannel)channel;
+- (void)setInterpolationTargetWithACV:(NSString *)curveFilename;
+- (void)setInterpolationTargetWithACVURL:(NSURL *)curveFileURL;
+
+// Curve calculation
+// These are kept for compatibility, and are no longer used by the filter itself
+- (NSMutableArray *)getPreparedSplineCurve:(NSArray *)points;
+- (NSMutableArray *)splineCurve:(NSArray *)points;
+- (NSMutableArray *)secondDerivative:(NSArray *)cgPoints;
+- (void)updateToneCurveTexture;
+   
+@end
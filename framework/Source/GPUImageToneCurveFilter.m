@@ -1,537 +1,772 @@
-#import "GPUImageToneCurveFilter.h"
-
-#pragma mark -
-#pragma mark GPUImageACVFile Helper
-
-//  GPUImageACVFile
-//
-//  ACV File format Parser
-//  Please refer to http://www.adobe.com/devnet-apps/photoshop/fileformatashtml/PhotoshopFileFormats.htm#50577411_pgfId-1056330
-//
-
-@interface GPUImageACVFile : NSObject{
-    short version;
-    short totalCurves;
-    
-    NSArray *rgbCompositeCurvePoints;
-    NSArray *redCurvePoints;
-    NSArray *greenCurvePoints;    
-    NSArray *blueCurvePoints;
-}
-
-@property(strong,nonatomic) NSArray *rgbCompositeCurvePoints;
-@property(strong,nonatomic) NSArray *redCurvePoints;
-@property(strong,nonatomic) NSArray *greenCurvePoints;    
-@property(strong,nonatomic) NSArray *blueCurvePoints;
-
-- (id) initWithCurveFilePathURL:(NSURL*)curveFilePathURL;
-
-@end
-
-@implementation GPUImageACVFile
-
-@synthesize rgbCompositeCurvePoints, redCurvePoints, greenCurvePoints, blueCurvePoints;
-
-- (id) initWithCurveFilePathURL:(NSURL*)curveFilePathURL
-{
-    self = [super init];
-	if (self != nil)
-	{
-        NSError* error = nil;
-        NSFileHandle* file = [NSFileHandle fileHandleForReadingFromURL:curveFilePathURL
-                                                                 error:&error];
-        
-        if ((file == nil) || (error != nil))
-        {
-            NSLog(@"Failed to open file: %@", error);
-            
-            return self;
-        }
-        
-        NSData *databuffer;
-        
-        // 2 bytes, Version ( = 1 or = 4)
-        databuffer = [file readDataOfLength: 2];
-        version = CFSwapInt16BigToHost(*(int*)([databuffer bytes]));
-        
-        // 2 bytes, Count of curves in the file.
-        [file seekToFileOffset:2];
-        databuffer = [file readDataOfLength:2];
-        totalCurves = CFSwapInt16BigToHost(*(int*)([databuffer bytes]));
-        
-        NSMutableArray *curves = [NSMutableArray new];
-        
-        float pointRate = (1.0 / 255);
-        // The following is the data for each curve specified by count above
-        for (NSInteger x = 0; x<totalCurves; x++)
-        {
-            // 2 bytes, Count of points in the curve (short integer from 2...19)
-            databuffer = [file readDataOfLength:2];            
-            short pointCount = CFSwapInt16BigToHost(*(int*)([databuffer bytes]));
-            
-            NSMutableArray *points = [NSMutableArray new];
-            // point count * 4
-            // Curve points. Each curve point is a pair of short integers where 
-            // the first number is the output value (vertical coordinate on the 
-            // Curves dialog graph) and the second is the input value. All coordinates have range 0 to 255. 
-            for (NSInteger y = 0; y<pointCount; y++)
-            {
-                databuffer = [file readDataOfLength:2];
-                short y = CFSwapInt16BigToHost(*(int*)([databuffer bytes]));
-                databuffer = [file readDataOfLength:2];
-                short x = CFSwapInt16BigToHost(*(int*)([databuffer bytes]));
-                
-                [points addObject:[NSValue valueWithCGSize:CGSizeMake(x * pointRate, y * pointRate)]];
-            }
-            
-            [curves addObject:points];
-        }
-        
-        [file closeFile];
-        
-        rgbCompositeCurvePoints = [curves objectAtIndex:0];
-        redCurvePoints = [curves objectAtIndex:1];
-        greenCurvePoints = [curves objectAtIndex:2];
-        blueCurvePoints = [curves objectAtIndex:3];
-	}
-	
-	return self;
-    
-}
-
-@end
-
-#pragma mark -
-#pragma mark GPUImageToneCurveFilter Implementation
-
-NSString *const kGPUImageToneCurveFragmentShaderString = SHADER_STRING
-(
- varying highp vec2 textureCoordinate;
- uniform sampler2D inputImageTexture;
- uniform sampler2D toneCurveTexture;
- 
- void main()
- {
-     lowp vec4 textureColor = texture2D(inputImageTexture, textureCoordinate);
-     lowp float redCurveValue = texture2D(toneCurveTexture, vec2(textureColor.r, 0.0)).r;
-     lowp float greenCurveValue = texture2D(toneCurveTexture, vec2(textureColor.g, 0.0)).g;
-     lowp float blueCurveValue = texture2D(toneCurveTexture, vec2(textureColor.b, 0.0)).b;
-     
-     gl_FragColor = vec4(redCurveValue, greenCurveValue, blueCurveValue, textureColor.a);
- }
-);
-
-
-@interface GPUImageToneCurveFilter()
-{
-    GLint toneCurveTextureUniform;
-    GLuint toneCurveTexture;
-    GLubyte *toneCurveByteArray;
-    
-    NSArray *_redCurve, *_greenCurve, *_blueCurve, *_rgbCompositeCurve;
-}
-
-@end
-
-@implementation GPUImageToneCurveFilter
-
-@synthesize rgbCompositeControlPoints = _rgbCompositeControlPoints;
-@synthesize redControlPoints = _redControlPoints;
-@synthesize greenControlPoints = _greenControlPoints;
-@synthesize blueControlPoints = _blueControlPoints;
-
-#pragma mark -
-#pragma mark Initialization and teardown
-
-- (id)init;
-{
-    if (!(self = [super initWithFragmentShaderFromString:kGPUImageToneCurveFragmentShaderString]))
-    {
-		return nil;
-    }
-    
-    toneCurveTextureUniform = [filterProgram uniformIndex:@"toneCurveTexture"];    
-    
-    NSArray *defaultCurve = [NSArray arrayWithObjects:[NSValue valueWithCGPoint:CGPointMake(0.0, 0.0)], [NSValue valueWithCGPoint:CGPointMake(0.5, 0.5)], [NSValue valueWithCGPoint:CGPointMake(1.0, 1.0)], nil];
-    [self setRgbCompositeControlPoints:defaultCurve];
-    [self setRedControlPoints:defaultCurve];
-    [self setGreenControlPoints:defaultCurve];
-    [self setBlueControlPoints:defaultCurve];
-    
-    return self;
-}
-
-// This pulls in Adobe ACV curve files to specify the tone curve
-- (id)initWithACV:(NSString*)curveFilename
-{
-    return [self initWithACVURL:[[NSBundle mainBundle] URLForResource:curveFilename
-                                                        withExtension:@"acv"]];
-}
-
-- (id)initWithACVURL:(NSURL*)curveFileURL
-{
-    if (!(self = [super initWithFragmentShaderFromString:kGPUImageToneCurveFragmentShaderString]))
-    {
-		return nil;
-    }
-    
-    toneCurveTextureUniform = [filterProgram uniformIndex:@"toneCurveTexture"];
-    
-    
-    GPUImageACVFile *curve = [[GPUImageACVFile alloc] initWithCurveFilePathURL:curveFileURL];
-    
-    [self setRgbCompositeControlPoints:curve.rgbCompositeCurvePoints];
-    [self setRedControlPoints:curve.redCurvePoints];
-    [self setGreenControlPoints:curve.greenCurvePoints];
-    [self setBlueControlPoints:curve.blueCurvePoints];
-    
-    curve = nil;
-    
-    return self;
-    
-}
-
-- (void)setPointsWithACV:(NSString*)curveFilename
-{
-    [self setPointsWithACVURL:[[NSBundle mainBundle] URLForResource:curveFilename withExtension:@"acv"]];
-}
-
-- (void)setPointsWithACVURL:(NSURL*)curveFileURL
-{
-    GPUImageACVFile *curve = [[GPUImageACVFile alloc] initWithCurveFilePathURL:curveFileURL];
-    
-    [self setRgbCompositeControlPoints:curve.rgbCompositeCurvePoints];
-    [self setRedControlPoints:curve.redCurvePoints];
-    [self setGreenControlPoints:curve.greenCurvePoints];
-    [self setBlueControlPoints:curve.blueCurvePoints];
-    
-    curve = nil;
-}
-
-- (void)dealloc
-{
-    if (toneCurveTexture)
-    {
-        glDeleteTextures(1, &toneCurveTexture);
-        toneCurveTexture = 0;
-        free(toneCurveByteArray);
-    }
-}
-
-#pragma mark -
-#pragma mark Curve calculation
-
-- (NSArray *)getPreparedSplineCurve:(NSArray *)points
-{
-    if (points && [points count] > 0) 
-    {
-        // Sort the array.
-        NSArray *sortedPoints = [points sortedArrayUsingComparator:^(id a, id b) {
-            float x1 = [(NSValue *)a CGPointValue].x;
-            float x2 = [(NSValue *)b CGPointValue].x;            
-            return x1 > x2;
-        }];
-                
-        // Convert from (0, 1) to (0, 255).
-        NSMutableArray *convertedPoints = [NSMutableArray arrayWithCapacity:[sortedPoints count]];
-        for (int i=0; i<[points count]; i++){
-            CGPoint point = [[sortedPoints objectAtIndex:i] CGPointValue];
-            point.x = point.x * 255;
-            point.y = point.y * 255;
-                        
-            [convertedPoints addObject:[NSValue valueWithCGPoint:point]];
-        }
-        
-        
-        NSMutableArray *splinePoints = [self splineCurve:convertedPoints];
-        
-        // If we have a first point like (0.3, 0) we'll be missing some points at the beginning
-        // that should be 0.
-        CGPoint firstSplinePoint = [[splinePoints objectAtIndex:0] CGPointValue];
-        
-        if (firstSplinePoint.x > 0) {
-            for (int i=firstSplinePoint.x; i >= 0; i--) {
-                CGPoint newCGPoint = CGPointMake(i, 0);
-                [splinePoints insertObject:[NSValue valueWithCGPoint:newCGPoint] atIndex:0];
-            }
-        }
-
-        // Insert points similarly at the end, if necessary.
-        CGPoint lastSplinePoint = [[splinePoints objectAtIndex:([splinePoints count] - 1)] CGPointValue];
-
-        if (lastSplinePoint.x < 255) {
-            for (int i = lastSplinePoint.x + 1; i <= 255; i++) {
-                CGPoint newCGPoint = CGPointMake(i, 255);
-                [splinePoints addObject:[NSValue valueWithCGPoint:newCGPoint]];
-            }
-        }
-        
-        
-        // Prepare the spline points.
-        NSMutableArray *preparedSplinePoints = [NSMutableArray arrayWithCapacity:[splinePoints count]];
-        for (int i=0; i<[splinePoints count]; i++) 
-        {
-            CGPoint newPoint = [[splinePoints objectAtIndex:i] CGPointValue];
-            CGPoint origPoint = CGPointMake(newPoint.x, newPoint.x);
-            
-            float distance = sqrt(pow((origPoint.x - newPoint.x), 2.0) + pow((origPoint.y - newPoint.y), 2.0));
-            
-            if (origPoint.y > newPoint.y) 
-            {
-                distance = -distance;
-            }
-            
-            [preparedSplinePoints addObject:[NSNumber numberWithFloat:distance]];
-        }
-        
-        return preparedSplinePoints;
-    }
-    
-    return nil;
-}
-
-
-- (NSMutableArray *)splineCurve:(NSArray *)points
-{
-    NSMutableArray *sdA = [self secondDerivative:points];
-    
-    // Is [points count] equal to [sdA count]?
-//    int n = [points count];
-    int n = [sdA count];
-    if (n < 1)
-    {
-        return nil;
-    }
-    double sd[n];
-    
-    // From NSMutableArray to sd[n];
-    for (int i=0; i<n; i++) 
-    {
-        sd[i] = [[sdA objectAtIndex:i] doubleValue];
-    }
-    
-    
-    NSMutableArray *output = [NSMutableArray arrayWithCapacity:(n+1)];
-                              
-    for(int i=0; i<n-1 ; i++) 
-    {
-        CGPoint cur = [[points objectAtIndex:i] CGPointValue];
-        CGPoint next = [[points objectAtIndex:(i+1)] CGPointValue];
-        
-        for(int x=cur.x;x<(int)next.x;x++) 
-        {
-            double t = (double)(x-cur.x)/(next.x-cur.x);
-            
-            double a = 1-t;
-            double b = t;
-            double h = next.x-cur.x;
-            
-            double y= a*cur.y + b*next.y + (h*h/6)*( (a*a*a-a)*sd[i]+ (b*b*b-b)*sd[i+1] );
-                        
-            if (y > 255.0)
-            {
-                y = 255.0;   
-            }
-            else if (y < 0.0)
-            {
-                y = 0.0;   
-            }
-            
-            [output addObject:[NSValue valueWithCGPoint:CGPointMake(x, y)]];
-        }
-    }
-    
-    // If the last point is (255, 255) it doesn't get added.
-    if ([output count] == 255) {
-        [output addObject:[points lastObject]];
-    }
-    return output;
-}
-
-- (NSMutableArray *)secondDerivative:(NSArray *)points
-{
-    int n = [points count];
-    if ((n <= 0) || (n == 1))
-    {
-        return nil;
-    }
-    
-    double matrix[n][3];
-    double result[n];
-    matrix[0][1]=1;
-    // What about matrix[0][1] and matrix[0][0]? Assuming 0 for now (Brad L.)
-    matrix[0][0]=0;    
-    matrix[0][2]=0;    
-    
-    for(int i=1;i<n-1;i++) 
-    {
-        CGPoint P1 = [[points objectAtIndex:(i-1)] CGPointValue];
-        CGPoint P2 = [[points objectAtIndex:i] CGPointValue];
-        CGPoint P3 = [[points objectAtIndex:(i+1)] CGPointValue];
-        
-        matrix[i][0]=(double)(P2.x-P1.x)/6;
-        matrix[i][1]=(double)(P3.x-P1.x)/3;
-        matrix[i][2]=(double)(P3.x-P2.x)/6;
-        result[i]=(double)(P3.y-P2.y)/(P3.x-P2.x) - (double)(P2.y-P1.y)/(P2.x-P1.x);
-    }
-    
-    // What about result[0] and result[n-1]? Assuming 0 for now (Brad L.)
-    result[0] = 0;
-    result[n-1] = 0;
-	
-    matrix[n-1][1]=1;
-    // What about matrix[n-1][0] and matrix[n-1][2]? For now, assuming they are 0 (Brad L.)
-    matrix[n-1][0]=0;
-    matrix[n-1][2]=0;
-    
-  	// solving pass1 (up->down)
-  	for(int i=1;i<n;i++) 
-    {
-		double k = matrix[i][0]/matrix[i-1][1];
-		matrix[i][1] -= k*matrix[i-1][2];
-		matrix[i][0] = 0;
-		result[i] -= k*result[i-1];
-    }
-	// solving pass2 (down->up)
-	for(int i=n-2;i>=0;i--) 
-    {
-		double k = matrix[i][2]/matrix[i+1][1];
-		matrix[i][1] -= k*matrix[i+1][0];
-		matrix[i][2] = 0;
-		result[i] -= k*result[i+1];
-	}
-    
-    double y2[n];
-    for(int i=0;i<n;i++) y2[i]=result[i]/matrix[i][1];
-    
-    NSMutableArray *output = [NSMutableArray arrayWithCapacity:n];
-    for (int i=0;i<n;i++) 
-    {
-        [output addObject:[NSNumber numberWithDouble:y2[i]]];
-    }
-    
-    return output;
-}
-
-- (void)updateToneCurveTexture;
-{
-    runSynchronouslyOnVideoProcessingQueue(^{
-        [GPUImageOpenGLESContext useImageProcessingContext];
-        if (!toneCurveTexture)
-        {
-            glActiveTexture(GL_TEXTURE3);
-            glGenTextures(1, &toneCurveTexture);
-            glBindTexture(GL_TEXTURE_2D, toneCurveTexture);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-            
-            toneCurveByteArray = calloc(256 * 4, sizeof(GLubyte));
-        }
-        else
-        {
-            glActiveTexture(GL_TEXTURE3);
-            glBindTexture(GL_TEXTURE_2D, toneCurveTexture);
-        }
-        
-        if ( ([_redCurve count] >= 256) && ([_greenCurve count] >= 256) && ([_blueCurve count] >= 256) && ([_rgbCompositeCurve count] >= 256))
-        {
-            for (unsigned int currentCurveIndex = 0; currentCurveIndex < 256; currentCurveIndex++)
-            {
-                // BGRA for upload to texture
-                toneCurveByteArray[currentCurveIndex * 4] = fmin(fmax(currentCurveIndex + [[_blueCurve objectAtIndex:currentCurveIndex] floatValue] + [[_rgbCompositeCurve objectAtIndex:currentCurveIndex] floatValue], 0), 255);
-                toneCurveByteArray[currentCurveIndex * 4 + 1] = fmin(fmax(currentCurveIndex + [[_greenCurve objectAtIndex:currentCurveIndex] floatValue] + [[_rgbCompositeCurve objectAtIndex:currentCurveIndex] floatValue], 0), 255);
-                toneCurveByteArray[currentCurveIndex * 4 + 2] = fmin(fmax(currentCurveIndex + [[_redCurve objectAtIndex:currentCurveIndex] floatValue] + [[_rgbCompositeCurve objectAtIndex:currentCurveIndex] floatValue], 0), 255);
-                toneCurveByteArray[currentCurveIndex * 4 + 3] = 255;
-            }
-            
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 256 /*width*/, 1 /*height*/, 0, GL_BGRA, GL_UNSIGNED_BYTE, toneCurveByteArray);
-        }        
-    });
-}
-
-#pragma mark -
-#pragma mark Rendering
-
-- (void)renderToTextureWithVertices:(const GLfloat *)vertices textureCoordinates:(const GLfloat *)textureCoordinates sourceTexture:(GLuint)sourceTexture;
-{
-    if (self.preventRendering)
-    {
-        return;
-    }
-    
-    [GPUImageOpenGLESContext setActiveShaderProgram:filterProgram];
-    [self setFilterFBO];
-    
-    glClearColor(backgroundColorRed, backgroundColorGreen, backgroundColorBlue, backgroundColorAlpha);
-    glClear(GL_COLOR_BUFFER_BIT);
-    
-  	glActiveTexture(GL_TEXTURE2);
-  	glBindTexture(GL_TEXTURE_2D, sourceTexture);
-  	glUniform1i(filterInputTextureUniform, 2);	
-    
-    glActiveTexture(GL_TEXTURE3);
-    glBindTexture(GL_TEXTURE_2D, toneCurveTexture);                
-    glUniform1i(toneCurveTextureUniform, 3);	
-    
-    glVertexAttribPointer(filterPositionAttribute, 2, GL_FLOAT, 0, 0, vertices);
-    glVertexAttribPointer(filterTextureCoordinateAttribute, 2, GL_FLOAT, 0, 0, textureCoordinates);
-    
-    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);    
-}
-
-#pragma mark -
-#pragma mark Accessors
-
-- (void)setRGBControlPoints:(NSArray *)points
-{
-    _redControlPoints = [points copy];
-    _redCurve = [self getPreparedSplineCurve:_redControlPoints];
-
-    _greenControlPoints = [points copy];
-    _greenCurve = [self getPreparedSplineCurve:_greenControlPoints];
-
-    _blueControlPoints = [points copy];
-    _blueCurve = [self getPreparedSplineCurve:_blueControlPoints];
-    
-    [self updateToneCurveTexture];
-}
-
-
-- (void)setRgbCompositeControlPoints:(NSArray *)newValue
-{
-  _rgbCompositeControlPoints = [newValue copy];
-  _rgbCompositeCurve = [self getPreparedSplineCurve:_rgbCompositeControlPoints];
-  
-  [self updateToneCurveTexture];
-}
-
-
-- (void)setRedControlPoints:(NSArray *)newValue;
-{  
-    _redControlPoints = [newValue copy];
-    _redCurve = [self getPreparedSplineCurve:_redControlPoints];
-    
-    [self updateToneCurveTexture];
-}
-
-
-- (void)setGreenControlPoints:(NSArray *)newValue
-{
-    _greenControlPoints = [newValue copy];
-    _greenCurve = [self getPreparedSplineCurve:_greenControlPoints];
-    
-    [self updateToneCurveTexture];
-}
-
-
-- (void)setBlueControlPoints:(NSArray *)newValue
-{
-    _blueControlPoints = [newValue copy];
-    _blueCurve = [self getPreparedSplineCurve:_blueControlPoints];
-    
-    [self updateToneCurveTexture];
-}
-
-@end
+#import "GPUImageToneCurveFilter.h"
+
+#pragma mark -
+#pragma mark GPUImageACVFile Helper
+
+//  GPUImageACVFile
+//
+//  ACV File format Parser
+//  Please refer to http://www.adobe.com/devnet-apps/photoshop/fileformatashtml/PhotoshopFileFormats.htm#50577411_pgfId-1056330
+//
+
+@interface GPUImageACVFile : NSObject{
+    short version;
+    short totalCurves;
+    
+    NSArray *rgbCompositeCurvePoints;
+    NSArray *redCurvePoints;
+    NSArray *greenCurvePoints;    
+    NSArray *blueCurvePoints;
+}
+
+@property(strong,nonatomic) NSArray *rgbCompositeCurvePoints;
+@property(strong,nonatomic) NSArray *redCurvePoints;
+@property(strong,nonatomic) NSArray *greenCurvePoints;    
+@property(strong,nonatomic) NSArray *blueCurvePoints;
+
+- (id) initWithCurveFilePathURL:(NSURL*)curveFilePathURL;
+
+@end
+
+@implementation GPUImageACVFile
+
+@synthesize rgbCompositeCurvePoints, redCurvePoints, greenCurvePoints, blueCurvePoints;
+
+- (id) initWithCurveFilePathURL:(NSURL*)curveFilePathURL
+{
+    self = [super init];
+	if (self != nil)
+	{
+        NSError* error = nil;
+        NSFileHandle* file = [NSFileHandle fileHandleForReadingFromURL:curveFilePathURL
+                                                                 error:&error];
+        
+        if ((file == nil) || (error != nil))
+        {
+            NSLog(@"Failed to open file: %@", error);
+            
+            return self;
+        }
+        
+        NSData *databuffer;
+        
+        // 2 bytes, Version ( = 1 or = 4)
+        databuffer = [file readDataOfLength: 2];
+        version = CFSwapInt16BigToHost(*(int*)([databuffer bytes]));
+        
+        // 2 bytes, Count of curves in the file.
+        [file seekToFileOffset:2];
+        databuffer = [file readDataOfLength:2];
+        totalCurves = CFSwapInt16BigToHost(*(int*)([databuffer bytes]));
+        
+        NSMutableArray *curves = [NSMutableArray new];
+        
+        float pointRate = (1.0 / 255);
+        // The following is the data for each curve specified by count above
+        for (NSInteger x = 0; x<totalCurves; x++)
+        {
+            // 2 bytes, Count of points in the curve (short integer from 2...19)
+            databuffer = [file readDataOfLength:2];            
+            short pointCount = CFSwapInt16BigToHost(*(int*)([databuffer bytes]));
+            
+            NSMutableArray *points = [NSMutableArray new];
+            // point count * 4
+            // Curve points. Each curve point is a pair of short integers where 
+            // the first number is the output value (vertical coordinate on the 
+            // Curves dialog graph) and the second is the input value. All coordinates have range 0 to 255. 
+            for (NSInteger y = 0; y<pointCount; y++)
+            {
+                databuffer = [file readDataOfLength:2];
+                short y = CFSwapInt16BigToHost(*(int*)([databuffer bytes]));
+                databuffer = [file readDataOfLength:2];
+                short x = CFSwapInt16BigToHost(*(int*)([databuffer bytes]));
+                
+                [points addObject:[NSValue valueWithCGSize:CGSizeMake(x * pointRate, y * pointRate)]];
+            }
+            
+            [curves addObject:points];
+        }
+        
+        [file closeFile];
+        
+        rgbCompositeCurvePoints = [curves objectAtIndex:0];
+        redCurvePoints = [curves objectAtIndex:1];
+        greenCurvePoints = [curves objectAtIndex:2];
+        blueCurvePoints = [curves objectAtIndex:3];
+	}
+	
+	return self;
+    
+}
+
+@end
+
+#pragma mark -
+#pragma mark GPUImageToneCurveFilter Implementation
+
+NSString *const kGPUImageToneCurveFragmentShaderString = SHADER_STRING
+(
+ varying highp vec2 textureCoordinate;
+ uniform sampler2D inputImageTexture;
+ uniform sampler2D toneCurveTexture;
+ uniform mediump float curveSetCoordinate;
+ 
+ // Lines input values up with the centers of the curve's texels
+ const mediump float curveScale = 1023.0 / 1024.0;
+ const mediump float curveOffset = 0.5 / 1024.0;
+ 
+ void main()
+ {
+     lowp vec4 textureColor = texture2D(inputImageTexture, textureCoordinate);
+     mediump vec3 curveCoordinates = textureColor.rgb * curveScale + curveOffset;
+     mediump float redCurveValue = texture2D(toneCurveTexture, vec2(curveCoordinates.r, curveSetCoordinate)).r;
+     mediump float greenCurveValue = texture2D(toneCurveTexture, vec2(curveCoordinates.g, curveSetCoordinate)).g;
+     mediump float blueCurveValue = texture2D(toneCurveTexture, vec2(curveCoordinates.b, curveSetCoordinate)).b;
+     
+     gl_FragColor = vec4(redCurveValue, greenCurveValue, blueCurveValue, textureColor.a);
+ }
+);
+
+#pragma mark -
+#pragma mark Spline evaluation
+
+#define kGPUImageToneCurveChannelCount 4
+#define kGPUImageToneCurveSetCount 2
+
+// Solves a natural cubic spline through the control points and samples it at curveLength evenly spaced inputs. Inputs before the first point map to 0 and inputs past the last point to 1.
+static void GPUImageToneCurveEvaluateSpline(const CGPoint *controlPoints, NSUInteger pointCount, GLfloat *curve, NSUInteger curveLength)
+{
+    if (pointCount < 2)
+    {
+        for (NSUInteger curveIndex = 0; curveIndex < curveLength; curveIndex++)
+        {
+            curve[curveIndex] = (GLfloat)curveIndex / (GLfloat)(curveLength - 1);
+        }
+        return;
+    }
+    
+    // Sort by input, keeping the last of any points that share one
+    CGPoint points[pointCount];
+    NSUInteger n = 0;
+    for (NSUInteger pointIndex = 0; pointIndex < pointCount; pointIndex++)
+    {
+        CGPoint point = controlPoints[pointIndex];
+        NSUInteger insertionIndex = n;
+        while ( (insertionIndex > 0) && (points[insertionIndex - 1].x > point.x) )
+        {
+            insertionIndex--;
+        }
+        
+        if ( (insertionIndex > 0) && (points[insertionIndex - 1].x == point.x) )
+        {
+            points[insertionIndex - 1] = point;
+            continue;
+        }
+        
+        memmove(&points[insertionIndex + 1], &points[insertionIndex], (n - insertionIndex) * sizeof(CGPoint));
+        points[insertionIndex] = point;
+        n++;
+    }
+    
+    if (n < 2)
+    {
+        GPUImageToneCurveEvaluateSpline(NULL, 0, curve, curveLength);
+        return;
+    }
+    
+    // Second derivatives from the tridiagonal system, with the ends held at zero, by forward elimination and back substitution
+    double secondDerivatives[n], modifiedUpper[n], modifiedResult[n];
+    modifiedUpper[0] = 0.0;
+    modifiedResult[0] = 0.0;
+    for (NSUInteger i = 1; i < n - 1; i++)
+    {
+        double lower = (points[i].x - points[i - 1].x) / 6.0;
+        double diagonal = (points[i + 1].x - points[i - 1].x) / 3.0;
+        double upper = (points[i + 1].x - points[i].x) / 6.0;
+        double result = (points[i + 1].y - points[i].y) / (points[i + 1].x - points[i].x) - (points[i].y - points[i - 1].y) / (points[i].x - points[i - 1].x);
+        
+        double pivot = diagonal - lower * modifiedUpper[i - 1];
+        modifiedUpper[i] = upper / pivot;
+        modifiedResult[i] = (result - lower * modifiedResult[i - 1]) / pivot;
+    }
+    
+    secondDerivatives[n - 1] = 0.0;
+    for (NSInteger i = n - 2; i > 0; i--)
+    {
+        secondDerivatives[i] = modifiedResult[i] - modifiedUpper[i] * secondDerivatives[i + 1];
+    }
+    secondDerivatives[0] = 0.0;
+    
+    NSUInteger segment = 0;
+    for (NSUInteger curveIndex = 0; curveIndex < curveLength; curveIndex++)
+    {
+        double x = (double)curveIndex / (double)(curveLength - 1);
+        
+        if (x < points[0].x)
+        {
+            curve[curveIndex] = 0.0;
+            continue;
+        }
+        else if (x > points[n - 1].x)
+        {
+            curve[curveIndex] = 1.0;
+            continue;
+        }
+        
+        while ( (segment < n - 2) && (x > points[segment + 1].x) )
+        {
+            segment++;
+        }
+        
+        CGPoint current = points[segment];
+        CGPoint next = points[segment + 1];
+        double h = next.x - current.x;
+        double b = (x - current.x) / h;
+        double a = 1.0 - b;
+        double y = a * current.y + b * next.y + (h * h / 6.0) * ( (a * a * a - a) * secondDerivatives[segment] + (b * b * b - b) * secondDerivatives[segment + 1] );
+        
+        curve[curveIndex] = fmin(fmax(y, 0.0), 1.0);
+    }
+}
+
+// Only needs to handle values from 0 to 1, so small values are flushed to zero rather than made denormal
+static inline GLushort GPUImageHalfFloatFromFloat(GLfloat value)
+{
+    union { GLfloat floatValue; uint32_t bits; } conversion;
+    conversion.floatValue = value;
+    
+    uint32_t sign = (conversion.bits >> 16) & 0x8000;
+    int32_t exponent = (int32_t)((conversion.bits >> 23) & 0xff) - 127 + 15;
+    uint32_t mantissa = conversion.bits & 0x7fffff;
+    
+    if (exponent <= 0)
+    {
+        return sign;
+    }
+    else if (exponent >= 31)
+    {
+        return sign | 0x7c00;
+    }
+    
+    // Adding the rounded mantissa lets a carry roll over into the exponent
+    return sign | ((exponent << 10) + ((mantissa + 0x1000) >> 13));
+}
+
+#pragma mark -
+#pragma mark GPUImageToneCurveFilter Implementation
+
+@interface GPUImageToneCurveFilter()
+{
+    GLint toneCurveTextureUniform, curveSetCoordinateUniform;
+    GLuint toneCurveTexture;
+    GLenum toneCurveTextureType;
+    GLvoid *toneCurveTextureData;
+    BOOL toneCurveTextureNeedsUpdate;
+    
+    // Each set holds the composite, red, green and blue curves, one after another
+    GLfloat *toneCurves;
+}
+
+- (void)setControlPoints:(const CGPoint *)points count:(NSUInteger)pointCount forChannel:(GPUImageToneCurveChannel)channel inCurveSet:(NSUInteger)curveSet;
+- (void)setControlPointArray:(NSArray *)points forChannel:(GPUImageToneCurveChannel)channel inCurveSet:(NSUInteger)curveSet;
+
+@end
+
+@implementation GPUImageToneCurveFilter
+
+@synthesize rgbCompositeControlPoints = _rgbCompositeControlPoints;
+@synthesize redControlPoints = _redControlPoints;
+@synthesize greenControlPoints = _greenControlPoints;
+@synthesize blueControlPoints = _blueControlPoints;
+@synthesize curveInterpolation = _curveInterpolation;
+
+#pragma mark -
+#pragma mark Initialization and teardown
+
+- (id)init;
+{
+    if (!(self = [super initWithFragmentShaderFromString:kGPUImageToneCurveFragmentShaderString]))
+    {
+		return nil;
+    }
+    
+    toneCurveTextureUniform = [filterProgram uniformIndex:@"toneCurveTexture"];
+    curveSetCoordinateUniform = [filterProgram uniformIndex:@"curveSetCoordinate"];
+    
+    toneCurves = calloc(kGPUImageToneCurveSetCount * kGPUImageToneCurveChannelCount * kGPUImageToneCurveLength, sizeof(GLfloat));
+    toneCurveTextureData = calloc(kGPUImageToneCurveSetCount * kGPUImageToneCurveLength * 4, sizeof(GLushort));
+    
+    for (NSUInteger channel = 0; channel < kGPUImageToneCurveChannelCount; channel++)
+    {
+        [self setControlPoints:NULL count:0 forChannel:(GPUImageToneCurveChannel)channel inCurveSet:1];
+    }
+    
+    NSArray *defaultCurve = [NSArray arrayWithObjects:[NSValue valueWithCGPoint:CGPointMake(0.0, 0.0)], [NSValue valueWithCGPoint:CGPointMake(0.5, 0.5)], [NSValue valueWithCGPoint:CGPointMake(1.0, 1.0)], nil];
+    [self setRgbCompositeControlPoints:defaultCurve];
+    [self setRedControlPoints:defaultCurve];
+    [self setGreenControlPoints:defaultCurve];
+    [self setBlueControlPoints:defaultCurve];
+    
+    self.curveInterpolation = 0.0;
+    
+    return self;
+}
+
+// This pulls in Adobe ACV curve files to specify the tone curve
+- (id)initWithACV:(NSString*)curveFilename
+{
+    return [self initWithACVURL:[[NSBundle mainBundle] URLForResource:curveFilename
+                                                        withExtension:@"acv"]];
+}
+
+- (id)initWithACVURL:(NSURL*)curveFileURL
+{
+    if (!(self = [self init]))
+    {
+		return nil;
+    }
+    
+    [self setPointsWithACVURL:curveFileURL];
+    
+    return self;
+}
+
+- (void)setPointsWithACV:(NSString*)curveFilename
+{
+    [self setPointsWithACVURL:[[NSBundle mainBundle] URLForResource:curveFilename withExtension:@"acv"]];
+}
+
+- (void)setPointsWithACVURL:(NSURL*)curveFileURL
+{
+    GPUImageACVFile *curve = [[GPUImageACVFile alloc] initWithCurveFilePathURL:curveFileURL];
+    
+    [self setRgbCompositeControlPoints:curve.rgbCompositeCurvePoints];
+    [self setRedControlPoints:curve.redCurvePoints];
+    [self setGreenControlPoints:curve.greenCurvePoints];
+    [self setBlueControlPoints:curve.blueCurvePoints];
+    
+    curve = nil;
+}
+
+- (void)setInterpolationTargetWithACV:(NSString *)curveFilename;
+{
+    [self setInterpolationTargetWithACVURL:[[NSBundle mainBundle] URLForResource:curveFilename withExtension:@"acv"]];
+}
+
+- (void)setInterpolationTargetWithACVURL:(NSURL *)curveFileURL;
+{
+    GPUImageACVFile *curve = [[GPUImageACVFile alloc] initWithCurveFilePathURL:curveFileURL];
+    
+    [self setControlPointArray:curve.rgbCompositeCurvePoints forChannel:kGPUImageToneCurveRGBComposite inCurveSet:1];
+    [self setControlPointArray:curve.redCurvePoints forChannel:kGPUImageToneCurveRed inCurveSet:1];
+    [self setControlPointArray:curve.greenCurvePoints forChannel:kGPUImageToneCurveGreen inCurveSet:1];
+    [self setControlPointArray:curve.blueCurvePoints forChannel:kGPUImageToneCurveBlue inCurveSet:1];
+    
+    curve = nil;
+}
+
+- (void)dealloc
+{
+    runSynchronouslyOnVideoProcessingQueue(^{
+        [GPUImageOpenGLESContext useImageProcessingContext];
+        if (toneCurveTexture)
+        {
+            glDeleteTextures(1, &toneCurveTexture);
+            toneCurveTexture = 0;
+        }
+    });
+    
+    free(toneCurves);
+    free(toneCurveTextureData);
+}
+
+#pragma mark -
+#pragma mark Curve calculation
+
+- (void)setControlPoints:(const CGPoint *)points count:(NSUInteger)pointCount forChannel:(GPUImageToneCurveChannel)channel;
+{
+    [self setControlPoints:points count:pointCount forChannel:channel inCurveSet:0];
+}
+
+- (void)setInterpolationTargetControlPoints:(const CGPoint *)points count:(NSUInteger)pointCount forChannel:(GPUImageToneCurveChannel)channel;
+{
+    [self setControlPoints:points count:pointCount forChannel:channel inCurveSet:1];
+}
+
+- (void)setControlPoints:(const CGPoint *)points count:(NSUInteger)pointCount forChannel:(GPUImageToneCurveChannel)channel inCurveSet:(NSUInteger)curveSet;
+{
+    // The texture is built from these curves on the video processing queue, so they are only changed there
+    runSynchronouslyOnVideoProcessingQueue(^{
+        GLfloat *curve = toneCurves + (curveSet * kGPUImageToneCurveChannelCount + channel) * kGPUImageToneCurveLength;
+        GPUImageToneCurveEvaluateSpline(points, pointCount, curve, kGPUImageToneCurveLength);
+        toneCurveTextureNeedsUpdate = YES;
+    });
+}
+
+- (void)setControlPointArray:(NSArray *)points forChannel:(GPUImageToneCurveChannel)channel inCurveSet:(NSUInteger)curveSet;
+{
+    NSUInteger pointCount = [points count];
+    CGPoint controlPoints[MAX(pointCount, 1)];
+    for (NSUInteger pointIndex = 0; pointIndex < pointCount; pointIndex++)
+    {
+        controlPoints[pointIndex] = [[points objectAtIndex:pointIndex] CGPointValue];
+    }
+    
+    [self setControlPoints:controlPoints count:pointCount forChannel:channel inCurveSet:curveSet];
+}
+
+- (NSArray *)getPreparedSplineCurve:(NSArray *)points
+{
+    if (points && [points count] > 0) 
+    {
+        // Sort the array.
+        NSArray *sortedPoints = [points sortedArrayUsingComparator:^(id a, id b) {
+            float x1 = [(NSValue *)a CGPointValue].x;
+            float x2 = [(NSValue *)b CGPointValue].x;            
+            return x1 > x2;
+        }];
+                
+        // Convert from (0, 1) to (0, 255).
+        NSMutableArray *convertedPoints = [NSMutableArray arrayWithCapacity:[sortedPoints count]];
+        for (int i=0; i<[points count]; i++){
+            CGPoint point = [[sortedPoints objectAtIndex:i] CGPointValue];
+            point.x = point.x * 255;
+            point.y = point.y * 255;
+                        
+            [convertedPoints addObject:[NSValue valueWithCGPoint:point]];
+        }
+        
+        
+        NSMutableArray *splinePoints = [self splineCurve:convertedPoints];
+        
+        // If we have a first point like (0.3, 0) we'll be missing some points at the beginning
+        // that should be 0.
+        CGPoint firstSplinePoint = [[splinePoints objectAtIndex:0] CGPointValue];
+        
+        if (firstSplinePoint.x > 0) {
+            for (int i=firstSplinePoint.x; i >= 0; i--) {
+                CGPoint newCGPoint = CGPointMake(i, 0);
+                [splinePoints insertObject:[NSValue valueWithCGPoint:newCGPoint] atIndex:0];
+            }
+        }
+
+        // Insert points similarly at the end, if necessary.
+        CGPoint lastSplinePoint = [[splinePoints objectAtIndex:([splinePoints count] - 1)] CGPointValue];
+
+        if (lastSplinePoint.x < 255) {
+            for (int i = lastSplinePoint.x + 1; i <= 255; i++) {
+                CGPoint newCGPoint = CGPointMake(i, 255);
+                [splinePoints addObject:[NSValue valueWithCGPoint:newCGPoint]];
+            }
+        }
+        
+        
+        // Prepare the spline points.
+        NSMutableArray *preparedSplinePoints = [NSMutableArray arrayWithCapacity:[splinePoints count]];
+        for (int i=0; i<[splinePoints count]; i++) 
+        {
+            CGPoint newPoint = [[splinePoints objectAtIndex:i] CGPointValue];
+            CGPoint origPoint = CGPointMake(newPoint.x, newPoint.x);
+            
+            float distance = sqrt(pow((origPoint.x - newPoint.x), 2.0) + pow((origPoint.y - newPoint.y), 2.0));
+            
+            if (origPoint.y > newPoint.y) 
+            {
+                distance = -distance;
+            }
+            
+            [preparedSplinePoints addObject:[NSNumber numberWithFloat:distance]];
+        }
+        
+        return preparedSplinePoints;
+    }
+    
+    return nil;
+}
+
+
+- (NSMutableArray *)splineCurve:(NSArray *)points
+{
+    NSMutableArray *sdA = [self secondDerivative:points];
+    
+    // Is [points count] equal to [sdA count]?
+//    int n = [points count];
+    int n = [sdA count];
+    if (n < 1)
+    {
+        return nil;
+    }
+    double sd[n];
+    
+    // From NSMutableArray to sd[n];
+    for (int i=0; i<n; i++) 
+    {
+        sd[i] = [[sdA objectAtIndex:i] doubleValue];
+    }
+    
+    
+    NSMutableArray *output = [NSMutableArray arrayWithCapacity:(n+1)];
+                              
+    for(int i=0; i<n-1 ; i++) 
+    {
+        CGPoint cur = [[points objectAtIndex:i] CGPointValue];
+        CGPoint next = [[points objectAtIndex:(i+1)] CGPointValue];
+        
+        for(int x=cur.x;x<(int)next.x;x++) 
+        {
+            double t = (double)(x-cur.x)/(next.x-cur.x);
+            
+            double a = 1-t;
+            double b = t;
+            double h = next.x-cur.x;
+            
+            double y= a*cur.y + b*next.y + (h*h/6)*( (a*a*a-a)*sd[i]+ (b*b*b-b)*sd[i+1] );
+                        
+            if (y > 255.0)
+            {
+                y = 255.0;   
+            }
+            else if (y < 0.0)
+            {
+                y = 0.0;   
+            }
+            
+            [output addObject:[NSValue valueWithCGPoint:CGPointMake(x, y)]];
+        }
+    }
+    
+    // If the last point is (255, 255) it doesn't get added.
+    if ([output count] == 255) {
+        [output addObject:[points lastObject]];
+    }
+    return output;
+}
+
+- (NSMutableArray *)secondDerivative:(NSArray *)points
+{
+    int n = [points count];
+    if ((n <= 0) || (n == 1))
+    {
+        return nil;
+    }
+    
+    double matrix[n][3];
+    double result[n];
+    matrix[0][1]=1;
+    // What about matrix[0][1] and matrix[0][0]? Assuming 0 for now (Brad L.)
+    matrix[0][0]=0;    
+    matrix[0][2]=0;    
+    
+    for(int i=1;i<n-1;i++) 
+    {
+        CGPoint P1 = [[points objectAtIndex:(i-1)] CGPointValue];
+        CGPoint P2 = [[points objectAtIndex:i] CGPointValue];
+        CGPoint P3 = [[points objectAtIndex:(i+1)] CGPointValue];
+        
+        matrix[i][0]=(double)(P2.x-P1.x)/6;
+        matrix[i][1]=(double)(P3.x-P1.x)/3;
+        matrix[i][2]=(double)(P3.x-P2.x)/6;
+        result[i]=(double)(P3.y-P2.y)/(P3.x-P2.x) - (double)(P2.y-P1.y)/(P2.x-P1.x);
+    }
+    
+    // What about result[0] and result[n-1]? Assuming 0 for now (Brad L.)
+    result[0] = 0;
+    result[n-1] = 0;
+	
+    matrix[n-1][1]=1;
+    // What about matrix[n-1][0] and matrix[n-1][2]? For now, assuming they are 0 (Brad L.)
+    matrix[n-1][0]=0;
+    matrix[n-1][2]=0;
+    
+  	// solving pass1 (up->down)
+  	for(int i=1;i<n;i++) 
+    {
+		double k = matrix[i][0]/matrix[i-1][1];
+		matrix[i][1] -= k*matrix[i-1][2];
+		matrix[i][0] = 0;
+		result[i] -= k*result[i-1];
+    }
+	// solving pass2 (down->up)
+	for(int i=n-2;i>=0;i--) 
+    {
+		double k = matrix[i][2]/matrix[i+1][1];
+		matrix[i][1] -= k*matrix[i+1][0];
+		matrix[i][2] = 0;
+		result[i] -= k*result[i+1];
+	}
+    
+    double y2[n];
+    for(int i=0;i<n;i++) y2[i]=result[i]/matrix[i][1];
+    
+    NSMutableArray *output = [NSMutableArray arrayWithCapacity:n];
+    for (int i=0;i<n;i++) 
+    {
+        [output addObject:[NSNumber numberWithDouble:y2[i]]];
+    }
+    
+    return output;
+}
+
+- (void)updateToneCurveTexture;
+{
+    runSynchronouslyOnVideoProcessingQueue(^{
+        [GPUImageOpenGLESContext useImageProcessingContext];
+        
+        BOOL needsStorage = !toneCurveTexture;
+        if (needsStorage)
+        {
+            glActiveTexture(GL_TEXTURE3);
+            glGenTextures(1, &toneCurveTexture);
+            glBindTexture(GL_TEXTURE_2D, toneCurveTexture);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+            
+            // Half floats keep the steps of steep curves out of dark gradients, where they need to be filtered linearly
+            BOOL supportsFilteredHalfFloat = [GPUImageOpenGLESContext deviceSupportsOpenGLESExtension:@"GL_OES_texture_half_float"] && [GPUImageOpenGLESContext deviceSupportsOpenGLESExtension:@"GL_OES_texture_half_float_linear"];
+            toneCurveTextureType = supportsFilteredHalfFloat ? GL_HALF_FLOAT_OES : GL_UNSIGNED_BYTE;
+        }
+        else
+        {
+            glActiveTexture(GL_TEXTURE3);
+            glBindTexture(GL_TEXTURE_2D, toneCurveTexture);
+        }
+        
+        // Each row holds one set of curves, with the composite curve applied on top of each channel's
+        for (NSUInteger curveSet = 0; curveSet < kGPUImageToneCurveSetCount; curveSet++)
+        {
+            const GLfloat *rgbCompositeCurve = toneCurves + (curveSet * kGPUImageToneCurveChannelCount + kGPUImageToneCurveRGBComposite) * kGPUImageToneCurveLength;
+            const GLfloat *redCurve = toneCurves + (curveSet * kGPUImageToneCurveChannelCount + kGPUImageToneCurveRed) * kGPUImageToneCurveLength;
+            const GLfloat *greenCurve = toneCurves + (curveSet * kGPUImageToneCurveChannelCount + kGPUImageToneCurveGreen) * kGPUImageToneCurveLength;
+            const GLfloat *blueCurve = toneCurves + (curveSet * kGPUImageToneCurveChannelCount + kGPUImageToneCurveBlue) * kGPUImageToneCurveLength;
+            
+            for (NSUInteger currentCurveIndex = 0; currentCurveIndex < kGPUImageToneCurveLength; currentCurveIndex++)
+            {
+                GLfloat identityValue = (GLfloat)currentCurveIndex / (GLfloat)(kGPUImageToneCurveLength - 1);
+                GLfloat compositeOffset = rgbCompositeCurve[currentCurveIndex] - identityValue;
+                GLfloat redValue = fminf(fmaxf(redCurve[currentCurveIndex] + compositeOffset, 0.0), 1.0);
+                GLfloat greenValue = fminf(fmaxf(greenCurve[currentCurveIndex] + compositeOffset, 0.0), 1.0);
+                GLfloat blueValue = fminf(fmaxf(blueCurve[currentCurveIndex] + compositeOffset, 0.0), 1.0);
+                NSUInteger texelOffset = (curveSet * kGPUImageToneCurveLength + currentCurveIndex) * 4;
+                
+                if (toneCurveTextureType == GL_HALF_FLOAT_OES)
+                {
+                    GLushort *halfFloatData = (GLushort *)toneCurveTextureData;
+                    halfFloatData[texelOffset] = GPUImageHalfFloatFromFloat(redValue);
+                    halfFloatData[texelOffset + 1] = GPUImageHalfFloatFromFloat(greenValue);
+                    halfFloatData[texelOffset + 2] = GPUImageHalfFloatFromFloat(blueValue);
+                    halfFloatData[texelOffset + 3] = GPUImageHalfFloatFromFloat(1.0);
+                }
+                else
+                {
+                    GLubyte *byteData = (GLubyte *)toneCurveTextureData;
+                    byteData[texelOffset] = (GLubyte)(redValue * 255.0 + 0.5);
+                    byteData[texelOffset + 1] = (GLubyte)(greenValue * 255.0 + 0.5);
+                    byteData[texelOffset + 2] = (GLubyte)(blueValue * 255.0 + 0.5);
+                    byteData[texelOffset + 3] = 255;
+                }
+            }
+        }
+        
+        if (needsStorage)
+        {
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, kGPUImageToneCurveLength /*width*/, kGPUImageToneCurveSetCount /*height*/, 0, GL_RGBA, toneCurveTextureType, toneCurveTextureData);
+        }
+        else
+        {
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, kGPUImageToneCurveLength, kGPUImageToneCurveSetCount, GL_RGBA, toneCurveTextureType, toneCurveTextureData);
+        }
+        
+        toneCurveTextureNeedsUpdate = NO;
+    });
+}
+
+#pragma mark -
+#pragma mark Rendering
+
+- (void)renderToTextureWithVertices:(const GLfloat *)vertices textureCoordinates:(const GLfloat *)textureCoordinates sourceTexture:(GLuint)sourceTexture;
+{
+    if (self.preventRendering)
+    {
+        return;
+    }
+    
+    // However many curves changed since the last frame, they go up to the GPU together
+    if (toneCurveTextureNeedsUpdate)
+    {
+        [self updateToneCurveTexture];
+    }
+    
+    [GPUImageOpenGLESContext setActiveShaderProgram:filterProgram];
+    [self setFilterFBO];
+    
+    glClearColor(backgroundColorRed, backgroundColorGreen, backgroundColorBlue, backgroundColorAlpha);
+    glClear(GL_COLOR_BUFFER_BIT);
+    
+  	glActiveTexture(GL_TEXTURE2);
+  	glBindTexture(GL_TEXTURE_2D, sourceTexture);
+  	glUniform1i(filterInputTextureUniform, 2);	
+    
+    glActiveTexture(GL_TEXTURE3);
+    glBindTexture(GL_TEXTURE_2D, toneCurveTexture);                
+    glUniform1i(toneCurveTextureUniform, 3);	
+    
+    glVertexAttribPointer(filterPositionAttribute, 2, GL_FLOAT, 0, 0, vertices);
+    glVertexAttribPointer(filterTextureCoordinateAttribute, 2, GL_FLOAT, 0, 0, textureCoordinates);
+    
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);    
+}
+
+#pragma mark -
+#pragma mark Accessors
+
+- (void)setRGBControlPoints:(NSArray *)points
+{
+    _redControlPoints = [points copy];
+    [self setControlPointArray:_redControlPoints forChannel:kGPUImageToneCurveRed inCurveSet:0];
+
+    _greenControlPoints = [points copy];
+    [self setControlPointArray:_greenControlPoints forChannel:kGPUImageToneCurveGreen inCurveSet:0];
+
+    _blueControlPoints = [points copy];
+    [self setControlPointArray:_blueControlPoints forChannel:kGPUImageToneCurveBlue inCurveSet:0];
+}
+
+
+- (void)setRgbCompositeControlPoints:(NSArray *)newValue
+{
+    _rgbCompositeControlPoints = [newValue copy];
+    [self setControlPointArray:_rgbCompositeControlPoints forChannel:kGPUImageToneCurveRGBComposite inCurveSet:0];
+}
+
+
+- (void)setRedControlPoints:(NSArray *)newValue;
+{  
+    _redControlPoints = [newValue copy];
+    [self setControlPointArray:_redControlPoints forChannel:kGPUImageToneCurveRed inCurveSet:0];
+}
+
+
+- (void)setGreenControlPoints:(NSArray *)newValue
+{
+    _greenControlPoints = [newValue copy];
+    [self setControlPointArray:_greenControlPoints forChannel:kGPUImageToneCurveGreen inCurveSet:0];
+}
+
+
+- (void)setBlueControlPoints:(NSArray *)newValue
+{
+    _blueControlPoints = [newValue copy];
+    [self setControlPointArray:_blueControlPoints forChannel:kGPUImageToneCurveBlue inCurveSet:0];
+}
+
+- (void)setCurveInterpolation:(CGFloat)newValue;
+{
+    _curveInterpolation = newValue;
+    
+    // Linear filtering between the two rows of the texture does the blending, at no cost over a single curve
+    [self setFloat:(0.25 + 0.5 * fmin(fmax(_curveInterpolation, 0.0), 1.0)) forUniform:curveSetCoordinateUniform program:filterProgram];
+}
+
+@end
\ No newline at end of file
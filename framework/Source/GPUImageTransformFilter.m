@@ -146,7 +146,8 @@ NSString *const kGPUImageTransformVertexShaderString = SHADER_STRING
 
 - (void)newFrameReadyAtTime:(CMTime)frameTime atIndex:(NSInteger)textureIndex;
 {
-    outputTextureRetainCount = [targets count];
+    outputTextureRetainCount = [self numberOfTargetsToSendFrameAtTime:frameTime];
+    [self applyParameterAnimationsAtTime:frameTime];
 
     CGSize currentFBOSize = [self sizeOfFBO];
     CGFloat normalizedHeight = currentFBOSize.height / currentFBOSize.width;
@@ -86,6 +86,20 @@ NSString *const kGPUImageTwoInputNearbyTexelSamplingVertexShaderString = SHADER_
     }
 }
 
+#pragma mark -
+#pragma mark Tiled processing
+
+- (NSUInteger)pixelFootprintRadius;
+{
+    if (!hasOverriddenImageSizeFactor)
+    {
+        return 1;
+    }
+    
+    CGSize currentFBOSize = [self sizeOfFBO];
+    return (NSUInteger)ceil(MAX(_texelWidth * currentFBOSize.width, _texelHeight * currentFBOSize.height));
+}
+
 #pragma mark -
 #pragma mark Accessors
 
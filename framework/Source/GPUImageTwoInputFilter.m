@@ -40,20 +40,8 @@ NSString *const kGPUImageTwoInputTextureVertexShaderString = SHADER_STRING
 		return nil;
     }
     
-    inputRotation2 = kGPUImageNoRotation;
+    numberOfInputs = 2;
     
-    hasSetFirstTexture = NO;
-    
-    hasReceivedFirstFrame = NO;
-    hasReceivedSecondFrame = NO;
-    firstFrameWasVideo = NO;
-    secondFrameWasVideo = NO;
-    firstFrameCheckDisabled = NO;
-    secondFrameCheckDisabled = NO;
-    
-    firstFrameTime = kCMTimeInvalid;
-    secondFrameTime = kCMTimeInvalid;
-        
     runSynchronouslyOnVideoProcessingQueue(^{
         [GPUImageOpenGLESContext useImageProcessingContext];
         filterSecondTextureCoordinateAttribute = [filterProgram attributeIndex:@"inputTextureCoordinate2"];
@@ -73,12 +61,12 @@ NSString *const kGPUImageTwoInputTextureVertexShaderString = SHADER_STRING
 
 - (void)disableFirstFrameCheck;
 {
-    firstFrameCheckDisabled = YES;
+    [self disableFrameCheckForInputAtIndex:0];
 }
 
 - (void)disableSecondFrameCheck;
 {
-    secondFrameCheckDisabled = YES;
+    [self disableFrameCheckForInputAtIndex:1];
 }
 
 #pragma mark -
@@ -88,12 +76,14 @@ NSString *const kGPUImageTwoInputTextureVertexShaderString = SHADER_STRING
 {
     if (self.preventRendering)
     {
+        framebufferHoldsPreviousFrame = NO;
         return;
     }
     
     [GPUImageOpenGLESContext setActiveShaderProgram:filterProgram];
     [self setFilterFBO];
     [self setUniformsForProgramAtIndex:0];
+    [self restrictRenderingToRegion:outputChangedRegion];
         
     glClearColor(backgroundColorRed, backgroundColorGreen, backgroundColorBlue, backgroundColorAlpha);
     glClear(GL_COLOR_BUFFER_BIT);
@@ -103,168 +93,17 @@ NSString *const kGPUImageTwoInputTextureVertexShaderString = SHADER_STRING
 	glUniform1i(filterInputTextureUniform, 2);	
     
     glActiveTexture(GL_TEXTURE3);
-    glBindTexture(GL_TEXTURE_2D, filterSourceTexture2);                
+    glBindTexture(GL_TEXTURE_2D, inputTextures[1]);                
     glUniform1i(filterInputTextureUniform2, 3);
     
     glVertexAttribPointer(filterPositionAttribute, 2, GL_FLOAT, 0, 0, vertices);
 	glVertexAttribPointer(filterTextureCoordinateAttribute, 2, GL_FLOAT, 0, 0, textureCoordinates);
-    glVertexAttribPointer(filterSecondTextureCoordinateAttribute, 2, GL_FLOAT, 0, 0, [[self class] textureCoordinatesForRotation:inputRotation2]);
+    glVertexAttribPointer(filterSecondTextureCoordinateAttribute, 2, GL_FLOAT, 0, 0, [[self class] textureCoordinatesForRotation:inputRotations[1]]);
     
-    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);    
-}
-
-- (void)releaseInputTexturesIfNeeded;
-{
-    if (shouldConserveMemoryForNextFrame)
-    {
-        [firstTextureDelegate textureNoLongerNeededForTarget:self];
-        [secondTextureDelegate textureNoLongerNeededForTarget:self];
-        shouldConserveMemoryForNextFrame = NO;
-    }
-}
-
-#pragma mark -
-#pragma mark GPUImageInput
-
-- (NSInteger)nextAvailableTextureIndex;
-{
-    if (hasSetFirstTexture)
-    {
-        return 1;
-    }
-    else
-    {
-        return 0;
-    }
-}
-
-- (void)setInputTexture:(GLuint)newInputTexture atIndex:(NSInteger)textureIndex;
-{
-    if (textureIndex == 0)
-    {
-        filterSourceTexture = newInputTexture;
-        hasSetFirstTexture = YES;
-    }
-    else
-    {
-        filterSourceTexture2 = newInputTexture;
-    }
-}
-
-- (void)setInputSize:(CGSize)newSize atIndex:(NSInteger)textureIndex;
-{
-    if (textureIndex == 0)
-    {
-        [super setInputSize:newSize atIndex:textureIndex];
-        
-        if (CGSizeEqualToSize(newSize, CGSizeZero))
-        {
-            hasSetFirstTexture = NO;
-        }
-    }
-}
-
-- (void)setInputRotation:(GPUImageRotationMode)newInputRotation atIndex:(NSInteger)textureIndex;
-{
-    if (textureIndex == 0)
-    {
-        inputRotation = newInputRotation;
-    }
-    else
-    {
-        inputRotation2 = newInputRotation;
-    }
-}
-
-- (CGSize)rotatedSize:(CGSize)sizeToRotate forIndex:(NSInteger)textureIndex;
-{
-    CGSize rotatedSize = sizeToRotate;
-    
-    GPUImageRotationMode rotationToCheck;
-    if (textureIndex == 0)
-    {
-        rotationToCheck = inputRotation;
-    }
-    else
-    {
-        rotationToCheck = inputRotation2;
-    }
-    
-    if (GPUImageRotationSwapsWidthAndHeight(rotationToCheck))
-    {
-        rotatedSize.width = sizeToRotate.height;
-        rotatedSize.height = sizeToRotate.width;
-    }
-    
-    return rotatedSize; 
-}
-
-- (void)newFrameReadyAtTime:(CMTime)frameTime atIndex:(NSInteger)textureIndex;
-{
-    outputTextureRetainCount = [targets count];
-
-    // You can set up infinite update loops, so this helps to short circuit them
-    if (hasReceivedFirstFrame && hasReceivedSecondFrame)
-    {
-        return;
-    }
-    
-    BOOL updatedMovieFrameOppositeStillImage = NO;
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
     
-    if (textureIndex == 0)
-    {
-        hasReceivedFirstFrame = YES;
-        firstFrameTime = frameTime;
-        if (secondFrameCheckDisabled)
-        {
-            hasReceivedSecondFrame = YES;
-        }
-        
-        if (!CMTIME_IS_INDEFINITE(frameTime))
-        {
-            if CMTIME_IS_INDEFINITE(secondFrameTime)
-            {
-                updatedMovieFrameOppositeStillImage = YES;
-            }
-        }
-    }
-    else
-    {
-        hasReceivedSecondFrame = YES;
-        secondFrameTime = frameTime;
-        if (firstFrameCheckDisabled)
-        {
-            hasReceivedFirstFrame = YES;
-        }
-
-        if (!CMTIME_IS_INDEFINITE(frameTime))
-        {
-            if CMTIME_IS_INDEFINITE(firstFrameTime)
-            {
-                updatedMovieFrameOppositeStillImage = YES;
-            }
-        }
-    }
-
-    // || (hasReceivedFirstFrame && secondFrameCheckDisabled) || (hasReceivedSecondFrame && firstFrameCheckDisabled)
-    if ((hasReceivedFirstFrame && hasReceivedSecondFrame) || updatedMovieFrameOppositeStillImage)
-    {
-        [super newFrameReadyAtTime:frameTime atIndex:0];
-        hasReceivedFirstFrame = NO;
-        hasReceivedSecondFrame = NO;
-    }
-}
-
-- (void)setTextureDelegate:(id<GPUImageTextureDelegate>)newTextureDelegate atIndex:(NSInteger)textureIndex;
-{
-    if (textureIndex == 0)
-    {
-        firstTextureDelegate = newTextureDelegate;
-    }
-    else
-    {
-        secondTextureDelegate = newTextureDelegate;
-    }
+    glDisable(GL_SCISSOR_TEST);
+    framebufferHoldsPreviousFrame = YES;
 }
 
-@end
+@end
\ No newline at end of file
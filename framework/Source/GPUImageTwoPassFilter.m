@@ -1,4 +1,5 @@
 #import "GPUImageTwoPassFilter.h"
+#import "GPUImageFence.h"
 
 @implementation GPUImageTwoPassFilter
 
@@ -126,6 +127,8 @@
     runSynchronouslyOnVideoProcessingQueue(^{
         [GPUImageOpenGLESContext useImageProcessingContext];
 
+        framebufferHoldsPreviousFrame = NO;
+
         if (!filterFramebuffer)
         {
             if ([GPUImageOpenGLESContext supportsFastTextureUpload] && preparedToCaptureImage)
@@ -133,6 +136,8 @@
                 preparedToCaptureImage = NO;
                 [super createFilterFBOofSize:currentFBOSize];
                 preparedToCaptureImage = YES;
+                // Only the first stage may have been made single channel, and the captured second stage isn't
+                outputTextureIsMonochrome = NO;
             }
             else
             {
@@ -202,14 +207,15 @@
         {
             [self initializeSecondOutputTextureIfNeeded];
             glBindTexture(GL_TEXTURE_2D, secondFilterOutputTexture);
-//            if ([self providesMonochromeOutput] && [GPUImageOpenGLESContext deviceSupportsRedTextures])
-//            {
-//                glTexImage2D(GL_TEXTURE_2D, 0, GL_RG_EXT, (int)currentFBOSize.width, (int)currentFBOSize.height, 0, GL_RG_EXT, GL_UNSIGNED_BYTE, 0);
-//            }
-//            else
-//            {
-                glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, (int)currentFBOSize.width, (int)currentFBOSize.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, 0);
-//            }
+            // Two-pass filters with monochrome output convert to luminance in their first pass, so both stages fit in one channel
+            if (outputTextureIsMonochrome)
+            {
+                glTexImage2D(GL_TEXTURE_2D, 0, GL_RED_EXT, (int)currentFBOSize.width, (int)currentFBOSize.height, 0, GL_RED_EXT, GL_UNSIGNED_BYTE, 0);
+            }
+            else
+            {
+                glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, (int)currentFBOSize.width, (int)currentFBOSize.height, 0, GL_RGBA, [self outputTextureType], 0);
+            }
             glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, secondFilterOutputTexture, 0);
             
             [self notifyTargetsAboutNewOutputTexture];
@@ -236,6 +242,8 @@
 
 - (void)destroyFilterFBO;
 {
+    framebufferHoldsPreviousFrame = NO;
+
     runSynchronouslyOnVideoProcessingQueue(^{
         [GPUImageOpenGLESContext useImageProcessingContext];
         
@@ -273,6 +281,11 @@
 {
     CGSize currentFBOSize = [self sizeOfFBO];
 
+    if (filterFramebuffer && (outputTextureIsMonochrome != [self rendersMonochromeOutputIntoRedTexture]))
+    {
+        [self destroyFilterFBO];
+    }
+
     if (!filterFramebuffer)
     {
         if ([GPUImageOpenGLESContext supportsFastTextureUpload] && preparedToCaptureImage)
@@ -280,6 +293,7 @@
             preparedToCaptureImage = NO;
             [super createFilterFBOofSize:currentFBOSize];
             preparedToCaptureImage = YES;
+            outputTextureIsMonochrome = NO;
         }
         else
         {
@@ -319,14 +333,21 @@
 {
     if (self.preventRendering)
     {
+        framebufferHoldsPreviousFrame = NO;
         return;
     }
     
     // This assumes that any two-pass filter that says it desires monochrome input is using the first pass for a luminance conversion, which can be dropped
     if (!currentlyReceivingMonochromeInput)
     {
-        // Run the first stage of the two-pass filter
+        // Run the first stage of the two-pass filter, over enough of the frame to cover everything the second stage samples
+        CGRect secondStageChangedRegion = outputChangedRegion;
+        if (!CGRectEqualToRect(outputChangedRegion, kGPUImageFullFrameRegion))
+        {
+            outputChangedRegion = CGRectIntersection([self region:outputChangedRegion expandedByPixels:[self pixelFootprintRadius]], kGPUImageFullFrameRegion);
+        }
         [super renderToTextureWithVertices:vertices textureCoordinates:textureCoordinates sourceTexture:sourceTexture];
+        outputChangedRegion = secondStageChangedRegion;
     }
     
     // Run the second stage of the two-pass filter
@@ -334,6 +355,7 @@
     
     [GPUImageOpenGLESContext setActiveShaderProgram:secondFilterProgram];
     [self setUniformsForProgramAtIndex:1];
+    [self restrictRenderingToRegion:outputChangedRegion];
 
     glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT);
@@ -356,11 +378,15 @@
     glVertexAttribPointer(secondFilterPositionAttribute, 2, GL_FLOAT, 0, 0, vertices);
 
     glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    
+    glDisable(GL_SCISSOR_TEST);
+    framebufferHoldsPreviousFrame = YES;
 
     // Release the first FBO early
     if (shouldConserveMemoryForNextFrame)
     {
         [firstTextureDelegate textureNoLongerNeededForTarget:self];
+        framebufferHoldsPreviousFrame = NO;
 
         glDeleteFramebuffers(1, &filterFramebuffer);
         filterFramebuffer = 0;
@@ -382,13 +408,14 @@
 
 - (void)prepareForImageCapture;
 {
-    if (preparedToCaptureImage)
+    if (preparedToCaptureImage || ([self outputTextureType] != GL_UNSIGNED_BYTE))
     {
         return;
     }
     
     runSynchronouslyOnVideoProcessingQueue(^{
         preparedToCaptureImage = YES;
+        imageCaptureFence = [[GPUImageFence alloc] initWithLabel:NSStringFromClass([self class])];
         
         if ([GPUImageOpenGLESContext supportsFastTextureUpload])
         {
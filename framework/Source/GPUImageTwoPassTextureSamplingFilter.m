@@ -41,6 +41,25 @@
     }
 }
 
+- (NSUInteger)pixelFootprintRadius;
+{
+    // Most of the two-pass sampling kernels take nine samples centered on the current pixel
+    return 4;
+}
+
+#pragma mark -
+#pragma mark Changed regions
+
+- (CGRect)outputRegionAffectedByInputRegion:(CGRect)inputRegion atIndex:(NSInteger)textureIndex;
+{
+    return [self region:inputRegion expandedByPixels:[self pixelFootprintRadius]];
+}
+
+- (CGRect)inputRegionNeededForOutputRegion:(CGRect)outputRegion atIndex:(NSInteger)textureIndex;
+{
+    return [self region:outputRegion expandedByPixels:[self pixelFootprintRadius]];
+}
+
 - (void)setupFilterForSize:(CGSize)filterFrameSize;
 {
     runSynchronouslyOnVideoProcessingQueue(^{
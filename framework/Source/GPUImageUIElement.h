@@ -1,5 +1,8 @@
 #import "GPUImageOutput.h"
 
+// The layer is drawn into a bitmap that is kept from one update to the next, so an update only redraws and uploads the parts of the layer marked as changed with setNeedsUpdateInRect:.
+// Drawing the layer happens on the thread that calls update, and only the upload to the texture goes onto the video processing queue.
+
 @interface GPUImageUIElement : GPUImageOutput
 
 // Initialization and teardown
@@ -8,6 +11,19 @@
 
 // Layer management
 - (CGSize)layerSizeInPixels;
+
+/** Marks part of the layer to be redrawn on the next update, such as the frame of a label whose text changed
+ 
+ @param changedRect The changed area, in points in the layer's own coordinate space
+ */
+- (void)setNeedsUpdateInRect:(CGRect)changedRect;
+
+/** Redraws the parts of the layer marked with setNeedsUpdateInRect: since the last update and sends them on as a new frame, or redraws the whole layer if nothing was marked or its size changed
+ */
 - (void)update;
 
+/** Marks a changed area and updates it in one step
+ */
+- (void)updateInRect:(CGRect)changedRect;
+
 @end
@@ -8,8 +8,18 @@
     CGSize previousLayerSizeInPixels;
     CMTime time;
     NSTimeInterval actualTimeOfLastUpdate;
+    
+    GLubyte *layerBitmapData;
+    CGContextRef layerBitmapContext;
+    CGRect layerRegionNeedingUpdate;
+    GLuint textureHoldingLayerBitmap;
+    
+    dispatch_semaphore_t bitmapUploadSemaphore;
 }
 
+- (void)createLayerBitmapOfSize:(CGSize)bitmapSize;
+- (void)destroyLayerBitmap;
+
 @end
 
 @implementation GPUImageUIElement
@@ -19,16 +29,12 @@
 
 - (id)initWithView:(UIView *)inputView;
 {
-    if (!(self = [super init]))
+    if (!(self = [self initWithLayer:inputView.layer]))
     {
 		return nil;
     }
     
     view = inputView;
-    layer = inputView.layer;
-
-    previousLayerSizeInPixels = CGSizeZero;
-    [self update];
     
     return self;
 }
@@ -44,11 +50,59 @@
     layer = inputLayer;
 
     previousLayerSizeInPixels = CGSizeZero;
+    layerRegionNeedingUpdate = CGRectNull;
+    bitmapUploadSemaphore = dispatch_semaphore_create(1);
+    
     [self update];
 
     return self;
 }
 
+- (void)dealloc;
+{
+    [self destroyLayerBitmap];
+    
+#if ( (__IPHONE_OS_VERSION_MIN_REQUIRED < __IPHONE_6_0) || (!defined(__IPHONE_6_0)) )
+    if (bitmapUploadSemaphore != NULL)
+    {
+        dispatch_release(bitmapUploadSemaphore);
+    }
+#endif
+}
+
+#pragma mark -
+#pragma mark Layer bitmap
+
+- (void)createLayerBitmapOfSize:(CGSize)bitmapSize;
+{
+    [self destroyLayerBitmap];
+    
+    layerBitmapData = (GLubyte *) calloc(1, (int)bitmapSize.width * (int)bitmapSize.height * 4);
+    
+    CGColorSpaceRef genericRGBColorspace = CGColorSpaceCreateDeviceRGB();
+    layerBitmapContext = CGBitmapContextCreate(layerBitmapData, (int)bitmapSize.width, (int)bitmapSize.height, 8, (int)bitmapSize.width * 4, genericRGBColorspace,  kCGBitmapByteOrder32Little | kCGImageAlphaPremultipliedFirst);
+    CGColorSpaceRelease(genericRGBColorspace);
+    
+    // Flipped so that rows of the bitmap run from the top of the layer down, like the texture rows they are uploaded to, and so that the context works in the layer's points
+	CGContextTranslateCTM(layerBitmapContext, 0.0f, bitmapSize.height);
+    CGContextScaleCTM(layerBitmapContext, layer.contentsScale, -layer.contentsScale);
+}
+
+- (void)destroyLayerBitmap;
+{
+    if (layerBitmapContext != NULL)
+    {
+        CGContextRelease(layerBitmapContext);
+        layerBitmapContext = NULL;
+    }
+    
+    if (layerBitmapData != NULL)
+    {
+        free(layerBitmapData);
+        layerBitmapData = NULL;
+    }
+}
+
 #pragma mark -
 #pragma mark Layer management
 
@@ -58,11 +112,19 @@
     return CGSizeMake(layer.contentsScale * pointSize.width, layer.contentsScale * pointSize.height);
 }
 
+- (void)setNeedsUpdateInRect:(CGRect)changedRect;
+{
+    layerRegionNeedingUpdate = CGRectUnion(layerRegionNeedingUpdate, changedRect);
+}
+
+- (void)updateInRect:(CGRect)changedRect;
+{
+    [self setNeedsUpdateInRect:changedRect];
+    [self update];
+}
+
 - (void)update;
 {
-    [GPUImageOpenGLESContext useImageProcessingContext];
-    [self initializeOutputTextureIfNeeded];
-    
     if(CMTIME_IS_INVALID(time)) {
         time = CMTimeMakeWithSeconds(0, 600);
         actualTimeOfLastUpdate = [NSDate timeIntervalSinceReferenceDate];
@@ -72,39 +134,86 @@
         time = CMTimeAdd(time, CMTimeMakeWithSeconds(diff, 600));
         actualTimeOfLastUpdate = now;
     }
+    CMTime frameTime = time;
     
     CGSize layerPixelSize = [self layerSizeInPixels];
+    if ( (layerPixelSize.width < 1.0) || (layerPixelSize.height < 1.0) )
+    {
+        return;
+    }
     
-    GLubyte *imageData = (GLubyte *) calloc(1, (int)layerPixelSize.width * (int)layerPixelSize.height * 4);
+    // The bitmap is reused until the previous frame's rows are in the texture
+    dispatch_semaphore_wait(bitmapUploadSemaphore, DISPATCH_TIME_FOREVER);
     
-    CGColorSpaceRef genericRGBColorspace = CGColorSpaceCreateDeviceRGB();    
-    CGContextRef imageContext = CGBitmapContextCreate(imageData, (int)layerPixelSize.width, (int)layerPixelSize.height, 8, (int)layerPixelSize.width * 4, genericRGBColorspace,  kCGBitmapByteOrder32Little | kCGImageAlphaPremultipliedFirst);
-//    CGContextRotateCTM(imageContext, M_PI_2);
-	CGContextTranslateCTM(imageContext, 0.0f, layerPixelSize.height);
-    CGContextScaleCTM(imageContext, layer.contentsScale, -layer.contentsScale);
-    //        CGContextSetBlendMode(imageContext, kCGBlendModeCopy); // From Technical Q&A QA1708: http://developer.apple.com/library/ios/#qa/qa1708/_index.html
+    BOOL layerSizeChanged = !CGSizeEqualToSize(layerPixelSize, previousLayerSizeInPixels);
+    if (layerSizeChanged || (layerBitmapContext == NULL))
+    {
+        [self createLayerBitmapOfSize:layerPixelSize];
+    }
     
-    [layer renderInContext:imageContext];
+    CGRect layerBounds = CGRectMake(0.0, 0.0, layer.bounds.size.width, layer.bounds.size.height);
+    CGRect regionToDraw = (layerSizeChanged || CGRectIsNull(layerRegionNeedingUpdate)) ? layerBounds : CGRectIntersection(layerRegionNeedingUpdate, layerBounds);
+    layerRegionNeedingUpdate = CGRectNull;
     
-    CGContextRelease(imageContext);
-    CGColorSpaceRelease(genericRGBColorspace);
+    // Redraw whole pixels, so that the edges of the changed area aren't blended with what was there before
+    CGFloat scale = layer.contentsScale;
+    CGRect pixelRegionToDraw = CGRectIntegral(CGRectMake(regionToDraw.origin.x * scale, regionToDraw.origin.y * scale, regionToDraw.size.width * scale, regionToDraw.size.height * scale));
+    pixelRegionToDraw = CGRectIntersection(pixelRegionToDraw, CGRectMake(0.0, 0.0, layerPixelSize.width, layerPixelSize.height));
+    if (CGRectIsEmpty(pixelRegionToDraw))
+    {
+        dispatch_semaphore_signal(bitmapUploadSemaphore);
+        return;
+    }
+    regionToDraw = CGRectMake(pixelRegionToDraw.origin.x / scale, pixelRegionToDraw.origin.y / scale, pixelRegionToDraw.size.width / scale, pixelRegionToDraw.size.height / scale);
     
-    glBindTexture(GL_TEXTURE_2D, outputTexture);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, (int)layerPixelSize.width, (int)layerPixelSize.height, 0, GL_BGRA, GL_UNSIGNED_BYTE, imageData);
+    CGContextSaveGState(layerBitmapContext);
+    CGContextClipToRect(layerBitmapContext, regionToDraw);
+    CGContextClearRect(layerBitmapContext, regionToDraw);
+    [layer renderInContext:layerBitmapContext];
+    CGContextRestoreGState(layerBitmapContext);
     
-    free(imageData);
+    // OpenGL ES 2.0 can't upload part of a row from a wider bitmap, so whole rows covering the changed area go up
+    NSUInteger firstRow = (NSUInteger)pixelRegionToDraw.origin.y;
+    NSUInteger rowCount = (NSUInteger)pixelRegionToDraw.size.height;
+    CGRect changedRowsRegion = CGRectMake(0.0, firstRow / layerPixelSize.height, 1.0, rowCount / layerPixelSize.height);
     
-    for (id<GPUImageInput> currentTarget in targets)
-    {
-        if (currentTarget != self.targetToIgnoreForUpdates)
+    previousLayerSizeInPixels = layerPixelSize;
+    
+    runAsynchronouslyOnVideoProcessingQueue(^{
+        [GPUImageOpenGLESContext useImageProcessingContext];
+        [self initializeOutputTextureIfNeeded];
+        
+        // A new texture, or one at a new size, needs the whole bitmap before rows can be replaced in it
+        CGRect changedRegion = changedRowsRegion;
+        glBindTexture(GL_TEXTURE_2D, outputTexture);
+        if (layerSizeChanged || (textureHoldingLayerBitmap != outputTexture))
+        {
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, (int)layerPixelSize.width, (int)layerPixelSize.height, 0, GL_BGRA, GL_UNSIGNED_BYTE, layerBitmapData);
+            textureHoldingLayerBitmap = outputTexture;
+            changedRegion = kGPUImageFullFrameRegion;
+        }
+        else
+        {
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, firstRow, (int)layerPixelSize.width, rowCount, GL_BGRA, GL_UNSIGNED_BYTE, layerBitmapData + (firstRow * (NSUInteger)layerPixelSize.width * 4));
+        }
+        
+        dispatch_semaphore_signal(bitmapUploadSemaphore);
+        
+        [self generateMipmapsForTargetsIfNeededWithOutputSize:layerPixelSize];
+        
+        for (id<GPUImageInput> currentTarget in targets)
         {
-            NSInteger indexOfObject = [targets indexOfObject:currentTarget];
-            NSInteger textureIndexOfTarget = [[targetTextureIndices objectAtIndex:indexOfObject] integerValue];
-            
-            [currentTarget setInputSize:layerPixelSize atIndex:textureIndexOfTarget];
-            [currentTarget newFrameReadyAtTime:time atIndex:textureIndexOfTarget];
+            if ( (currentTarget != self.targetToIgnoreForUpdates) && [self shouldSendFrameAtTime:frameTime toTarget:currentTarget] )
+            {
+                NSInteger indexOfObject = [targets indexOfObject:currentTarget];
+                NSInteger textureIndexOfTarget = [[targetTextureIndices objectAtIndex:indexOfObject] integerValue];
+                
+                [self setInputChangedRegion:changedRegion forTarget:currentTarget atIndex:textureIndexOfTarget];
+                [currentTarget setInputSize:layerPixelSize atIndex:textureIndexOfTarget];
+                [currentTarget newFrameReadyAtTime:frameTime atIndex:textureIndexOfTarget];
+            }
         }
-    }    
+    });
 }
 
 @end
@@ -1,69 +1,7 @@
 #import "GPUImageVideoCamera.h"
 #import "GPUImageMovieWriter.h"
 #import "GPUImageFilter.h"
-
-NSString *const kGPUImageYUVVideoRangeConversionForRGFragmentShaderString = SHADER_STRING
-(
- varying highp vec2 textureCoordinate;
- 
- uniform sampler2D luminanceTexture;
- uniform sampler2D chrominanceTexture;
- 
- void main()
- {
-     mediump vec3 yuv;
-     lowp vec3 rgb;
-     
-     yuv.x = texture2D(luminanceTexture, textureCoordinate).r;
-     yuv.yz = texture2D(chrominanceTexture, textureCoordinate).rg - vec2(0.5, 0.5);
-     
-     // BT.601, which is the standard for SDTV is provided as a reference
-     /*
-      rgb = mat3(      1,       1,       1,
-      0, -.39465, 2.03211,
-      1.13983, -.58060,       0) * yuv;
-      */
-     
-     // Using BT.709 which is the standard for HDTV
-     rgb = mat3(      1,       1,       1,
-                0, -.21482, 2.12798,
-                1.28033, -.38059,       0) * yuv;
-     
-     gl_FragColor = vec4(rgb, 1);
- }
-);
-
-NSString *const kGPUImageYUVVideoRangeConversionForLAFragmentShaderString = SHADER_STRING
-(
- varying highp vec2 textureCoordinate;
- 
- uniform sampler2D luminanceTexture;
- uniform sampler2D chrominanceTexture;
- 
- void main()
- {
-     mediump vec3 yuv;
-     lowp vec3 rgb;
-     
-     yuv.x = texture2D(luminanceTexture, textureCoordinate).r;
-     yuv.yz = texture2D(chrominanceTexture, textureCoordinate).ra - vec2(0.5, 0.5);
-     
-     // BT.601, which is the standard for SDTV is provided as a reference
-     /*
-      rgb = mat3(      1,       1,       1,
-      0, -.39465, 2.03211,
-      1.13983, -.58060,       0) * yuv;
-      */
-     
-     // Using BT.709 which is the standard for HDTV
-     rgb = mat3(      1,       1,       1,
-                0, -.21482, 2.12798,
-                1.28033, -.38059,       0) * yuv;
-     
-     gl_FragColor = vec4(rgb, 1);
- }
- );
-
+#import "GPUImageYUVConverter.h"
 
 #pragma mark -
 #pragma mark Private methods and instance variables
@@ -78,17 +16,15 @@ NSString *const kGPUImageYUVVideoRangeConversionForLAFragmentShaderString = SHAD
     
     dispatch_queue_t cameraProcessingQueue, audioProcessingQueue;
     
-    GLProgram *yuvConversionProgram;
-    GLint yuvConversionPositionAttribute, yuvConversionTextureCoordinateAttribute;
-    GLint yuvConversionLuminanceTextureUniform, yuvConversionChrominanceTextureUniform;
-    GLuint yuvConversionFramebuffer;
+    GPUImageYUVConverter *yuvConverter;
     
     int imageBufferWidth, imageBufferHeight;
 }
 
 - (void)updateOrientationSendToTargets;
 - (void)convertYUVToRGBOutput;
-- (void)setYUVConversionFBO;
+- (void)createYUVConversionOutputTexture;
+- (void)destroyYUVConversionOutputTexture;
 
 @end
 
@@ -137,42 +73,7 @@ NSString *const kGPUImageYUVVideoRangeConversionForLAFragmentShaderString = SHAD
         if (captureAsYUV)
         {
             [GPUImageOpenGLESContext useImageProcessingContext];
-//            if ([GPUImageOpenGLESContext deviceSupportsRedTextures])
-//            {
-//                yuvConversionProgram = [[GPUImageOpenGLESContext sharedImageProcessingOpenGLESContext] programForVertexShaderString:kGPUImageVertexShaderString fragmentShaderString:kGPUImageYUVVideoRangeConversionForRGFragmentShaderString];
-//            }
-//            else
-//            {
-                yuvConversionProgram = [[GPUImageOpenGLESContext sharedImageProcessingOpenGLESContext] programForVertexShaderString:kGPUImageVertexShaderString fragmentShaderString:kGPUImageYUVVideoRangeConversionForLAFragmentShaderString];
-//            }
-
-            if (!yuvConversionProgram.initialized)
-            {
-                [yuvConversionProgram addAttribute:@"position"];
-                [yuvConversionProgram addAttribute:@"inputTextureCoordinate"];
-                
-                if (![yuvConversionProgram link])
-                {
-                    NSString *progLog = [yuvConversionProgram programLog];
-                    NSLog(@"Program link log: %@", progLog);
-                    NSString *fragLog = [yuvConversionProgram fragmentShaderLog];
-                    NSLog(@"Fragment shader compile log: %@", fragLog);
-                    NSString *vertLog = [yuvConversionProgram vertexShaderLog];
-                    NSLog(@"Vertex shader compile log: %@", vertLog);
-                    yuvConversionProgram = nil;
-                    NSAssert(NO, @"Filter shader link failed");
-                }
-            }
-            
-            yuvConversionPositionAttribute = [yuvConversionProgram attributeIndex:@"position"];
-            yuvConversionTextureCoordinateAttribute = [yuvConversionProgram attributeIndex:@"inputTextureCoordinate"];
-            yuvConversionLuminanceTextureUniform = [yuvConversionProgram uniformIndex:@"luminanceTexture"];
-            yuvConversionChrominanceTextureUniform = [yuvConversionProgram uniformIndex:@"chrominanceTexture"];
-            
-            [GPUImageOpenGLESContext setActiveShaderProgram:yuvConversionProgram];
-            
-            glEnableVertexAttribArray(yuvConversionPositionAttribute);
-            glEnableVertexAttribArray(yuvConversionTextureCoordinateAttribute);
+            yuvConverter = [[GPUImageYUVConverter alloc] initWithPlaneLayout:kGPUImageYUVBiPlanar];
         }
         
         if ([GPUImageOpenGLESContext supportsFastTextureUpload])
@@ -318,7 +219,7 @@ NSString *const kGPUImageYUVVideoRangeConversionForLAFragmentShaderString = SHAD
 //    if (captureAsYUV && [GPUImageOpenGLESContext deviceSupportsRedTextures])
     if (captureAsYUV && [GPUImageOpenGLESContext supportsFastTextureUpload])
     {
-        [self destroyYUVConversionFBO];
+        [self destroyYUVConversionOutputTexture];
     }
 }
 
@@ -503,7 +404,7 @@ NSString *const kGPUImageYUVVideoRangeConversionForLAFragmentShaderString = SHAD
 {
     for (id<GPUImageInput> currentTarget in targets)
     {
-        if ([currentTarget enabled])
+        if ([self shouldSendFrameAtTime:currentTime toTarget:currentTarget])
         {
             NSInteger indexOfObject = [targets indexOfObject:currentTarget];
             NSInteger textureIndexOfTarget = [[targetTextureIndices objectAtIndex:indexOfObject] integerValue];
@@ -566,8 +467,8 @@ NSString *const kGPUImageYUVVideoRangeConversionForLAFragmentShaderString = SHAD
                 imageBufferWidth = bufferWidth;
                 imageBufferHeight = bufferHeight;
                 
-                [self destroyYUVConversionFBO];
-                [self createYUVConversionFBO];
+                [self destroyYUVConversionOutputTexture];
+                [self createYUVConversionOutputTexture];
             }
             
             CVReturn err;
@@ -615,6 +516,7 @@ NSString *const kGPUImageYUVVideoRangeConversionForLAFragmentShaderString = SHAD
             
             if (!allTargetsWantMonochromeData)
             {
+                [yuvConverter matchColorSpaceOfPixelBuffer:cameraFrame];
                 [self convertYUVToRGBOutput];
             }
 
@@ -682,7 +584,7 @@ NSString *const kGPUImageYUVVideoRangeConversionForLAFragmentShaderString = SHAD
         
         for (id<GPUImageInput> currentTarget in targets)
         {
-            if ([currentTarget enabled])
+            if ([self shouldSendFrameAtTime:currentTime toTarget:currentTarget])
             {
                 if (currentTarget != self.targetToIgnoreForUpdates)
                 {
@@ -716,80 +618,30 @@ NSString *const kGPUImageYUVVideoRangeConversionForLAFragmentShaderString = SHAD
 
 - (void)convertYUVToRGBOutput;
 {
-    [GPUImageOpenGLESContext setActiveShaderProgram:yuvConversionProgram];
-    [self setYUVConversionFBO];
-    
-    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-    
-    static const GLfloat squareVertices[] = {
-        -1.0f, -1.0f,
-        1.0f, -1.0f,
-        -1.0f,  1.0f,
-        1.0f,  1.0f,
-    };
-    
-    static const GLfloat textureCoordinates[] = {
-        0.0f, 0.0f,
-        1.0f, 0.0f,
-        0.0f, 1.0f,
-        1.0f, 1.0f,
-    };
-    
-	glActiveTexture(GL_TEXTURE4);
-	glBindTexture(GL_TEXTURE_2D, luminanceTexture);
-	glUniform1i(yuvConversionLuminanceTextureUniform, 4);
-
-    glActiveTexture(GL_TEXTURE5);
-	glBindTexture(GL_TEXTURE_2D, chrominanceTexture);
-	glUniform1i(yuvConversionChrominanceTextureUniform, 5);
-
-    glVertexAttribPointer(yuvConversionPositionAttribute, 2, GL_FLOAT, 0, 0, squareVertices);
-	glVertexAttribPointer(yuvConversionTextureCoordinateAttribute, 2, GL_FLOAT, 0, 0, textureCoordinates);
-    
-    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-}
-
-- (void)setYUVConversionFBO;
-{
-    if (!yuvConversionFramebuffer)
+    if (!outputTexture)
     {
-        [self createYUVConversionFBO];
+        [self createYUVConversionOutputTexture];
     }
     
-    glBindFramebuffer(GL_FRAMEBUFFER, yuvConversionFramebuffer);
-    
-    glViewport(0, 0, imageBufferWidth, imageBufferHeight);
+    [yuvConverter setTexture:luminanceTexture forPlane:0];
+    [yuvConverter setTexture:chrominanceTexture forPlane:1];
+    [yuvConverter convertToTexture:outputTexture ofSize:CGSizeMake(imageBufferWidth, imageBufferHeight)];
 }
 
-- (void)createYUVConversionFBO;
+- (void)createYUVConversionOutputTexture;
 {
     [self initializeOutputTextureIfNeeded];
     
     glActiveTexture(GL_TEXTURE1);
-    glGenFramebuffers(1, &yuvConversionFramebuffer);
-    glBindFramebuffer(GL_FRAMEBUFFER, yuvConversionFramebuffer);
-    
     glBindTexture(GL_TEXTURE_2D, outputTexture);
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, imageBufferWidth, imageBufferHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, 0);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, outputTexture, 0);
-    
-	GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
-    [self notifyTargetsAboutNewOutputTexture];
-
-    NSAssert(status == GL_FRAMEBUFFER_COMPLETE, @"Incomplete filter FBO: %d", status);
     glBindTexture(GL_TEXTURE_2D, 0);
 
+    [self notifyTargetsAboutNewOutputTexture];
 }
 
-- (void)destroyYUVConversionFBO;
+- (void)destroyYUVConversionOutputTexture;
 {
-    if (yuvConversionFramebuffer)
-	{
-		glDeleteFramebuffers(1, &yuvConversionFramebuffer);
-		yuvConversionFramebuffer = 0;
-	}
-    
     if (outputTexture)
     {
         glDeleteTextures(1, &outputTexture);
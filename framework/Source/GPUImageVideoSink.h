@@ -0,0 +1,32 @@
+#import <Foundation/Foundation.h>
+#import <CoreMedia/CoreMedia.h>
+#import "GPUImageOpenGLESContext.h"
+
+/** What a movie source needs from the end of a chain that it drives
+
+ GPUImageMovieWriter implements this on top of AVAssetWriter, and GPUImageRawVideoOutput on top of a plain file writer. A source handed one through enableSynchronizedEncodingUsingMovieWriter: stops reading frames as fast as it can, and instead reads one each time the sink calls videoInputReadyCallback, so that nothing gets dropped when the sink can't keep up.
+ */
+@protocol GPUImageVideoSink <GPUImageInput>
+
+/** Whether frames come in real time and can be dropped if the sink falls behind. Sources turn this off when synchronizing with the sink.
+ */
+@property(readwrite, nonatomic) BOOL encodingLiveVideo;
+
+/** Called by the sink whenever it can take another video frame, once enableSynchronizationCallbacks has been called
+ */
+@property(nonatomic, copy) void(^videoInputReadyCallback)(void);
+
+/** Called by the sink whenever it can take another audio sample, once enableSynchronizationCallbacks has been called
+ */
+@property(nonatomic, copy) void(^audioInputReadyCallback)(void);
+
+- (void)startRecording;
+- (void)finishRecording;
+- (void)cancelRecording;
+- (void)processAudioBuffer:(CMSampleBufferRef)audioBuffer;
+
+/** Starts calling the ready callbacks on the video processing queue
+ */
+- (void)enableSynchronizationCallbacks;
+
+@end
@@ -0,0 +1,17 @@
+#import <Foundation/Foundation.h>
+#import "GPUImageVideoSink.h"
+
+/** A source that reads a whole video, rather than getting frames pushed at it like a camera
+
+ GPUImageMovie implements this for anything AVAssetReader can decode, and GPUImageRawVideoInput for uncompressed YUV files.
+ */
+@protocol GPUImageVideoSource <NSObject>
+
+/** Paces reading to the sink, which pulls each frame through videoInputReadyCallback, instead of reading as fast as frames can be processed
+ */
+- (void)enableSynchronizedEncodingUsingMovieWriter:(id<GPUImageVideoSink>)movieWriter;
+
+- (void)startProcessing;
+- (void)endProcessing;
+
+@end
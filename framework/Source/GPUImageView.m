@@ -20,6 +20,8 @@
     CGSize inputImageSize;
     GLfloat imageVertices[8];
     GLfloat backgroundColorRed, backgroundColorGreen, backgroundColorBlue, backgroundColorAlpha;
+    
+    BOOL isVisibleOnScreen;
 }
 
 // Initialization and teardown
@@ -32,6 +34,9 @@
 // Handling fill mode
 - (void)recalculateViewGeometry;
 
+// Tracking visibility
+- (void)updateVisibilityOnScreen;
+
 @end
 
 @implementation GPUImageView
@@ -147,6 +152,27 @@
     });
 }
 
+#pragma mark -
+#pragma mark Tracking visibility
+
+- (void)didMoveToWindow;
+{
+    [super didMoveToWindow];
+    [self updateVisibilityOnScreen];
+}
+
+- (void)setHidden:(BOOL)newValue;
+{
+    [super setHidden:newValue];
+    [self updateVisibilityOnScreen];
+}
+
+- (void)updateVisibilityOnScreen;
+{
+    // This is read from the video processing queue, which can't safely ask UIKit itself
+    isVisibleOnScreen = (self.window != nil) && !self.hidden;
+}
+
 #pragma mark -
 #pragma mark Managing the display FBOs
 
@@ -451,6 +477,11 @@
     
 }
 
+- (BOOL)wantsNextFrame;
+{
+    return enabled && isVisibleOnScreen;
+}
+
 #pragma mark -
 #pragma mark Accessors
 
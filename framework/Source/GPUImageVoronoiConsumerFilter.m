@@ -65,4 +65,18 @@ NSString *const kGPUImageVoronoiConsumerFragmentShaderString = SHADER_STRING
     glUniform2f(sizeUniform, _sizeInPixels.width, _sizeInPixels.height);
 }
 
+#pragma mark -
+#pragma mark Changed regions
+
+- (CGRect)outputRegionAffectedByInputRegion:(CGRect)inputRegion atIndex:(NSInteger)textureIndex;
+{
+    // Each pixel samples the color of whichever seed point the Voronoi map leads it to
+    return kGPUImageFullFrameRegion;
+}
+
+- (CGRect)inputRegionNeededForOutputRegion:(CGRect)outputRegion atIndex:(NSInteger)textureIndex;
+{
+    return kGPUImageFullFrameRegion;
+}
+
 @end
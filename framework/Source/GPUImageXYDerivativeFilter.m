@@ -58,4 +58,10 @@ NSString *const kGPUImageGradientFragmentShaderString = SHADER_STRING
     return self;
 }
 
+// The three derivative products don't fit in a single channel
+- (BOOL)providesMonochromeOutput;
+{
+    return NO;
+}
+
 @end
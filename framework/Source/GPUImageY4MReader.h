@@ -0,0 +1,28 @@
+#import <Foundation/Foundation.h>
+#import "GPUImageRawVideoInput.h"
+
+/** Reads uncompressed 4:2:0 video from a YUV4MPEG2 (Y4M) file, or from a headerless raw video file whose layout is given up front
+ 
+ Only 8-bit 4:2:0 Y4M files can be read. Frames are timed by their index and the frame rate, starting from zero.
+ */
+@interface GPUImageY4MReader : NSObject <GPUImageRawVideoReader>
+
+@property(readonly, nonatomic) NSURL *url;
+@property(readonly, nonatomic) CGSize frameSize;
+@property(readonly, nonatomic) GPUImageYUVPlaneLayout planeLayout;
+
+/** The time between frames, which is read from the header of Y4M files
+ */
+@property(readonly, nonatomic) CMTime frameDuration;
+
+// Initialization and teardown
+
+/** Opens a Y4M file and reads its header, returning nil if it isn't one that can be read
+ */
+- (id)initWithURL:(NSURL *)newURL;
+
+/** Reads bare frames with no headers, such as those written by ffmpeg -f rawvideo
+ */
+- (id)initWithRawVideoURL:(NSURL *)newURL frameSize:(CGSize)newFrameSize planeLayout:(GPUImageYUVPlaneLayout)newPlaneLayout frameDuration:(CMTime)newFrameDuration;
+
+@end
@@ -0,0 +1,214 @@
+#import "GPUImageY4MReader.h"
+#include <stdio.h>
+
+#define GPUImageY4MMaximumHeaderLength 1024
+
+@interface GPUImageY4MReader ()
+{
+    FILE *videoFile;
+    BOOL hasHeaders;
+    long firstFrameOffset;
+    size_t bytesPerFrame;
+    int64_t currentFrameIndex;
+}
+
+- (BOOL)openFile;
+- (BOOL)readStreamHeader;
+- (BOOL)readLineIntoBuffer:(char *)lineBuffer length:(size_t)bufferLength;
+
+@end
+
+@implementation GPUImageY4MReader
+
+@synthesize url = _url;
+@synthesize frameSize = _frameSize;
+@synthesize planeLayout = _planeLayout;
+@synthesize frameDuration = _frameDuration;
+
+#pragma mark -
+#pragma mark Initialization and teardown
+
+- (id)initWithURL:(NSURL *)newURL;
+{
+    if (!(self = [super init]))
+    {
+		return nil;
+    }
+
+    _url = newURL;
+    _planeLayout = kGPUImageYUVTriPlanar;
+    _frameDuration = CMTimeMake(1, 30);
+    hasHeaders = YES;
+
+    if (![self openFile])
+    {
+        return nil;
+    }
+
+    if (![self readStreamHeader])
+    {
+        NSLog(@"Not a 4:2:0 Y4M file: %@", newURL);
+        [self close];
+        return nil;
+    }
+
+    return self;
+}
+
+- (id)initWithRawVideoURL:(NSURL *)newURL frameSize:(CGSize)newFrameSize planeLayout:(GPUImageYUVPlaneLayout)newPlaneLayout frameDuration:(CMTime)newFrameDuration;
+{
+    if (!(self = [super init]))
+    {
+		return nil;
+    }
+
+    _url = newURL;
+    _frameSize = newFrameSize;
+    _planeLayout = newPlaneLayout;
+    _frameDuration = newFrameDuration;
+    hasHeaders = NO;
+    firstFrameOffset = 0;
+
+    if (![self openFile])
+    {
+        return nil;
+    }
+
+    return self;
+}
+
+- (void)dealloc;
+{
+    [self close];
+}
+
+#pragma mark -
+#pragma mark Parsing
+
+- (BOOL)openFile;
+{
+    videoFile = fopen([[_url path] fileSystemRepresentation], "rb");
+    if (videoFile == NULL)
+    {
+        NSLog(@"Error opening raw video at URL: %@", _url);
+        return NO;
+    }
+
+    return YES;
+}
+
+- (BOOL)readLineIntoBuffer:(char *)lineBuffer length:(size_t)bufferLength;
+{
+    if (fgets(lineBuffer, (int)bufferLength, videoFile) == NULL)
+    {
+        return NO;
+    }
+
+    size_t lineLength = strlen(lineBuffer);
+    if ((lineLength == 0) || (lineBuffer[lineLength - 1] != '\n'))
+    {
+        // Either the file ended mid-line or the line is longer than any valid header
+        return NO;
+    }
+
+    lineBuffer[lineLength - 1] = '\0';
+    return YES;
+}
+
+- (BOOL)readStreamHeader;
+{
+    char headerLine[GPUImageY4MMaximumHeaderLength];
+    if (![self readLineIntoBuffer:headerLine length:GPUImageY4MMaximumHeaderLength] || (strncmp(headerLine, "YUV4MPEG2", 9) != 0))
+    {
+        return NO;
+    }
+
+    int frameWidth = 0, frameHeight = 0;
+    int frameRateNumerator = 30, frameRateDenominator = 1;
+    BOOL isFourTwoZero = YES;
+
+    char *savePointer = NULL;
+    for (char *parameter = strtok_r(headerLine + 9, " ", &savePointer); parameter != NULL; parameter = strtok_r(NULL, " ", &savePointer))
+    {
+        switch (parameter[0])
+        {
+            case 'W': frameWidth = atoi(parameter + 1); break;
+            case 'H': frameHeight = atoi(parameter + 1); break;
+            case 'F': sscanf(parameter + 1, "%d:%d", &frameRateNumerator, &frameRateDenominator); break;
+            case 'C':
+            {
+                // These only differ in where chroma samples are sited, which is close enough for filtering, while other names are other subsamplings or bit depths
+                const char *colorSpace = parameter + 1;
+                isFourTwoZero = ((strcmp(colorSpace, "420") == 0) || (strcmp(colorSpace, "420jpeg") == 0) || (strcmp(colorSpace, "420paldv") == 0) || (strcmp(colorSpace, "420mpeg2") == 0));
+            }; break;
+            default: break;
+        }
+    }
+
+    if ((frameWidth <= 0) || (frameHeight <= 0) || (frameRateNumerator <= 0) || (frameRateDenominator <= 0) || !isFourTwoZero)
+    {
+        return NO;
+    }
+
+    _frameSize = CGSizeMake(frameWidth, frameHeight);
+    _frameDuration = CMTimeMake(frameRateDenominator, frameRateNumerator);
+    firstFrameOffset = ftell(videoFile);
+
+    return YES;
+}
+
+#pragma mark -
+#pragma mark GPUImageRawVideoReader protocol
+
+- (BOOL)openForReading;
+{
+    if ((videoFile == NULL) && ![self openFile])
+    {
+        return NO;
+    }
+
+    size_t frameWidth = (size_t)_frameSize.width;
+    size_t frameHeight = (size_t)_frameSize.height;
+    bytesPerFrame = (frameWidth * frameHeight) + (2 * ((frameWidth + 1) / 2) * ((frameHeight + 1) / 2));
+    currentFrameIndex = 0;
+
+    return (fseek(videoFile, firstFrameOffset, SEEK_SET) == 0);
+}
+
+- (BOOL)readNextFrameIntoBytes:(GLubyte *)frameBytes frameTime:(CMTime *)frameTime;
+{
+    if (videoFile == NULL)
+    {
+        return NO;
+    }
+
+    if (hasHeaders)
+    {
+        char frameHeader[GPUImageY4MMaximumHeaderLength];
+        if (![self readLineIntoBuffer:frameHeader length:GPUImageY4MMaximumHeaderLength] || (strncmp(frameHeader, "FRAME", 5) != 0))
+        {
+            return NO;
+        }
+    }
+
+    if (fread(frameBytes, 1, bytesPerFrame, videoFile) != bytesPerFrame)
+    {
+        return NO;
+    }
+
+    *frameTime = CMTimeMultiply(_frameDuration, (int32_t)currentFrameIndex);
+    currentFrameIndex++;
+
+    return YES;
+}
+
+- (void)close;
+{
+    if (videoFile != NULL)
+    {
+        fclose(videoFile);
+        videoFile = NULL;
+    }
+}
+
+@end
@@ -0,0 +1,27 @@
+#import <Foundation/Foundation.h>
+#import "GPUImageRawVideoOutput.h"
+
+/** Writes uncompressed 4:2:0 video to a YUV4MPEG2 (Y4M) file, or as headerless raw frames
+ 
+ Y4M files have a constant frame rate, so frames are written one after another in the order they arrive and their times are implied by frameDuration.
+ */
+@interface GPUImageY4MWriter : NSObject <GPUImageRawVideoWriter>
+
+@property(readonly, nonatomic) NSURL *url;
+@property(readonly, nonatomic) GPUImageYUVPlaneLayout planeLayout;
+
+/** The time between frames written into the Y4M header. Defaults to 1/30 of a second.
+ */
+@property(readwrite, nonatomic) CMTime frameDuration;
+
+// Initialization and teardown
+
+/** Writes a Y4M file, which always uses I420 planes
+ */
+- (id)initWithURL:(NSURL *)newURL;
+
+/** Writes bare frames with no headers, such as ffmpeg -f rawvideo reads
+ */
+- (id)initWithRawVideoURL:(NSURL *)newURL planeLayout:(GPUImageYUVPlaneLayout)newPlaneLayout;
+
+@end
@@ -0,0 +1,118 @@
+#import "GPUImageY4MWriter.h"
+#include <stdio.h>
+
+@interface GPUImageY4MWriter ()
+{
+    FILE *videoFile;
+    BOOL hasHeaders;
+    size_t bytesPerFrame;
+}
+
+@end
+
+@implementation GPUImageY4MWriter
+
+@synthesize url = _url;
+@synthesize planeLayout = _planeLayout;
+@synthesize frameDuration = _frameDuration;
+
+#pragma mark -
+#pragma mark Initialization and teardown
+
+- (id)initWithURL:(NSURL *)newURL;
+{
+    if (!(self = [super init]))
+    {
+		return nil;
+    }
+
+    _url = newURL;
+    _planeLayout = kGPUImageYUVTriPlanar;
+    _frameDuration = CMTimeMake(1, 30);
+    hasHeaders = YES;
+
+    return self;
+}
+
+- (id)initWithRawVideoURL:(NSURL *)newURL planeLayout:(GPUImageYUVPlaneLayout)newPlaneLayout;
+{
+    if (!(self = [super init]))
+    {
+		return nil;
+    }
+
+    _url = newURL;
+    _planeLayout = newPlaneLayout;
+    _frameDuration = CMTimeMake(1, 30);
+    hasHeaders = NO;
+
+    return self;
+}
+
+- (void)dealloc;
+{
+    [self close];
+}
+
+#pragma mark -
+#pragma mark GPUImageRawVideoWriter protocol
+
+- (BOOL)openForWritingWithFrameSize:(CGSize)frameSize;
+{
+    [self close];
+
+    videoFile = fopen([[_url path] fileSystemRepresentation], "wb");
+    if (videoFile == NULL)
+    {
+        NSLog(@"Error opening raw video for writing at URL: %@", _url);
+        return NO;
+    }
+
+    size_t frameWidth = (size_t)frameSize.width;
+    size_t frameHeight = (size_t)frameSize.height;
+    bytesPerFrame = (frameWidth * frameHeight) + (2 * ((frameWidth + 1) / 2) * ((frameHeight + 1) / 2));
+
+    if (hasHeaders)
+    {
+        // F is frames per second as a ratio, the inverse of the frame duration
+        if (fprintf(videoFile, "YUV4MPEG2 W%zu H%zu F%d:%lld Ip A1:1 C420jpeg\n", frameWidth, frameHeight, _frameDuration.timescale, _frameDuration.value) < 0)
+        {
+            [self close];
+            return NO;
+        }
+    }
+
+    return YES;
+}
+
+- (BOOL)isReadyForMoreFrames;
+{
+    // Writes block until they're done, so there's never a backlog to wait on
+    return (videoFile != NULL);
+}
+
+- (BOOL)appendFrameBytes:(const GLubyte *)frameBytes frameTime:(CMTime)frameTime;
+{
+    if (videoFile == NULL)
+    {
+        return NO;
+    }
+
+    if (hasHeaders && (fputs("FRAME\n", videoFile) == EOF))
+    {
+        return NO;
+    }
+
+    return (fwrite(frameBytes, 1, bytesPerFrame, videoFile) == bytesPerFrame);
+}
+
+- (void)close;
+{
+    if (videoFile != NULL)
+    {
+        fclose(videoFile);
+        videoFile = NULL;
+    }
+}
+
+@end
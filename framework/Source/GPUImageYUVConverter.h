@@ -0,0 +1,74 @@
+#import <Foundation/Foundation.h>
+#import <CoreVideo/CoreVideo.h>
+#import "GPUImageOpenGLESContext.h"
+
+extern NSString *const kGPUImageYUVBiPlanarConversionFragmentShaderString;
+extern NSString *const kGPUImageYUVTriPlanarConversionFragmentShaderString;
+
+typedef enum {
+    kGPUImageYUVBiPlanar,       // NV12: a full-size Y plane, then a half-size plane of interleaved Cb and Cr samples
+    kGPUImageYUVTriPlanar       // I420: a full-size Y plane, then half-size Cb and Cr planes
+} GPUImageYUVPlaneLayout;
+
+typedef enum {
+    kGPUImageYUVColorMatrixBT601,   // The standard for SDTV
+    kGPUImageYUVColorMatrixBT709    // The standard for HDTV
+} GPUImageYUVColorMatrix;
+
+/** Converts 4:2:0 YUV planes into an RGBA texture at the start of a filter chain
+
+ Sources that can get frames as YUV planes use this instead of having them converted to BGRA on the CPU, which also cuts the bytes uploaded per frame from 4 per pixel to 1.5. Planes can be textures from a CVOpenGLESTextureCache or be uploaded from bytes. Targets that want monochrome input can be handed the luminanceTexture directly, skipping conversion.
+
+ All methods need to be called on the video processing queue.
+ */
+@interface GPUImageYUVConverter : NSObject
+
+@property(readonly, nonatomic) GPUImageYUVPlaneLayout planeLayout;
+@property(readwrite, nonatomic) GPUImageYUVColorMatrix colorMatrix;
+
+/** Whether luma spans the full 0 - 255 range, rather than the 16 - 235 of video range. Defaults to NO.
+ */
+@property(readwrite, nonatomic) BOOL fullRange;
+
+/** The Y plane of the current frame
+
+ This can only stand in for monochrome output when fullRange is YES, since a video range plane hasn't been stretched out to 0 - 255.
+ */
+@property(readonly, nonatomic) GLuint luminanceTexture;
+
+/// @name Initialization and teardown
+
+- (id)initWithPlaneLayout:(GPUImageYUVPlaneLayout)newPlaneLayout;
+
+/// @name Supplying planes
+
+/** Picks the color matrix and range described by a pixel buffer's format and attachments. Buffers that don't say which matrix they use get BT.709 at HD sizes and BT.601 below that.
+ */
+- (void)matchColorSpaceOfPixelBuffer:(CVPixelBufferRef)pixelBuffer;
+
+- (NSUInteger)numberOfPlanes;
+
+/** Uses an existing texture for a plane, such as one from a CVOpenGLESTextureCache. The texture must stay valid until after the next conversion.
+ */
+- (void)setTexture:(GLuint)planeTexture forPlane:(NSUInteger)planeIndex;
+
+/** Uploads a plane into a texture owned by the converter, reusing the texture's storage while the plane's size stays the same
+
+ @param planeIndex 0 for Y, then 1 for interleaved CbCr, or 1 for Cb and 2 for Cr
+ @param planeBytes The plane's samples
+ @param planeWidth The width of the plane in samples, which is half the frame width for chroma planes
+ @param planeHeight The height of the plane in rows
+ @param bytesPerRow The distance between the starts of consecutive rows, which can include padding
+ */
+- (void)uploadPlane:(NSUInteger)planeIndex fromBytes:(const GLubyte *)planeBytes width:(int)planeWidth height:(int)planeHeight bytesPerRow:(size_t)bytesPerRow;
+
+/// @name Conversion
+
+/** Renders the current planes into an RGBA texture
+
+ @param outputTexture A texture that already has storage of frameSize
+ @param frameSize The size of the full frame in pixels
+ */
+- (void)convertToTexture:(GLuint)outputTexture ofSize:(CGSize)frameSize;
+
+@end
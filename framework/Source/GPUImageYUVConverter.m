@@ -0,0 +1,367 @@
+#import "GPUImageYUVConverter.h"
+#import "GPUImageFilter.h"
+
+#define GPUImageYUVMaximumPlanes 3
+
+NSString *const kGPUImageYUVBiPlanarConversionFragmentShaderString = SHADER_STRING
+(
+ varying highp vec2 textureCoordinate;
+
+ uniform sampler2D luminanceTexture;
+ uniform sampler2D chrominanceTexture;
+ uniform mediump mat3 colorConversionMatrix;
+ uniform mediump vec3 colorConversionOffset;
+
+ void main()
+ {
+     mediump vec3 yuv;
+     lowp vec3 rgb;
+
+     yuv.x = texture2D(luminanceTexture, textureCoordinate).r;
+     yuv.yz = texture2D(chrominanceTexture, textureCoordinate).ra;
+
+     rgb = colorConversionMatrix * (yuv - colorConversionOffset);
+
+     gl_FragColor = vec4(rgb, 1);
+ }
+);
+
+NSString *const kGPUImageYUVTriPlanarConversionFragmentShaderString = SHADER_STRING
+(
+ varying highp vec2 textureCoordinate;
+
+ uniform sampler2D luminanceTexture;
+ uniform sampler2D blueDifferenceTexture;
+ uniform sampler2D redDifferenceTexture;
+ uniform mediump mat3 colorConversionMatrix;
+ uniform mediump vec3 colorConversionOffset;
+
+ void main()
+ {
+     mediump vec3 yuv;
+     lowp vec3 rgb;
+
+     yuv.x = texture2D(luminanceTexture, textureCoordinate).r;
+     yuv.y = texture2D(blueDifferenceTexture, textureCoordinate).r;
+     yuv.z = texture2D(redDifferenceTexture, textureCoordinate).r;
+
+     rgb = colorConversionMatrix * (yuv - colorConversionOffset);
+
+     gl_FragColor = vec4(rgb, 1);
+ }
+);
+
+@interface GPUImageYUVConverter()
+{
+    GLProgram *conversionProgram;
+    GLint conversionPositionAttribute, conversionTextureCoordinateAttribute;
+    GLint conversionMatrixUniform, conversionOffsetUniform;
+    GLint planeTextureUniforms[GPUImageYUVMaximumPlanes];
+    GLuint conversionFramebuffer;
+
+    GLuint planeTextures[GPUImageYUVMaximumPlanes];
+    GLuint uploadedPlaneTextures[GPUImageYUVMaximumPlanes];
+    CGSize uploadedPlaneSizes[GPUImageYUVMaximumPlanes];
+
+    GLfloat conversionMatrix[9];
+    GLfloat conversionOffset[3];
+}
+
+- (void)calculateConversionMatrix;
+- (GLenum)textureFormatForPlane:(NSUInteger)planeIndex;
+
+@end
+
+@implementation GPUImageYUVConverter
+
+@synthesize planeLayout = _planeLayout;
+@synthesize colorMatrix = _colorMatrix;
+@synthesize fullRange = _fullRange;
+
+#pragma mark -
+#pragma mark Initialization and teardown
+
+- (id)initWithPlaneLayout:(GPUImageYUVPlaneLayout)newPlaneLayout;
+{
+    if (!(self = [super init]))
+    {
+		return nil;
+    }
+
+    _planeLayout = newPlaneLayout;
+    _colorMatrix = kGPUImageYUVColorMatrixBT709;
+    _fullRange = NO;
+    [self calculateConversionMatrix];
+
+    runSynchronouslyOnVideoProcessingQueue(^{
+        [GPUImageOpenGLESContext useImageProcessingContext];
+
+        NSString *fragmentShaderString = (_planeLayout == kGPUImageYUVBiPlanar) ? kGPUImageYUVBiPlanarConversionFragmentShaderString : kGPUImageYUVTriPlanarConversionFragmentShaderString;
+        conversionProgram = [[GPUImageOpenGLESContext sharedImageProcessingOpenGLESContext] programForVertexShaderString:kGPUImageVertexShaderString fragmentShaderString:fragmentShaderString];
+
+        if (!conversionProgram.initialized)
+        {
+            [conversionProgram addAttribute:@"position"];
+            [conversionProgram addAttribute:@"inputTextureCoordinate"];
+
+            if (![conversionProgram link])
+            {
+                NSString *progLog = [conversionProgram programLog];
+                NSLog(@"Program link log: %@", progLog);
+                NSString *fragLog = [conversionProgram fragmentShaderLog];
+                NSLog(@"Fragment shader compile log: %@", fragLog);
+                NSString *vertLog = [conversionProgram vertexShaderLog];
+                NSLog(@"Vertex shader compile log: %@", vertLog);
+                conversionProgram = nil;
+                NSAssert(NO, @"Filter shader link failed");
+            }
+        }
+
+        conversionPositionAttribute = [conversionProgram attributeIndex:@"position"];
+        conversionTextureCoordinateAttribute = [conversionProgram attributeIndex:@"inputTextureCoordinate"];
+        conversionMatrixUniform = [conversionProgram uniformIndex:@"colorConversionMatrix"];
+        conversionOffsetUniform = [conversionProgram uniformIndex:@"colorConversionOffset"];
+
+        planeTextureUniforms[0] = [conversionProgram uniformIndex:@"luminanceTexture"];
+        if (_planeLayout == kGPUImageYUVBiPlanar)
+        {
+            planeTextureUniforms[1] = [conversionProgram uniformIndex:@"chrominanceTexture"];
+        }
+        else
+        {
+            planeTextureUniforms[1] = [conversionProgram uniformIndex:@"blueDifferenceTexture"];
+            planeTextureUniforms[2] = [conversionProgram uniformIndex:@"redDifferenceTexture"];
+        }
+
+        [GPUImageOpenGLESContext setActiveShaderProgram:conversionProgram];
+
+        glEnableVertexAttribArray(conversionPositionAttribute);
+        glEnableVertexAttribArray(conversionTextureCoordinateAttribute);
+    });
+
+    return self;
+}
+
+- (void)dealloc;
+{
+    runSynchronouslyOnVideoProcessingQueue(^{
+        [GPUImageOpenGLESContext useImageProcessingContext];
+
+        if (conversionFramebuffer)
+        {
+            glDeleteFramebuffers(1, &conversionFramebuffer);
+            conversionFramebuffer = 0;
+        }
+
+        for (NSUInteger planeIndex = 0; planeIndex < GPUImageYUVMaximumPlanes; planeIndex++)
+        {
+            if (uploadedPlaneTextures[planeIndex])
+            {
+                glDeleteTextures(1, &uploadedPlaneTextures[planeIndex]);
+                uploadedPlaneTextures[planeIndex] = 0;
+            }
+        }
+    });
+}
+
+#pragma mark -
+#pragma mark Supplying planes
+
+- (void)matchColorSpaceOfPixelBuffer:(CVPixelBufferRef)pixelBuffer;
+{
+    self.fullRange = (CVPixelBufferGetPixelFormatType(pixelBuffer) == kCVPixelFormatType_420YpCbCr8BiPlanarFullRange);
+
+    CFTypeRef matrixAttachment = CVBufferGetAttachment(pixelBuffer, kCVImageBufferYCbCrMatrixKey, NULL);
+    if (matrixAttachment != NULL)
+    {
+        self.colorMatrix = CFEqual(matrixAttachment, kCVImageBufferYCbCrMatrix_ITU_R_601_4) ? kGPUImageYUVColorMatrixBT601 : kGPUImageYUVColorMatrixBT709;
+    }
+    else
+    {
+        self.colorMatrix = (CVPixelBufferGetHeight(pixelBuffer) >= 720) ? kGPUImageYUVColorMatrixBT709 : kGPUImageYUVColorMatrixBT601;
+    }
+}
+
+- (NSUInteger)numberOfPlanes;
+{
+    return (_planeLayout == kGPUImageYUVBiPlanar) ? 2 : 3;
+}
+
+- (void)setTexture:(GLuint)planeTexture forPlane:(NSUInteger)planeIndex;
+{
+    NSAssert(planeIndex < [self numberOfPlanes], @"Plane %d is out of range for this layout", planeIndex);
+
+    planeTextures[planeIndex] = planeTexture;
+}
+
+- (void)uploadPlane:(NSUInteger)planeIndex fromBytes:(const GLubyte *)planeBytes width:(int)planeWidth height:(int)planeHeight bytesPerRow:(size_t)bytesPerRow;
+{
+    NSAssert(planeIndex < [self numberOfPlanes], @"Plane %d is out of range for this layout", planeIndex);
+
+    GLenum planeFormat = [self textureFormatForPlane:planeIndex];
+    size_t packedBytesPerRow = (size_t)planeWidth * ((planeFormat == GL_LUMINANCE_ALPHA) ? 2 : 1);
+
+    if (!uploadedPlaneTextures[planeIndex])
+    {
+        glActiveTexture(GL_TEXTURE4 + planeIndex);
+        glGenTextures(1, &uploadedPlaneTextures[planeIndex]);
+        glBindTexture(GL_TEXTURE_2D, uploadedPlaneTextures[planeIndex]);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    }
+    else
+    {
+        glActiveTexture(GL_TEXTURE4 + planeIndex);
+        glBindTexture(GL_TEXTURE_2D, uploadedPlaneTextures[planeIndex]);
+    }
+
+    // OpenGL ES 2.0 has no GL_UNPACK_ROW_LENGTH, so rows with padding at their ends need to be packed together first
+    const GLubyte *bytesToUpload = planeBytes;
+    GLubyte *packedBytes = NULL;
+    if (bytesPerRow != packedBytesPerRow)
+    {
+        packedBytes = (GLubyte *) malloc(packedBytesPerRow * planeHeight);
+        for (int currentRow = 0; currentRow < planeHeight; currentRow++)
+        {
+            memcpy(packedBytes + (currentRow * packedBytesPerRow), planeBytes + (currentRow * bytesPerRow), packedBytesPerRow);
+        }
+        bytesToUpload = packedBytes;
+    }
+
+    // Plane rows are rarely a multiple of 4 bytes long
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    CGSize planeSize = CGSizeMake(planeWidth, planeHeight);
+    if (CGSizeEqualToSize(uploadedPlaneSizes[planeIndex], planeSize))
+    {
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, planeWidth, planeHeight, planeFormat, GL_UNSIGNED_BYTE, bytesToUpload);
+    }
+    else
+    {
+        glTexImage2D(GL_TEXTURE_2D, 0, planeFormat, planeWidth, planeHeight, 0, planeFormat, GL_UNSIGNED_BYTE, bytesToUpload);
+        uploadedPlaneSizes[planeIndex] = planeSize;
+    }
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    free(packedBytes);
+
+    planeTextures[planeIndex] = uploadedPlaneTextures[planeIndex];
+}
+
+- (GLenum)textureFormatForPlane:(NSUInteger)planeIndex;
+{
+    // Interleaved CbCr samples land in the luminance and alpha channels, which the shader reads as .r and .a
+    return ((_planeLayout == kGPUImageYUVBiPlanar) && (planeIndex == 1)) ? GL_LUMINANCE_ALPHA : GL_LUMINANCE;
+}
+
+#pragma mark -
+#pragma mark Conversion
+
+- (void)calculateConversionMatrix;
+{
+    GLfloat redWeight, blueWeight;
+    if (_colorMatrix == kGPUImageYUVColorMatrixBT601)
+    {
+        redWeight = 0.299;
+        blueWeight = 0.114;
+    }
+    else
+    {
+        redWeight = 0.2126;
+        blueWeight = 0.0722;
+    }
+    GLfloat greenWeight = 1.0 - redWeight - blueWeight;
+
+    // Video range puts luma between 16 and 235 and chroma between 16 and 240, so those get stretched back out to the full range here
+    GLfloat luminanceScale = _fullRange ? 1.0 : (255.0 / 219.0);
+    GLfloat chrominanceScale = _fullRange ? 1.0 : (255.0 / 224.0);
+
+    // Column-major, with columns for Y, Cb, and Cr
+    conversionMatrix[0] = luminanceScale;
+    conversionMatrix[1] = luminanceScale;
+    conversionMatrix[2] = luminanceScale;
+    conversionMatrix[3] = 0.0;
+    conversionMatrix[4] = -chrominanceScale * 2.0 * blueWeight * (1.0 - blueWeight) / greenWeight;
+    conversionMatrix[5] = chrominanceScale * 2.0 * (1.0 - blueWeight);
+    conversionMatrix[6] = chrominanceScale * 2.0 * (1.0 - redWeight);
+    conversionMatrix[7] = -chrominanceScale * 2.0 * redWeight * (1.0 - redWeight) / greenWeight;
+    conversionMatrix[8] = 0.0;
+
+    conversionOffset[0] = _fullRange ? 0.0 : (16.0 / 255.0);
+    conversionOffset[1] = 0.5;
+    conversionOffset[2] = 0.5;
+}
+
+- (void)convertToTexture:(GLuint)outputTexture ofSize:(CGSize)frameSize;
+{
+    [GPUImageOpenGLESContext setActiveShaderProgram:conversionProgram];
+
+    if (!conversionFramebuffer)
+    {
+        glGenFramebuffers(1, &conversionFramebuffer);
+    }
+
+    // The output texture is attached every time, because its owner may have deleted and recreated it since the last conversion
+    glBindFramebuffer(GL_FRAMEBUFFER, conversionFramebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, outputTexture, 0);
+    NSAssert(glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE, @"Incomplete YUV conversion FBO");
+
+    glViewport(0, 0, (int)frameSize.width, (int)frameSize.height);
+
+    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    static const GLfloat squareVertices[] = {
+        -1.0f, -1.0f,
+        1.0f, -1.0f,
+        -1.0f,  1.0f,
+        1.0f,  1.0f,
+    };
+
+    static const GLfloat textureCoordinates[] = {
+        0.0f, 0.0f,
+        1.0f, 0.0f,
+        0.0f, 1.0f,
+        1.0f, 1.0f,
+    };
+
+    for (NSUInteger planeIndex = 0; planeIndex < [self numberOfPlanes]; planeIndex++)
+    {
+        glActiveTexture(GL_TEXTURE4 + planeIndex);
+        glBindTexture(GL_TEXTURE_2D, planeTextures[planeIndex]);
+        glUniform1i(planeTextureUniforms[planeIndex], 4 + planeIndex);
+    }
+
+    glUniformMatrix3fv(conversionMatrixUniform, 1, GL_FALSE, conversionMatrix);
+    glUniform3fv(conversionOffsetUniform, 1, conversionOffset);
+
+    glVertexAttribPointer(conversionPositionAttribute, 2, GL_FLOAT, 0, 0, squareVertices);
+    glVertexAttribPointer(conversionTextureCoordinateAttribute, 2, GL_FLOAT, 0, 0, textureCoordinates);
+
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+}
+
+#pragma mark -
+#pragma mark Accessors
+
+- (GLuint)luminanceTexture;
+{
+    return planeTextures[0];
+}
+
+- (void)setColorMatrix:(GPUImageYUVColorMatrix)newValue;
+{
+    _colorMatrix = newValue;
+    [self calculateConversionMatrix];
+}
+
+- (void)setFullRange:(BOOL)newValue;
+{
+    _fullRange = newValue;
+    [self calculateConversionMatrix];
+}
+
+@end
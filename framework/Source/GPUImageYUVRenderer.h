@@ -0,0 +1,65 @@
+#import <Foundation/Foundation.h>
+#import "GPUImageOpenGLESContext.h"
+#import "GPUImageYUVConverter.h"
+
+extern NSString *const kGPUImageRGBToYUVPlaneFragmentShaderString;
+extern NSString *const kGPUImageRGBToYUVPackedComponentFragmentShaderString;
+extern NSString *const kGPUImageRGBToYUVPackedChrominancePairFragmentShaderString;
+
+/** Renders an RGBA texture out as 4:2:0 YUV planes at the end of a filter chain
+
+ This is the reverse of GPUImageYUVConverter. Doing the conversion on the GPU means that outputs read back or encode 1.5 bytes per pixel instead of 4, and encoders don't have to convert colorspaces themselves. Planes can either be drawn into single- and two-channel textures, such as the red and red-green planes of a CVPixelBuffer wrapped by a CVOpenGLESTextureCache, or be drawn four samples to an RGBA texel and read back into memory on devices without those texture formats.
+
+ All methods need to be called on the video processing queue.
+ */
+@interface GPUImageYUVRenderer : NSObject
+
+@property(readonly, nonatomic) GPUImageYUVPlaneLayout planeLayout;
+
+/** The color matrix to encode with. Defaults to kGPUImageYUVColorMatrixBT709.
+ */
+@property(readwrite, nonatomic) GPUImageYUVColorMatrix colorMatrix;
+
+/** Whether to spread luma across the full 0 - 255 range, rather than the 16 - 235 of video range that encoders expect. Defaults to NO.
+ */
+@property(readwrite, nonatomic) BOOL fullRange;
+
+/// @name Initialization and teardown
+
+- (id)initWithPlaneLayout:(GPUImageYUVPlaneLayout)newPlaneLayout;
+
+/// @name Plane geometry
+
+- (NSUInteger)numberOfPlanes;
+
+/** The width and height of a plane in samples, where chroma planes are half the size of the frame in each direction, rounded up
+ */
+- (CGSize)sizeOfPlane:(NSUInteger)planeIndex forFrameSize:(CGSize)frameSize;
+
+/** The bytes in one row of a plane with no padding
+ */
+- (size_t)bytesPerRowOfPlane:(NSUInteger)planeIndex forFrameSize:(CGSize)frameSize;
+
+/// @name Rendering planes
+
+/** Draws one plane into a texture of that plane's size
+
+ The Y plane and the planes of I420 need a single-channel (GL_RED_EXT) texture, and the interleaved CbCr plane of NV12 needs a two-channel (GL_RG_EXT) one.
+
+ @param inputTexture The RGBA frame, with its first row at the top
+ @param planeIndex 0 for Y, then 1 for interleaved CbCr, or 1 for Cb and 2 for Cr
+ @param planeTexture The texture to draw into
+ @param frameSize The size of the full frame in pixels
+ */
+- (void)renderTexture:(GLuint)inputTexture intoPlane:(NSUInteger)planeIndex texture:(GLuint)planeTexture frameSize:(CGSize)frameSize;
+
+/** Draws every plane packed four bytes to an RGBA texel and reads them all back
+
+ @param inputTexture The RGBA frame, with its first row at the top
+ @param frameSize The size of the full frame in pixels
+ @param planeBytes Where each plane should be written
+ @param bytesPerRow The row stride of each destination plane, which needs to be at least bytesPerRowOfPlane:forFrameSize:
+ */
+- (void)readPlanesFromTexture:(GLuint)inputTexture frameSize:(CGSize)frameSize intoBytes:(GLubyte **)planeBytes bytesPerRow:(const size_t *)bytesPerRow;
+
+@end
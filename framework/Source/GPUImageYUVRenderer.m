@@ -0,0 +1,449 @@
+#import "GPUImageYUVRenderer.h"
+#import "GPUImageFilter.h"
+
+#define GPUImageYUVMaximumPlanes 3
+
+NSString *const kGPUImageRGBToYUVPlaneFragmentShaderString = SHADER_STRING
+(
+ varying highp vec2 textureCoordinate;
+
+ uniform sampler2D inputImageTexture;
+ uniform mediump mat3 colorConversionMatrix;
+ uniform mediump vec3 colorConversionOffset;
+ uniform mediump vec3 firstComponent;
+ uniform mediump vec3 secondComponent;
+
+ void main()
+ {
+     mediump vec3 yuv = colorConversionMatrix * texture2D(inputImageTexture, textureCoordinate).rgb + colorConversionOffset;
+
+     gl_FragColor = vec4(dot(yuv, firstComponent), dot(yuv, secondComponent), 0.0, 1.0);
+ }
+);
+
+NSString *const kGPUImageRGBToYUVPackedComponentFragmentShaderString = SHADER_STRING
+(
+ varying highp vec2 textureCoordinate;
+
+ uniform sampler2D inputImageTexture;
+ uniform mediump mat3 colorConversionMatrix;
+ uniform mediump vec3 colorConversionOffset;
+ uniform mediump vec3 firstComponent;
+ uniform highp float packedWidth;
+ uniform highp float planeWidth;
+
+ void main()
+ {
+     // Each output texel holds four horizontally adjacent samples of the plane
+     highp float sampleStep = 1.0 / planeWidth;
+     highp float firstSampleX = (floor(textureCoordinate.x * packedWidth) * 4.0 + 0.5) * sampleStep;
+
+     mediump vec4 packedSamples;
+     packedSamples.r = dot(colorConversionMatrix * texture2D(inputImageTexture, vec2(firstSampleX, textureCoordinate.y)).rgb + colorConversionOffset, firstComponent);
+     packedSamples.g = dot(colorConversionMatrix * texture2D(inputImageTexture, vec2(firstSampleX + sampleStep, textureCoordinate.y)).rgb + colorConversionOffset, firstComponent);
+     packedSamples.b = dot(colorConversionMatrix * texture2D(inputImageTexture, vec2(firstSampleX + 2.0 * sampleStep, textureCoordinate.y)).rgb + colorConversionOffset, firstComponent);
+     packedSamples.a = dot(colorConversionMatrix * texture2D(inputImageTexture, vec2(firstSampleX + 3.0 * sampleStep, textureCoordinate.y)).rgb + colorConversionOffset, firstComponent);
+
+     gl_FragColor = packedSamples;
+ }
+);
+
+NSString *const kGPUImageRGBToYUVPackedChrominancePairFragmentShaderString = SHADER_STRING
+(
+ varying highp vec2 textureCoordinate;
+
+ uniform sampler2D inputImageTexture;
+ uniform mediump mat3 colorConversionMatrix;
+ uniform mediump vec3 colorConversionOffset;
+ uniform highp float packedWidth;
+ uniform highp float planeWidth;
+
+ void main()
+ {
+     // Each output texel holds two horizontally adjacent CbCr pairs
+     highp float sampleStep = 1.0 / planeWidth;
+     highp float firstSampleX = (floor(textureCoordinate.x * packedWidth) * 2.0 + 0.5) * sampleStep;
+
+     mediump vec3 firstYUV = colorConversionMatrix * texture2D(inputImageTexture, vec2(firstSampleX, textureCoordinate.y)).rgb + colorConversionOffset;
+     mediump vec3 secondYUV = colorConversionMatrix * texture2D(inputImageTexture, vec2(firstSampleX + sampleStep, textureCoordinate.y)).rgb + colorConversionOffset;
+
+     gl_FragColor = vec4(firstYUV.yz, secondYUV.yz);
+ }
+);
+
+@interface GPUImageYUVRenderer()
+{
+    GLProgram *planeProgram, *packedComponentProgram, *packedChrominancePairProgram;
+
+    GLuint planeFramebuffer;
+    GLuint packedFramebuffers[GPUImageYUVMaximumPlanes], packedTextures[GPUImageYUVMaximumPlanes];
+    CGSize packedTextureSizes[GPUImageYUVMaximumPlanes];
+    GLubyte *packedRowBuffer;
+    size_t packedRowBufferLength;
+
+    GLfloat conversionMatrix[9];
+    GLfloat conversionOffset[3];
+}
+
+- (GLProgram *)linkedProgramForFragmentShaderString:(NSString *)fragmentShaderString;
+- (void)calculateConversionMatrix;
+- (void)getComponentsOfPlane:(NSUInteger)planeIndex first:(GLfloat *)firstComponent second:(GLfloat *)secondComponent;
+- (BOOL)planeHasChrominancePairs:(NSUInteger)planeIndex;
+- (CGSize)packedSizeOfPlane:(NSUInteger)planeIndex forFrameSize:(CGSize)frameSize;
+- (void)drawTexture:(GLuint)inputTexture withProgram:(GLProgram *)program;
+
+@end
+
+@implementation GPUImageYUVRenderer
+
+@synthesize planeLayout = _planeLayout;
+@synthesize colorMatrix = _colorMatrix;
+@synthesize fullRange = _fullRange;
+
+#pragma mark -
+#pragma mark Initialization and teardown
+
+- (id)initWithPlaneLayout:(GPUImageYUVPlaneLayout)newPlaneLayout;
+{
+    if (!(self = [super init]))
+    {
+		return nil;
+    }
+
+    _planeLayout = newPlaneLayout;
+    _colorMatrix = kGPUImageYUVColorMatrixBT709;
+    _fullRange = NO;
+    [self calculateConversionMatrix];
+
+    runSynchronouslyOnVideoProcessingQueue(^{
+        [GPUImageOpenGLESContext useImageProcessingContext];
+
+        planeProgram = [self linkedProgramForFragmentShaderString:kGPUImageRGBToYUVPlaneFragmentShaderString];
+        packedComponentProgram = [self linkedProgramForFragmentShaderString:kGPUImageRGBToYUVPackedComponentFragmentShaderString];
+        if (_planeLayout == kGPUImageYUVBiPlanar)
+        {
+            packedChrominancePairProgram = [self linkedProgramForFragmentShaderString:kGPUImageRGBToYUVPackedChrominancePairFragmentShaderString];
+        }
+    });
+
+    return self;
+}
+
+- (void)dealloc;
+{
+    runSynchronouslyOnVideoProcessingQueue(^{
+        [GPUImageOpenGLESContext useImageProcessingContext];
+
+        if (planeFramebuffer)
+        {
+            glDeleteFramebuffers(1, &planeFramebuffer);
+            planeFramebuffer = 0;
+        }
+
+        for (NSUInteger planeIndex = 0; planeIndex < GPUImageYUVMaximumPlanes; planeIndex++)
+        {
+            if (packedFramebuffers[planeIndex])
+            {
+                glDeleteFramebuffers(1, &packedFramebuffers[planeIndex]);
+                packedFramebuffers[planeIndex] = 0;
+            }
+
+            if (packedTextures[planeIndex])
+            {
+                glDeleteTextures(1, &packedTextures[planeIndex]);
+                packedTextures[planeIndex] = 0;
+            }
+        }
+    });
+
+    free(packedRowBuffer);
+}
+
+- (GLProgram *)linkedProgramForFragmentShaderString:(NSString *)fragmentShaderString;
+{
+    GLProgram *program = [[GPUImageOpenGLESContext sharedImageProcessingOpenGLESContext] programForVertexShaderString:kGPUImageVertexShaderString fragmentShaderString:fragmentShaderString];
+
+    if (!program.initialized)
+    {
+        [program addAttribute:@"position"];
+        [program addAttribute:@"inputTextureCoordinate"];
+
+        if (![program link])
+        {
+            NSString *progLog = [program programLog];
+            NSLog(@"Program link log: %@", progLog);
+            NSString *fragLog = [program fragmentShaderLog];
+            NSLog(@"Fragment shader compile log: %@", fragLog);
+            NSString *vertLog = [program vertexShaderLog];
+            NSLog(@"Vertex shader compile log: %@", vertLog);
+            program = nil;
+            NSAssert(NO, @"Filter shader link failed");
+        }
+    }
+
+    [GPUImageOpenGLESContext setActiveShaderProgram:program];
+
+    glEnableVertexAttribArray([program attributeIndex:@"position"]);
+    glEnableVertexAttribArray([program attributeIndex:@"inputTextureCoordinate"]);
+
+    return program;
+}
+
+#pragma mark -
+#pragma mark Plane geometry
+
+- (NSUInteger)numberOfPlanes;
+{
+    return (_planeLayout == kGPUImageYUVBiPlanar) ? 2 : 3;
+}
+
+- (CGSize)sizeOfPlane:(NSUInteger)planeIndex forFrameSize:(CGSize)frameSize;
+{
+    if (planeIndex == 0)
+    {
+        return frameSize;
+    }
+
+    return CGSizeMake(ceil(frameSize.width / 2.0), ceil(frameSize.height / 2.0));
+}
+
+- (size_t)bytesPerRowOfPlane:(NSUInteger)planeIndex forFrameSize:(CGSize)frameSize;
+{
+    size_t samplesPerRow = (size_t)[self sizeOfPlane:planeIndex forFrameSize:frameSize].width;
+    return [self planeHasChrominancePairs:planeIndex] ? (samplesPerRow * 2) : samplesPerRow;
+}
+
+- (BOOL)planeHasChrominancePairs:(NSUInteger)planeIndex;
+{
+    return ((_planeLayout == kGPUImageYUVBiPlanar) && (planeIndex == 1));
+}
+
+- (CGSize)packedSizeOfPlane:(NSUInteger)planeIndex forFrameSize:(CGSize)frameSize;
+{
+    CGSize planeSize = [self sizeOfPlane:planeIndex forFrameSize:frameSize];
+    CGFloat samplesPerTexel = [self planeHasChrominancePairs:planeIndex] ? 2.0 : 4.0;
+
+    return CGSizeMake(ceil(planeSize.width / samplesPerTexel), planeSize.height);
+}
+
+- (void)getComponentsOfPlane:(NSUInteger)planeIndex first:(GLfloat *)firstComponent second:(GLfloat *)secondComponent;
+{
+    for (NSUInteger componentIndex = 0; componentIndex < 3; componentIndex++)
+    {
+        firstComponent[componentIndex] = 0.0;
+        secondComponent[componentIndex] = 0.0;
+    }
+
+    if (planeIndex == 0)
+    {
+        firstComponent[0] = 1.0;
+    }
+    else if ([self planeHasChrominancePairs:planeIndex])
+    {
+        firstComponent[1] = 1.0;
+        secondComponent[2] = 1.0;
+    }
+    else
+    {
+        // Cb for the second plane of I420, Cr for the third
+        firstComponent[planeIndex] = 1.0;
+    }
+}
+
+#pragma mark -
+#pragma mark Rendering planes
+
+- (void)calculateConversionMatrix;
+{
+    GLfloat redWeight, blueWeight;
+    if (_colorMatrix == kGPUImageYUVColorMatrixBT601)
+    {
+        redWeight = 0.299;
+        blueWeight = 0.114;
+    }
+    else
+    {
+        redWeight = 0.2126;
+        blueWeight = 0.0722;
+    }
+    GLfloat greenWeight = 1.0 - redWeight - blueWeight;
+
+    // Video range squeezes luma into 16 - 235 and chroma into 16 - 240
+    GLfloat luminanceScale = _fullRange ? 1.0 : (219.0 / 255.0);
+    GLfloat blueDifferenceScale = (_fullRange ? 1.0 : (224.0 / 255.0)) / (2.0 * (1.0 - blueWeight));
+    GLfloat redDifferenceScale = (_fullRange ? 1.0 : (224.0 / 255.0)) / (2.0 * (1.0 - redWeight));
+
+    // Column-major, with columns for R, G, and B and rows for Y, Cb, and Cr
+    conversionMatrix[0] = luminanceScale * redWeight;
+    conversionMatrix[1] = -blueDifferenceScale * redWeight;
+    conversionMatrix[2] = redDifferenceScale * (1.0 - redWeight);
+    conversionMatrix[3] = luminanceScale * greenWeight;
+    conversionMatrix[4] = -blueDifferenceScale * greenWeight;
+    conversionMatrix[5] = -redDifferenceScale * greenWeight;
+    conversionMatrix[6] = luminanceScale * blueWeight;
+    conversionMatrix[7] = blueDifferenceScale * (1.0 - blueWeight);
+    conversionMatrix[8] = -redDifferenceScale * blueWeight;
+
+    conversionOffset[0] = _fullRange ? 0.0 : (16.0 / 255.0);
+    conversionOffset[1] = 0.5;
+    conversionOffset[2] = 0.5;
+}
+
+- (void)drawTexture:(GLuint)inputTexture withProgram:(GLProgram *)program;
+{
+    static const GLfloat squareVertices[] = {
+        -1.0f, -1.0f,
+        1.0f, -1.0f,
+        -1.0f,  1.0f,
+        1.0f,  1.0f,
+    };
+
+    static const GLfloat textureCoordinates[] = {
+        0.0f, 0.0f,
+        1.0f, 0.0f,
+        0.0f, 1.0f,
+        1.0f, 1.0f,
+    };
+
+	glActiveTexture(GL_TEXTURE4);
+	glBindTexture(GL_TEXTURE_2D, inputTexture);
+	glUniform1i([program uniformIndex:@"inputImageTexture"], 4);
+
+    glUniformMatrix3fv([program uniformIndex:@"colorConversionMatrix"], 1, GL_FALSE, conversionMatrix);
+    glUniform3fv([program uniformIndex:@"colorConversionOffset"], 1, conversionOffset);
+
+    glVertexAttribPointer([program attributeIndex:@"position"], 2, GL_FLOAT, 0, 0, squareVertices);
+	glVertexAttribPointer([program attributeIndex:@"inputTextureCoordinate"], 2, GL_FLOAT, 0, 0, textureCoordinates);
+
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+}
+
+- (void)renderTexture:(GLuint)inputTexture intoPlane:(NSUInteger)planeIndex texture:(GLuint)planeTexture frameSize:(CGSize)frameSize;
+{
+    NSAssert(planeIndex < [self numberOfPlanes], @"Plane %d is out of range for this layout", planeIndex);
+
+    [GPUImageOpenGLESContext setActiveShaderProgram:planeProgram];
+
+    if (!planeFramebuffer)
+    {
+        glGenFramebuffers(1, &planeFramebuffer);
+    }
+
+    // Plane textures usually come from a texture cache and change from frame to frame, so they're attached each time
+    glBindFramebuffer(GL_FRAMEBUFFER, planeFramebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, planeTexture, 0);
+    NSAssert(glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE, @"Incomplete YUV plane FBO");
+
+    CGSize planeSize = [self sizeOfPlane:planeIndex forFrameSize:frameSize];
+    glViewport(0, 0, (int)planeSize.width, (int)planeSize.height);
+
+    GLfloat firstComponent[3], secondComponent[3];
+    [self getComponentsOfPlane:planeIndex first:firstComponent second:secondComponent];
+    glUniform3fv([planeProgram uniformIndex:@"firstComponent"], 1, firstComponent);
+    glUniform3fv([planeProgram uniformIndex:@"secondComponent"], 1, secondComponent);
+
+    [self drawTexture:inputTexture withProgram:planeProgram];
+}
+
+- (void)readPlanesFromTexture:(GLuint)inputTexture frameSize:(CGSize)frameSize intoBytes:(GLubyte **)planeBytes bytesPerRow:(const size_t *)bytesPerRow;
+{
+    NSUInteger numberOfPlanes = [self numberOfPlanes];
+
+    // Draw every plane before reading any back, so that the GPU only has to be waited on once
+    for (NSUInteger planeIndex = 0; planeIndex < numberOfPlanes; planeIndex++)
+    {
+        CGSize planeSize = [self sizeOfPlane:planeIndex forFrameSize:frameSize];
+        CGSize packedSize = [self packedSizeOfPlane:planeIndex forFrameSize:frameSize];
+
+        if (!packedFramebuffers[planeIndex])
+        {
+            glGenFramebuffers(1, &packedFramebuffers[planeIndex]);
+            glGenTextures(1, &packedTextures[planeIndex]);
+
+            glActiveTexture(GL_TEXTURE1);
+            glBindTexture(GL_TEXTURE_2D, packedTextures[planeIndex]);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        }
+
+        glBindFramebuffer(GL_FRAMEBUFFER, packedFramebuffers[planeIndex]);
+
+        if (!CGSizeEqualToSize(packedTextureSizes[planeIndex], packedSize))
+        {
+            glActiveTexture(GL_TEXTURE1);
+            glBindTexture(GL_TEXTURE_2D, packedTextures[planeIndex]);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, (int)packedSize.width, (int)packedSize.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, packedTextures[planeIndex], 0);
+            NSAssert(glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE, @"Incomplete packed YUV plane FBO");
+            packedTextureSizes[planeIndex] = packedSize;
+        }
+
+        glViewport(0, 0, (int)packedSize.width, (int)packedSize.height);
+
+        GLProgram *packingProgram = [self planeHasChrominancePairs:planeIndex] ? packedChrominancePairProgram : packedComponentProgram;
+        [GPUImageOpenGLESContext setActiveShaderProgram:packingProgram];
+
+        glUniform1f([packingProgram uniformIndex:@"packedWidth"], packedSize.width);
+        glUniform1f([packingProgram uniformIndex:@"planeWidth"], planeSize.width);
+        if (packingProgram == packedComponentProgram)
+        {
+            GLfloat firstComponent[3], secondComponent[3];
+            [self getComponentsOfPlane:planeIndex first:firstComponent second:secondComponent];
+            glUniform3fv([packingProgram uniformIndex:@"firstComponent"], 1, firstComponent);
+        }
+
+        [self drawTexture:inputTexture withProgram:packingProgram];
+    }
+
+    for (NSUInteger planeIndex = 0; planeIndex < numberOfPlanes; planeIndex++)
+    {
+        CGSize packedSize = [self packedSizeOfPlane:planeIndex forFrameSize:frameSize];
+        size_t packedBytesPerRow = (size_t)packedSize.width * 4;
+        size_t planeBytesPerRow = [self bytesPerRowOfPlane:planeIndex forFrameSize:frameSize];
+        int planeHeight = (int)packedSize.height;
+
+        glBindFramebuffer(GL_FRAMEBUFFER, packedFramebuffers[planeIndex]);
+
+        if (bytesPerRow[planeIndex] == packedBytesPerRow)
+        {
+            glReadPixels(0, 0, (int)packedSize.width, planeHeight, GL_RGBA, GL_UNSIGNED_BYTE, planeBytes[planeIndex]);
+        }
+        else
+        {
+            // Packed rows can run past the end of the plane's rows, or the destination rows can be padded, so go through a scratch buffer and copy row by row
+            size_t packedLength = packedBytesPerRow * planeHeight;
+            if (packedLength > packedRowBufferLength)
+            {
+                free(packedRowBuffer);
+                packedRowBuffer = (GLubyte *) malloc(packedLength);
+                packedRowBufferLength = packedLength;
+            }
+
+            glReadPixels(0, 0, (int)packedSize.width, planeHeight, GL_RGBA, GL_UNSIGNED_BYTE, packedRowBuffer);
+
+            for (int currentRow = 0; currentRow < planeHeight; currentRow++)
+            {
+                memcpy(planeBytes[planeIndex] + (currentRow * bytesPerRow[planeIndex]), packedRowBuffer + (currentRow * packedBytesPerRow), planeBytesPerRow);
+            }
+        }
+    }
+}
+
+#pragma mark -
+#pragma mark Accessors
+
+- (void)setColorMatrix:(GPUImageYUVColorMatrix)newValue;
+{
+    _colorMatrix = newValue;
+    [self calculateConversionMatrix];
+}
+
+- (void)setFullRange:(BOOL)newValue;
+{
+    _fullRange = newValue;
+    [self calculateConversionMatrix];
+}
+
+@end